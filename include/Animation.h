@@ -0,0 +1,43 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 关键帧动画 ====================
+// 动画为全屏单色点阵（1位/像素，每行ANIMATION_ROW_BYTES字节，高位在左），颜色取上/下半屏的文本与背景颜色。
+// 客户端一次上传整个序列：一个完整关键帧，之后每帧只带与上一帧相比变化的行内字节段，
+// 设备保存在动画缓冲区中循环播放，不再需要蓝牙通信。
+// 播放时每帧只应用增量、只重绘实际翻转的像素；最后一帧回到关键帧的增量在上传时预先算好，
+// 回绕时同样只重绘变化的像素。颜色改变时整帧重绘一次。
+// 序列格式（多字节整数高字节在前）：
+//   [帧数 1][循环次数 1，0为无限][关键帧时长 2][关键帧点阵 ANIMATION_FRAME_BYTES]
+//   之后每个增量帧：[时长 2][段数 1] + 每段 [行 1][起始字节 1][字节数 1][点阵...]
+// 缓冲区中去掉前2字节，末尾追加回绕增量 [段数 1][段...]。
+struct AnimationPlayback
+{
+    bool active;                          // 是否在播放（播放期间动画占据整屏）
+    bool finished;                        // 有限循环已播完，停在最后一帧
+    uint8_t frameCount;                   // 帧数（含关键帧）
+    uint8_t loopCount;                    // 循环次数（0为无限）
+    uint8_t loopsDone;                    // 已完成的循环次数
+    uint8_t frameIndex;                   // 当前显示的帧序号
+    const uint8_t *sequence;              // 序列（位于全屏内容缓冲区）
+    uint32_t nextOffset;                  // 下一增量帧在序列中的偏移
+    uint32_t wrapOffset;                  // 回绕增量在序列中的偏移
+    uint16_t duration;                    // 当前帧时长（毫秒）
+    unsigned long frameStart;             // 当前帧开始显示的时间
+    uint32_t framesShown;                 // 累计切换的帧数
+    uint32_t pixelsDrawn;                 // 累计重绘的像素数
+    uint8_t frame[ANIMATION_FRAME_BYTES]; // 当前显示的点阵
+};
+
+extern AnimationPlayback animationPlayback;
+
+bool isAnimationPlaying();                                // 动画是否占据屏幕（文本渲染据此让出）
+void stopAnimation();                                     // 停止播放并恢复文本显示
+void updateAnimation();                                   // loop中调用：到时切换帧，颜色变化时整帧重绘
+void handleAnimationCommand(const BluetoothFrame &frame); // 处理动画命令 (0x05)
+
+#endif
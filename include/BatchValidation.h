@@ -0,0 +1,37 @@
+#ifndef BATCHVALIDATION_H
+#define BATCHVALIDATION_H
+
+#include "Platform.h"
+#include "config.h"
+
+// ==================== 批量命令校验 ====================
+// 批量帧的拆分与整体校验。设备状态经BatchContext传入，不依赖显示与缓存的实现，可在主机上测试。
+// 校验通过的批量在应用时不会因以下原因中途失败：命令或长度不合法、屏幕区域无效、字形定义记录不完整、
+// 文本超出区域容量、按ID文本引用的字形未缓存或被同一批量中的字形定义淘汰（应用期间这些ID固定在缓存中）。
+// 字形表空间、局部更新范围等取决于应用时内容的条件无法预先确定，由应用阶段的整体回滚兜底（见CommandBatch.h）。
+
+// 批量帧中的一条子命令
+struct BatchRecord
+{
+    uint8_t command;
+    uint16_t length;
+    const uint8_t *data;
+    uint8_t fontSize; // 该子命令生效时的字体（按批量内的字体切换推演）
+};
+
+// 校验所需的设备状态（[0]为16x16，[1]为32x32）
+struct BatchContext
+{
+    uint8_t fontSize;                                     // 批量开始时的字体
+    bool fontPackLoaded;                                  // 设备端字库已加载
+    uint16_t cacheCapacity[2];                            // 字形缓存容量
+    uint16_t tableCapacity[2];                            // 去重字形表容量
+    bool (*isGlyphCached)(uint8_t fontSize, uint16_t id); // 字形ID当前是否已缓存
+};
+
+// 拆分并校验批量数据，返回子命令数；不合法时返回-1，failedIndex为第一条不合法的子命令
+int parseBatch(const uint8_t *data, int length, const BatchContext &context, BatchRecord *records, int &failedIndex);
+// 收集按ID文本引用的指定字体字形ID（升序、去重），多于maxIds时返回-1
+int collectPinnedGlyphIds(const BatchRecord *records, int count, uint8_t fontSize, uint16_t *ids, int maxIds);
+
+#endif
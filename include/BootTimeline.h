@@ -0,0 +1,22 @@
+#ifndef BOOTTIMELINE_H
+#define BOOTTIMELINE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 启动时间线 ====================
+// 各初始化阶段完成时调用bootMark()记下时刻（上电以来的微秒数），启动结束后输出到日志，
+// 也可经启动时间线查询命令 (0x14) 导出，据此查看上电到首帧内容之间的时间花在哪里。
+// 蓝牙在后台任务中启动，其阶段可能在setup()结束之后才记录。
+struct BootMark
+{
+    uint8_t phase;  // 阶段编号（BOOT_PHASE_*）
+    uint32_t micro; // 完成时刻（上电以来的微秒数）
+};
+
+void bootMark(uint8_t phase);                                // 记录阶段完成时刻（可从其他任务调用）
+void reportBootTimeline();                                   // 输出已记录的各阶段时刻与耗时
+void handleBootTimelineCommand(const BluetoothFrame &frame); // 处理启动时间线查询命令 (0x14)
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef CHUNKEDTRANSFER_H
+#define CHUNKEDTRANSFER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 分块传输（断点续传） ====================
+// 单帧数据受 BT_MAX_FRAME_SIZE 限制，超长内容（如长跑马灯）分块写入内容槽，
+// 收齐后按目标命令整体处理。设备对每个数据块应答已确认偏移，
+// 蓝牙断线重连后客户端用QUERY取回偏移，从该处继续发送即可。
+struct TransferSlot
+{
+    bool active;                // 是否有进行中的传输
+    uint8_t transferId;         // 客户端指定的传输ID
+    uint8_t targetCommand;      // 收齐后按此命令处理
+    uint32_t totalLength;       // 总长度
+    uint32_t receivedBytes;     // 已连续收到（已确认）的字节数
+    uint8_t *buffer;            // 内容槽（指向静态传输缓冲区）
+    unsigned long lastActivity; // 最近一次收到数据的时间（闲置超时判断用）
+};
+
+extern TransferSlot transferSlot;
+
+void handleTransferCommand(const BluetoothFrame &frame); // 处理分块传输命令 (0x0C)
+void abortTransfer();                                   // 放弃当前传输并释放内容槽
+void updateTransfer();                                  // loop中调用：传输闲置超时后放弃
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef COMMANDBATCH_H
+#define COMMANDBATCH_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 批量命令（原子场景切换） ====================
+// 一个批量帧携带多条子命令，格式：重复 [命令][长度高][长度低][数据...]。
+// 先整体校验（见BatchValidation.h），全部合法才依次应用；应用期间推迟亮度等即时刷新，结束后只渲染一次，
+// 观众不会看到"新文字旧颜色"之类的中间状态。
+// 应用前保存场景（显示/颜色/特效/亮度状态、字体、流式播放、各区域文本、模板字段、分页设置、插播层数），
+// 任一子命令未能完整生效（如字形表已满）时整体回滚到该场景；字形缓存中已写入的定义保留。
+extern bool batchApplying; // 正在应用批量命令（各处理函数据此推迟即时刷新）
+
+void markBatchFailed();                               // 子命令未能完整生效时由处理函数调用（仅在应用批量期间起作用）
+void handleBatchCommand(const BluetoothFrame &frame); // 处理批量命令 (0x0E)
+
+#endif
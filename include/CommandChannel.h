@@ -0,0 +1,35 @@
+#ifndef COMMANDCHANNEL_H
+#define COMMANDCHANNEL_H
+
+#include "Transport.h"
+#include "bluetooth_protocol.h"
+#include "FlowControl.h"
+
+// ==================== 命令通道 ====================
+// 一个输入通道 = 传输 + 独立的解析器/帧/流量控制状态，完整帧都交给 processBluetoothCommand 统一处理；
+// 处理期间的应答写回该帧的来源通道。各通道共用一个帧缓冲区，一帧收完（或超时放弃）之前
+// 其他通道的数据留在各自的接收队列中，不会与该帧交错。
+class CommandChannel
+{
+private:
+    Transport &transport;
+    BluetoothProtocolParser parser;
+    BluetoothFrame frame;
+    FlowControlState flowControl;
+
+    void handleParseResult(ParseResult result);
+
+public:
+    CommandChannel(Transport &transport, uint16_t flowWindow);
+
+    bool begin(); // 初始化传输
+    void poll();  // 读取全部可用数据并处理完整帧
+
+    Transport &getTransport() { return transport; }
+    BluetoothProtocolParser &getParser() { return parser; }
+    FlowControlState &getFlowControl() { return flowControl; }
+};
+
+CommandChannel *getActiveChannel(); // 当前正在处理数据的通道（不在处理中时为nullptr）
+
+#endif
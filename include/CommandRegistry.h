@@ -0,0 +1,35 @@
+#ifndef COMMANDREGISTRY_H
+#define COMMANDREGISTRY_H
+
+#include "Platform.h"
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 命令注册表 ====================
+// 每个命令码对应一条说明：处理函数、数据长度范围、所属扩展特性、能否放入批量命令。
+// 解析器据此拒绝未注册命令与超长数据，分发按命令码直接索引，能力查询也由此生成。
+// 未注册的命令码在解析阶段即被拒绝。
+typedef void (*CommandHandler)(const BluetoothFrame &frame);
+
+struct CommandSpec
+{
+    uint8_t command;        // 命令码
+    const char *name;       // 名称（日志用）
+    CommandHandler handler; // 处理函数
+    uint16_t minLength;     // 最小数据长度
+    uint16_t maxLength;     // 最大数据长度（BT_CMD_LEN_UNLIMITED不设上限）
+    uint32_t feature;       // 所属扩展特性（BT_FEATURE_*，基础命令为0）
+    bool batchable;         // 能否作为批量命令的子命令
+};
+
+// 特性过滤：去掉依赖运行时资源（字库、流式文本分区等）而资源不可用的特性，由main.cpp设置
+typedef uint32_t (*FeatureFilter)(uint32_t features);
+
+void registerCommandTable(const CommandSpec *table, size_t count);   // 注册命令表（setup中调用）
+const CommandSpec *findCommandSpec(uint8_t command);                 // 按命令码查找，未注册返回nullptr
+bool isCommandLengthValid(const CommandSpec *spec, uint16_t length); // 数据长度是否在允许范围内
+void setFeatureFilter(FeatureFilter filter);                         // 设置特性过滤函数
+uint32_t getSupportedFeatures();                                     // 当前可用的扩展特性
+void handleCapabilityCommand(const BluetoothFrame &frame);           // 处理能力查询命令 (0x10)
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef COMMANDTABLE_H
+#define COMMANDTABLE_H
+
+#include "config.h"
+
+// ==================== 命令表 ====================
+// 全部命令的注册行：命令码、名称、处理函数、最小/最大数据长度、所属特性、能否放入批量命令。
+// 固件（main.cpp）与主机测试共用同一份长度范围与批量标记，展开时由调用方决定处理函数一列的取值：
+//   #define ROW(command, name, handler, minLength, maxLength, feature, batchable) {...},
+//   static const CommandSpec table[] = {COMMAND_TABLE(ROW)};
+#define COMMAND_TABLE(ENTRY)                                                                                                            \
+    ENTRY(BT_CMD_SET_DIRECTION, "方向", handleSetDirectionCommand, 0, 0, 0, true)                                                     \
+    ENTRY(BT_CMD_SET_VERTICAL, "竖向", handleSetVerticalCommand, 0, 0, 0, true)                                                       \
+    ENTRY(BT_CMD_SET_FONT_16x16, "16x16字体", handleSetFont16Command, 0, 0, 0, true)                                                  \
+    ENTRY(BT_CMD_SET_FONT_32x32, "32x32字体", handleSetFont32Command, 0, 0, 0, true)                                                  \
+    ENTRY(BT_CMD_SET_TEXT, "文本", handleTextCommand, 1, BT_CMD_LEN_UNLIMITED, 0, true)                                               \
+    ENTRY(BT_CMD_SET_ANIMATION, "动画", handleAnimationCommand, 0, BT_CMD_LEN_UNLIMITED, BT_FEATURE_ANIMATION, false)                 \
+    ENTRY(BT_CMD_SET_COLOR, "颜色", handleColorCommand, BT_COLOR_DATA_LEN, BT_COLOR_DATA_LEN, 0, true)                                \
+    ENTRY(BT_CMD_SET_BRIGHTNESS, "亮度", handleBrightnessCommand, BT_BRIGHTNESS_DATA_LEN, BT_BRIGHTNESS_DATA_LEN, 0, true)            \
+    ENTRY(BT_CMD_SET_EFFECT, "特效", handleEffectCommand, BT_EFFECT_DATA_LEN, BT_EFFECT_DATA_LEN, 0, true)                            \
+    ENTRY(BT_CMD_DEFINE_GLYPH, "字形定义", handleGlyphDefineCommand, 1 + BT_GLYPH_ID_LEN, BT_CMD_LEN_UNLIMITED,                       \
+          BT_FEATURE_GLYPH_CACHE, true)                                                                                                 \
+    ENTRY(BT_CMD_SET_TEXT_BY_ID, "按ID文本", handleTextByIdCommand, 1 + BT_GLYPH_ID_LEN, BT_CMD_LEN_UNLIMITED,                        \
+          BT_FEATURE_GLYPH_CACHE, true)                                                                                                 \
+    ENTRY(BT_CMD_SET_TEXT_UTF8, "UTF-8文本", handleUtf8TextCommand, 2, BT_CMD_LEN_UNLIMITED, BT_FEATURE_FONT_PACK, true)              \
+    ENTRY(BT_CMD_TRANSFER, "分块传输", handleTransferCommand, 2, BT_CMD_LEN_UNLIMITED, BT_FEATURE_TRANSFER, false)                    \
+    ENTRY(BT_CMD_TEXT_RANGE, "局部文本", handleTextRangeCommand, BT_RANGE_HEADER_LEN, BT_CMD_LEN_UNLIMITED, BT_FEATURE_TEXT_RANGE,    \
+          true)                                                                                                                         \
+    ENTRY(BT_CMD_BATCH, "批量", handleBatchCommand, BT_BATCH_RECORD_HEADER_LEN, BT_CMD_LEN_UNLIMITED, BT_FEATURE_BATCH, false)        \
+    ENTRY(BT_CMD_FLOW_CONTROL, "流量控制", handleChannelFlowControlCommand, 0, 1, BT_FEATURE_FLOW_CONTROL, false)                     \
+    ENTRY(BT_CMD_CAPABILITIES, "能力查询", handleCapabilityCommand, 0, 0, 0, false)                                                   \
+    ENTRY(BT_CMD_SCENE_SYNC, "场景同步", handleSceneSyncCommand, 0, SCENE_ITEM_COUNT, BT_FEATURE_SCENE_SYNC, false)                   \
+    ENTRY(BT_CMD_MEMORY_STATS, "内存统计", handleMemoryStatsCommand, 0, 0, BT_FEATURE_MEMORY_STATS, false)                            \
+    ENTRY(BT_CMD_STREAM_TEXT, "流式文本", handleStreamTextCommand, 1, BT_CMD_LEN_UNLIMITED, BT_FEATURE_STREAM_TEXT, false)            \
+    ENTRY(BT_CMD_BOOT_TIMELINE, "启动时间线", handleBootTimelineCommand, 0, 0, BT_FEATURE_BOOT_TIMELINE, false)                       \
+    ENTRY(BT_CMD_IMAGE, "图像", handleImageCommand, 1, BT_CMD_LEN_UNLIMITED, BT_FEATURE_IMAGE, false)                                 \
+    ENTRY(BT_CMD_LIVE, "实时流", handleLiveStreamCommand, 1, BT_CMD_LEN_UNLIMITED, BT_FEATURE_LIVE, false)                            \
+    ENTRY(BT_CMD_PLAYLIST, "播放列表", handlePlaylistCommand, 1, BT_CMD_LEN_UNLIMITED, BT_FEATURE_PLAYLIST, false)                    \
+    ENTRY(BT_CMD_TICKER, "滚动队列", handleTickerCommand, 2, BT_CMD_LEN_UNLIMITED, BT_FEATURE_TICKER, false)                          \
+    ENTRY(BT_CMD_TEXT_FIELD, "模板字段", handleTextFieldCommand, 1, BT_CMD_LEN_UNLIMITED, BT_FEATURE_TEXT_FIELD, true)                \
+    ENTRY(BT_CMD_PRIORITY, "优先插播", handlePriorityCommand, 1, 4, BT_FEATURE_PRIORITY, true)                                        \
+    ENTRY(BT_CMD_PAGING, "分页设置", handlePagingCommand, 1, BT_PAGING_DATA_LEN, BT_FEATURE_PAGING, true)
+
+#endif
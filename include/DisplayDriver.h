@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
 #include "config.h"
+#include "TextStore.h"
 
 // 字体参数在config.h中定义，根据currentFontSize动态选择
 // 移除固定宏定义，改为在代码中根据字体大小标志位选择对应参数
@@ -18,6 +19,45 @@ extern MatrixPanel_I2S_DMA *dma_display;
 // 外部字体大小标志位声明
 extern uint8_t currentFontSize;
 
+// 屏幕镜像：开启SCENE_FIRST_FRAME时，经drawPanelPixel/clearPanel的绘制同步记录一份，
+// 场景快照据此保存首帧（DMA显示缓冲区为位平面格式，不便直接读回）
+#if SCENE_FIRST_FRAME
+extern uint16_t panelMirror[SCREEN_WIDTH * SCREEN_HEIGHT];
+#endif
+
+// 离屏绘制目标：pixels非空时drawPanelPixel改为写入该位图（宽SCREEN_WIDTH，对应屏幕第top行起的height行），
+// 屏幕与镜像均不变；翻页过渡借此用现有的字符绘制函数预渲染整页
+struct PanelTarget
+{
+    uint16_t *pixels; // 位图（nullptr表示直接绘制到屏幕）
+    int top;          // 位图第0行对应的屏幕行
+    int height;       // 位图行数
+};
+extern PanelTarget panelTarget;
+
+inline void drawPanelPixel(int x, int y, uint16_t color)
+{
+    if (panelTarget.pixels)
+    {
+        if (x >= 0 && x < SCREEN_WIDTH && y >= panelTarget.top && y < panelTarget.top + panelTarget.height)
+            panelTarget.pixels[(y - panelTarget.top) * SCREEN_WIDTH + x] = color;
+        return;
+    }
+    dma_display->drawPixel(x, y, color);
+#if SCENE_FIRST_FRAME
+    if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT)
+        panelMirror[y * SCREEN_WIDTH + x] = color;
+#endif
+}
+
+inline void clearPanel()
+{
+    dma_display->clearScreen();
+#if SCENE_FIRST_FRAME
+    memset(panelMirror, 0, sizeof(panelMirror));
+#endif
+}
+
 // 颜色定义
 #define COLOR_WHITE 0xFFFF
 #define COLOR_RED 0xF800
@@ -30,20 +70,20 @@ void drawChar16x16(int x, int y, const uint16_t *font_data, uint16_t color);
 void drawChar16x16Gradient(int x, int y, const uint16_t *font_data, bool isUpper, uint8_t gradientMode);
 void drawChar16x16Vertical(int x, int y, const uint16_t *font_data, uint16_t color);                             // 竖向显示字符
 void drawChar16x16VerticalGradient(int x, int y, const uint16_t *font_data, bool isUpper, uint8_t gradientMode); // 竖向渐变字符
-void drawString16x16(int x, int y, const uint16_t *font_array, int char_count, uint16_t color);
-void drawString16x16Gradient(int x, int y, const uint16_t *font_array, int char_count, bool isUpper, uint8_t gradientMode);
-void drawString16x16Vertical(int x, int y, const uint16_t *font_array, int char_count, uint16_t color);                             // 竖向显示字符串
-void drawString16x16VerticalGradient(int x, int y, const uint16_t *font_array, int char_count, bool isUpper, uint8_t gradientMode); // 竖向渐变字符串
-void drawChar32x32(int x, int y, const uint16_t *font_data, uint16_t color);                                                        // 32x32字符显示
-void drawChar32x32Vertical(int x, int y, const uint16_t *font_data, uint16_t color);                                                // 32x32竖向显示字符
-void drawChar32x32Gradient(int x, int y, const uint16_t *font_data, uint8_t gradientMode);                                          // 32x32字符渐变色显示
-void drawChar32x32VerticalGradient(int x, int y, const uint16_t *font_data, uint8_t gradientMode);                                  // 32x32竖向字符渐变色显示
-void drawString32x32(int x, int y, const uint16_t *font_array, int char_count, uint16_t color);                                     // 32x32字符串显示
-void drawString32x32Vertical(int x, int y, const uint16_t *font_array, int char_count, uint16_t color);                             // 32x32竖向显示字符串
-void drawString32x32Gradient(int x, int y, const uint16_t *font_array, int char_count, uint8_t gradientMode);                       // 32x32字符串渐变色显示
-void drawString32x32VerticalGradient(int x, int y, const uint16_t *font_array, int char_count, uint8_t gradientMode);               // 32x32竖向字符串渐变色显示
-uint16_t rgb888to565(uint8_t r, uint8_t g, uint8_t b);                                                                              // RGB888转RGB565
-uint16_t getGradientColor(int x, int y, bool isUpper, uint8_t gradientMode);                                                        // 获取16x16渐变色
-uint16_t getGradientColor32x32(int x, int y, uint8_t gradientMode);                                                                 // 获取32x32渐变色
+void drawString16x16(int x, int y, const GlyphText &text, uint16_t color);
+void drawString16x16Gradient(int x, int y, const GlyphText &text, bool isUpper, uint8_t gradientMode);
+void drawString16x16Vertical(int x, int y, const GlyphText &text, uint16_t color);                             // 竖向显示字符串
+void drawString16x16VerticalGradient(int x, int y, const GlyphText &text, bool isUpper, uint8_t gradientMode); // 竖向渐变字符串
+void drawChar32x32(int x, int y, const uint16_t *font_data, uint16_t color);                                   // 32x32字符显示
+void drawChar32x32Vertical(int x, int y, const uint16_t *font_data, uint16_t color);                           // 32x32竖向显示字符
+void drawChar32x32Gradient(int x, int y, const uint16_t *font_data, uint8_t gradientMode);                     // 32x32字符渐变色显示
+void drawChar32x32VerticalGradient(int x, int y, const uint16_t *font_data, uint8_t gradientMode);             // 32x32竖向字符渐变色显示
+void drawString32x32(int x, int y, const GlyphText &text, uint16_t color);                                     // 32x32字符串显示
+void drawString32x32Vertical(int x, int y, const GlyphText &text, uint16_t color);                             // 32x32竖向显示字符串
+void drawString32x32Gradient(int x, int y, const GlyphText &text, uint8_t gradientMode);                       // 32x32字符串渐变色显示
+void drawString32x32VerticalGradient(int x, int y, const GlyphText &text, uint8_t gradientMode);               // 32x32竖向字符串渐变色显示
+uint16_t rgb888to565(uint8_t r, uint8_t g, uint8_t b);                                                         // RGB888转RGB565
+uint16_t getGradientColor(int x, int y, bool isUpper, uint8_t gradientMode);                                   // 获取16x16渐变色
+uint16_t getGradientColor32x32(int x, int y, uint8_t gradientMode);                                            // 获取32x32渐变色
 
 #endif
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef FLOWCONTROL_H
+#define FLOWCONTROL_H
+
+#include "Platform.h"
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 流量控制（基于额度的发送窗口） ====================
+// 客户端用流量控制命令开启后，设备按"累计已消费字节数"发放额度：
+// 客户端保证 已发送字节数 - 设备已消费字节数 <= 窗口，即可满速发送而不会溢出接收队列。
+// 已消费指字节已从接收队列读出，设备忙于处理大帧期间不读取，额度自然停止增长。
+// 计数均从开启命令之后的第一个字节算起，按uint32回绕。每个输入通道各有一份状态。
+struct FlowControlState
+{
+    uint16_t window;        // 发送窗口（该通道接收缓冲区大小）
+    bool enabled;           // 是否已开启
+    uint32_t consumedBytes; // 累计已消费字节数
+    uint32_t grantedBytes;  // 最近一次通告给客户端的已消费字节数
+};
+
+void flowControlConsume(FlowControlState &state, size_t count);                     // 记录从接收队列读出的字节
+void flowControlPoll(FlowControlState &state, bool queueEmpty);                     // 满足条件时发放额度
+void handleFlowControlCommand(const BluetoothFrame &frame, FlowControlState &state); // 处理流量控制命令 (0x0F)
+
+#endif
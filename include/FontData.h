@@ -2,21 +2,30 @@
 #define FONTDATA_H
 
 #include <Arduino.h>
+#include "config.h"
+
+// ==================== 内置示例数据 ====================
+// 内置点阵均为const数组，链接到Flash只读段，渲染时原地读取，不在启动时复制到DRAM。
+// 字符数为编译期常量，与数组实际长度不符时编译报错（见src/FontData.cpp）。
+// 更换或扩充内置内容时用 tools/mkbuiltin.py 从BDF字体重新生成本文件与src/FontData.cpp。
+#define UPPER_TEXT_CHAR_COUNT 6 // 上半屏示例字符数
+#define LOWER_TEXT_CHAR_COUNT 5 // 下半屏示例字符数
+#define FULL_TEXT_CHAR_COUNT 3  // 全屏（32x32）示例字符数
 
 // ==================== 字库数据声明 ====================
 // "人人人人人人" - 6个字符测试长文本分组显示
-extern uint16_t upper_text[];
+extern const uint16_t upper_text[];
 
 // "人人人人人" - 5个字符测试长文本分组显示
-extern uint16_t lower_text[];
+extern const uint16_t lower_text[];
 
 // 32x32向右箭头(→)图案 - 三个相同箭头测试
-extern uint16_t full_text[];
+extern const uint16_t full_text[];
 
 // ==================== 辅助函数声明 ====================
-// 获取字符数量的辅助函数
-int getUpperTextCharCount(); // 获取上半屏文本字符数
-int getLowerTextCharCount(); // 获取下半屏文本字符数
-int getFullTextCharCount();  // 获取全屏文本字符数
+// 获取字符数量的辅助函数（编译期常量）
+constexpr int getUpperTextCharCount() { return UPPER_TEXT_CHAR_COUNT; } // 获取上半屏文本字符数
+constexpr int getLowerTextCharCount() { return LOWER_TEXT_CHAR_COUNT; } // 获取下半屏文本字符数
+constexpr int getFullTextCharCount() { return FULL_TEXT_CHAR_COUNT; }   // 获取全屏文本字符数
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,65 @@
+#ifndef FONTPACK_H
+#define FONTPACK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "PartitionStore.h"
+
+// ==================== 设备端字库（Flash） ====================
+// 字库由 tools/mkfontpack.py 从标准BDF点阵字体离线生成，烧录到fontpack分区。
+// 文件格式（所有整数均为小端）：
+//   文件头  [魔数"LFNT" 4][版本 2][段数 2]
+//   段表    每段16字节：[字形尺寸16/32 1][保留 3][字形数 4][索引偏移 4][点阵偏移 4]
+//   索引    每段按码位升序排列的uint32码位数组
+//   点阵    与索引一一对应，每字形32或128字节，格式与文本命令(0x04)的点阵数据相同
+// 同一文件也可由 tools/mkbuiltin.py 转换为const数组链接进固件（FONT_PACK_BUILTIN），
+// 分区中没有字库时使用，数据位于Flash只读段，原地读取不占用DRAM。
+struct FontPackSection
+{
+    uint8_t glyphSize;     // 字形尺寸（16或32）
+    uint32_t glyphCount;   // 字形数量
+    uint32_t indexOffset;  // 码位索引偏移
+    uint32_t bitmapOffset; // 点阵数据偏移
+};
+
+class FontPack
+{
+private:
+    PartitionStore store;
+    const uint8_t *image; // 内置字库映像（Flash中的const数组），nullptr表示读取分区
+    uint32_t imageSize;
+    FontPackSection sections[FONT_PACK_MAX_SECTIONS];
+    uint8_t sectionCount;
+    bool loaded;
+
+    bool readBytes(uint32_t offset, void *dest, size_t length) const;
+    bool loadHeader();
+    const FontPackSection *findSection(uint8_t fontSize) const;
+    int32_t findIndex(const FontPackSection &section, uint32_t codepoint) const;
+
+public:
+    FontPack();
+
+    bool begin(const char *label = FONT_PACK_PARTITION); // 打开分区并校验文件头，分区无字库时回退到内置字库
+    bool beginImage(const uint8_t *data, uint32_t size); // 使用链接进固件的字库映像
+    bool isLoaded() const { return loaded; }
+    bool isBuiltin() const { return loaded && image != nullptr; }
+    uint32_t getGlyphCount(uint8_t fontSize) const;
+
+    // 读取码位对应的字形并转换为显示用的uint16_t列数据，字库中不存在时返回false
+    bool readGlyph(uint8_t fontSize, uint32_t codepoint, uint16_t *dest) const;
+};
+
+extern FontPack fontPack;
+
+#if FONT_PACK_BUILTIN
+// 由 tools/mkbuiltin.py --fontpack 生成（src/BuiltinFontPack.cpp）
+extern const uint8_t builtinFontPack[];
+extern const uint32_t builtinFontPackSize;
+#endif
+
+// UTF-8解码：非法序列按U+FFFD处理，返回解码出的码位数量
+int decodeUtf8(const uint8_t *text, size_t length, uint32_t *codepoints, int maxCodepoints);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef GLYPHCACHE_H
+#define GLYPHCACHE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 设备端字形缓存 ====================
+// 客户端通过 BT_CMD_DEFINE_GLYPH 以自选ID上传字形，之后文本只需发送2字节ID。
+// 缓存容量固定，满时按LRU（最近最少使用）淘汰。
+class GlyphCache
+{
+private:
+    uint16_t *glyphData;   // 点阵数据（capacity × wordsPerGlyph 个uint16_t）
+    uint16_t *glyphIds;    // 每个槽位对应的客户端字形ID
+    uint32_t *lastUsed;    // 每个槽位的最近使用时刻（0表示空槽）
+    uint16_t capacity;     // 槽位数量
+    uint16_t wordsPerGlyph; // 每个字形占用的uint16_t数量（16x16为16，32x32为64）
+    uint16_t usedCount;    // 已占用槽位数
+    uint32_t useClock;     // LRU逻辑时钟
+    uint32_t evictCount;   // 累计淘汰次数
+    const uint16_t *pinnedIds; // 不可淘汰的ID（升序，批量命令应用期间有效）
+    int pinnedCount;           // 不可淘汰的ID数
+
+    int findSlot(uint16_t id) const;
+    bool isPinned(uint16_t id) const;
+
+public:
+    GlyphCache(uint16_t capacity, uint16_t wordsPerGlyph); // 存储取自启动期分配区，随程序常驻
+
+    bool store(uint16_t id, const uint8_t *bitmapBytes); // 写入字形（字节为高字节在前），槽位全被固定时返回false
+    void pin(const uint16_t *ids, int count);             // 固定一组ID（升序，调用方保持数组有效），淘汰时跳过
+    void unpin() { pinnedIds = nullptr; pinnedCount = 0; } // 解除固定
+    const uint16_t *lookup(uint16_t id);                  // 查找字形并刷新LRU，不存在返回nullptr
+    int lookupSlot(uint16_t id);                          // 查找字形所在槽位并刷新LRU，不存在返回-1
+    bool contains(uint16_t id) const { return findSlot(id) >= 0; }
+    void clear();
+
+    const uint16_t *getGlyphData() const { return glyphData; }
+    uint16_t getCapacity() const { return capacity; }
+    uint16_t getUsedCount() const { return usedCount; }
+    uint16_t getWordsPerGlyph() const { return wordsPerGlyph; }
+    uint32_t getEvictCount() const { return evictCount; }
+};
+
+// ==================== 全局缓存实例 ====================
+extern GlyphCache glyphCache16; // 16x16字形缓存
+extern GlyphCache glyphCache32; // 32x32字形缓存
+
+int countDistinctGlyphIds(const uint8_t *idBytes, int count); // 统计ID列表（2字节高位在前）中不同ID的个数
+
+// ==================== 命令处理函数 ====================
+void handleGlyphDefineCommand(const BluetoothFrame &frame); // 处理字形定义命令 (0x09)
+void handleTextByIdCommand(const BluetoothFrame &frame);    // 处理按ID设置文本命令 (0x0A)
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef GLYPHSTREAM_H
+#define GLYPHSTREAM_H
+
+#include "Platform.h"
+#include "config.h"
+#include "PartitionStore.h"
+#include "TextStore.h"
+
+// ==================== 流式文本（Flash） ====================
+// 几千字的新闻、行情跑马灯不放进RAM，而是存入stream分区，滚动时只读取可见位置附近的字形。
+// 文件格式（文件头整数均为小端）：
+//   文件头  [魔数"LSTR" 4][版本 2][字形尺寸16/32 1][保留 1][字符数 4][保留 4]
+//   点阵    按字符顺序排列，每字形32或128字节，格式与文本命令(0x04)的点阵数据相同
+// 上传时文件头最后写入，上传中断或掉电不会留下半截的有效文本。
+// 读前窗口固定为STREAM_WINDOW_BYTES，与文本长度无关，RAM占用恒定。
+// 上传与窗口读取只依赖PartitionStore，主机构建时分区为文件替身 <标签>.bin，容量即文件大小；
+// 播放与流式文本命令在TextStream.h中。
+class GlyphStream
+{
+private:
+    PartitionStore store;
+    uint16_t *window;     // 读前窗口（取自streamWindowBuffer）
+    uint32_t windowStart; // 窗口内第一个字符的序号
+    int windowCount;      // 窗口内字符数（0表示窗口无效）
+    uint8_t glyphSize;    // 字形尺寸（16或32）
+    uint32_t charCount;   // 字符数（0表示分区中没有完整文本）
+    uint32_t windowLoads; // 窗口从Flash重新加载的次数
+
+    bool uploading;          // 上传进行中
+    uint8_t uploadGlyphSize; // 上传中的字形尺寸
+    uint32_t uploadBytes;    // 上传点阵总字节数
+    uint32_t uploadOffset;   // 下一个期望的点阵偏移
+    uint32_t erasedEnd;      // 分区已擦除到的偏移
+
+    uint32_t getCapacity() const;
+    bool loadHeader();
+    bool loadWindow(uint32_t start);
+
+public:
+    GlyphStream();
+
+    bool begin(const char *label = STREAM_PARTITION); // 打开分区并读取文件头
+    bool isAvailable() const { return store.isOpen(); }
+    bool isReady() const { return charCount > 0; }
+    uint32_t getCharCount() const { return charCount; }
+    uint8_t getGlyphSize() const { return glyphSize; }
+    uint32_t getWindowLoads() const { return windowLoads; }
+    uint32_t getUploadOffset() const { return uploadOffset; }
+
+    // 取从first起count个字符的连续点阵视图，不在窗口内时从Flash重新加载；
+    // count超过窗口容量时截断，视图在下一次fetch之前有效
+    GlyphText fetch(uint32_t first, int count);
+
+    uint8_t beginUpload(uint8_t glyphSize, uint32_t charCount); // 返回BT_STREAM_STATUS_*
+    uint8_t writeUpload(uint32_t offset, const uint8_t *data, size_t length);
+    uint8_t endUpload();
+};
+
+#endif
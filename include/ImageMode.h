@@ -0,0 +1,38 @@
+#ifndef IMAGEMODE_H
+#define IMAGEMODE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 图像模式 ====================
+// 全屏彩色图像（标志、促销画面），不受文本颜色影响。先上传完整图像（RGB565或调色板索引），
+// 之后的更新以RLE压缩的XOR增量发送：与当前图像逐像素异或，未变化的像素以跳过段表示，
+// 局部改动只需几十字节，远小于整帧RGB565的4KB。
+// 增量先整体校验一遍（只解析、不写入），合法后直接在图像缓冲区上原地异或，
+// 只重绘值发生变化的像素，不需要整帧的临时副本。
+// 图像模式期间图像占据整屏，文本状态照常更新，退出后恢复文本显示。
+struct ImageState
+{
+    bool active;            // 是否处于图像模式
+    uint16_t *pixels;       // 当前图像（RGB565，逐行排列，取自mediaBuffer）
+    uint32_t fullCount;     // 完整图像次数
+    uint32_t deltaCount;    // 增量更新次数
+    uint32_t deltaBytes;    // 增量数据累计字节数
+    uint32_t pixelsChanged; // 增量累计改变的像素数
+};
+
+extern ImageState imageState;
+
+// 图像编码的解码函数，实时流 (0x16) 复用同一编码
+typedef void (*ImagePixelCallback)(int index);
+bool validateFullImage(uint8_t op, const uint8_t *data, int length);     // 校验完整图像（RGB565/调色板）
+void decodeFullImage(uint8_t op, const uint8_t *data, uint16_t *pixels); // 解码已校验的完整图像
+int applyImageDelta(const uint8_t *data, int length, uint16_t *pixels,
+                    ImagePixelCallback onChanged); // 应用RLE XOR增量，返回改变的像素数（格式错误返回-1）
+
+bool isImageShowing();                                // 图像是否占据屏幕（文本渲染据此让出）
+void exitImageMode();                                 // 退出图像模式并恢复文本显示
+void handleImageCommand(const BluetoothFrame &frame); // 处理图像命令 (0x15)
+
+#endif
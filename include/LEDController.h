@@ -6,6 +6,7 @@
 #include "config.h"
 #include "bluetooth_protocol.h"
 #include "DisplayDriver.h"
+#include "TextStore.h"
 
 // 颜色定义（从DisplayDriver.h迁移）
 #define COLOR_WHITE 0xFFFF
@@ -18,13 +19,16 @@
 // 文本显示状态结构
 struct TextDisplayState
 {
-    String upperText;             // 上半屏文本
-    String lowerText;             // 下半屏文本
-    int upperIndex;               // 上半屏当前显示起始索引
-    int lowerIndex;               // 下半屏当前显示起始索引
-    unsigned long lastSwitchTime; // 上次切换时间
-    bool needUpdate;              // 是否需要更新显示
-    uint8_t displayDirection;     // 文本显示方向（0x00正向，0x01竖向）
+    String upperText;              // 上半屏文本
+    String lowerText;              // 下半屏文本
+    int upperIndex;                // 上半屏当前显示起始索引
+    int lowerIndex;                // 下半屏当前显示起始索引
+    unsigned long lastSwitchTime;  // 上半屏（32x32时为全屏）上次翻页时间
+    unsigned long lowerSwitchTime; // 下半屏上次翻页时间
+    bool needUpdate;               // 是否需要更新显示
+    uint8_t displayDirection;      // 文本显示方向（0x00正向，0x01竖向）
+    uint8_t upperDirtyCells;       // 上半屏（32x32时为全屏）待重绘字符格位掩码（按当前页显示位置）
+    uint8_t lowerDirtyCells;       // 下半屏待重绘字符格位掩码
 };
 
 // 颜色状态结构（支持上下半屏独立颜色）
@@ -109,31 +113,31 @@ extern EffectState effectState;
 extern uint8_t currentFontSize;
 extern MatrixPanel_I2S_DMA *dma_display;
 
-// 动态点阵数据存储
-extern uint16_t *dynamic_upper_text; // 动态上半屏点阵数据
-extern uint16_t *dynamic_lower_text; // 动态下半屏点阵数据
-extern uint16_t *dynamic_full_text;  // 动态全屏点阵数据
-extern int dynamic_upper_char_count; // 动态上半屏字符数
-extern int dynamic_lower_char_count; // 动态下半屏字符数
-extern int dynamic_full_char_count;  // 动态全屏字符数
-
 // ==================== 函数声明 ====================
 // 硬件初始化
 bool initializeDisplay();
 
 // 内存管理
-void freeDynamicTextData(); // 释放动态点阵数据内存
+void freeDynamicTextData();                    // 清空动态文本（释放字形引用与区域序号缓冲区）
+int getTextRegionCapacity(uint8_t screenArea); // 屏幕区域可容纳的字符数（按当前字体）
 
 // 示例演示函数
 void demoBluetoothDataUsage(); // 演示如何使用蓝牙点阵数据
 
 // 文本显示相关函数
-void handleTextCommand(const uint16_t *upperData, int upperCharCount, const uint16_t *lowerData, int lowerCharCount); // 处理点阵数据命令
-void handleDirectionCommand(uint8_t direction);                                                                       // 处理显示方向命令
-void displayTextOnHalf(int y, bool isUpper);                                                                          // 在半屏显示文本
-void displayFullScreenText32x32();                                                                                    // 32x32全屏文本显示
-void handleFullScreenTextCommand(const uint16_t *fontData, int charCount);                                            // 处理32x32全屏点阵数据命令
-void updateTextDisplay();                                                                                             // 更新文本显示
+void handleTextCommand(const GlyphText &upper, const GlyphText &lower);                                   // 处理点阵数据命令
+void handleDirectionCommand(uint8_t direction);                                                           // 处理显示方向命令
+void displayTextOnHalf(int y, bool isUpper);                                                              // 在半屏显示文本
+void displayFullScreenText32x32();                                                                        // 32x32全屏文本显示
+void handleFullScreenTextCommand(const GlyphText &text);                                                  // 处理32x32全屏点阵数据命令
+void handleUpperTextCommand(const GlyphText &text);                                                       // 独立处理上半屏（main.cpp）
+void handleLowerTextCommand(const GlyphText &text);                                                       // 独立处理下半屏（main.cpp）
+void applyTextGlyphs(uint8_t screenArea, const GlyphText &text);                                          // 按屏幕区域应用点阵数据（main.cpp）
+GlyphText getUpperDisplayText();                                                                          // 上半屏当前显示的文本（无动态文本时为示例数据）
+GlyphText getLowerDisplayText();                                                                          // 下半屏当前显示的文本
+GlyphText getFullDisplayText();                                                                           // 全屏（32x32）当前显示的文本
+void updateTextDisplay();                                                                                 // 更新文本显示
+bool applyTextRangeUpdate(uint8_t screenArea, uint8_t op, int start, int count, const GlyphText &glyphs); // 局部替换/插入/删除字符
 
 // 颜色相关函数
 void handleColorCommand(const BluetoothFrame &frame);                        // 处理颜色命令
@@ -145,16 +149,17 @@ void handleBrightnessCommand(const BluetoothFrame &frame); // 处理亮度命令
 void updateBrightness();                                   // 更新亮度设置
 
 // 特效相关函数
-void handleEffectCommand(const BluetoothFrame &frame);                                                            // 处理特效命令
-void clearAllEffects(bool isUpper);                                                                               // 清除指定半屏的所有特效
-void setScrollEffect(bool isUpper, uint8_t scrollType, uint8_t speed);                                            // 设置滚动特效
-void setBlinkEffect(bool isUpper, uint8_t speed);                                                                 // 设置闪烁特效
-void setBreatheEffect(bool isUpper, uint8_t speed);                                                               // 设置呼吸特效
-void displayScrollingText(const uint16_t *font_data, int char_count, int offset, int y, uint8_t scrollType);      // 显示滚动文本
-void displayScrollingText32x32(const uint16_t *font_data, int char_count, int offset, int y, uint8_t scrollType); // 显示32x32滚动文本
-void updateScrollEffect();                                                                                        // 更新滚动特效
-void updateBlinkEffect();                                                                                         // 更新闪烁特效
-void updateBreatheEffect();                                                                                       // 更新呼吸特效
-void updateAllEffects();                                                                                          // 更新所有特效
+void handleEffectCommand(const BluetoothFrame &frame);                                        // 处理特效命令
+void clearAllEffects(bool isUpper);                                                           // 清除指定半屏的所有特效
+void setScrollEffect(bool isUpper, uint8_t scrollType, uint8_t speed);                        // 设置滚动特效
+void setBlinkEffect(bool isUpper, uint8_t speed);                                             // 设置闪烁特效
+void setBreatheEffect(bool isUpper, uint8_t speed);                                           // 设置呼吸特效
+void displayScrollingText(const GlyphText &text, int offset, int y, uint8_t scrollType);      // 显示滚动文本
+void displayScrollingText32x32(const GlyphText &text, int offset, int y, uint8_t scrollType); // 显示32x32滚动文本
+void displayStreamingText(bool isUpper, int y);                                               // 显示流式文本（只读取可见部分）
+void updateScrollEffect();                                                                    // 更新滚动特效
+void updateBlinkEffect();                                                                     // 更新闪烁特效
+void updateBreatheEffect();                                                                   // 更新呼吸特效
+void updateAllEffects();                                                                      // 更新所有特效
 
 #endif
\ No newline at end of file
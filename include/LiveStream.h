@@ -0,0 +1,47 @@
+#ifndef LIVESTREAM_H
+#define LIVESTREAM_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 实时流 ====================
+// 主机（如PC上的实时可视化）连续发送带帧号的关键帧与增量帧，编码与图像命令 (0x15) 相同。
+// 接收与呈现解耦：收到的帧直接从接收缓冲区解码到后台缓冲，不逐帧应答；
+// loop按LIVE_PRESENT_INTERVAL_MS的节奏把后台缓冲中最新的一帧呈现到屏上，
+// 只比较、重绘增量标记过的行中实际变化的像素（前台副本记录屏上内容）。
+// 两次呈现之间到达的多帧只呈现最新一帧（计为被取代），帧号不新于已解码帧的帧直接丢弃；
+// 增量帧必须紧接上一帧，中间丢帧时增量链断开，丢弃后续增量并应答一次"需要关键帧"。
+// 帧号为16位循环计数，按差值判断先后。
+struct LiveStreamState
+{
+    bool active;             // 是否处于实时流模式（期间占据整屏）
+    bool chainValid;         // 后台缓冲是否对应decodedSeq（增量帧可接续）
+    bool keyframeRequested;  // 已应答过"需要关键帧"，收到关键帧前不再重复
+    bool pending;            // 后台缓冲有尚未呈现的新帧
+    bool fullRedraw;         // 下次呈现整屏重绘（刚进入实时流，屏上不是前台副本的内容）
+    uint16_t *back;          // 后台缓冲（解码目标，RGB565）
+    uint16_t *front;         // 前台副本（屏上内容）
+    uint16_t decodedSeq;     // 最近解码的帧号
+    uint16_t presentedSeq;   // 最近呈现的帧号
+    uint32_t dirtyRows;      // 自上次呈现以来被修改的行（每位一行）
+    unsigned long lastPresent;
+    uint32_t received;       // 收到的帧数
+    uint32_t presented;      // 呈现的帧数
+    uint32_t superseded;     // 已解码但在呈现前被更新的帧取代的帧数
+    uint32_t dropped;        // 丢弃的帧数（过时、增量链断开或格式错误）
+    unsigned long windowStart;
+    uint32_t windowReceived; // 当前统计窗口内收到的帧数
+    uint32_t windowPresented;
+    uint16_t receiveFps;     // 上一统计窗口的接收帧率
+    uint16_t presentFps;     // 上一统计窗口的呈现帧率
+};
+
+extern LiveStreamState liveStream;
+
+bool isLiveStreaming();                                    // 实时流是否占据屏幕（文本渲染据此让出）
+void stopLiveStream();                                     // 结束实时流并恢复文本显示
+void updateLiveStream();                                   // loop中调用：按呈现节奏呈现最新帧并统计帧率
+void handleLiveStreamCommand(const BluetoothFrame &frame); // 处理实时流命令 (0x16)
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include "Platform.h"
+#include <type_traits>
+#include "config.h"
+
+// ==================== 延迟日志 ====================
+// LOG_E/LOG_W/LOG_I/LOG_D 只把 [时间戳][格式串指针][级别][参数] 写入环形缓冲区，不做格式化、不碰串口；
+// loop空闲时由 logDrain() 在串口发送缓冲区有空位时逐条输出，日志不再阻塞接收与渲染。
+// 低于 LOG_LEVEL 的调用在编译期整体去除。
+// 限制：格式串须为字符串常量；%s 参数须指向常量字符串（输出时才读取）；不支持浮点参数。
+// 缓冲区满时丢弃新日志并计数，输出时补一条丢弃提示。
+struct LogRecord
+{
+    uint32_t timestamp;              // 记录时间（毫秒）
+    const char *format;              // 格式串（常量，指针即可）
+    uint8_t level;                   // 级别
+    uint8_t argCount;                // 参数个数
+    uintptr_t args[LOG_MAX_ARGS];    // 参数（整数或常量字符串指针）
+};
+
+void logBegin();                                                                     // 初始化（设置串口发送缓冲区，须在Serial.begin之前）
+void logPush(uint8_t level, const char *format, const uintptr_t *args, uint8_t argCount); // 写入一条记录
+void logDrain();                                                                     // 空闲时输出，串口发送缓冲区不足时立即返回
+void logFlush();                                                                     // 阻塞输出全部记录（启动阶段或重启前使用）
+uint32_t logGetDroppedCount();                                                       // 累计丢弃条数
+
+template <typename T>
+inline uintptr_t logArg(T value)
+{
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+                  "日志参数只支持整数与常量字符串指针");
+    return (uintptr_t)value;
+}
+
+template <typename... Args>
+inline void logWrite(uint8_t level, const char *format, Args... args)
+{
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "日志参数过多");
+    uintptr_t values[sizeof...(Args) + 1] = {logArg(args)...};
+    logPush(level, format, values, sizeof...(Args));
+}
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(...) logWrite(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_E(...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(...) logWrite(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_W(...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(...) logWrite(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_I(...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(...) logWrite(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_D(...) ((void)0)
+#endif
+
+#endif
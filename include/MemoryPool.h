@@ -0,0 +1,105 @@
+#ifndef MEMORYPOOL_H
+#define MEMORYPOOL_H
+
+#include "Platform.h"
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 静态内存池 ====================
+// 内容与帧缓冲区全部来自编译期定长的内存池，运行期不再malloc/free：
+// 分配耗时固定，也不会因长期运行后的堆碎片导致大块上传失败。
+// 启动期分配区、区域文本与流式窗口的存储在.bss中；其余大块池构造时没有存储，
+// 由memoryPoolsBegin()在setup开头从堆一次性取得（此时堆尚无碎片），之后永不释放。
+// 各池记录高水位，可通过日志或内存统计命令查看实际用量，据此调整容量。
+
+// 线性分配区：只能整体回收到某个标记位置（先分配的后回收）
+class StaticArena
+{
+private:
+    const char *name;
+    uint8_t *storage;
+    size_t capacity;
+    size_t used;
+    size_t highWater;
+    uint32_t failureCount; // 容量不足导致的分配失败次数
+
+public:
+    constexpr StaticArena(const char *name, uint8_t *storage, size_t capacity)
+        : name(name), storage(storage), capacity(capacity), used(0), highWater(0), failureCount(0) {}
+
+    void attach(uint8_t *block) { storage = block; } // 绑定启动时取得的存储（容量为构造时给出的值）
+    bool hasStorage() const { return storage != nullptr; }
+
+    void *allocate(size_t size, size_t align = 4); // 容量不足（或尚未绑定存储）返回nullptr
+    template <typename T>
+    T *allocateArray(size_t count) { return (T *)allocate(count * sizeof(T), alignof(T)); }
+
+    size_t mark() const { return used; } // 当前分配位置
+    void rewind(size_t position);        // 回收到标记位置（之后分配的内存全部失效）
+
+    const char *getName() const { return name; }
+    size_t getCapacity() const { return capacity; }
+    size_t getUsed() const { return used; }
+    size_t getHighWater() const { return highWater; }
+    uint32_t getFailureCount() const { return failureCount; }
+};
+
+// 作用域内的临时分配在离开作用域时自动回收
+class ArenaScope
+{
+private:
+    StaticArena &arena;
+    size_t position;
+
+public:
+    explicit ArenaScope(StaticArena &arena) : arena(arena), position(arena.mark()) {}
+    ~ArenaScope() { arena.rewind(position); }
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+};
+
+// 定长缓冲区：整块归一个使用者，按需声明使用长度（内容保留，可在容量内增长）
+class FixedBuffer
+{
+private:
+    const char *name;
+    uint8_t *storage;
+    size_t capacity;
+    size_t used;
+    size_t highWater;
+    uint32_t failureCount;
+
+public:
+    constexpr FixedBuffer(const char *name, uint8_t *storage, size_t capacity)
+        : name(name), storage(storage), capacity(capacity), used(0), highWater(0), failureCount(0) {}
+
+    void attach(uint8_t *block) { storage = block; } // 绑定启动时取得的存储（容量为构造时给出的值）
+    bool hasStorage() const { return storage != nullptr; }
+
+    void *acquire(size_t size); // 声明使用前size字节，超出容量（或尚未绑定存储）返回nullptr
+    void release() { used = 0; }
+
+    const char *getName() const { return name; }
+    size_t getCapacity() const { return capacity; }
+    size_t getUsed() const { return used; }
+    size_t getHighWater() const { return highWater; }
+    uint32_t getFailureCount() const { return failureCount; }
+};
+
+// ==================== 全局内存池 ====================
+extern StaticArena bootArena;          // 启动期分配，永不回收（字形缓存）
+extern StaticArena scratchArena;       // 单条命令处理期间的临时缓冲（命令分发时整体回收）
+extern StaticArena priorityArena;      // 优先插播场景栈（按入栈顺序分配，出栈时回收到入栈前的位置）
+extern FixedBuffer upperTextBuffer;    // 上半屏文本字形序号
+extern FixedBuffer lowerTextBuffer;    // 下半屏文本字形序号
+extern FixedBuffer fullTextBuffer;     // 全屏（32x32）文本字形序号
+extern FixedBuffer transferBuffer;     // 分块传输重组缓冲
+extern FixedBuffer streamWindowBuffer; // 流式文本读前窗口
+extern FixedBuffer mediaBuffer;        // 全屏内容：动画序列、图像、实时流缓冲或翻页位图（同一时刻只有一个使用者）
+extern FixedBuffer playlistBuffer;     // 播放列表预备缓冲区（下一场景的负载）
+
+bool memoryPoolsBegin();                                    // setup开头调用：为大块内存池取得存储，全部成功返回true
+void reportMemoryUsage();                                   // 输出各内存池用量与高水位
+void handleMemoryStatsCommand(const BluetoothFrame &frame); // 处理内存统计查询命令 (0x12)
+
+#endif
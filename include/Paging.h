@@ -0,0 +1,33 @@
+#ifndef PAGING_H
+#define PAGING_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 分页与翻页过渡 ====================
+// 非滚动模式下一行放不下的文本按组分页轮流显示。每组字符数、每页停留时间与过渡方式按区域设置
+// （32x32字体时全屏使用上半屏的设置），默认与原固定行为一致：每组占满一行（16x16为4字，32x32为2字）、
+// 每页停留2秒、直接切换。
+// 过渡不在翻页时刻排版：停留期间把当前页和下一页分别预渲染成整行位图（每次调用最多渲染一页），
+// 过渡中的每一帧只按进度从两张位图按列拷贝到屏幕，翻页时刻没有字形绘制的耗时尖峰。
+// 位图以区域文本修改计数、页号、每组字符数、字体、方向与颜色为标记，任一变化即视为过期；
+// 过渡中内容或外观改变时立即结束过渡并整体重绘。闪烁、呼吸、滚动或流式文本的区域画面逐帧变化，直接切换。
+// 位图与动画、图像、实时流共用全屏内容缓冲区：缓冲区被它们占用时（如在全屏模式上插播）同样直接切换。
+struct PagingConfig
+{
+    uint8_t groupSize;      // 每组字符数（0表示占满一行）
+    uint16_t dwell;         // 每页停留时间（0.1秒为单位，从上一次过渡结束算起）
+    uint8_t transition;     // 过渡方式（BT_PAGING_TRANSITION_*）
+    uint8_t transitionTime; // 过渡时长（10毫秒为单位）
+};
+
+int getPageSize(bool isUpper);                                  // 区域每页字符数（按当前字体，32x32时isUpper为true表示全屏）
+const PagingConfig &getPagingConfig(bool isUpper);              // 区域的分页设置
+void setPagingConfig(bool isUpper, const PagingConfig &config); // 应用分页设置（每组字符数改变时从第一页重新开始）
+bool updatePaging(bool isUpper, unsigned long now);             // updateTextDisplay中调用：到时翻页、推进过渡、预渲染位图，需要整体重绘时返回true
+bool drawPagingFrame(bool isUpper);                             // 区域正在过渡时按当前进度从位图绘制并返回true
+void releasePagingBitmaps();                                    // 动画、图像与实时流取得全屏内容缓冲区前调用：位图作废并让出缓冲区
+void handlePagingCommand(const BluetoothFrame &frame);          // 处理分页设置命令 (0x1B)
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef PARTITIONSTORE_H
+#define PARTITIONSTORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef ARDUINO
+#include <esp_partition.h>
+#else
+#include <stdio.h>
+#endif
+
+// ==================== Flash数据分区访问 ====================
+// 设备上通过esp_partition读写partitions.csv中的数据分区；
+// 主机构建（未定义ARDUINO）时以同名文件 <标签>.bin 代替，便于在PC上测试。
+#define PARTITION_SECTOR_SIZE 4096 // Flash擦除扇区大小
+
+class PartitionStore
+{
+private:
+#ifdef ARDUINO
+    const esp_partition_t *partition;
+#else
+    FILE *file;
+    uint32_t fileSize;
+#endif
+
+public:
+    PartitionStore();
+    ~PartitionStore();
+
+    bool open(const char *label);
+    void close();
+    bool isOpen() const;
+    uint32_t size() const;
+
+    bool read(uint32_t offset, void *dest, size_t length) const;
+    bool write(uint32_t offset, const void *src, size_t length); // 目标区域须已擦除
+    bool erase(uint32_t offset, size_t length);                  // 按扇区对齐擦除（擦除后为0xFF）
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// ==================== 平台适配 ====================
+// 设备构建直接使用Arduino核心。主机构建（未定义ARDUINO，仅用于单元测试）只提供这里列出的接口，
+// 因此只有不依赖显示、蓝牙与Flash任务的模块能在主机上编译，见platformio.ini中env:native的源文件列表。
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <chrono>
+
+// 上电以来的毫秒数（主机上为单调时钟，只用于计算时间差）
+inline unsigned long millis()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+#endif
+
+#endif
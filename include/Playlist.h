@@ -0,0 +1,84 @@
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+#include "PartitionStore.h"
+
+// ==================== 场景播放列表 ====================
+// playlist分区保存最多PLAYLIST_SCENE_COUNT个完整场景（文本、颜色、特效、字体、方向、首帧），
+// 格式与场景快照相同（见SceneStore.h），以及一个按顺序轮播的列表，每项带显示时长与过渡方式。
+// 开始轮播后设备独立运行，不需要任何蓝牙通信；列表与运行状态保存在Flash中，重启后从第一项继续。
+// 下一项的场景在当前项开始后就从Flash读入预备缓冲区并校验，轮到它时只需从RAM应用，
+// 过渡期间直接把预备好的首帧逐列/逐行推送到屏上，切换时没有Flash读取和整屏重新渲染的停顿。
+// 分区布局：[列表 PLAYLIST_TABLE_SIZE][场景0 槽位][场景1 槽位]...
+// 列表（整数均为小端）：
+//   [魔数"LPLS" 4][版本 2][条目数 1][运行中 1] + 每条 [场景号 1][过渡方式 1][时长 2，0.1秒为单位]，末尾 [哈希 4]
+struct PlaylistEntry
+{
+    uint8_t scene;      // 场景号
+    uint8_t transition; // 过渡方式（BT_PLAYLIST_TRANSITION_*）
+    uint16_t duration;  // 显示时长（0.1秒为单位）
+};
+
+class Playlist
+{
+private:
+    PartitionStore store;
+    PlaylistEntry entries[PLAYLIST_MAX_ENTRIES];
+    uint8_t entryCount;
+    bool running;
+    uint32_t sceneLengths[PLAYLIST_SCENE_COUNT]; // 各场景负载长度（0表示未保存）
+    uint32_t sceneHashes[PLAYLIST_SCENE_COUNT];  // 各场景负载哈希
+    uint32_t sceneSequence;                      // 最大的场景槽位序号
+
+    int currentEntry;         // 当前条目（-1表示尚未显示任何条目）
+    unsigned long entryStart; // 当前条目开始显示的时间
+    uint8_t *staging;         // 预备缓冲区（取自playlistBuffer）
+    int stagedEntry;          // 预备缓冲区中的条目（-1表示没有）
+    uint32_t stagedLength;    // 预备场景的负载长度
+    bool prepareNeeded;       // 下一轮poll时预备下一项
+
+    bool transitioning;            // 正在过渡
+    unsigned long transitionStart; // 过渡开始时间
+    int transitionDrawn;           // 已推送的列数（左右擦除）或行数（上下擦除）
+    const uint8_t *incomingFrame;  // 新场景的首帧（位于预备缓冲区）
+    uint32_t switchCount;          // 本次启动以来的切换次数
+
+    uint32_t getSceneBase(int scene) const;
+    bool writeTable();
+    bool prepare(int entry);   // 把条目的场景读入预备缓冲区并校验
+    void discardStaged();      // 预备的内容失效（场景被覆盖、删除或列表改变）
+    int findNextEntry() const; // 下一个场景可用的条目（没有返回-1）
+    void beginSwitch(int entry);
+    void finishSwitch();
+    void drawTransition(unsigned long now);
+
+public:
+    Playlist();
+
+    bool begin(const char *label = PLAYLIST_PARTITION); // 打开分区，读取列表与各场景槽位头
+    bool isAvailable() const { return store.isOpen(); }
+    bool isRunning() const { return running; }
+    bool isTransitioning() const { return transitioning; } // 过渡期间文本渲染让出屏幕
+
+    uint8_t storeScene(uint8_t scene, uint32_t &length); // 把当前场景保存到场景槽位，返回状态
+    uint8_t deleteScene(uint8_t scene);
+    uint8_t setEntries(const PlaylistEntry *list, uint8_t count);
+    uint8_t start(bool persist = true); // 从第一项开始轮播，persist为true时运行状态写入Flash
+    void stop();                        // 停止轮播，停留在当前场景
+    bool resume();                      // 启动时调用：列表上次处于运行状态则立即显示第一项
+    void poll();                        // loop中调用：到时切换、推进过渡、预备下一项
+
+    uint8_t getEntryCount() const { return entryCount; }
+    int getCurrentEntry() const { return currentEntry; }
+    uint8_t getSceneMask() const; // 已保存场景的位掩码
+    uint32_t getSwitchCount() const { return switchCount; }
+};
+
+extern Playlist playlist;
+
+void handlePlaylistCommand(const BluetoothFrame &frame); // 处理播放列表命令 (0x17)
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef PRIORITY_H
+#define PRIORITY_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "LEDController.h"
+#include "TextStream.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 优先插播（场景栈） ====================
+// 紧急通知、叫号等插播不再覆盖掉原场景：插播命令先把当前场景压入栈，
+// 随后的文本、颜色、特效命令（通常与插播命令放在同一个批量帧中）只改变插播内容；
+// 到时或撤销后弹出，原场景连同滚动偏移、分页位置、闪烁/呼吸相位原样恢复。
+// 入栈时保存：显示/颜色/特效/亮度状态、字体、流式播放状态、各区域文本的字形序号（持有字形引用，
+// 不复制点阵），以及一帧屏幕镜像；出栈时把镜像直接推回屏幕，不重新排版渲染。
+// 插播期间动画、实时流的呈现与播放列表切换暂停，场景快照不保存插播内容。
+struct SceneStackEntry
+{
+    TextDisplayState text;      // 显示状态（分页位置、切换时刻等）
+    ColorState color;           // 颜色状态
+    EffectState effect;         // 特效状态（滚动偏移、闪烁与呼吸相位）
+    BrightnessState brightness; // 亮度
+    uint8_t fontSize;           // 字体大小
+    StreamPlayback stream;      // 流式文本播放状态
+    RegionSnapshot regions[3];  // 上/下半屏、全屏文本的字形序号（取自priorityArena）
+    uint16_t *frame;            // 屏幕镜像（未开启SCENE_FIRST_FRAME时为nullptr）
+    size_t arenaMark;           // 入栈前priorityArena的分配位置
+    uint8_t priority;           // 覆盖在该场景之上的插播的优先级
+    unsigned long pushedAt;     // 入栈时刻
+    unsigned long duration;     // 插播时长（毫秒，0表示直到撤销）
+};
+
+bool isPriorityActive();                                 // 是否正在显示插播（全屏模式据此让出屏幕）
+uint8_t getPriorityDepth();                              // 场景栈当前层数
+void discardPriorityScenes(uint8_t depth);               // 丢弃该层数以上的场景（不恢复，批量命令回滚时使用）
+void updatePriority();                                   // loop中调用：插播到时后恢复原场景
+void handlePriorityCommand(const BluetoothFrame &frame); // 处理优先插播命令 (0x1A)
+
+#endif
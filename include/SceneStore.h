@@ -0,0 +1,85 @@
+#ifndef SCENESTORE_H
+#define SCENESTORE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "PartitionStore.h"
+
+// ==================== 场景快照（Flash） ====================
+// 把已生效的场景（文本、颜色、特效、亮度、字体、方向）保存到scene分区，重启后在setup()最前面恢复，
+// 不必等客户端重连重新下发；开启SCENE_FIRST_FRAME时还附带一帧预渲染画面，显示硬件初始化后立即推送。
+// 分区按SCENE_SLOT_SIZE划分为若干槽位，每次保存写入下一个槽位（轮流使用，分摊擦写次数），
+// 只擦除本次实际用到的扇区；负载先写、槽位头最后写，掉电不会留下半截的有效快照。
+// 槽位头（整数均为小端）：
+//   [魔数"LSCN" 4][版本 2][保留 2][序号 4][负载长度 4][负载哈希 4]
+// 负载由若干段组成，每段 [段类型 1][保留 1][段长度 2][段数据...]，未知段类型跳过：
+//   0x01 显示设置  [字体大小][显示方向][亮度][流式文本播放中][流式文本区域][保留 3]
+//   0x02 颜色      上半屏、下半屏、全屏各13字节：[文本色2][背景色2][文本模式][背景模式][文本RGB 3][背景RGB 3][渐变模式]
+//   0x03 特效      上半屏、下半屏各7字节：[滚动开关][滚动类型][滚动速度][闪烁开关][闪烁速度][呼吸开关][呼吸速度]
+//   0x04 首帧      SCREEN_WIDTH×SCREEN_HEIGHT个RGB565像素，逐行排列
+//   0x10 16x16字形 [字形数 2][点阵...]，上下半屏文本用到的不同字形
+//   0x11 32x32字形 [字形数 2][点阵...]，全屏文本用到的不同字形
+//   0x20/0x21/0x22 上半屏/下半屏/全屏文本 [字符数 2][字形序号 2×字符数]，字符数为0表示显示内置示例
+// 槽位的读写与负载的应用为独立函数，播放列表（Playlist.h）以同一格式保存多个场景。
+// 场景变化后保持SCENE_SAVE_QUIET_MS不变才保存，且两次保存至少间隔SCENE_SAVE_MIN_INTERVAL_MS，
+// 场景与上次保存的相同时不写入。
+
+// 快照负载：位于分区中（store+base）或已读入RAM（data），length为负载长度
+struct ScenePayload
+{
+    const PartitionStore *store;
+    uint32_t base;
+    const uint8_t *data;
+    uint32_t length;
+
+    bool read(uint32_t offset, void *buffer, size_t size) const; // 读取负载内offset处的数据
+};
+
+// 读取并检查位于base、大小为slotSize的槽位头
+bool readSceneSlotHeader(const PartitionStore &store, uint32_t base, uint32_t slotSize,
+                         uint32_t &sequence, uint32_t &length, uint32_t &hash);
+// 校验槽位负载哈希
+bool verifySceneSlot(const PartitionStore &store, uint32_t base, uint32_t length, uint32_t hash);
+// 把当前场景写入槽位，成功时length为负载长度
+bool writeSceneSlot(PartitionStore &store, uint32_t base, uint32_t slotSize, uint32_t sequence, uint32_t &length);
+// 应用快照负载；drawFrame为false时不推送首帧（由调用者自行显示）
+bool applyScenePayload(const ScenePayload &payload, bool drawFrame);
+// RAM中负载的首帧像素（小端RGB565，逐行排列），没有首帧段时返回空
+const uint8_t *findSceneFrame(const uint8_t *payload, uint32_t length);
+
+class SceneStore
+{
+private:
+    PartitionStore store;
+    int latestSlot;              // 最新有效快照所在槽位（-1表示没有）
+    uint32_t latestSequence;     // 最新有效快照序号
+    uint32_t latestLength;       // 最新有效快照负载长度
+    uint32_t savedHash;          // 已保存（或已恢复）场景的哈希
+    uint32_t observedHash;       // 最近一次检查到的场景哈希
+    unsigned long lastCheckTime; // 上次检查时间
+    unsigned long changeTime;    // 场景最近一次变化的时间
+    unsigned long lastSaveTime;  // 上次尝试保存的时间
+    uint32_t saveCount;          // 本次启动以来保存成功的次数
+    uint32_t failureCount;       // 本次启动以来保存失败的次数
+
+    uint32_t getSlotCount() const;
+    uint32_t computeSnapshotHash() const; // 场景哈希（同步项加流式文本播放状态）
+
+public:
+    SceneStore();
+
+    bool begin(const char *label = SCENE_PARTITION); // 打开分区并查找最新的有效快照
+    bool isAvailable() const { return store.isOpen(); }
+    bool hasSnapshot() const { return latestSlot >= 0; }
+    uint32_t getSequence() const { return latestSequence; }
+    uint32_t getSaveCount() const { return saveCount; }
+
+    bool restore();       // 应用最新快照并推送首帧，没有快照或快照无效时返回false
+    void resetBaseline(); // 以当前场景为基准，之后有变化才保存（setup结束时调用）
+    bool save();          // 立即把当前场景写入下一个槽位
+    void poll();          // loop中调用：场景稳定后按节流规则保存
+};
+
+extern SceneStore sceneStore;
+
+#endif
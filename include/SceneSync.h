@@ -0,0 +1,28 @@
+#ifndef SCENESYNC_H
+#define SCENESYNC_H
+
+#include "Platform.h"
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 场景哈希同步 ====================
+// 客户端重连后查询各区域文本与各属性的哈希，只上传与期望场景不同的部分。
+// 哈希为FNV-1a 32位，按与协议相同的字节序列计算（文本即点阵字节，高字节在前），
+// 客户端可自行计算期望场景的哈希，也可在上传后查询一次并保存以便下次比较。
+
+// FNV-1a 32位（可链式累加）；文本存储、场景快照也用它校验，定义在头文件中，不必链接场景同步的其余部分
+inline uint32_t fnv1aHash(const uint8_t *data, size_t length, uint32_t hash = 0x811C9DC5)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= data[i];
+        hash *= 0x01000193; // FNV质数
+    }
+    return hash;
+}
+
+uint32_t computeSceneItemHash(uint8_t item, bool &valid); // 计算单个同步项的哈希
+uint32_t computeSceneHash();                              // 全部同步项的整体哈希（按同步项顺序链式累加）
+void handleSceneSyncCommand(const BluetoothFrame &frame); // 处理场景同步查询命令 (0x11)
+
+#endif
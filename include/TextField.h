@@ -0,0 +1,51 @@
+#ifndef TEXTFIELD_H
+#define TEXTFIELD_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 模板字段 ====================
+// 计数、价格、叫号、温度这类频繁变化的小数值不必每次重新栅格化并上传整段文本：
+// 先用文本命令设置模板（固定文字加占位字符），再把其中定宽的一段定义为字段。
+// 字段值只需几个字节的UTF-8，设备按字符集把每个字符映射为字形，只替换与屏上不同的字符格，
+// 模板其余部分不移动也不重绘。字符集的字形写入去重字形表并持有引用，不会被淘汰。
+struct FieldGlyphSet
+{
+    bool defined;                             // 已定义
+    bool is32;                                // 字形尺寸（定义时的字体）
+    uint8_t count;                            // 字符数
+    uint16_t codepoints[FIELD_SET_MAX_CHARS]; // 各字符的码位
+    uint16_t glyphs[FIELD_SET_MAX_CHARS];     // 各字符的字形在字形表中的序号（持有引用）
+};
+
+struct TextField
+{
+    bool defined;        // 已定义
+    bool is32;           // 定义时的字体（32x32时位于全屏区域）
+    uint8_t screenArea;  // 屏幕区域（16x16为上/下半屏）
+    uint8_t width;       // 宽度（字符数）
+    uint8_t align;       // 对齐方式（BT_FIELD_ALIGN_*）
+    uint8_t set;         // 字符集号
+    uint16_t start;      // 在区域文本中的起始位置
+    uint16_t padChar;    // 填充字符的码位（须在字符集中）
+    uint32_t updates;    // 值更新次数
+    uint32_t cellWrites; // 累计替换的字符格数
+};
+
+// 字符集与字段的副本（批量命令回滚时使用），字符集的字形引用随副本持有
+struct TextFieldState
+{
+    FieldGlyphSet sets[FIELD_MAX_SETS];
+    TextField fields[FIELD_MAX_FIELDS];
+};
+
+extern FieldGlyphSet fieldSets[FIELD_MAX_SETS];
+extern TextField textFields[FIELD_MAX_FIELDS];
+
+void saveTextFields(TextFieldState &state);               // 复制字符集与字段，字符集字形增加引用
+void restoreTextFields(TextFieldState &state);            // 换回保存的字符集与字段（引用随之转回）
+void releaseTextFields(TextFieldState &state);            // 放弃副本并释放其引用
+void handleTextFieldCommand(const BluetoothFrame &frame); // 处理模板字段命令 (0x19)
+
+#endif
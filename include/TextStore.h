@@ -0,0 +1,120 @@
+#ifndef TEXTSTORE_H
+#define TEXTSTORE_H
+
+#include "Platform.h"
+#include "config.h"
+#include "MemoryPool.h"
+
+// ==================== 去重文本存储 ====================
+// 区域文本不再逐字保存点阵，而是拆成两部分：
+//   字形表 —— 每个不同的字形只存一份，写入时按内容哈希查重，带引用计数；
+//   序号序列 —— 每个区域按字符顺序保存字形在表中的序号（2字节/字符）。
+// 中文文本重复字多，同样的内存能放下更长的文本，渲染时访问的点阵也更集中。
+// 上下半屏共用16x16字形表，全屏（32x32）使用32x32字形表。
+
+// 字形文本视图：按字符序号取点阵，渲染与存储接口统一使用
+struct GlyphText
+{
+    const uint16_t *glyphs;  // 字形表，或按字符顺序排列的连续点阵
+    const uint16_t *indices; // 每个字符在字形表中的序号，nullptr表示glyphs为连续点阵
+    int count;               // 字符数
+    int wordsPerGlyph;       // 每个字形占用的uint16_t数量（16x16为16，32x32为64）
+
+    GlyphText() : glyphs(nullptr), indices(nullptr), count(0), wordsPerGlyph(16) {}
+    GlyphText(const uint16_t *data, int count, int wordsPerGlyph)
+        : glyphs(data), indices(nullptr), count(data ? count : 0), wordsPerGlyph(wordsPerGlyph) {}
+    GlyphText(const uint16_t *table, const uint16_t *indices, int count, int wordsPerGlyph)
+        : glyphs(table), indices(indices), count(count), wordsPerGlyph(wordsPerGlyph) {}
+
+    const uint16_t *at(int i) const { return glyphs + (indices ? indices[i] : i) * wordsPerGlyph; }
+    GlyphText slice(int start, int length) const
+    {
+        return indices ? GlyphText(glyphs, indices + start, length, wordsPerGlyph)
+                       : GlyphText(glyphs + start * wordsPerGlyph, length, wordsPerGlyph);
+    }
+};
+
+// 内容寻址的字形表：相同点阵只存一份，引用归零即回收
+class GlyphTable
+{
+private:
+    const char *name;
+    uint16_t *glyphData;                  // 点阵数据（capacity × wordsPerGlyph 个uint16_t）
+    uint32_t *hashes;                     // 每个槽位点阵的哈希
+    uint16_t *refCounts;                  // 每个槽位的引用数（0表示空槽）
+    int16_t *nextSlot;                    // 同一哈希桶的下一个槽位；空槽时为空闲链表的下一个
+    int16_t buckets[GLYPH_TABLE_BUCKETS]; // 哈希桶链表头（-1表示空）
+    int16_t freeHead;                     // 空闲链表头
+    uint16_t capacity;                    // 槽位数量
+    uint16_t wordsPerGlyph;               // 每个字形占用的uint16_t数量
+    uint16_t usedCount;                   // 已占用槽位数
+    uint16_t highWater;                   // 已占用槽位数的历史最大值
+    uint32_t failureCount;                // 表满导致的写入失败次数
+    uint32_t internCount;                 // 累计写入字符数
+    uint32_t sharedCount;                 // 其中命中已有字形的次数
+
+    uint32_t hashGlyph(const uint16_t *glyph) const;
+
+public:
+    GlyphTable(const char *name, uint16_t capacity, uint16_t wordsPerGlyph); // 存储取自启动期分配区
+
+    int intern(const uint16_t *glyph); // 查找或写入字形并增加引用，返回序号，表满返回-1
+    void retain(uint16_t index);       // 为已占用的槽位增加引用（复制序号时使用）
+    void release(uint16_t index);      // 减少引用，归零时回收槽位
+    void clear();
+
+    const uint16_t *getGlyphData() const { return glyphData; }
+    const char *getName() const { return name; }
+    uint16_t getCapacity() const { return capacity; }
+    uint16_t getUsedCount() const { return usedCount; }
+    uint16_t getHighWater() const { return highWater; }
+    uint16_t getWordsPerGlyph() const { return wordsPerGlyph; }
+    uint32_t getFailureCount() const { return failureCount; }
+    uint32_t getInternCount() const { return internCount; }
+    uint32_t getSharedCount() const { return sharedCount; }
+};
+
+// 区域文本：字形表序号序列，存放在区域的定长缓冲区中
+struct RegionText
+{
+    GlyphTable *table;        // 所用字形表
+    FixedBuffer *indexBuffer; // 序号缓冲区
+    uint16_t *indices;        // 字形序号（指向indexBuffer，无内容时为nullptr）
+    int charCount;            // 字符数
+    uint32_t revision;        // 修改计数（每次改动递增，预渲染的内容据此判断是否过期）
+    bool hasText;             // 已设置过文本：为false时渲染内置示例数据，上传的文本为空（如全部删除）时仍为true、显示空白
+};
+
+// 区域文本快照：复制字形序号并持有字形引用，不复制点阵（优先插播的场景栈与批量命令的回滚共用）
+struct RegionSnapshot
+{
+    uint16_t *indices; // 字形序号（取自保存时给出的分配区，无内容时为nullptr）
+    int count;         // 字符数
+    bool hasText;      // 保存时区域是否已设置过文本
+};
+
+// ==================== 全局实例 ====================
+extern GlyphTable glyphTable16;    // 16x16字形表（上下半屏共用）
+extern GlyphTable glyphTable32;    // 32x32字形表（全屏）
+extern RegionText upperRegionText; // 上半屏文本
+extern RegionText lowerRegionText; // 下半屏文本
+extern RegionText fullRegionText;  // 全屏（32x32）文本
+
+// ==================== 区域文本操作 ====================
+// text不能引用目标区域自身的字形（写入前会先释放原内容）
+int setRegionText(RegionText &region, const GlyphText &text);                   // 整体替换，超出容量时截断，返回存储的字符数
+void clearRegionText(RegionText &region);                                       // 清空并释放字形引用，区域显示空白
+void resetRegionText(RegionText &region);                                       // 清空并回到未设置状态（渲染内置示例数据）
+GlyphText getRegionGlyphs(const RegionText &region);                            // 区域文本视图（经序号解析字形）
+bool replaceRegionGlyphs(RegionText &region, int start, const GlyphText &text); // 替换从start起的text.count个字符
+bool insertRegionGlyphs(RegionText &region, int start, const GlyphText &text);  // 在start处插入
+void deleteRegionGlyphs(RegionText &region, int start, int count);              // 删除从start起的count个字符
+void reportTextStoreUsage();                                                    // 输出字形表用量与去重效果
+int getTextRegionCapacity(uint8_t screenArea, uint8_t fontSize);                // 屏幕区域在指定字体下可容纳的字符数
+
+// ==================== 区域文本快照 ====================
+bool saveRegionText(const RegionText &region, StaticArena &arena, RegionSnapshot &snapshot); // 保存序号并增加引用，分配区不足返回false
+void restoreRegionText(RegionText &region, RegionSnapshot &snapshot);                        // 区域换回快照内容（引用随之转回），快照随后为空
+void releaseRegionSnapshot(const RegionText &region, RegionSnapshot &snapshot);              // 放弃快照并释放其引用
+
+#endif
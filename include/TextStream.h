@@ -0,0 +1,25 @@
+#ifndef TEXTSTREAM_H
+#define TEXTSTREAM_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "GlyphStream.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 流式文本播放 ====================
+// 流分区中的文本（见GlyphStream.h）以滚动方式显示在一个区域，由流式文本命令上传与控制。
+
+// 播放状态：同一时间只有一个区域播放流式文本
+struct StreamPlayback
+{
+    bool active;        // 是否在播放
+    uint8_t screenArea; // 播放区域（16x16为上/下半屏，32x32为全屏）
+};
+
+extern GlyphStream textStream;
+extern StreamPlayback streamPlayback;
+
+bool isRegionStreaming(bool isUpper);                      // 该区域当前是否显示流式文本（32x32时isUpper为true表示全屏）
+void handleStreamTextCommand(const BluetoothFrame &frame); // 处理流式文本命令 (0x13)
+
+#endif
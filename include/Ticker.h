@@ -0,0 +1,38 @@
+#ifndef TICKER_H
+#define TICKER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "TextStore.h"
+#include "bluetooth_protocol.h"
+
+// ==================== 滚动队列（跑马灯） ====================
+// 普通滚动每轮从右侧完全滚入、再完全滚出后才从头开始，中间整屏空白；换文本也会从头滚动。
+// 滚动队列把区域文本当作一条首尾相接的消息带：[消息0][分隔符][消息1][分隔符]...
+//   追加 —— 新消息连同分隔符接在带尾，正在滚动的内容不动；
+//   移出 —— 队首消息连同分隔符完全滚出左边后从区域文本中删除，滚动偏移同步减去其宽度，画面不跳动；
+//   补位 —— 带尾进入屏幕而没有新消息时，把队首消息复制一份接在带尾，已有内容循环播放而不留空白。
+// 只支持左滚动；区域文本被其他文本命令改写或字体切换后队列失效，按普通文本显示。
+struct TickerQueue
+{
+    bool active;                              // 已开始（START之后、STOP之前）
+    bool is32;                                // 开始时的字体（32x32时使用全屏区域）
+    uint8_t count;                            // 队列中的消息数
+    uint8_t separatorCount;                   // 分隔符字符数
+    uint16_t lengths[TICKER_MAX_MESSAGES];    // 各消息字符数（不含分隔符）
+    uint16_t separator[TICKER_MAX_SEPARATOR]; // 分隔符字形在字形表中的序号（持有引用）
+    uint32_t appended;                        // 累计追加的消息数
+    uint32_t evicted;                         // 累计滚出移除的消息数
+    uint32_t repeated;                        // 累计循环补位的消息数
+    bool fillFailed;                          // 补位因容量不足失败（只记录一次日志）
+};
+
+extern TickerQueue upperTicker; // 上半屏队列（32x32时为全屏队列）
+extern TickerQueue lowerTicker; // 下半屏队列
+
+bool isTickerRunning(bool isUpper);                    // 该区域是否按滚动队列显示（32x32时isUpper为true表示全屏）
+GlyphText getTickerText(bool isUpper);                 // 队列的消息带（队列为空时字符数为0，不显示内置示例）
+int advanceTicker(bool isUpper, int offset);           // 滚动偏移前进后调用：移出、补位，返回调整后的偏移
+void handleTickerCommand(const BluetoothFrame &frame); // 处理滚动队列命令 (0x18)
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "BluetoothSerial.h"
+#endif
+
+// ==================== 命令输入通道 ====================
+// 帧数据可以来自蓝牙SPP、有线高速串口，或主机上的TCP回环（未定义ARDUINO时），
+// 每个输入实现同一接口，由CommandChannel各自配一个解析器，送入同一命令分发流程。
+class Transport
+{
+public:
+    virtual ~Transport() {}
+
+    virtual const char *getName() const = 0;                 // 通道名（日志用）
+    virtual bool begin() = 0;                                // 初始化
+    virtual int available() = 0;                             // 可读字节数
+    virtual int read() = 0;                                  // 读取一个字节（无数据返回-1）
+    virtual size_t write(const uint8_t *data, size_t length) = 0; // 写出应答
+};
+
+#ifdef ARDUINO
+// 蓝牙SPP
+class SppTransport : public Transport
+{
+private:
+    BluetoothSerial &serial;
+    const String &deviceName;
+
+public:
+    SppTransport(BluetoothSerial &serial, const String &deviceName) : serial(serial), deviceName(deviceName) {}
+
+    const char *getName() const override { return "SPP"; }
+    bool begin() override;
+    int available() override { return serial.available(); }
+    int read() override { return serial.read(); }
+    size_t write(const uint8_t *data, size_t length) override { return serial.write(data, length); }
+};
+
+// 有线串口（安装人员批量下载内容用，远快于SPP）
+class UartTransport : public Transport
+{
+private:
+    HardwareSerial &serial;
+    uint32_t baudRate;
+    int8_t rxPin;
+    int8_t txPin;
+
+public:
+    UartTransport(HardwareSerial &serial, uint32_t baudRate, int8_t rxPin, int8_t txPin)
+        : serial(serial), baudRate(baudRate), rxPin(rxPin), txPin(txPin) {}
+
+    const char *getName() const override { return "UART"; }
+    bool begin() override;
+    int available() override { return serial.available(); }
+    int read() override { return serial.read(); }
+    size_t write(const uint8_t *data, size_t length) override { return serial.write(data, length); }
+};
+#else
+// 主机TCP回环：监听127.0.0.1上的端口，接受一个客户端，用于在PC上以全速驱动真实的解析器与处理函数
+class TcpLoopbackTransport : public Transport
+{
+private:
+    uint16_t port;
+    int listenFd;
+    int clientFd;
+    uint8_t readBuffer[256];
+    size_t readPos;
+    size_t readLength;
+
+    void closeClient();
+
+public:
+    explicit TcpLoopbackTransport(uint16_t port);
+    ~TcpLoopbackTransport();
+
+    const char *getName() const override { return "TCP"; }
+    bool begin() override;
+    int available() override;
+    int read() override;
+    size_t write(const uint8_t *data, size_t length) override;
+};
+#endif
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef BLUETOOTH_PROTOCOL_H
 #define BLUETOOTH_PROTOCOL_H
 
-#include "Arduino.h"
+#include "Platform.h"
 #include "config.h"
 
 enum class ParseState
@@ -23,7 +23,8 @@ enum class ParseResult
     FRAME_COMPLETE,
     FRAME_ERROR,
     INVALID_COMMAND,
-    DATA_TOO_LONG
+    DATA_TOO_LONG,
+    INVALID_LENGTH // 数据长度不在该命令允许范围内
 };
 
 struct BluetoothFrame
@@ -33,21 +34,15 @@ struct BluetoothFrame
     uint8_t *data;
     bool isValid;
     uint32_t timestamp;              // 接收时间戳
-    mutable uint16_t *convertedData; // 缓存转换后的16位数据
+    mutable uint16_t *convertedData; // 缓存转换后的16位数据（来自临时分配区，命令处理结束即失效）
     mutable bool isConverted;        // 转换标志
 
     BluetoothFrame() : command(0), dataLength(0), data(nullptr), isValid(false), timestamp(0), convertedData(nullptr), isConverted(false) {}
-    ~BluetoothFrame()
-    {
-        if (convertedData)
-        {
-            delete[] convertedData;
-            convertedData = nullptr;
-        }
-    }
 
     // 数据解析辅助方法
+#ifdef ARDUINO
     String getTextData() const;
+#endif
     void getColorData(uint8_t &screenArea, uint8_t &target, uint8_t &mode, uint8_t &r, uint8_t &g, uint8_t &b, uint8_t &gradientMode) const;
     uint8_t getBrightnessData() const;
     void getEffectData(uint8_t &screenArea, uint8_t &type, uint8_t &speed) const;
@@ -57,35 +52,69 @@ struct BluetoothFrame
     const uint16_t *getFontData32x32(uint8_t &screenArea, int &charCount) const;
 };
 
+// 解析器保存当前帧从帧头起的全部原始字节。出错时不再整体丢弃，而是从帧头后一字节起
+// 查找下一个可能的帧头(0xAA)，把其后的字节作为待重放数据重新解析，
+// 这样一个损坏的长度字节只会损失一帧，不会吞掉后面的若干正常帧。
 class BluetoothProtocolParser
 {
 private:
+    static const uint16_t MAX_DATA_LENGTH = 8192;
+    static const uint16_t FRAME_OVERHEAD = 7;      // 帧头2 + 命令1 + 长度2 + 帧尾2
+    static const uint32_t FRAME_TIMEOUT_MS = 5000; // 帧超时时间
+    static const int STATE_COUNT = (int)ParseState::FRAME_COMPLETE + 1;
+
     ParseState currentState;
     uint8_t command;
     uint16_t dataLength;
     uint16_t dataReceived;
-    uint8_t *dataBuffer;
-    uint32_t frameStartTime;      // 帧开始时间
-    uint32_t errorCount;          // 错误计数
-    uint16_t timeoutCheckCounter; // 超时检查计数器
-    static const uint16_t MAX_DATA_LENGTH = 8192;
-    static const uint32_t FRAME_TIMEOUT_MS = 5000; // 帧超时时间
+    uint16_t rawLength;                    // 当前帧已保存的原始字节数
+    uint16_t replayPos;                    // 待重放数据读位置（始终不小于rawLength，原地重放不会覆盖未读字节）
+    uint16_t replayEnd;                    // 待重放数据结束位置
+    uint32_t frameStartTime;               // 帧开始时间
+    uint32_t stateErrorCount[STATE_COUNT]; // 按出错时所处状态分类的错误计数
+    uint16_t timeoutCheckCounter;          // 超时检查计数器
+
+    // 当前帧原始字节（数据区从偏移5开始），由构造时传入；只有处于帧中或有待重放字节时才占用，
+    // 因此多个解析器可共用一个缓冲区，由调用方保证同一时刻只有一个不空闲（见CommandChannel）
+    uint8_t *frameBuffer;
+
+    ParseResult consumeByte(uint8_t byte, BluetoothFrame &frame); // 状态机处理一个字节
+    void recordError();                                           // 按当前状态记录错误
+    void resync();                                                // 出错后查找下一个帧头并安排重放
 
 public:
-    BluetoothProtocolParser();
-    ~BluetoothProtocolParser();
+    static const uint16_t FRAME_BUFFER_SIZE = MAX_DATA_LENGTH + FRAME_OVERHEAD; // 帧缓冲区所需字节数
+
+    explicit BluetoothProtocolParser(uint8_t *frameBuffer); // frameBuffer至少FRAME_BUFFER_SIZE字节
 
     ParseResult parseByte(uint8_t byte, BluetoothFrame &frame);
+    ParseResult parsePending(BluetoothFrame &frame);              // 解析一个待重放字节
+    bool hasPendingData() const { return replayPos < replayEnd; } // 有待重放字节时应先于新字节处理
+    bool isIdle() const;                                          // 不在帧中且没有待重放字节（不占用帧缓冲区）
+    bool abandonIfTimedOut();                                     // 当前帧超时则放弃并安排重放，返回是否放弃
     ParseResult parseBuffer(uint8_t *buffer, size_t length, BluetoothFrame frames[], size_t maxFrames, size_t &frameCount);
     void reset();
     bool isFrameComplete() const;
     bool isFrameTimeout() const;
-    uint32_t getErrorCount() const { return errorCount; }
+    uint32_t getErrorCount() const; // 各状态错误总数
+    uint32_t getErrorCount(ParseState state) const { return stateErrorCount[(int)state]; }
     ParseState getCurrentState() const { return currentState; }
 
     // 调试功能
+#ifdef ARDUINO
     String getStateString() const;
+#endif
+    static const char *getStateName(ParseState state); // 状态名（常量字符串，可用于延迟日志）
     void printDebugInfo() const;
 };
 
+// ==================== 应答帧发送（设备→客户端） ====================
+// 应答帧格式与请求帧相同：AA 55 [命令|0x80] [长度高] [长度低] [数据...] 0D 0A
+typedef void (*ResponseWriter)(const uint8_t *data, size_t length);
+void setResponseWriter(ResponseWriter writer);                              // 设置应答输出通道
+void sendResponseFrame(uint8_t command, const uint8_t *data, uint16_t length); // 发送应答帧
+
+// ==================== 命令分发（CommandRegistry.cpp实现） ====================
+void processBluetoothCommand(const BluetoothFrame &frame); // 按命令码分发完整帧
+
 #endif // BLUETOOTH_PROTOCOL_H
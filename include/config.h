@@ -20,10 +20,68 @@
 #define BT_CMD_SET_FONT_16x16 0x02 // 设置16x16字体命令
 #define BT_CMD_SET_FONT_32x32 0x03 // 设置32x32字体命令
 #define BT_CMD_SET_TEXT 0x04       // 设置文本命令
-#define BT_CMD_SET_ANIMATION 0x05  // 设置动画命令
+#define BT_CMD_SET_ANIMATION 0x05  // 设置动画命令（关键帧+增量帧序列，设备端循环播放）
 #define BT_CMD_SET_COLOR 0x06      // 设置颜色命令
 #define BT_CMD_SET_BRIGHTNESS 0x07 // 设置亮度命令
 #define BT_CMD_SET_EFFECT 0x08     // 设置特效命令
+#define BT_CMD_DEFINE_GLYPH 0x09   // 定义字形命令（写入设备端字形缓存）
+#define BT_CMD_SET_TEXT_BY_ID 0x0A // 按字形ID设置文本命令
+#define BT_CMD_SET_TEXT_UTF8 0x0B  // UTF-8文本命令（设备端字库排版）
+#define BT_CMD_TRANSFER 0x0C       // 分块传输命令（超过单帧上限的数据，支持断点续传）
+#define BT_CMD_TEXT_RANGE 0x0D     // 局部文本更新命令（替换/插入/删除字符）
+#define BT_CMD_BATCH 0x0E          // 批量命令（多条子命令整体校验、一次性应用并只渲染一次）
+#define BT_CMD_FLOW_CONTROL 0x0F   // 流量控制命令（开启/关闭基于额度的发送窗口）
+#define BT_CMD_CAPABILITIES 0x10   // 能力查询命令（协议版本、扩展特性与已注册命令）
+#define BT_CMD_SCENE_SYNC 0x11     // 场景同步查询命令（返回各区域、各属性的内容哈希）
+#define BT_CMD_MEMORY_STATS 0x12   // 内存统计查询命令（各静态内存池容量与高水位）
+#define BT_CMD_STREAM_TEXT 0x13    // 流式文本命令（上传到Flash流分区并滚动播放，长度不受RAM限制）
+#define BT_CMD_BOOT_TIMELINE 0x14  // 启动时间线查询命令（各初始化阶段完成时刻）
+#define BT_CMD_IMAGE 0x15          // 图像命令（全屏RGB565/调色板图像，RLE压缩的XOR增量更新）
+#define BT_CMD_LIVE 0x16           // 实时流命令（主机连续发送带帧号的关键帧/增量帧，设备按自身节奏呈现）
+#define BT_CMD_PLAYLIST 0x17       // 播放列表命令（保存多个场景，按列表设备端独立轮播）
+#define BT_CMD_TICKER 0x18         // 滚动队列命令（按区域追加消息，首尾相接连续滚动）
+#define BT_CMD_TEXT_FIELD 0x19     // 模板字段命令（文本中的定宽字段按值更新，只重绘变化的字符格）
+#define BT_CMD_PRIORITY 0x1A       // 优先插播命令（保存当前场景入栈，插播结束后原样恢复）
+#define BT_CMD_PAGING 0x1B         // 分页设置命令（每组字符数、停留时间与翻页过渡方式）
+#define BT_CMD_LAST BT_CMD_PAGING  // 命令码上限（命令注册表索引范围）
+#define BT_RESPONSE_FLAG 0x80      // 应答帧标志（设备→客户端，命令码|0x80）
+
+/* ------------------------------------------------------------------------
+ * 命令注册表与能力协商
+ * ------------------------------------------------------------------------ */
+#define BT_PROTOCOL_VERSION 1          // 协议版本
+#define BT_CMD_LEN_UNLIMITED 0xFFFF    // 数据长度不设上限（仍受单帧/分块传输上限约束）
+#define BT_FEATURE_GLYPH_CACHE 0x0001  // 字形缓存与按ID设置文本 (0x09/0x0A)
+#define BT_FEATURE_FONT_PACK 0x0002    // 设备端字库UTF-8文本 (0x0B)，仅字库已加载时通告
+#define BT_FEATURE_TRANSFER 0x0004     // 分块传输 (0x0C)
+#define BT_FEATURE_TEXT_RANGE 0x0008   // 局部文本更新 (0x0D)
+#define BT_FEATURE_BATCH 0x0010        // 批量命令 (0x0E)
+#define BT_FEATURE_FLOW_CONTROL 0x0020 // 流量控制 (0x0F)
+#define BT_FEATURE_SCENE_SYNC 0x0040   // 场景哈希同步 (0x11)
+#define BT_FEATURE_MEMORY_STATS 0x0080 // 内存统计查询 (0x12)
+#define BT_FEATURE_STREAM_TEXT 0x0100  // 流式文本 (0x13)，仅流分区存在时通告
+#define BT_FEATURE_BOOT_TIMELINE 0x0200 // 启动时间线查询 (0x14)
+#define BT_FEATURE_ANIMATION 0x0400     // 关键帧+增量帧动画 (0x05)
+#define BT_FEATURE_IMAGE 0x0800         // 全屏彩色图像与XOR增量 (0x15)
+#define BT_FEATURE_LIVE 0x1000          // 实时流 (0x16)
+#define BT_FEATURE_PLAYLIST 0x2000      // 场景播放列表 (0x17)，仅playlist分区存在时通告
+#define BT_FEATURE_TICKER 0x4000        // 滚动队列 (0x18)
+#define BT_FEATURE_TEXT_FIELD 0x8000    // 模板字段 (0x19)
+#define BT_FEATURE_PRIORITY 0x10000     // 优先插播 (0x1A)
+#define BT_FEATURE_PAGING 0x20000       // 分页设置与翻页过渡 (0x1B)
+
+/* ------------------------------------------------------------------------
+ * 场景同步项（哈希算法FNV-1a 32位，各项序列化格式见蓝牙场景同步帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define SCENE_ITEM_UPPER_TEXT 0x01   // 上半屏文本点阵
+#define SCENE_ITEM_LOWER_TEXT 0x02   // 下半屏文本点阵
+#define SCENE_ITEM_FULL_TEXT 0x03    // 全屏（32x32）文本点阵
+#define SCENE_ITEM_UPPER_COLOR 0x11  // 上半屏颜色
+#define SCENE_ITEM_LOWER_COLOR 0x12  // 下半屏颜色
+#define SCENE_ITEM_UPPER_EFFECT 0x21 // 上半屏特效
+#define SCENE_ITEM_LOWER_EFFECT 0x22 // 下半屏特效
+#define SCENE_ITEM_DISPLAY 0x30      // 显示设置（字体、方向、亮度）
+#define SCENE_ITEM_COUNT 8           // 同步项数量
 
 /* ------------------------------------------------------------------------
  * 参数定义
@@ -93,6 +151,315 @@
 #define FONT_BYTES_32 128  // 32x32字体字节数
 #define CHAR_SPACING_32 32 // 32x32字符间距
 
+/* ------------------------------------------------------------------------
+ * 字形缓存配置
+ * ------------------------------------------------------------------------ */
+#define GLYPH_CACHE_CAPACITY_16 128 // 16x16字形缓存容量（128×32字节=4KB）
+#define GLYPH_CACHE_CAPACITY_32 32  // 32x32字形缓存容量（32×128字节=4KB）
+#define BT_GLYPH_ID_LEN 2           // 字形ID长度（2字节，高字节在前）
+#define BT_GLYPH_STATUS_OK 0x00     // 按ID设置文本成功
+#define BT_GLYPH_STATUS_MISSING 0x01 // 存在未缓存的字形ID
+#define BT_GLYPH_STATUS_TOO_MANY 0x02 // 不同字形ID数超过缓存容量
+#define BT_GLYPH_STATUS_INVALID 0x03 // ID列表长度不是2的整数倍
+
+/* ------------------------------------------------------------------------
+ * 设备端字库配置（Flash分区，见partitions.csv与tools/mkfontpack.py）
+ * ------------------------------------------------------------------------ */
+#define FONT_PACK_PARTITION "fontpack" // 字库分区标签（主机构建时对应文件fontpack.bin）
+#define FONT_PACK_MAGIC 0x544E464C     // 字库文件魔数 "LFNT"（小端）
+#define FONT_PACK_VERSION 1            // 字库格式版本
+#define FONT_PACK_MAX_SECTIONS 2       // 最多段数（16x16与32x32各一段）
+#define FONT_PACK_BUILTIN 0            // 为1时链接内置字库映像（tools/mkbuiltin.py --fontpack 生成），分区无字库时使用
+#define BT_UTF8_STATUS_OK 0x00         // UTF-8文本全部字符命中字库
+#define BT_UTF8_STATUS_MISSING 0x01    // 部分字符字库中不存在（以空白显示）
+
+/* ------------------------------------------------------------------------
+ * 流式文本（Flash流分区，见partitions.csv与tools/mkstream.py）
+ * ------------------------------------------------------------------------ */
+#define STREAM_PARTITION "stream"       // 流分区标签（主机构建时对应文件stream.bin，容量即文件大小）
+#define STREAM_MAGIC 0x5254534C         // 流文件魔数 "LSTR"（小端）
+#define STREAM_VERSION 1                // 流文件格式版本
+#define STREAM_HEADER_SIZE 16           // 文件头长度，点阵数据紧随其后
+#define STREAM_WINDOW_BYTES 1024        // 读前窗口大小（16x16为32字，32x32为8字），只解码可见位置附近的字形
+#define BT_STREAM_BEGIN 0x00            // 开始上传：[字体大小][字符数4字节]
+#define BT_STREAM_DATA 0x01             // 上传点阵：[偏移4字节][点阵数据...]，偏移须连续
+#define BT_STREAM_END 0x02              // 结束上传（校验长度后写入文件头）
+#define BT_STREAM_PLAY 0x03             // 播放：[屏幕区域]
+#define BT_STREAM_STOP 0x04             // 停止播放，恢复区域文本
+#define BT_STREAM_STATUS_OK 0x00        // 成功
+#define BT_STREAM_STATUS_INVALID 0x01   // 参数无效或状态不符（未BEGIN、字体与当前不符等）
+#define BT_STREAM_STATUS_TOO_LARGE 0x02 // 超出流分区容量
+#define BT_STREAM_STATUS_OFFSET 0x03    // 偏移不连续（应答中附带期望偏移）
+#define BT_STREAM_STATUS_FLASH 0x04     // Flash擦写失败
+#define BT_STREAM_STATUS_EMPTY 0x05     // 流分区中没有完整的文本
+
+/* ------------------------------------------------------------------------
+ * 场景快照（Flash场景分区，见partitions.csv与SceneStore.h）
+ * ------------------------------------------------------------------------ */
+#define SCENE_PARTITION "scene"           // 场景分区标签
+#define SCENE_MAGIC 0x4E43534C            // 快照魔数 "LSCN"（小端）
+#define SCENE_VERSION 1                   // 快照格式版本
+#define SCENE_HEADER_SIZE 20              // 槽位头长度，负载紧随其后
+#define SCENE_SLOT_SIZE 0x8000            // 槽位大小（32KB，容得下字形表全满的场景；128KB分区共4个槽位轮流写入）
+#define SCENE_CHECK_INTERVAL_MS 1000      // 检查场景是否变化的间隔（毫秒）
+#define SCENE_SAVE_QUIET_MS 5000          // 场景保持不变这么久才保存，连续调整只写一次（毫秒）
+#define SCENE_SAVE_MIN_INTERVAL_MS 300000 // 两次保存的最小间隔，内容频繁变化时每5分钟最多写一次（毫秒）
+#define SCENE_FIRST_FRAME 1               // 为1时快照附带预渲染首帧（屏幕镜像占4KB RAM），启动时最先推送
+
+/* ------------------------------------------------------------------------
+ * 场景播放列表（Flash播放列表分区，场景格式同场景快照，见Playlist.h与蓝牙播放列表帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define PLAYLIST_PARTITION "playlist"                                         // 播放列表分区标签
+#define PLAYLIST_MAGIC 0x534C504C                                             // 列表表头魔数 "LPLS"（小端）
+#define PLAYLIST_VERSION 1                                                    // 列表格式版本
+#define PLAYLIST_TABLE_SIZE 0x1000                                            // 分区第一个扇区存放播放列表，场景槽位紧随其后
+#define PLAYLIST_SCENE_SLOT_SIZE 0x4000                                       // 每个场景槽位大小（16KB，含槽位头）
+#define PLAYLIST_SCENE_COUNT 8                                                // 可保存的场景数
+#define PLAYLIST_MAX_ENTRIES 16                                               // 列表最多条目数（同一场景可出现多次）
+#define PLAYLIST_STAGING_BYTES (PLAYLIST_SCENE_SLOT_SIZE - SCENE_HEADER_SIZE) // 预备缓冲区：下一场景的负载提前读入RAM
+#define PLAYLIST_TRANSITION_MS 400                                            // 切换过渡时长（毫秒）
+#define BT_PLAYLIST_STORE 0x00                                                // 把当前场景保存为场景：[场景号]
+#define BT_PLAYLIST_DELETE 0x01                                               // 删除场景：[场景号]
+#define BT_PLAYLIST_SET 0x02                                                  // 设置列表：[条目数] + 每条 [场景号][时长2，0.1秒为单位][过渡方式]
+#define BT_PLAYLIST_START 0x03                                                // 开始轮播（重启后自动继续）
+#define BT_PLAYLIST_STOP 0x04                                                 // 停止轮播，停留在当前场景
+#define BT_PLAYLIST_STATUS 0x05                                               // 查询状态
+#define BT_PLAYLIST_ENTRY_LEN 4                                               // 列表条目长度
+#define BT_PLAYLIST_TRANSITION_CUT 0x00                                       // 过渡：直接切换
+#define BT_PLAYLIST_TRANSITION_WIPE_LEFT 0x01                                 // 过渡：新场景从左向右逐列覆盖
+#define BT_PLAYLIST_TRANSITION_WIPE_DOWN 0x02                                 // 过渡：新场景从上向下逐行覆盖
+#define BT_PLAYLIST_STATUS_OK 0x00                                            // 成功
+#define BT_PLAYLIST_STATUS_INVALID 0x01                                       // 参数错误（场景号、条目格式等）
+#define BT_PLAYLIST_STATUS_NO_STORAGE 0x02                                    // 播放列表分区不存在或写入失败（如场景超出槽位大小）
+#define BT_PLAYLIST_STATUS_NO_SCENE 0x03                                      // 条目引用了未保存的场景，或列表为空
+
+/* ------------------------------------------------------------------------
+ * 滚动队列（跑马灯消息队列，见Ticker.h与蓝牙滚动队列帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define TICKER_MAX_MESSAGES 16         // 每个区域队列最多消息数（含循环补位的副本）
+#define TICKER_MAX_SEPARATOR 4         // 分隔符最多字符数
+#define BT_TICKER_START 0x00           // 开始（清空队列）：[屏幕区域][速度][分隔符字符数][分隔符点阵...]
+#define BT_TICKER_APPEND 0x01          // 追加消息：[屏幕区域][点阵数据...]
+#define BT_TICKER_CLEAR 0x02           // 清空队列：[屏幕区域]
+#define BT_TICKER_STOP 0x03            // 停止：[屏幕区域]，区域文本保留，按普通滚动显示
+#define BT_TICKER_STATUS 0x04          // 查询状态：[屏幕区域]
+#define BT_TICKER_STATUS_OK 0x00       // 成功
+#define BT_TICKER_STATUS_INVALID 0x01  // 参数错误（区域、点阵长度、分隔符长度等）
+#define BT_TICKER_STATUS_FULL 0x02     // 队列已满或区域文本容量/字形表不足，稍后重发
+#define BT_TICKER_STATUS_INACTIVE 0x03 // 该区域没有运行中的滚动队列
+
+/* ------------------------------------------------------------------------
+ * 动画（全屏单色点阵，关键帧+增量帧，见Animation.h与蓝牙动画帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define ANIMATION_ROW_BYTES (SCREEN_WIDTH / 8)                      // 每行点阵字节数（1位/像素，高位在左）
+#define ANIMATION_FRAME_BYTES (ANIMATION_ROW_BYTES * SCREEN_HEIGHT) // 单帧点阵字节数（256字节）
+#define ANIMATION_BUFFER_BYTES 8192                                 // 动画序列缓冲区（关键帧、各增量帧与回绕增量）
+#define ANIMATION_MIN_DURATION_MS 20                                // 单帧最短显示时间（毫秒），更短的时长按此处理
+#define BT_ANIMATION_HEADER_LEN (4 + ANIMATION_FRAME_BYTES)         // 动画数据最小长度（帧数+循环次数+关键帧时长+关键帧）
+#define BT_ANIMATION_SPAN_HEADER_LEN 3                              // 增量段头长度（行+起始字节+字节数）
+#define BT_ANIMATION_STATUS_OK 0x00                                 // 已开始播放（或已停止）
+#define BT_ANIMATION_STATUS_INVALID 0x01                            // 序列格式错误（段越界、长度不符等），原动画不变
+#define BT_ANIMATION_STATUS_TOO_LARGE 0x02                          // 超出动画缓冲区容量，原动画不变
+#define BT_ANIMATION_STATUS_BUSY 0x03                               // 优先插播显示中，命令未执行，原动画不变
+
+/* ------------------------------------------------------------------------
+ * 图像模式（全屏RGB565图像，见ImageMode.h与蓝牙图像帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define IMAGE_PIXEL_COUNT (SCREEN_WIDTH * SCREEN_HEIGHT) // 图像像素数（2048）
+#define IMAGE_BUFFER_BYTES (IMAGE_PIXEL_COUNT * 2)       // 图像缓冲区（RGB565，4KB）
+#define BT_IMAGE_FULL_RGB565 0x00                        // 完整图像：[RGB565像素×2048，高字节在前]
+#define BT_IMAGE_FULL_PALETTE 0x01                       // 完整图像（调色板）：[颜色数-1][调色板RGB565...][像素索引，按颜色数取1/2/4/8位]
+#define BT_IMAGE_DELTA 0x02                              // 增量更新：[RLE编码的XOR数据]，与当前图像逐像素异或
+#define BT_IMAGE_EXIT 0x03                               // 退出图像模式，恢复文本显示
+#define BT_IMAGE_RLE_SKIP 0x00                           // RLE控制字节高2位为00：跳过(低6位+1)个像素
+#define BT_IMAGE_RLE_REPEAT 0x40                         // 高2位为01：后跟1个XOR值，作用于(低6位+1)个像素
+#define BT_IMAGE_RLE_LITERAL 0x80                        // 最高位为1：后跟(低7位+1)个XOR值，各作用于1个像素
+#define BT_IMAGE_STATUS_OK 0x00                          // 成功
+#define BT_IMAGE_STATUS_INVALID 0x01                     // 数据格式错误或越过图像末尾，图像不变
+#define BT_IMAGE_STATUS_NO_IMAGE 0x02                    // 增量更新前没有完整图像
+#define BT_IMAGE_STATUS_BUSY 0x03                        // 优先插播显示中，命令未执行，图像不变
+
+/* ------------------------------------------------------------------------
+ * 实时流（帧编码与图像命令相同，见LiveStream.h与蓝牙实时流帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define LIVE_BUFFER_BYTES (IMAGE_BUFFER_BYTES * 2) // 后台缓冲（解码目标）与前台副本（屏上内容）
+#define LIVE_PRESENT_INTERVAL_MS 16                // 呈现间隔（毫秒），两次呈现之间到达的帧只呈现最新一帧
+#define LIVE_STATS_WINDOW_MS 1000                  // 帧率统计窗口（毫秒）
+#define BT_LIVE_HEADER_LEN 3                       // 帧数据头长度（操作+帧号2字节）
+#define BT_LIVE_KEY_RGB565 0x00                    // 关键帧：[帧号2][RGB565像素×2048]
+#define BT_LIVE_KEY_PALETTE 0x01                   // 关键帧（调色板）：[帧号2][颜色数-1][调色板][像素索引]
+#define BT_LIVE_DELTA 0x02                         // 增量帧：[帧号2][RLE编码的XOR数据]，只能接在上一帧之后
+#define BT_LIVE_STOP 0x03                          // 结束实时流，应答统计后恢复文本显示
+#define BT_LIVE_STATS 0x04                         // 查询统计（帧率、丢帧数）
+#define BT_LIVE_STATUS_OK 0x00                     // 成功
+#define BT_LIVE_STATUS_INVALID 0x01                // 帧数据格式错误，该帧被丢弃
+#define BT_LIVE_STATUS_NEED_KEYFRAME 0x02          // 增量帧链已断（丢帧或尚无关键帧），请发送关键帧
+
+/* ------------------------------------------------------------------------
+ * 局部文本更新操作
+ * ------------------------------------------------------------------------ */
+#define BT_RANGE_REPLACE 0x01 // 替换：从起始位置起覆盖为新字符
+#define BT_RANGE_INSERT 0x02  // 插入：在起始位置前插入新字符
+#define BT_RANGE_DELETE 0x03  // 删除：从起始位置起删除指定数量字符
+#define BT_RANGE_HEADER_LEN 6 // 数据头长度：[屏幕区域][操作][起始2字节][数量2字节]
+
+/* ------------------------------------------------------------------------
+ * 模板字段（区域文本中的定宽字段，值由字符集映射为字形，见TextField.h与蓝牙模板字段帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define FIELD_MAX_SETS 4               // 字符集数量
+#define FIELD_SET_MAX_CHARS 16         // 每个字符集最多字符数（如0-9、空格、小数点、负号）
+#define FIELD_MAX_FIELDS 8             // 字段数量
+#define FIELD_MAX_WIDTH 16             // 字段最大宽度（字符数）
+#define BT_FIELD_DEFINE_SET 0x00       // 定义字符集：[字符集号][字符数N][N个码位，各2字节][N个点阵，可省略改用设备端字库]
+#define BT_FIELD_DEFINE 0x01           // 定义字段：[字段号][屏幕区域][起始2字节][宽度][对齐][字符集号][填充码位2字节]
+#define BT_FIELD_SET_VALUE 0x02        // 设置字段值：[字段号][值（UTF-8）]
+#define BT_FIELD_CLEAR 0x03            // 清除全部字段与字符集
+#define BT_FIELD_ALIGN_LEFT 0x00       // 值靠左，右侧填充
+#define BT_FIELD_ALIGN_RIGHT 0x01      // 值靠右，左侧填充（数字常用）
+#define BT_FIELD_STATUS_OK 0x00        // 成功
+#define BT_FIELD_STATUS_INVALID 0x01   // 参数错误，或字段超出当前区域文本/字体与定义时不符
+#define BT_FIELD_STATUS_UNDEFINED 0x02 // 字段或字符集未定义
+#define BT_FIELD_STATUS_MISSING 0x03   // 值中有字符集之外的字符（以填充字符显示）
+#define BT_FIELD_STATUS_TOO_LONG 0x04  // 值超出字段宽度，未更新
+#define BT_FIELD_STATUS_FULL 0x05      // 字形表空间不足
+
+/* ------------------------------------------------------------------------
+ * 优先插播（场景栈，见Priority.h与蓝牙优先插播帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define PRIORITY_STACK_DEPTH 3          // 场景栈深度（插播可嵌套的层数）
+#define PRIORITY_STACK_BYTES 10240      // 场景栈存储：每层保存各区域文本的字形序号与一帧屏幕镜像（4KB）
+#define BT_PRIORITY_PUSH 0x00           // 插播：[优先级][时长2字节，0.1秒为单位，0表示直到撤销]，保存当前场景
+#define BT_PRIORITY_POP 0x01            // 撤销最上层插播，恢复其下的场景
+#define BT_PRIORITY_CLEAR 0x02          // 撤销全部插播，恢复插播前的场景
+#define BT_PRIORITY_STATUS 0x03         // 查询状态
+#define BT_PRIORITY_STATUS_OK 0x00      // 成功
+#define BT_PRIORITY_STATUS_INVALID 0x01 // 参数错误
+#define BT_PRIORITY_STATUS_FULL 0x02    // 场景栈已满或存储不足
+#define BT_PRIORITY_STATUS_LOWER 0x03   // 优先级低于正在显示的插播，未插播
+#define BT_PRIORITY_STATUS_EMPTY 0x04   // 没有正在显示的插播
+#define BT_PRIORITY_STATUS_BUSY 0x05    // 全屏模式显示中且未开启屏幕镜像（SCENE_FIRST_FRAME），无法原样恢复
+
+/* ------------------------------------------------------------------------
+ * 分页与翻页过渡（见Paging.h与蓝牙分页过渡帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define BT_PAGING_DATA_LEN 6                            // 设置：[屏幕区域][每组字符数，0为占满一行][停留时间2字节，0.1秒为单位][过渡方式][过渡时长，10毫秒为单位]
+#define PAGING_DEFAULT_DWELL 20                         // 默认每页停留时间（0.1秒为单位，即2秒）
+#define PAGING_BITMAP_BYTES (4 * SCREEN_WIDTH * 16 * 2) // 翻页位图：上下半屏各两页（32x32时全屏两页），共8KB
+#define BT_PAGING_TRANSITION_CUT 0x00                   // 过渡：直接切换
+#define BT_PAGING_TRANSITION_SLIDE 0x01                 // 过渡：新页从右侧推入，旧页向左推出
+#define BT_PAGING_TRANSITION_WIPE 0x02                  // 过渡：新页从左向右逐列覆盖旧页
+#define BT_PAGING_TRANSITION_SCROLL 0x03                // 过渡：文本连续左移，新页首字紧接旧页末字滚入，停在居中位置
+#define BT_PAGING_STATUS_OK 0x00                        // 成功
+#define BT_PAGING_STATUS_INVALID 0x01                   // 参数错误
+
+/* ------------------------------------------------------------------------
+ * 批量命令配置
+ * ------------------------------------------------------------------------ */
+#define BT_BATCH_RECORD_HEADER_LEN 3 // 子命令头长度：[命令][长度高][长度低]
+#define BT_BATCH_MAX_COMMANDS 32     // 单个批量帧最多子命令数
+#define BT_BATCH_STATUS_OK 0x00      // 全部子命令已应用
+#define BT_BATCH_STATUS_INVALID 0x01 // 校验失败，未应用任何子命令
+#define BT_BATCH_STATUS_FAILED 0x02  // 子命令应用中途失败，已整体回滚到批量之前的场景
+#define BT_BATCH_STATUS_NO_MEMORY 0x03 // 临时分配区不足以保存回滚所需的场景，未应用任何子命令
+
+/* ------------------------------------------------------------------------
+ * 流量控制配置
+ * ------------------------------------------------------------------------ */
+#define FLOW_CONTROL_OFF 0x00     // 关闭流量控制（默认，兼容旧客户端）
+#define FLOW_CONTROL_ON 0x01      // 开启流量控制
+#define FLOW_WINDOW_BYTES 512     // 蓝牙通道发送窗口（字节），等于蓝牙串口接收队列大小
+#define FLOW_CREDIT_THRESHOLD 128 // 累计消费达到该字节数即发放额度，接收队列读空时也会发放
+
+/* ------------------------------------------------------------------------
+ * 命令输入通道配置
+ * ------------------------------------------------------------------------ */
+#define UART_BAUD_RATE 921600    // 有线串口波特率
+#define UART_RX_PIN 33           // 有线串口RX引脚（避开HUB75占用的引脚）
+#define UART_TX_PIN 32           // 有线串口TX引脚
+#define UART_RX_BUFFER_SIZE 4096 // 有线串口接收缓冲区（即该通道的流量控制窗口）
+#define HOST_LOOPBACK_PORT 7878  // 主机构建时TCP回环通道端口
+
+/* ------------------------------------------------------------------------
+ * 分块传输配置
+ * ------------------------------------------------------------------------ */
+#define BT_TRANSFER_BEGIN 0x01             // 开始传输：[子命令][传输ID][目标命令][总长度4字节]
+#define BT_TRANSFER_DATA 0x02              // 数据块：[子命令][传输ID][偏移4字节][数据...]
+#define BT_TRANSFER_COMMIT 0x03            // 提交：[子命令][传输ID]，数据完整后按目标命令处理
+#define BT_TRANSFER_QUERY 0x04             // 查询已确认偏移（断线重连后续传）：[子命令][传输ID]
+#define BT_TRANSFER_ABORT 0x05             // 放弃传输：[子命令][传输ID]
+#define BT_TRANSFER_STATUS_OK 0x00         // 成功
+#define BT_TRANSFER_STATUS_UNKNOWN 0x01    // 传输ID不存在
+#define BT_TRANSFER_STATUS_GAP 0x02        // 偏移不连续（客户端应从应答偏移处重发）
+#define BT_TRANSFER_STATUS_NO_MEMORY 0x03  // 内存不足
+#define BT_TRANSFER_STATUS_INCOMPLETE 0x04 // 数据未收全，无法提交
+#define BT_TRANSFER_STATUS_INVALID 0x05    // 参数无效
+#define BT_TRANSFER_MAX_SIZE 16384         // 单次传输最大总长度（字节，即静态传输缓冲区大小）
+#define BT_TRANSFER_IDLE_TIMEOUT_MS 60000  // 传输无数据超过该时间即放弃并释放缓冲区（留足断线重连续传的时间）
+
+/* ------------------------------------------------------------------------
+ * 静态内存池（内容与帧缓冲区启动时即固定，运行期不再申请或释放，长期运行不产生碎片）
+ * 开启经典蓝牙后静态DRAM段只剩约124KB，还要容纳Arduino核心、蓝牙协议栈与其余全局变量；
+ * 其余DRAM只能作为堆使用，因此大块内存池编译期定长、在setup开头从堆一次性取得，之后永不释放。
+ * ------------------------------------------------------------------------ */
+#define TEXT_REGION_CHARS_16 1024   // 上/下半屏区域文本容量（16x16字符数，每字符占2字节序号）
+#define TEXT_REGION_CHARS_32 256    // 全屏区域文本容量（32x32字符数）
+#define GLYPH_TABLE_CAPACITY_16 384 // 16x16去重字形表容量（上下半屏共用的不同字形数）
+#define GLYPH_TABLE_CAPACITY_32 64  // 32x32去重字形表容量
+#define GLYPH_TABLE_BUCKETS 128     // 字形表哈希桶数量（2的幂）
+#define BOOT_ARENA_BYTES 34304      // 启动期分配区（去重字形表24960字节 + 字形缓存9152字节，见TextStore.cpp中的检查）
+#define SCRATCH_ARENA_BYTES 24576   // 临时分配区（单条命令处理期间的转换缓冲，最大用量为批量中的UTF-8文本约22KB）
+#define MEDIA_BUFFER_BYTES 8192     // 全屏内容缓冲区：动画、图像、实时流与翻页位图共用（取各自需求的最大值）
+#define MEMORY_STATIC_BUDGET 40960  // 常驻.bss的内存池存储上限（启动期分配区与区域文本、流式窗口）
+#define MEMORY_POOL_BOOT 0x00       // 内存池编号：启动期分配区
+#define MEMORY_POOL_SCRATCH 0x01    // 内存池编号：临时分配区
+#define MEMORY_POOL_UPPER_TEXT 0x02 // 内存池编号：上半屏文本字形序号
+#define MEMORY_POOL_LOWER_TEXT 0x03 // 内存池编号：下半屏文本字形序号
+#define MEMORY_POOL_FULL_TEXT 0x04  // 内存池编号：全屏文本字形序号
+#define MEMORY_POOL_TRANSFER 0x05   // 内存池编号：分块传输缓冲区
+#define MEMORY_POOL_GLYPHS_16 0x06  // 内存池编号：16x16去重字形表
+#define MEMORY_POOL_GLYPHS_32 0x07  // 内存池编号：32x32去重字形表
+#define MEMORY_POOL_STREAM 0x08     // 内存池编号：流式文本读前窗口
+#define MEMORY_POOL_MEDIA 0x09      // 内存池编号：全屏内容缓冲区（原动画池，0x0A、0x0B、0x0E已并入）
+#define MEMORY_POOL_PLAYLIST 0x0C   // 内存池编号：播放列表预备缓冲区
+#define MEMORY_POOL_PRIORITY 0x0D   // 内存池编号：优先插播场景栈
+#define MEMORY_POOL_COUNT 12        // 内存池数量
+
+/* ------------------------------------------------------------------------
+ * 启动时间线（各阶段完成时刻，见BootTimeline.h与蓝牙启动时间线帧格式.md）
+ * ------------------------------------------------------------------------ */
+#define BOOT_PHASE_SETUP 0x00       // 进入setup()（此前为引导程序与运行时初始化）
+#define BOOT_PHASE_DISPLAY 0x01     // 显示硬件初始化完成
+#define BOOT_PHASE_STREAM 0x02      // 流式文本分区打开完成
+#define BOOT_PHASE_SCENE 0x03       // 场景快照恢复完成（含预渲染首帧）
+#define BOOT_PHASE_FIRST_FRAME 0x04 // 首帧内容绘制完成
+#define BOOT_PHASE_UART 0x05        // 有线串口启动完成
+#define BOOT_PHASE_FONT_PACK 0x06   // 设备端字库加载完成
+#define BOOT_PHASE_SETUP_DONE 0x07  // setup()结束，进入主循环
+#define BOOT_PHASE_BLUETOOTH 0x08   // 蓝牙启动完成（后台任务，可能晚于setup()结束）
+#define BOOT_TIMELINE_CAPACITY 16   // 最多记录的阶段数
+#define BT_DEFERRED_INIT 1          // 为1时蓝牙在首帧绘制后由后台任务启动，不推迟内容显示
+#define BT_INIT_TASK_STACK 4096     // 蓝牙启动任务栈大小（字节）
+#define BT_INIT_TASK_CORE 0         // 蓝牙启动任务所在核心（主循环在核心1）
+
+/* ------------------------------------------------------------------------
+ * 日志配置（编译期按级别过滤，运行时写入环形缓冲区，空闲时输出）
+ * ------------------------------------------------------------------------ */
+#define LOG_LEVEL_NONE 0  // 关闭日志
+#define LOG_LEVEL_ERROR 1 // 错误
+#define LOG_LEVEL_WARN 2  // 警告
+#define LOG_LEVEL_INFO 3  // 信息
+#define LOG_LEVEL_DEBUG 4 // 调试
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO // 编译期日志级别（可用 -DLOG_LEVEL=... 覆盖）
+#endif
+#define LOG_BUFFER_RECORDS 64     // 日志环形缓冲区记录数
+#define LOG_MAX_ARGS 8            // 单条日志最多参数个数
+#define LOG_SERIAL_TX_BUFFER 1024 // 调试串口发送缓冲区（字节）
+#define LOG_DRAIN_HEADROOM 256    // 发送缓冲区空闲不少于该字节数时才输出下一条，保证不阻塞
+#ifndef LOG_BINARY_OUTPUT
+#define LOG_BINARY_OUTPUT 0 // 1=输出二进制记录，由 tools/logdecode.py 结合固件ELF在主机解码
+#endif
+
 /* ------------------------------------------------------------------------
  * 性能配置
  * ------------------------------------------------------------------------ */
@@ -0,0 +1,320 @@
+#include "Animation.h"
+#include "LEDController.h"
+#include "DisplayDriver.h"
+#include "ImageMode.h"
+#include "LiveStream.h"
+#include "Paging.h"
+#include "Priority.h"
+#include "MemoryPool.h"
+#include "Log.h"
+#include <string.h>
+
+AnimationPlayback animationPlayback = {};
+
+static uint16_t readBE16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+// 像素颜色按所在半屏取文本/背景颜色，文本为渐变模式时按位置取渐变色
+static uint16_t getAnimationPixelColor(int x, int y, bool on)
+{
+    bool isUpper = y < SCREEN_HEIGHT / 2;
+    if (!on)
+        return isUpper ? colorState.upperBackgroundColor : colorState.lowerBackgroundColor;
+
+    uint8_t textMode = isUpper ? colorState.upperTextMode : colorState.lowerTextMode;
+    uint8_t gradientMode = isUpper ? colorState.upperGradientMode : colorState.lowerGradientMode;
+    return getGradientColor(x, y, isUpper, textMode == BT_COLOR_MODE_GRADIENT ? gradientMode : BT_GRADIENT_FIXED);
+}
+
+// 把一个字节写入当前帧，只重绘与原值不同的像素
+static void writeFrameByte(int index, uint8_t value)
+{
+    uint8_t changed = animationPlayback.frame[index] ^ value;
+    if (!changed)
+        return;
+
+    int y = index / ANIMATION_ROW_BYTES;
+    int x0 = (index % ANIMATION_ROW_BYTES) * 8;
+    for (int bit = 0; bit < 8; bit++)
+    {
+        uint8_t mask = 0x80 >> bit;
+        if (changed & mask)
+        {
+            drawPanelPixel(x0 + bit, y, getAnimationPixelColor(x0 + bit, y, (value & mask) != 0));
+            animationPlayback.pixelsDrawn++;
+        }
+    }
+    animationPlayback.frame[index] = value;
+}
+
+// 应用一组增量段 [段数][段...]，返回其后的偏移（段已在上传时校验）
+static uint32_t applySpans(uint32_t offset)
+{
+    const uint8_t *p = animationPlayback.sequence + offset;
+    uint8_t spanCount = *p++;
+    for (uint8_t i = 0; i < spanCount; i++)
+    {
+        int base = p[0] * ANIMATION_ROW_BYTES + p[1];
+        uint8_t length = p[2];
+        p += BT_ANIMATION_SPAN_HEADER_LEN;
+        for (uint8_t k = 0; k < length; k++)
+        {
+            writeFrameByte(base + k, p[k]);
+        }
+        p += length;
+    }
+    return p - animationPlayback.sequence;
+}
+
+static void drawWholeFrame()
+{
+    for (int y = 0; y < SCREEN_HEIGHT; y++)
+    {
+        for (int x = 0; x < SCREEN_WIDTH; x++)
+        {
+            bool on = animationPlayback.frame[y * ANIMATION_ROW_BYTES + x / 8] & (0x80 >> (x % 8));
+            drawPanelPixel(x, y, getAnimationPixelColor(x, y, on));
+        }
+    }
+    animationPlayback.pixelsDrawn += SCREEN_WIDTH * SCREEN_HEIGHT;
+}
+
+static uint16_t clampDuration(uint16_t duration)
+{
+    return duration < ANIMATION_MIN_DURATION_MS ? ANIMATION_MIN_DURATION_MS : duration;
+}
+
+// 显示关键帧：序列开头为 [关键帧时长2][关键帧点阵]
+static void showKeyframe()
+{
+    memcpy(animationPlayback.frame, animationPlayback.sequence + 2, ANIMATION_FRAME_BYTES);
+    drawWholeFrame();
+    animationPlayback.frameIndex = 0;
+    animationPlayback.duration = clampDuration(readBE16(animationPlayback.sequence));
+    animationPlayback.nextOffset = 2 + ANIMATION_FRAME_BYTES;
+    animationPlayback.frameStart = millis();
+}
+
+bool isAnimationPlaying()
+{
+    return animationPlayback.active;
+}
+
+void stopAnimation()
+{
+    if (!animationPlayback.active)
+        return;
+
+    LOG_I("停止播放动画 - 已切换: %u帧, 重绘: %u像素", animationPlayback.framesShown, animationPlayback.pixelsDrawn);
+    animationPlayback.active = false;
+    mediaBuffer.release();
+    textState.needUpdate = true; // 恢复文本显示
+}
+
+void updateAnimation()
+{
+    AnimationPlayback &anim = animationPlayback;
+    if (!anim.active)
+        return;
+
+    // 颜色变化影响所有点亮像素，整帧重绘一次
+    if (colorState.needColorUpdate)
+    {
+        colorState.needColorUpdate = false;
+        drawWholeFrame();
+    }
+
+    unsigned long now = millis();
+    if (anim.finished || now - anim.frameStart < anim.duration)
+        return;
+
+    if (anim.frameIndex + 1 < anim.frameCount)
+    {
+        anim.duration = clampDuration(readBE16(anim.sequence + anim.nextOffset));
+        anim.nextOffset = applySpans(anim.nextOffset + 2);
+        anim.frameIndex++;
+    }
+    else
+    {
+        anim.loopsDone++;
+        if (anim.loopCount > 0 && anim.loopsDone >= anim.loopCount)
+        {
+            anim.finished = true; // 停在最后一帧
+            LOG_I("动画播放完毕 - 循环: %d次", anim.loopsDone);
+            return;
+        }
+        applySpans(anim.wrapOffset);
+        anim.frameIndex = 0;
+        anim.duration = clampDuration(readBE16(anim.sequence));
+        anim.nextOffset = 2 + ANIMATION_FRAME_BYTES;
+    }
+
+    // 按计划时刻推进，不累积处理延迟；落后超过一帧时从当前时刻重新计时
+    anim.frameStart = (now - anim.frameStart < 2UL * anim.duration) ? anim.frameStart + anim.duration : now;
+    anim.framesShown++;
+}
+
+// ==================== 上传 ====================
+// 校验增量帧序列：段不越界、长度与帧数一致，返回增量帧部分的字节数（出错返回-1）
+static int validateDeltas(const uint8_t *data, int length, int deltaFrames)
+{
+    int offset = 0;
+    for (int f = 0; f < deltaFrames; f++)
+    {
+        if (offset + 3 > length)
+            return -1;
+        uint8_t spanCount = data[offset + 2];
+        offset += 3;
+        for (uint8_t i = 0; i < spanCount; i++)
+        {
+            if (offset + BT_ANIMATION_SPAN_HEADER_LEN > length)
+                return -1;
+            uint8_t row = data[offset];
+            uint8_t start = data[offset + 1];
+            uint8_t count = data[offset + 2];
+            if (row >= SCREEN_HEIGHT || count == 0 || start + count > ANIMATION_ROW_BYTES)
+                return -1;
+            offset += BT_ANIMATION_SPAN_HEADER_LEN + count;
+            if (offset > length)
+                return -1;
+        }
+    }
+    return offset;
+}
+
+// 在临时帧上依次应用全部增量得到最后一帧，再逐行与关键帧比较生成回绕增量（每行至多一段）
+static int buildWrapDelta(const uint8_t *keyframe, const uint8_t *deltas, int deltaFrames, uint8_t *out)
+{
+    uint8_t *last = scratchArena.allocateArray<uint8_t>(ANIMATION_FRAME_BYTES);
+    if (!last)
+        return -1;
+    memcpy(last, keyframe, ANIMATION_FRAME_BYTES);
+
+    const uint8_t *p = deltas;
+    for (int f = 0; f < deltaFrames; f++)
+    {
+        uint8_t spanCount = p[2];
+        p += 3;
+        for (uint8_t i = 0; i < spanCount; i++)
+        {
+            memcpy(last + p[0] * ANIMATION_ROW_BYTES + p[1], p + BT_ANIMATION_SPAN_HEADER_LEN, p[2]);
+            p += BT_ANIMATION_SPAN_HEADER_LEN + p[2];
+        }
+    }
+
+    int length = 1;
+    uint8_t spanCount = 0;
+    for (int y = 0; y < SCREEN_HEIGHT; y++)
+    {
+        const uint8_t *from = last + y * ANIMATION_ROW_BYTES;
+        const uint8_t *to = keyframe + y * ANIMATION_ROW_BYTES;
+        int first = 0;
+        int end = ANIMATION_ROW_BYTES;
+        while (first < end && from[first] == to[first])
+            first++;
+        while (end > first && from[end - 1] == to[end - 1])
+            end--;
+        if (first == end)
+            continue;
+
+        out[length++] = y;
+        out[length++] = first;
+        out[length++] = end - first;
+        memcpy(out + length, to + first, end - first);
+        length += end - first;
+        spanCount++;
+    }
+    out[0] = spanCount;
+    return length;
+}
+
+// 回绕增量最大长度：每行一段
+static const int WRAP_DELTA_MAX = 1 + SCREEN_HEIGHT * (BT_ANIMATION_SPAN_HEADER_LEN + ANIMATION_ROW_BYTES);
+
+static void sendAnimationResponse(uint8_t status)
+{
+    uint8_t response[2] = {status, animationPlayback.active ? animationPlayback.frameCount : (uint8_t)0};
+    sendResponseFrame(BT_CMD_SET_ANIMATION, response, sizeof(response));
+}
+
+// 处理动画命令 (0x05)
+// 数据为空或帧数为0时停止播放；否则整体校验后替换当前动画并从关键帧开始播放
+// 应答：[状态][帧数]
+void handleAnimationCommand(const BluetoothFrame &frame)
+{
+    // 插播期间屏幕属于插播内容，出栈时推回的是入栈时的屏幕镜像，此时替换或停止动画会与镜像不一致
+    if (isPriorityActive())
+    {
+        LOG_W("动画命令被拒绝: 优先插播显示中");
+        sendAnimationResponse(BT_ANIMATION_STATUS_BUSY);
+        return;
+    }
+    if (frame.data == nullptr || frame.dataLength == 0 || frame.data[0] == 0)
+    {
+        stopAnimation();
+        sendAnimationResponse(BT_ANIMATION_STATUS_OK);
+        return;
+    }
+    if (frame.dataLength < BT_ANIMATION_HEADER_LEN)
+    {
+        LOG_E("错误: 动画数据长度不足 - %d字节", frame.dataLength);
+        sendAnimationResponse(BT_ANIMATION_STATUS_INVALID);
+        return;
+    }
+
+    uint8_t frameCount = frame.data[0];
+    uint8_t loopCount = frame.data[1];
+    const uint8_t *keyframe = frame.data + 4;
+    const uint8_t *deltas = keyframe + ANIMATION_FRAME_BYTES;
+    int deltaLength = frame.dataLength - BT_ANIMATION_HEADER_LEN;
+    if (validateDeltas(deltas, deltaLength, frameCount - 1) != deltaLength)
+    {
+        LOG_E("错误: 动画序列格式错误 - 帧数: %d, 增量数据: %d字节", frameCount, deltaLength);
+        sendAnimationResponse(BT_ANIMATION_STATUS_INVALID);
+        return;
+    }
+
+    uint8_t *wrap = scratchArena.allocateArray<uint8_t>(WRAP_DELTA_MAX);
+    int wrapLength = wrap ? buildWrapDelta(keyframe, deltas, frameCount - 1, wrap) : -1;
+    size_t sequenceLength = frame.dataLength - 2;
+    if (wrapLength < 0 || sequenceLength + wrapLength > ANIMATION_BUFFER_BYTES)
+    {
+        LOG_E("错误: 动画超出缓冲区容量 - 需要: %u字节", (unsigned)(sequenceLength + (wrapLength > 0 ? wrapLength : 0)));
+        sendAnimationResponse(BT_ANIMATION_STATUS_TOO_LARGE);
+        return;
+    }
+
+    // 校验通过后才替换正在播放的动画；动画、图像与实时流都占据整屏，后到的替换先到的
+    exitImageMode();
+    stopLiveStream();
+    releasePagingBitmaps();
+    animationPlayback.active = false;
+    uint8_t *sequence = (uint8_t *)mediaBuffer.acquire(sequenceLength + wrapLength);
+    if (!sequence)
+    {
+        sendAnimationResponse(BT_ANIMATION_STATUS_TOO_LARGE);
+        textState.needUpdate = true; // 原动画已停止，恢复文本显示
+        return;
+    }
+    memcpy(sequence, frame.data + 2, sequenceLength);
+    memcpy(sequence + sequenceLength, wrap, wrapLength);
+
+    AnimationPlayback &anim = animationPlayback;
+    anim.sequence = sequence;
+    anim.frameCount = frameCount;
+    anim.loopCount = loopCount;
+    anim.loopsDone = 0;
+    anim.finished = false;
+    anim.wrapOffset = sequenceLength;
+    anim.framesShown = 0;
+    anim.pixelsDrawn = 0;
+    anim.active = true;
+    colorState.needColorUpdate = false;
+    showKeyframe();
+
+    LOG_I("开始播放动画 - 帧数: %d, 循环: %d, 序列: %u字节 (完整帧需%u字节)",
+          frameCount, loopCount, (unsigned)(sequenceLength + wrapLength), (unsigned)(frameCount * ANIMATION_FRAME_BYTES));
+    sendAnimationResponse(BT_ANIMATION_STATUS_OK);
+}
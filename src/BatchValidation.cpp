@@ -0,0 +1,281 @@
+#include "BatchValidation.h"
+#include "CommandRegistry.h"
+#include "FontPack.h"
+#include "TextStore.h"
+#include "MemoryPool.h"
+
+static int getFontIndex(uint8_t fontSize)
+{
+    return (fontSize == BT_FONT_32x32) ? 1 : 0;
+}
+
+static uint16_t readId(const uint8_t *bytes)
+{
+    return ((uint16_t)bytes[0] << 8) | bytes[1];
+}
+
+// 有序去重插入：返回插入后的元素个数（已存在时不变），超过maxCount返回-1
+template <typename T>
+static int insertSorted(T *values, int count, int maxCount, T value)
+{
+    int low = 0;
+    int high = count;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (values[mid] < value)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low < count && values[low] == value)
+        return count;
+    if (count >= maxCount)
+        return -1;
+
+    memmove(values + low + 1, values + low, (count - low) * sizeof(T));
+    values[low] = value;
+    return count + 1;
+}
+
+// 16x16字体只能写入上/下半屏或全屏两行，32x32字体不区分区域
+static bool isTextAreaValid(uint8_t screenArea, uint8_t fontSize)
+{
+    return fontSize == BT_FONT_32x32 || (screenArea >= BT_SCREEN_UPPER && screenArea <= BT_SCREEN_BOTH);
+}
+
+// 字形定义须由完整的记录组成，否则处理函数会在中途停下
+static bool isGlyphDefineValid(const BatchRecord &record)
+{
+    int offset = 0;
+    while (offset < record.length)
+    {
+        uint8_t fontSize = record.data[offset];
+        if (fontSize != BT_FONT_16x16 && fontSize != BT_FONT_32x32)
+            return false;
+        offset += 1 + BT_GLYPH_ID_LEN + ((fontSize == BT_FONT_32x32) ? FONT_BYTES_32 : FONT_BYTES_16);
+    }
+    return offset == record.length;
+}
+
+// 检查字形ID是否已缓存，或由本批量中更早的字形定义子命令提供
+static bool isGlyphAvailable(uint16_t id, uint8_t fontSize, const BatchContext &context,
+                             const BatchRecord *records, int recordCount)
+{
+    if (context.isGlyphCached && context.isGlyphCached(fontSize, id))
+        return true;
+
+    for (int r = 0; r < recordCount; r++)
+    {
+        if (records[r].command != BT_CMD_DEFINE_GLYPH)
+            continue;
+
+        int offset = 0;
+        while (offset < records[r].length)
+        {
+            uint8_t glyphFont = records[r].data[offset];
+            if (glyphFont == fontSize && readId(records[r].data + offset + 1) == id)
+                return true;
+            offset += 1 + BT_GLYPH_ID_LEN + ((glyphFont == BT_FONT_32x32) ? FONT_BYTES_32 : FONT_BYTES_16);
+        }
+    }
+    return false;
+}
+
+// UTF-8文本：字符数不超过区域容量，不同字符数不超过字形表容量（与处理函数的截断条件一致）
+static bool isUtf8TextValid(const BatchRecord &record, const BatchContext &context)
+{
+    int capacity = getTextRegionCapacity(record.data[0], record.fontSize);
+    int tableCapacity = context.tableCapacity[getFontIndex(record.fontSize)];
+
+    ArenaScope scope(scratchArena);
+    uint32_t *codepoints = scratchArena.allocateArray<uint32_t>(capacity + 1);
+    uint32_t *unique = scratchArena.allocateArray<uint32_t>(tableCapacity);
+    if (!codepoints || !unique)
+        return false;
+
+    int count = decodeUtf8(record.data + 1, record.length - 1, codepoints, capacity + 1);
+    if (count > capacity)
+        return false;
+
+    int uniqueCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (codepoints[i] < 0x20)
+            continue; // 控制字符不显示
+        uniqueCount = insertSorted(unique, uniqueCount, tableCapacity, codepoints[i]);
+        if (uniqueCount < 0)
+            return false;
+    }
+    return true;
+}
+
+// 校验单条子命令：先按注册表检查命令与长度，再检查依赖设备状态的语义
+static bool validateBatchRecord(const BatchContext &context, const BatchRecord *records, int index, bool isLast)
+{
+    const BatchRecord &record = records[index];
+
+    // 批量与分块传输不可嵌套，未注册及不可批量的命令（如动画、流式文本）也不接受
+    const CommandSpec *spec = findCommandSpec(record.command);
+    if (!spec || !spec->batchable || !isCommandLengthValid(spec, record.length))
+        return false;
+
+    int glyphBytes = (record.fontSize == BT_FONT_32x32) ? FONT_BYTES_32 : FONT_BYTES_16;
+
+    switch (record.command)
+    {
+    case BT_CMD_SET_TEXT:
+    {
+        int charCount = (record.length - 1) / glyphBytes;
+        return charCount > 0 && isTextAreaValid(record.data[0], record.fontSize) &&
+               charCount <= getTextRegionCapacity(record.data[0], record.fontSize);
+    }
+
+    case BT_CMD_SET_COLOR:
+    {
+        uint8_t screenArea = record.data[0];
+        uint8_t target = record.data[1];
+        uint8_t mode = record.data[2];
+        if (screenArea < BT_SCREEN_UPPER || screenArea > BT_SCREEN_BOTH)
+            return false;
+        if (target != BT_COLOR_TARGET_TEXT && target != BT_COLOR_TARGET_BACKGROUND)
+            return false;
+        return !(target == BT_COLOR_TARGET_BACKGROUND && mode == BT_COLOR_MODE_GRADIENT);
+    }
+
+    case BT_CMD_DEFINE_GLYPH:
+        return isGlyphDefineValid(record);
+
+    case BT_CMD_SET_TEXT_BY_ID:
+    {
+        if ((record.length - 1) % BT_GLYPH_ID_LEN != 0 || !isTextAreaValid(record.data[0], record.fontSize))
+            return false;
+        int idCount = (record.length - 1) / BT_GLYPH_ID_LEN;
+        if (idCount > getTextRegionCapacity(record.data[0], record.fontSize))
+            return false;
+        for (int i = 0; i < idCount; i++)
+        {
+            if (!isGlyphAvailable(readId(record.data + 1 + i * 2), record.fontSize, context, records, index))
+                return false;
+        }
+        return true;
+    }
+
+    case BT_CMD_SET_TEXT_UTF8:
+        return context.fontPackLoaded && isTextAreaValid(record.data[0], record.fontSize) &&
+               isUtf8TextValid(record, context);
+
+    case BT_CMD_TEXT_RANGE:
+    {
+        uint8_t op = record.data[1];
+        int count = ((int)record.data[4] << 8) | record.data[5];
+        if (record.fontSize != BT_FONT_32x32 && record.data[0] != BT_SCREEN_UPPER && record.data[0] != BT_SCREEN_LOWER)
+            return false;
+        if (op == BT_RANGE_DELETE)
+            return true;
+        return (op == BT_RANGE_REPLACE || op == BT_RANGE_INSERT) &&
+               record.length - BT_RANGE_HEADER_LEN == count * glyphBytes;
+    }
+
+    case BT_CMD_PRIORITY:
+        // 撤销插播会回收场景栈的存储，无法回滚，只能作为最后一条子命令
+        return isLast || (record.data[0] != BT_PRIORITY_POP && record.data[0] != BT_PRIORITY_CLEAR);
+
+    default:
+        return true;
+    }
+}
+
+// 记录子命令用到的字形ID（按ID文本引用的与字形定义的）；各字体的不同ID须能同时放入缓存，
+// 否则后面的定义会淘汰前面引用的字形。超出容量返回false
+static bool addCacheIds(const BatchRecord &record, uint16_t *ids[2], int idCounts[2], const BatchContext &context)
+{
+    if (record.command == BT_CMD_SET_TEXT_BY_ID)
+    {
+        int font = getFontIndex(record.fontSize);
+        for (int offset = 1; offset + 1 < record.length; offset += BT_GLYPH_ID_LEN)
+        {
+            idCounts[font] = insertSorted(ids[font], idCounts[font], context.cacheCapacity[font], readId(record.data + offset));
+            if (idCounts[font] < 0)
+                return false;
+        }
+    }
+    else if (record.command == BT_CMD_DEFINE_GLYPH)
+    {
+        int offset = 0;
+        while (offset < record.length)
+        {
+            int font = getFontIndex(record.data[offset]);
+            idCounts[font] = insertSorted(ids[font], idCounts[font], context.cacheCapacity[font], readId(record.data + offset + 1));
+            if (idCounts[font] < 0)
+                return false;
+            offset += 1 + BT_GLYPH_ID_LEN + (font ? FONT_BYTES_32 : FONT_BYTES_16);
+        }
+    }
+    return true;
+}
+
+int parseBatch(const uint8_t *data, int length, const BatchContext &context, BatchRecord *records, int &failedIndex)
+{
+    int recordCount = 0;
+    uint8_t fontSize = context.fontSize;
+    int offset = 0;
+
+    // 先拆分，最后一条子命令确定后再逐条校验
+    while (offset < length)
+    {
+        failedIndex = recordCount;
+        if (recordCount >= BT_BATCH_MAX_COMMANDS || offset + BT_BATCH_RECORD_HEADER_LEN > length)
+            return -1;
+
+        BatchRecord &record = records[recordCount];
+        record.command = data[offset];
+        record.length = ((uint16_t)data[offset + 1] << 8) | data[offset + 2];
+        record.data = data + offset + BT_BATCH_RECORD_HEADER_LEN;
+        record.fontSize = fontSize;
+        if (offset + BT_BATCH_RECORD_HEADER_LEN + record.length > length)
+            return -1;
+
+        if (record.command == BT_CMD_SET_FONT_16x16)
+            fontSize = BT_FONT_16x16;
+        else if (record.command == BT_CMD_SET_FONT_32x32)
+            fontSize = BT_FONT_32x32;
+
+        offset += BT_BATCH_RECORD_HEADER_LEN + record.length;
+        recordCount++;
+    }
+
+    ArenaScope scope(scratchArena);
+    uint16_t *ids[2] = {scratchArena.allocateArray<uint16_t>(context.cacheCapacity[0]),
+                        scratchArena.allocateArray<uint16_t>(context.cacheCapacity[1])};
+    int idCounts[2] = {0, 0};
+    for (int i = 0; i < recordCount; i++)
+    {
+        failedIndex = i;
+        if ((context.cacheCapacity[0] > 0 && !ids[0]) || (context.cacheCapacity[1] > 0 && !ids[1]))
+            return -1;
+        if (!validateBatchRecord(context, records, i, i == recordCount - 1) ||
+            !addCacheIds(records[i], ids, idCounts, context))
+            return -1;
+    }
+
+    return recordCount;
+}
+
+int collectPinnedGlyphIds(const BatchRecord *records, int count, uint8_t fontSize, uint16_t *ids, int maxIds)
+{
+    int idCount = 0;
+    for (int r = 0; r < count; r++)
+    {
+        const BatchRecord &record = records[r];
+        if (record.command != BT_CMD_SET_TEXT_BY_ID || record.fontSize != fontSize)
+            continue;
+        for (int offset = 1; offset + 1 < record.length; offset += BT_GLYPH_ID_LEN)
+        {
+            idCount = insertSorted(ids, idCount, maxIds, readId(record.data + offset));
+            if (idCount < 0)
+                return -1;
+        }
+    }
+    return idCount;
+}
@@ -0,0 +1,94 @@
+#include "BootTimeline.h"
+#include "Log.h"
+
+#include "freertos/FreeRTOS.h"
+
+static portMUX_TYPE bootMux = portMUX_INITIALIZER_UNLOCKED; // 蓝牙启动任务也会记录
+#define BOOT_LOCK() portENTER_CRITICAL(&bootMux)
+#define BOOT_UNLOCK() portEXIT_CRITICAL(&bootMux)
+
+static BootMark bootMarks[BOOT_TIMELINE_CAPACITY];
+static uint8_t bootMarkCount = 0;
+
+static const char *getPhaseName(uint8_t phase)
+{
+    switch (phase)
+    {
+    case BOOT_PHASE_SETUP:
+        return "进入setup";
+    case BOOT_PHASE_DISPLAY:
+        return "显示硬件";
+    case BOOT_PHASE_STREAM:
+        return "流式文本分区";
+    case BOOT_PHASE_SCENE:
+        return "场景快照";
+    case BOOT_PHASE_FIRST_FRAME:
+        return "首帧内容";
+    case BOOT_PHASE_UART:
+        return "有线串口";
+    case BOOT_PHASE_FONT_PACK:
+        return "设备端字库";
+    case BOOT_PHASE_SETUP_DONE:
+        return "setup结束";
+    case BOOT_PHASE_BLUETOOTH:
+        return "蓝牙";
+    default:
+        return "未知阶段";
+    }
+}
+
+void bootMark(uint8_t phase)
+{
+    uint32_t now = micros();
+    BOOT_LOCK();
+    if (bootMarkCount < BOOT_TIMELINE_CAPACITY)
+    {
+        bootMarks[bootMarkCount].phase = phase;
+        bootMarks[bootMarkCount].micro = now;
+        bootMarkCount++;
+    }
+    BOOT_UNLOCK();
+}
+
+// 耗时为与上一条记录的间隔；后台任务的记录按完成顺序穿插其中
+void reportBootTimeline()
+{
+    BootMark marks[BOOT_TIMELINE_CAPACITY];
+    BOOT_LOCK();
+    uint8_t count = bootMarkCount;
+    memcpy(marks, bootMarks, count * sizeof(BootMark));
+    BOOT_UNLOCK();
+
+    LOG_I("启动时间线 - 共%d个阶段", count);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t elapsed = (i > 0) ? marks[i].micro - marks[i - 1].micro : marks[i].micro;
+        LOG_I("  %s: %u.%03u毫秒 (+%u微秒)", getPhaseName(marks[i].phase),
+              marks[i].micro / 1000, marks[i].micro % 1000, elapsed);
+    }
+}
+
+// 处理启动时间线查询命令 (0x14)
+// 应答：[阶段数] + 每个阶段 [阶段编号][完成时刻4字节（微秒）]，按记录顺序
+void handleBootTimelineCommand(const BluetoothFrame &)
+{
+    uint8_t response[1 + BOOT_TIMELINE_CAPACITY * 5];
+    int length = 1;
+
+    BOOT_LOCK();
+    uint8_t count = bootMarkCount;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t micro = bootMarks[i].micro;
+        response[length++] = bootMarks[i].phase;
+        response[length++] = (uint8_t)(micro >> 24);
+        response[length++] = (uint8_t)(micro >> 16);
+        response[length++] = (uint8_t)(micro >> 8);
+        response[length++] = (uint8_t)(micro & 0xFF);
+    }
+    BOOT_UNLOCK();
+    response[0] = count;
+
+    LOG_I("启动时间线查询 - 返回%d个阶段", count);
+    sendResponseFrame(BT_CMD_BOOT_TIMELINE, response, length);
+}
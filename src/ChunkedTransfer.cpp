@@ -0,0 +1,214 @@
+#include "ChunkedTransfer.h"
+#include "CommandRegistry.h"
+#include "MemoryPool.h"
+#include "Log.h"
+
+TransferSlot transferSlot = {false, 0, 0, 0, 0, nullptr, 0};
+
+// 读取4字节大端整数
+static uint32_t readBE32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// 应答格式：[子命令][传输ID][状态][已确认偏移4字节]
+static void sendTransferResponse(uint8_t subCommand, uint8_t transferId, uint8_t status)
+{
+    bool current = transferSlot.active && transferSlot.transferId == transferId;
+    uint32_t offset = current ? transferSlot.receivedBytes : 0;
+    uint8_t response[7] = {subCommand, transferId, status,
+                           (uint8_t)(offset >> 24), (uint8_t)(offset >> 16),
+                           (uint8_t)(offset >> 8), (uint8_t)(offset & 0xFF)};
+    sendResponseFrame(BT_CMD_TRANSFER, response, sizeof(response));
+}
+
+void abortTransfer()
+{
+    transferBuffer.release();
+    transferSlot.buffer = nullptr;
+    transferSlot.active = false;
+    transferSlot.totalLength = 0;
+    transferSlot.receivedBytes = 0;
+}
+
+// 客户端断开后不再续传时，传输缓冲区会一直被占用，闲置超时后释放
+void updateTransfer()
+{
+    if (transferSlot.active && millis() - transferSlot.lastActivity > BT_TRANSFER_IDLE_TIMEOUT_MS)
+    {
+        LOG_W("分块传输%d闲置超时，已放弃 (已收%u/%u字节)",
+              transferSlot.transferId, transferSlot.receivedBytes, transferSlot.totalLength);
+        abortTransfer();
+    }
+}
+
+// 开始传输；若同一传输（ID、目标、总长度均相同）仍在进行，则视为续传，保留已收数据
+static void handleTransferBegin(const BluetoothFrame &frame, uint8_t transferId)
+{
+    if (frame.dataLength < 7)
+    {
+        sendTransferResponse(BT_TRANSFER_BEGIN, transferId, BT_TRANSFER_STATUS_INVALID);
+        return;
+    }
+
+    uint8_t targetCommand = frame.data[2];
+    uint32_t totalLength = readBE32(frame.data + 3);
+
+    const CommandSpec *spec = findCommandSpec(targetCommand);
+    if (targetCommand == BT_CMD_TRANSFER || totalLength == 0 || totalLength > BT_TRANSFER_MAX_SIZE ||
+        !isCommandLengthValid(spec, (uint16_t)totalLength))
+    {
+        LOG_E("错误: 分块传输参数无效 - 目标命令: 0x%02X, 总长度: %u", targetCommand, totalLength);
+        sendTransferResponse(BT_TRANSFER_BEGIN, transferId, BT_TRANSFER_STATUS_INVALID);
+        return;
+    }
+
+    if (transferSlot.active && transferSlot.transferId == transferId &&
+        transferSlot.targetCommand == targetCommand && transferSlot.totalLength == totalLength)
+    {
+        LOG_I("分块传输续传 - ID: %d, 已确认: %u/%u字节",
+              transferId, transferSlot.receivedBytes, totalLength);
+        transferSlot.lastActivity = millis();
+        sendTransferResponse(BT_TRANSFER_BEGIN, transferId, BT_TRANSFER_STATUS_OK);
+        return;
+    }
+
+    abortTransfer();
+    transferSlot.buffer = (uint8_t *)transferBuffer.acquire(totalLength); // 静态传输缓冲区，同一时刻只有一个传输
+    if (!transferSlot.buffer)
+    {
+        LOG_E("错误: 分块传输缓冲区不足 (%u字节)", totalLength);
+        sendTransferResponse(BT_TRANSFER_BEGIN, transferId, BT_TRANSFER_STATUS_NO_MEMORY);
+        return;
+    }
+
+    transferSlot.active = true;
+    transferSlot.transferId = transferId;
+    transferSlot.targetCommand = targetCommand;
+    transferSlot.totalLength = totalLength;
+    transferSlot.receivedBytes = 0;
+    transferSlot.lastActivity = millis();
+
+    LOG_I("分块传输开始 - ID: %d, 目标命令: 0x%02X, 总长度: %u字节", transferId, targetCommand, totalLength);
+    sendTransferResponse(BT_TRANSFER_BEGIN, transferId, BT_TRANSFER_STATUS_OK);
+}
+
+// 数据块：只接受与已确认偏移衔接的数据，重复部分忽略，出现空洞则应答当前偏移
+static void handleTransferData(const BluetoothFrame &frame, uint8_t transferId)
+{
+    if (!transferSlot.active || transferSlot.transferId != transferId)
+    {
+        sendTransferResponse(BT_TRANSFER_DATA, transferId, BT_TRANSFER_STATUS_UNKNOWN);
+        return;
+    }
+    if (frame.dataLength < 6)
+    {
+        sendTransferResponse(BT_TRANSFER_DATA, transferId, BT_TRANSFER_STATUS_INVALID);
+        return;
+    }
+
+    uint32_t offset = readBE32(frame.data + 2);
+    uint32_t chunkLength = frame.dataLength - 6;
+    const uint8_t *chunk = frame.data + 6;
+
+    if (offset > transferSlot.receivedBytes)
+    {
+        sendTransferResponse(BT_TRANSFER_DATA, transferId, BT_TRANSFER_STATUS_GAP);
+        return;
+    }
+    if (offset + chunkLength > transferSlot.totalLength)
+    {
+        sendTransferResponse(BT_TRANSFER_DATA, transferId, BT_TRANSFER_STATUS_INVALID);
+        return;
+    }
+
+    uint32_t end = offset + chunkLength;
+    if (end > transferSlot.receivedBytes)
+    {
+        uint32_t skip = transferSlot.receivedBytes - offset;
+        memcpy(transferSlot.buffer + transferSlot.receivedBytes, chunk + skip, chunkLength - skip);
+        transferSlot.receivedBytes = end;
+    }
+    transferSlot.lastActivity = millis();
+    sendTransferResponse(BT_TRANSFER_DATA, transferId, BT_TRANSFER_STATUS_OK);
+}
+
+// 提交：数据收齐后构造完整帧，交给常规命令分发处理
+static void handleTransferCommit(uint8_t transferId)
+{
+    if (!transferSlot.active || transferSlot.transferId != transferId)
+    {
+        sendTransferResponse(BT_TRANSFER_COMMIT, transferId, BT_TRANSFER_STATUS_UNKNOWN);
+        return;
+    }
+    if (transferSlot.receivedBytes < transferSlot.totalLength)
+    {
+        sendTransferResponse(BT_TRANSFER_COMMIT, transferId, BT_TRANSFER_STATUS_INCOMPLETE);
+        return;
+    }
+
+    LOG_I("分块传输完成 - ID: %d, 目标命令: 0x%02X, %u字节",
+          transferId, transferSlot.targetCommand, transferSlot.totalLength);
+
+    BluetoothFrame assembled;
+    assembled.command = transferSlot.targetCommand;
+    assembled.dataLength = (uint16_t)transferSlot.totalLength;
+    assembled.data = transferSlot.buffer;
+    assembled.isValid = true;
+    assembled.timestamp = millis();
+    processBluetoothCommand(assembled);
+
+    sendTransferResponse(BT_TRANSFER_COMMIT, transferId, BT_TRANSFER_STATUS_OK);
+    abortTransfer();
+}
+
+// 处理分块传输命令 (0x0C)
+void handleTransferCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 2)
+    {
+        LOG_E("错误: 分块传输数据无效");
+        return;
+    }
+
+    uint8_t subCommand = frame.data[0];
+    uint8_t transferId = frame.data[1];
+
+    switch (subCommand)
+    {
+    case BT_TRANSFER_BEGIN:
+        handleTransferBegin(frame, transferId);
+        break;
+
+    case BT_TRANSFER_DATA:
+        handleTransferData(frame, transferId);
+        break;
+
+    case BT_TRANSFER_COMMIT:
+        handleTransferCommit(transferId);
+        break;
+
+    case BT_TRANSFER_QUERY:
+        if (transferSlot.active && transferSlot.transferId == transferId)
+            transferSlot.lastActivity = millis(); // 客户端准备续传，重新计算闲置时间
+        sendTransferResponse(BT_TRANSFER_QUERY, transferId,
+                             (transferSlot.active && transferSlot.transferId == transferId)
+                                 ? BT_TRANSFER_STATUS_OK
+                                 : BT_TRANSFER_STATUS_UNKNOWN);
+        break;
+
+    case BT_TRANSFER_ABORT:
+        if (transferSlot.active && transferSlot.transferId == transferId)
+        {
+            abortTransfer();
+            LOG_I("分块传输已放弃 - ID: %d", transferId);
+        }
+        sendTransferResponse(BT_TRANSFER_ABORT, transferId, BT_TRANSFER_STATUS_OK);
+        break;
+
+    default:
+        LOG_E("错误: 未知的分块传输子命令 0x%02X", subCommand);
+        sendTransferResponse(subCommand, transferId, BT_TRANSFER_STATUS_INVALID);
+        break;
+    }
+}
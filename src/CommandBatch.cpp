@@ -0,0 +1,212 @@
+#include "CommandBatch.h"
+#include "BatchValidation.h"
+#include "LEDController.h"
+#include "GlyphCache.h"
+#include "FontPack.h"
+#include "TextStream.h"
+#include "TextField.h"
+#include "Paging.h"
+#include "Priority.h"
+#include "MemoryPool.h"
+#include "Log.h"
+
+bool batchApplying = false;
+static bool batchFailed = false;
+
+// 应用前的场景，子命令失败时据此回滚
+struct BatchSnapshot
+{
+    TextDisplayState text;
+    ColorState color;
+    EffectState effect;
+    uint8_t brightness;
+    uint8_t fontSize;
+    StreamPlayback stream;
+    PagingConfig paging[2];    // [0]上半屏，[1]下半屏
+    uint8_t priorityDepth;     // 插播层数（批量中入栈的场景在回滚时丢弃）
+    RegionSnapshot regions[3]; // 上/下半屏、全屏文本（取自scratchArena）
+    TextFieldState *fields;    // 字符集与字段（取自scratchArena）
+};
+
+static BatchSnapshot snapshot;
+static RegionText *const batchRegions[3] = {&upperRegionText, &lowerRegionText, &fullRegionText};
+
+void markBatchFailed()
+{
+    if (batchApplying)
+        batchFailed = true;
+}
+
+static bool isGlyphCached(uint8_t fontSize, uint16_t id)
+{
+    return ((fontSize == BT_FONT_32x32) ? glyphCache32 : glyphCache16).contains(id);
+}
+
+// 保存场景：快照存储取自临时分配区，批量处理结束时随之回收
+static bool saveSnapshot()
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if (!saveRegionText(*batchRegions[i], scratchArena, snapshot.regions[i]))
+        {
+            while (i-- > 0)
+            {
+                releaseRegionSnapshot(*batchRegions[i], snapshot.regions[i]);
+            }
+            return false;
+        }
+    }
+    snapshot.fields = scratchArena.allocateArray<TextFieldState>(1);
+    if (!snapshot.fields)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            releaseRegionSnapshot(*batchRegions[i], snapshot.regions[i]);
+        }
+        return false;
+    }
+    saveTextFields(*snapshot.fields);
+
+    snapshot.text = textState;
+    snapshot.color = colorState;
+    snapshot.effect = effectState;
+    snapshot.brightness = brightnessState.brightness;
+    snapshot.fontSize = currentFontSize;
+    snapshot.stream = streamPlayback;
+    snapshot.paging[0] = getPagingConfig(true);
+    snapshot.paging[1] = getPagingConfig(false);
+    snapshot.priorityDepth = getPriorityDepth();
+    return true;
+}
+
+// 回滚：批量中入栈的插播丢弃，其余内容换回快照（引用随之转回）
+static void restoreSnapshot()
+{
+    discardPriorityScenes(snapshot.priorityDepth);
+    setPagingConfig(true, snapshot.paging[0]);
+    setPagingConfig(false, snapshot.paging[1]);
+    restoreTextFields(*snapshot.fields);
+    for (int i = 0; i < 3; i++)
+    {
+        restoreRegionText(*batchRegions[i], snapshot.regions[i]);
+    }
+
+    textState = snapshot.text;
+    colorState = snapshot.color;
+    effectState = snapshot.effect;
+    brightnessState.brightness = snapshot.brightness;
+    currentFontSize = snapshot.fontSize;
+    streamPlayback = snapshot.stream;
+    textState.needUpdate = true;
+}
+
+static void releaseSnapshot()
+{
+    releaseTextFields(*snapshot.fields);
+    for (int i = 0; i < 3; i++)
+    {
+        releaseRegionSnapshot(*batchRegions[i], snapshot.regions[i]);
+    }
+}
+
+// 批量中按ID文本引用的字形在应用期间固定在缓存中，同一批量中的字形定义不会淘汰它们
+static bool pinReferencedGlyphs(const BatchRecord *records, int recordCount)
+{
+    GlyphCache *caches[2] = {&glyphCache16, &glyphCache32};
+    const uint8_t fonts[2] = {BT_FONT_16x16, BT_FONT_32x32};
+    for (int i = 0; i < 2; i++)
+    {
+        uint16_t *ids = scratchArena.allocateArray<uint16_t>(caches[i]->getCapacity());
+        int count = ids ? collectPinnedGlyphIds(records, recordCount, fonts[i], ids, caches[i]->getCapacity()) : -1;
+        if (count < 0)
+            return false;
+        caches[i]->pin(ids, count);
+    }
+    return true;
+}
+
+static void sendBatchResponse(uint8_t status, uint8_t failedIndex)
+{
+    uint8_t response[2] = {status, failedIndex};
+    sendResponseFrame(BT_CMD_BATCH, response, sizeof(response));
+}
+
+// 处理批量命令 (0x0E)
+// 应答：[状态][序号]，成功时序号为已应用的子命令数，否则为出错的子命令；状态非0时场景与批量之前相同
+void handleBatchCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < BT_BATCH_RECORD_HEADER_LEN)
+    {
+        LOG_E("错误: 批量命令数据无效");
+        sendBatchResponse(BT_BATCH_STATUS_INVALID, 0);
+        return;
+    }
+
+    // 第一遍：拆分子命令并整体校验
+    BatchContext context;
+    context.fontSize = currentFontSize;
+    context.fontPackLoaded = fontPack.isLoaded();
+    context.cacheCapacity[0] = glyphCache16.getCapacity();
+    context.cacheCapacity[1] = glyphCache32.getCapacity();
+    context.tableCapacity[0] = glyphTable16.getCapacity();
+    context.tableCapacity[1] = glyphTable32.getCapacity();
+    context.isGlyphCached = isGlyphCached;
+
+    BatchRecord records[BT_BATCH_MAX_COMMANDS];
+    int failedIndex = 0;
+    int recordCount = parseBatch(frame.data, frame.dataLength, context, records, failedIndex);
+    if (recordCount < 0)
+    {
+        LOG_E("错误: 批量子命令校验失败，序号: %d", failedIndex);
+        sendBatchResponse(BT_BATCH_STATUS_INVALID, failedIndex);
+        return;
+    }
+
+    if (!pinReferencedGlyphs(records, recordCount) || !saveSnapshot())
+    {
+        glyphCache16.unpin();
+        glyphCache32.unpin();
+        LOG_E("错误: 临时分配区不足，批量命令未应用");
+        sendBatchResponse(BT_BATCH_STATUS_NO_MEMORY, 0);
+        return;
+    }
+
+    // 第二遍：依次应用，期间推迟即时刷新；任一子命令失败即停止
+    LOG_I("应用批量命令: %d条子命令", recordCount);
+    batchApplying = true;
+    batchFailed = false;
+    int applied = 0;
+    while (applied < recordCount && !batchFailed)
+    {
+        BluetoothFrame subFrame;
+        subFrame.command = records[applied].command;
+        subFrame.dataLength = records[applied].length;
+        subFrame.data = (uint8_t *)records[applied].data;
+        subFrame.isValid = true;
+        subFrame.timestamp = frame.timestamp;
+        processBluetoothCommand(subFrame);
+        applied++;
+    }
+    batchApplying = false;
+    glyphCache16.unpin();
+    glyphCache32.unpin();
+
+    if (batchFailed)
+    {
+        restoreSnapshot();
+        LOG_W("批量子命令应用失败，已回滚 - 序号: %d, 命令: 0x%02X", applied - 1, records[applied - 1].command);
+    }
+    else
+    {
+        releaseSnapshot();
+    }
+
+    // 只渲染一次：先画好新场景再切换亮度
+    updateTextDisplay();
+    updateBrightness();
+
+    if (batchFailed)
+        sendBatchResponse(BT_BATCH_STATUS_FAILED, applied - 1);
+    else
+        sendBatchResponse(BT_BATCH_STATUS_OK, recordCount);
+}
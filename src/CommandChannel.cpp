@@ -0,0 +1,115 @@
+#include "CommandChannel.h"
+#include "Log.h"
+
+static CommandChannel *activeChannel = nullptr;
+
+// 各通道的解析器共用一个帧缓冲区：一个通道处于帧中时其他通道暂不读取，数据留在各自传输的接收队列中
+alignas(4) static uint8_t sharedFrameBuffer[BluetoothProtocolParser::FRAME_BUFFER_SIZE];
+static CommandChannel *frameOwner = nullptr; // 正在使用帧缓冲区的通道（没有未完成的帧时为nullptr）
+
+CommandChannel *getActiveChannel()
+{
+    return activeChannel;
+}
+
+// 应答输出到当前通道
+static void writeActiveChannel(const uint8_t *data, size_t length)
+{
+    if (activeChannel)
+    {
+        activeChannel->getTransport().write(data, length);
+    }
+}
+
+CommandChannel::CommandChannel(Transport &transport, uint16_t flowWindow)
+    : transport(transport), parser(sharedFrameBuffer)
+{
+    flowControl = {flowWindow, false, 0, 0};
+}
+
+bool CommandChannel::begin()
+{
+    setResponseWriter(writeActiveChannel);
+    return transport.begin();
+}
+
+void CommandChannel::poll()
+{
+    // 另一通道的帧尚未收完：本通道不消费数据，流量控制额度也随之暂停发放
+    if (frameOwner && frameOwner != this)
+        return;
+
+    activeChannel = this;
+    frameOwner = this;
+
+    // 发送端中途停发（如断线）时不会再有字节到达，在这里按超时放弃该帧，帧缓冲区随之让出
+    if (parser.abandonIfTimedOut())
+    {
+        handleParseResult(ParseResult::FRAME_ERROR);
+    }
+
+    // 重同步产生的待重放字节必须先于新收到的字节处理
+    while (parser.hasPendingData() || transport.available() > 0)
+    {
+        ParseResult result;
+        if (parser.hasPendingData())
+        {
+            result = parser.parsePending(frame);
+        }
+        else
+        {
+            uint8_t receivedByte = (uint8_t)transport.read();
+            flowControlConsume(flowControl, 1); // 先计入已消费，开关流量控制的帧本身不计入新窗口
+            result = parser.parseByte(receivedByte, frame);
+        }
+
+        if (result != ParseResult::NEED_MORE_DATA)
+        {
+            handleParseResult(result);
+            flowControlPoll(flowControl, false);
+        }
+    }
+    flowControlPoll(flowControl, true); // 接收缓冲区已读空，发放剩余额度
+
+    if (parser.isIdle())
+        frameOwner = nullptr;
+    activeChannel = nullptr;
+}
+
+// 处理解析结果
+void CommandChannel::handleParseResult(ParseResult result)
+{
+    switch (result)
+    {
+    case ParseResult::FRAME_COMPLETE:
+        LOG_D("[%s] 收到完整帧 - 命令: 0x%02X, 数据长度: %d",
+              transport.getName(), frame.command, frame.dataLength);
+        processBluetoothCommand(frame);
+        parser.reset(); // 重置解析器准备下一帧
+        break;
+
+    case ParseResult::FRAME_ERROR:
+        LOG_E("[%s] 错误: 帧格式错误", transport.getName());
+        break;
+
+    case ParseResult::INVALID_COMMAND:
+        LOG_E("[%s] 错误: 无效命令", transport.getName());
+        break;
+
+    case ParseResult::DATA_TOO_LONG:
+        LOG_E("[%s] 错误: 数据过长", transport.getName());
+        break;
+
+    case ParseResult::INVALID_LENGTH:
+        LOG_E("[%s] 错误: 数据长度不符合命令要求", transport.getName());
+        break;
+
+    case ParseResult::NEED_MORE_DATA:
+        // 继续等待更多数据，无需处理
+        break;
+
+    default:
+        LOG_W("[%s] 未知解析结果: %d", transport.getName(), (int)result);
+        break;
+    }
+}
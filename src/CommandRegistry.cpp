@@ -0,0 +1,123 @@
+#include "CommandRegistry.h"
+#include "MemoryPool.h"
+#include "Log.h"
+
+static const CommandSpec *commandIndex[BT_CMD_LAST + 1] = {nullptr}; // 按命令码直接索引
+static const CommandSpec *registeredTable = nullptr;
+static size_t registeredCount = 0;
+static FeatureFilter featureFilter = nullptr;
+
+void registerCommandTable(const CommandSpec *table, size_t count)
+{
+    registeredTable = table;
+    registeredCount = count;
+    for (int command = 0; command <= BT_CMD_LAST; command++)
+    {
+        commandIndex[command] = nullptr;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (table[i].command <= BT_CMD_LAST)
+        {
+            commandIndex[table[i].command] = &table[i];
+        }
+        else
+        {
+            LOG_E("错误: 命令码0x%02X超出注册表范围", table[i].command);
+        }
+    }
+}
+
+const CommandSpec *findCommandSpec(uint8_t command)
+{
+    return command <= BT_CMD_LAST ? commandIndex[command] : nullptr;
+}
+
+bool isCommandLengthValid(const CommandSpec *spec, uint16_t length)
+{
+    if (!spec || length < spec->minLength)
+        return false;
+    return spec->maxLength == BT_CMD_LEN_UNLIMITED || length <= spec->maxLength;
+}
+
+// 处理蓝牙命令：按命令码查注册表分发（设备与主机回环共用）
+void processBluetoothCommand(const BluetoothFrame &frame)
+{
+    const CommandSpec *spec = findCommandSpec(frame.command);
+    if (!frame.isValid || spec == nullptr)
+    {
+        LOG_W("未支持的命令: 0x%02X", frame.command);
+        return;
+    }
+
+    // 解析器已检查过长度，这里覆盖分块传输、批量命令组装出的帧
+    if (!isCommandLengthValid(spec, frame.dataLength))
+    {
+        LOG_E("错误: %s命令数据长度无效 (%d字节)", spec->name, frame.dataLength);
+        return;
+    }
+
+    // 处理期间的临时缓冲（字体转换等）来自临时分配区，结束后整体回收；
+    // 批量、分块传输嵌套分发的子命令各自回收，仍保持先分配后回收的顺序
+    {
+        ArenaScope scratch(scratchArena);
+        spec->handler(frame);
+    }
+    frame.convertedData = nullptr;
+    frame.isConverted = false;
+}
+
+void setFeatureFilter(FeatureFilter filter)
+{
+    featureFilter = filter;
+}
+
+// 由已注册命令汇总特性；依赖运行时资源的特性（如字库）经过滤函数去掉，仅在资源可用时通告
+uint32_t getSupportedFeatures()
+{
+    uint32_t features = 0;
+    for (size_t i = 0; i < registeredCount; i++)
+    {
+        features |= registeredTable[i].feature;
+    }
+    return featureFilter ? featureFilter(features) : features;
+}
+
+// 处理能力查询命令 (0x10)
+// 应答：[协议版本][特性4字节][最大帧长2字节][命令数] + 每条命令 [命令码][最小长度2字节][最大长度2字节]
+void handleCapabilityCommand(const BluetoothFrame &)
+{
+    uint8_t response[8 + (BT_CMD_LAST + 1) * 5];
+    uint32_t features = getSupportedFeatures();
+    int length = 0;
+
+    response[length++] = BT_PROTOCOL_VERSION;
+    response[length++] = (uint8_t)(features >> 24);
+    response[length++] = (uint8_t)(features >> 16);
+    response[length++] = (uint8_t)(features >> 8);
+    response[length++] = (uint8_t)(features & 0xFF);
+    response[length++] = (uint8_t)(BT_MAX_FRAME_SIZE >> 8);
+    response[length++] = (uint8_t)(BT_MAX_FRAME_SIZE & 0xFF);
+
+    int countPos = length++;
+    uint8_t commandCount = 0;
+    for (int command = 0; command <= BT_CMD_LAST; command++)
+    {
+        const CommandSpec *spec = commandIndex[command];
+        if (!spec)
+            continue;
+        if (spec->feature && !(spec->feature & features))
+            continue;
+
+        response[length++] = spec->command;
+        response[length++] = (uint8_t)(spec->minLength >> 8);
+        response[length++] = (uint8_t)(spec->minLength & 0xFF);
+        response[length++] = (uint8_t)(spec->maxLength >> 8);
+        response[length++] = (uint8_t)(spec->maxLength & 0xFF);
+        commandCount++;
+    }
+    response[countPos] = commandCount;
+
+    LOG_I("能力查询 - 协议版本: %d, 特性: 0x%08X, 命令数: %d", BT_PROTOCOL_VERSION, features, commandCount);
+    sendResponseFrame(BT_CMD_CAPABILITIES, response, length);
+}
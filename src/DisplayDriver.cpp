@@ -22,6 +22,12 @@ extern struct ColorState
     bool needColorUpdate;
 } colorState;
 
+PanelTarget panelTarget = {nullptr, 0, 0}; // 离屏绘制目标（默认直接绘制到屏幕）
+
+#if SCENE_FIRST_FRAME
+uint16_t panelMirror[SCREEN_WIDTH * SCREEN_HEIGHT]; // 屏幕镜像（场景快照首帧）
+#endif
+
 // 渐变色组合结构
 struct GradientColors
 {
@@ -59,7 +65,7 @@ void drawChar16x16(int x, int y, const uint16_t *font_data, uint16_t color)
                 int py = y + row;
                 if (px >= 0 && px < PANEL_RES_X && py >= 0 && py < PANEL_RES_Y)
                 {
-                    dma_display->drawPixel(px, py, color);
+                    drawPanelPixel(px, py, color);
                 }
             }
         }
@@ -82,7 +88,7 @@ void drawChar16x16Vertical(int x, int y, const uint16_t *font_data, uint16_t col
                 int py = y + (15 - col); // 向左旋转后的Y坐标
                 if (px >= 0 && px < PANEL_RES_X && py >= 0 && py < PANEL_RES_Y)
                 {
-                    dma_display->drawPixel(px, py, color);
+                    drawPanelPixel(px, py, color);
                 }
             }
         }
@@ -106,7 +112,7 @@ void drawChar16x16Gradient(int x, int y, const uint16_t *font_data, bool isUpper
                 {
                     // 根据像素位置获取渐变色
                     uint16_t color = getGradientColor(px, py, isUpper, gradientMode);
-                    dma_display->drawPixel(px, py, color);
+                    drawPanelPixel(px, py, color);
                 }
             }
         }
@@ -131,66 +137,66 @@ void drawChar16x16VerticalGradient(int x, int y, const uint16_t *font_data, bool
                 {
                     // 根据旋转后的像素位置获取渐变色
                     uint16_t color = getGradientColor(px, py, isUpper, gradientMode);
-                    dma_display->drawPixel(px, py, color);
+                    drawPanelPixel(px, py, color);
                 }
             }
         }
     }
 }
 
-void drawString16x16(int x, int y, const uint16_t *font_array, int char_count, uint16_t color)
+void drawString16x16(int x, int y, const GlyphText &text, uint16_t color)
 {
     int pos_x = x;
 
     // 遍历每个字符的字库数据
-    for (int i = 0; i < char_count; i++)
+    for (int i = 0; i < text.count; i++)
     {
-        // 每个字符占用16个uint16_t
-        const uint16_t *char_data = &font_array[i * 16];
+        // 经字形序号取得点阵（每个字符16个uint16_t）
+        const uint16_t *char_data = text.at(i);
         drawChar16x16(pos_x, y, char_data, color);
         pos_x += CHAR_SPACING_16; // 移动到下一个字符位置
     }
 }
 
-void drawString16x16Gradient(int x, int y, const uint16_t *font_array, int char_count, bool isUpper, uint8_t gradientMode)
+void drawString16x16Gradient(int x, int y, const GlyphText &text, bool isUpper, uint8_t gradientMode)
 {
     int pos_x = x;
 
     // 遍历每个字符的字库数据
-    for (int i = 0; i < char_count; i++)
+    for (int i = 0; i < text.count; i++)
     {
-        // 每个字符占用16个uint16_t
-        const uint16_t *char_data = &font_array[i * 16];
+        // 经字形序号取得点阵（每个字符16个uint16_t）
+        const uint16_t *char_data = text.at(i);
         drawChar16x16Gradient(pos_x, y, char_data, isUpper, gradientMode);
         pos_x += CHAR_SPACING_16; // 移动到下一个字符位置
     }
 }
 
 // 竖向显示字符串
-void drawString16x16Vertical(int x, int y, const uint16_t *font_array, int char_count, uint16_t color)
+void drawString16x16Vertical(int x, int y, const GlyphText &text, uint16_t color)
 {
     int pos_x = x;
 
     // 遍历每个字符的字库数据，向左旋转后从左到右排列
-    for (int i = 0; i < char_count; i++)
+    for (int i = 0; i < text.count; i++)
     {
-        // 每个字符占用16个uint16_t
-        const uint16_t *char_data = &font_array[i * 16];
+        // 经字形序号取得点阵（每个字符16个uint16_t）
+        const uint16_t *char_data = text.at(i);
         drawChar16x16Vertical(pos_x, y, char_data, color);
         pos_x += CHAR_SPACING_16; // 水平移动到下一个字符位置
     }
 }
 
 // 竖向渐变字符串
-void drawString16x16VerticalGradient(int x, int y, const uint16_t *font_array, int char_count, bool isUpper, uint8_t gradientMode)
+void drawString16x16VerticalGradient(int x, int y, const GlyphText &text, bool isUpper, uint8_t gradientMode)
 {
     int pos_x = x;
 
     // 遍历每个字符的字库数据，向左旋转后从左到右排列
-    for (int i = 0; i < char_count; i++)
+    for (int i = 0; i < text.count; i++)
     {
-        // 每个字符占用16个uint16_t
-        const uint16_t *char_data = &font_array[i * 16];
+        // 经字形序号取得点阵（每个字符16个uint16_t）
+        const uint16_t *char_data = text.at(i);
         drawChar16x16VerticalGradient(pos_x, y, char_data, isUpper, gradientMode);
         pos_x += CHAR_SPACING_16; // 水平移动到下一个字符位置
     }
@@ -288,7 +294,7 @@ void drawChar32x32(int x, int y, const uint16_t *font_data, uint16_t color)
                 int py = y + row;
                 if (px >= 0 && px < PANEL_RES_X && py >= 0 && py < PANEL_RES_Y)
                 {
-                    dma_display->drawPixel(px, py, color);
+                    drawPanelPixel(px, py, color);
                 }
             }
         }
@@ -323,7 +329,7 @@ void drawChar32x32Vertical(int x, int y, const uint16_t *font_data, uint16_t col
                 int py = y + (31 - col);
                 if (px >= 0 && px < PANEL_RES_X && py >= 0 && py < PANEL_RES_Y)
                 {
-                    dma_display->drawPixel(px, py, color);
+                    drawPanelPixel(px, py, color);
                 }
             }
         }
@@ -331,21 +337,21 @@ void drawChar32x32Vertical(int x, int y, const uint16_t *font_data, uint16_t col
 }
 
 // 32x32字符串显示函数
-void drawString32x32(int x, int y, const uint16_t *font_array, int char_count, uint16_t color)
+void drawString32x32(int x, int y, const GlyphText &text, uint16_t color)
 {
-    for (int i = 0; i < char_count; i++)
+    for (int i = 0; i < text.count; i++)
     {
-        const uint16_t *char_data = font_array + (i * 64); // 每个32x32字符64个uint16_t
+        const uint16_t *char_data = text.at(i); // 每个32x32字符64个uint16_t
         drawChar32x32(x + i * CHAR_SPACING_32, y, char_data, color);
     }
 }
 
 // 32x32竖向字符串显示函数
-void drawString32x32Vertical(int x, int y, const uint16_t *font_array, int char_count, uint16_t color)
+void drawString32x32Vertical(int x, int y, const GlyphText &text, uint16_t color)
 {
-    for (int i = 0; i < char_count; i++)
+    for (int i = 0; i < text.count; i++)
     {
-        const uint16_t *char_data = font_array + (i * 64); // 每个32x32字符64个uint16_t
+        const uint16_t *char_data = text.at(i); // 每个32x32字符64个uint16_t
         drawChar32x32Vertical(x + i * CHAR_SPACING_32, y, char_data, color);
     }
 }
@@ -379,7 +385,7 @@ void drawChar32x32Gradient(int x, int y, const uint16_t *font_data, uint8_t grad
                 {
                     // 根据像素位置获取32x32渐变色
                     uint16_t color = getGradientColor32x32(px, py, gradientMode);
-                    dma_display->drawPixel(px, py, color);
+                    drawPanelPixel(px, py, color);
                 }
             }
         }
@@ -416,7 +422,7 @@ void drawChar32x32VerticalGradient(int x, int y, const uint16_t *font_data, uint
                 {
                     // 根据旋转后的像素位置获取32x32渐变色
                     uint16_t color = getGradientColor32x32(px, py, gradientMode);
-                    dma_display->drawPixel(px, py, color);
+                    drawPanelPixel(px, py, color);
                 }
             }
         }
@@ -424,21 +430,21 @@ void drawChar32x32VerticalGradient(int x, int y, const uint16_t *font_data, uint
 }
 
 // 32x32字符串渐变色显示函数
-void drawString32x32Gradient(int x, int y, const uint16_t *font_array, int char_count, uint8_t gradientMode)
+void drawString32x32Gradient(int x, int y, const GlyphText &text, uint8_t gradientMode)
 {
-    for (int i = 0; i < char_count; i++)
+    for (int i = 0; i < text.count; i++)
     {
-        const uint16_t *char_data = font_array + (i * 64); // 每个32x32字符64个uint16_t
+        const uint16_t *char_data = text.at(i); // 每个32x32字符64个uint16_t
         drawChar32x32Gradient(x + i * CHAR_SPACING_32, y, char_data, gradientMode);
     }
 }
 
 // 32x32竖向字符串渐变色显示函数
-void drawString32x32VerticalGradient(int x, int y, const uint16_t *font_array, int char_count, uint8_t gradientMode)
+void drawString32x32VerticalGradient(int x, int y, const GlyphText &text, uint8_t gradientMode)
 {
-    for (int i = 0; i < char_count; i++)
+    for (int i = 0; i < text.count; i++)
     {
-        const uint16_t *char_data = font_array + (i * 64); // 每个32x32字符64个uint16_t
+        const uint16_t *char_data = text.at(i); // 每个32x32字符64个uint16_t
         drawChar32x32VerticalGradient(x + i * CHAR_SPACING_32, y, char_data, gradientMode);
     }
 }
@@ -0,0 +1,57 @@
+#include "FlowControl.h"
+#include "Log.h"
+
+// 额度应答：[开关][窗口2字节][累计已消费4字节]，高字节在前
+static void sendCreditGrant(FlowControlState &state)
+{
+    uint32_t consumed = state.consumedBytes;
+    uint8_t response[7] = {(uint8_t)(state.enabled ? FLOW_CONTROL_ON : FLOW_CONTROL_OFF),
+                           (uint8_t)(state.window >> 8), (uint8_t)(state.window & 0xFF),
+                           (uint8_t)(consumed >> 24), (uint8_t)(consumed >> 16),
+                           (uint8_t)(consumed >> 8), (uint8_t)(consumed & 0xFF)};
+    sendResponseFrame(BT_CMD_FLOW_CONTROL, response, sizeof(response));
+    state.grantedBytes = consumed;
+}
+
+void flowControlConsume(FlowControlState &state, size_t count)
+{
+    if (state.enabled)
+    {
+        state.consumedBytes += count;
+    }
+}
+
+// 未通告的消费量达到阈值，或接收队列已读空（避免客户端等待最后一点额度）时发放
+void flowControlPoll(FlowControlState &state, bool queueEmpty)
+{
+    if (!state.enabled)
+        return;
+
+    uint32_t pending = state.consumedBytes - state.grantedBytes;
+    if (pending >= FLOW_CREDIT_THRESHOLD || (queueEmpty && pending > 0))
+    {
+        sendCreditGrant(state);
+    }
+}
+
+// 处理流量控制命令 (0x0F)：[开关]，空数据表示查询当前额度
+void handleFlowControlCommand(const BluetoothFrame &frame, FlowControlState &state)
+{
+    if (frame.isValid && frame.data != nullptr && frame.dataLength >= 1)
+    {
+        uint8_t mode = frame.data[0];
+        if (mode != FLOW_CONTROL_OFF && mode != FLOW_CONTROL_ON)
+        {
+            LOG_E("错误: 无效的流量控制参数 0x%02X", mode);
+            return;
+        }
+
+        // 开关时计数清零，客户端从收到本应答起重新计算已发送字节
+        state.enabled = (mode == FLOW_CONTROL_ON);
+        state.consumedBytes = 0;
+        state.grantedBytes = 0;
+        LOG_I("流量控制已%s，窗口: %d字节", state.enabled ? "开启" : "关闭", state.window);
+    }
+
+    sendCreditGrant(state);
+}
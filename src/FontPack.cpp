@@ -0,0 +1,224 @@
+#include "FontPack.h"
+#include <string.h>
+
+FontPack fontPack;
+
+// 小端读取辅助函数
+static uint16_t readLE16(const uint8_t *p)
+{
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static uint32_t readLE32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+FontPack::FontPack() : image(nullptr), imageSize(0), sectionCount(0), loaded(false) {}
+
+bool FontPack::readBytes(uint32_t offset, void *dest, size_t length) const
+{
+    if (!image)
+        return store.read(offset, dest, length);
+    if (offset > imageSize || length > imageSize - offset)
+        return false;
+    memcpy(dest, image + offset, length); // 内置映像位于Flash只读段，经Cache原地读取
+    return true;
+}
+
+bool FontPack::begin(const char *label)
+{
+    loaded = false;
+    sectionCount = 0;
+    image = nullptr;
+
+    if (store.open(label) && loadHeader())
+        return true;
+
+#if FONT_PACK_BUILTIN
+    return beginImage(builtinFontPack, builtinFontPackSize);
+#else
+    return false;
+#endif
+}
+
+bool FontPack::beginImage(const uint8_t *data, uint32_t size)
+{
+    loaded = false;
+    sectionCount = 0;
+    image = data;
+    imageSize = size;
+
+    if (!image || !loadHeader())
+    {
+        image = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool FontPack::loadHeader()
+{
+    uint8_t header[8];
+    if (!readBytes(0, header, sizeof(header)))
+        return false;
+    if (readLE32(header) != FONT_PACK_MAGIC || readLE16(header + 4) != FONT_PACK_VERSION)
+        return false;
+
+    uint16_t count = readLE16(header + 6);
+    if (count > FONT_PACK_MAX_SECTIONS)
+        count = FONT_PACK_MAX_SECTIONS;
+
+    for (int i = 0; i < count; i++)
+    {
+        uint8_t entry[16];
+        if (!readBytes(8 + i * 16, entry, sizeof(entry)))
+            return false;
+
+        FontPackSection &section = sections[sectionCount];
+        section.glyphSize = entry[0];
+        section.glyphCount = readLE32(entry + 4);
+        section.indexOffset = readLE32(entry + 8);
+        section.bitmapOffset = readLE32(entry + 12);
+        if (section.glyphSize == FONT_WIDTH_16 || section.glyphSize == FONT_WIDTH_32)
+        {
+            sectionCount++;
+        }
+    }
+
+    loaded = sectionCount > 0;
+    return loaded;
+}
+
+const FontPackSection *FontPack::findSection(uint8_t fontSize) const
+{
+    uint8_t glyphSize = (fontSize == BT_FONT_32x32) ? FONT_WIDTH_32 : FONT_WIDTH_16;
+    for (int i = 0; i < sectionCount; i++)
+    {
+        if (sections[i].glyphSize == glyphSize)
+        {
+            return &sections[i];
+        }
+    }
+    return nullptr;
+}
+
+uint32_t FontPack::getGlyphCount(uint8_t fontSize) const
+{
+    const FontPackSection *section = findSection(fontSize);
+    return section ? section->glyphCount : 0;
+}
+
+// 在有序码位索引中二分查找，直接读取Flash（分区或内置映像），不占用RAM
+int32_t FontPack::findIndex(const FontPackSection &section, uint32_t codepoint) const
+{
+    int32_t low = 0;
+    int32_t high = (int32_t)section.glyphCount - 1;
+    while (low <= high)
+    {
+        int32_t mid = low + (high - low) / 2;
+        uint8_t raw[4];
+        if (!readBytes(section.indexOffset + mid * 4, raw, sizeof(raw)))
+            return -1;
+
+        uint32_t value = readLE32(raw);
+        if (value == codepoint)
+            return mid;
+        if (value < codepoint)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+}
+
+bool FontPack::readGlyph(uint8_t fontSize, uint32_t codepoint, uint16_t *dest) const
+{
+    if (!loaded || !dest)
+        return false;
+
+    const FontPackSection *section = findSection(fontSize);
+    if (!section)
+        return false;
+
+    int32_t index = findIndex(*section, codepoint);
+    if (index < 0)
+        return false;
+
+    int glyphBytes = (section->glyphSize == FONT_WIDTH_32) ? FONT_BYTES_32 : FONT_BYTES_16;
+    uint8_t raw[FONT_BYTES_32];
+    if (!readBytes(section->bitmapOffset + (uint32_t)index * glyphBytes, raw, glyphBytes))
+        return false;
+
+    // 按字节顺序组合 0x12,0x34 -> 0x1234（与文本命令一致）
+    for (int i = 0; i < glyphBytes / 2; i++)
+    {
+        dest[i] = ((uint16_t)raw[i * 2] << 8) | raw[i * 2 + 1];
+    }
+    return true;
+}
+
+// 非法序列（非法首字节、续字节缺失或不足、超长编码、代理区码位、超出U+10FFFF）替换为一个U+FFFD：
+// 续字节不足时只吞掉已读到的有效前缀，其后的字节重新按首字节解析，不会连带吞掉后面的正常字符
+int decodeUtf8(const uint8_t *text, size_t length, uint32_t *codepoints, int maxCodepoints)
+{
+    static const uint32_t minCodepoint[4] = {0, 0x80, 0x800, 0x10000}; // 各长度的最小码位，小于它即为超长编码
+
+    int count = 0;
+    size_t i = 0;
+    while (i < length && count < maxCodepoints)
+    {
+        uint8_t lead = text[i];
+        uint32_t codepoint;
+        int extra;
+
+        if (lead < 0x80)
+        {
+            codepoint = lead;
+            extra = 0;
+        }
+        else if ((lead & 0xE0) == 0xC0)
+        {
+            codepoint = lead & 0x1F;
+            extra = 1;
+        }
+        else if ((lead & 0xF0) == 0xE0)
+        {
+            codepoint = lead & 0x0F;
+            extra = 2;
+        }
+        else if ((lead & 0xF8) == 0xF0)
+        {
+            codepoint = lead & 0x07;
+            extra = 3;
+        }
+        else
+        {
+            codepoints[count++] = 0xFFFD; // 非法首字节
+            i++;
+            continue;
+        }
+
+        int consumed = 1;
+        while (consumed <= extra && i + consumed < length && (text[i + consumed] & 0xC0) == 0x80)
+        {
+            codepoint = (codepoint << 6) | (text[i + consumed] & 0x3F);
+            consumed++;
+        }
+
+        if (consumed <= extra)
+        {
+            codepoints[count++] = 0xFFFD; // 序列被截断或续字节非法
+        }
+        else if (codepoint < minCodepoint[extra] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+        {
+            codepoints[count++] = 0xFFFD; // 超长编码或非法码位
+        }
+        else
+        {
+            codepoints[count++] = codepoint;
+        }
+        i += consumed;
+    }
+    return count;
+}
@@ -0,0 +1,329 @@
+#include "GlyphCache.h"
+#include "LEDController.h"
+#include "MemoryPool.h"
+#include "CommandBatch.h"
+#include "Log.h"
+
+static_assert(GLYPH_CACHE_CAPACITY_16 * (FONT_BYTES_16 + 6) + GLYPH_CACHE_CAPACITY_32 * (FONT_BYTES_32 + 6) <= BOOT_ARENA_BYTES,
+              "启动期分配区容纳不下字形缓存");
+
+// ==================== 全局缓存实例 ====================
+GlyphCache glyphCache16(GLYPH_CACHE_CAPACITY_16, FONT_BYTES_16 / 2);
+GlyphCache glyphCache32(GLYPH_CACHE_CAPACITY_32, FONT_BYTES_32 / 2);
+
+GlyphCache::GlyphCache(uint16_t capacity, uint16_t wordsPerGlyph)
+    : capacity(capacity), wordsPerGlyph(wordsPerGlyph), pinnedIds(nullptr), pinnedCount(0)
+{
+    // 缓存随程序常驻，从启动期分配区取得存储，不经过堆
+    lastUsed = bootArena.allocateArray<uint32_t>(capacity);
+    glyphData = bootArena.allocateArray<uint16_t>(capacity * wordsPerGlyph);
+    glyphIds = bootArena.allocateArray<uint16_t>(capacity);
+    if (!lastUsed || !glyphData || !glyphIds)
+    {
+        this->capacity = 0; // 分配区不足时缓存不可用，按全部未命中处理
+    }
+    clear();
+}
+
+void GlyphCache::clear()
+{
+    for (int i = 0; i < capacity; i++)
+    {
+        lastUsed[i] = 0;
+    }
+    usedCount = 0;
+    useClock = 0;
+    evictCount = 0;
+}
+
+// 查找ID所在槽位，不存在返回-1
+int GlyphCache::findSlot(uint16_t id) const
+{
+    for (int i = 0; i < capacity; i++)
+    {
+        if (lastUsed[i] != 0 && glyphIds[i] == id)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void GlyphCache::pin(const uint16_t *ids, int count)
+{
+    pinnedIds = ids;
+    pinnedCount = ids ? count : 0;
+}
+
+bool GlyphCache::isPinned(uint16_t id) const
+{
+    int low = 0;
+    int high = pinnedCount - 1;
+    while (low <= high)
+    {
+        int mid = (low + high) / 2;
+        if (pinnedIds[mid] == id)
+            return true;
+        if (pinnedIds[mid] < id)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return false;
+}
+
+// 写入字形：已存在则覆盖，否则占用空槽，满时淘汰最久未使用且未固定的槽位
+bool GlyphCache::store(uint16_t id, const uint8_t *bitmapBytes)
+{
+    if (!bitmapBytes || capacity == 0)
+        return false;
+
+    int slot = findSlot(id);
+    if (slot < 0)
+    {
+        uint32_t oldest = UINT32_MAX;
+        for (int i = 0; i < capacity; i++)
+        {
+            if (lastUsed[i] == 0)
+            {
+                slot = i;
+                break;
+            }
+            if (lastUsed[i] < oldest && !isPinned(glyphIds[i]))
+            {
+                oldest = lastUsed[i];
+                slot = i;
+            }
+        }
+        if (slot < 0)
+        {
+            LOG_W("字形缓存槽位均已固定，字形ID %d未写入", id);
+            return false;
+        }
+
+        if (lastUsed[slot] == 0)
+        {
+            usedCount++;
+        }
+        else
+        {
+            evictCount++;
+        }
+        glyphIds[slot] = id;
+    }
+
+    // 按字节顺序组合 0x12,0x34 -> 0x1234（与文本命令一致）
+    uint16_t *dest = glyphData + slot * wordsPerGlyph;
+    for (int i = 0; i < wordsPerGlyph; i++)
+    {
+        dest[i] = ((uint16_t)bitmapBytes[i * 2] << 8) | bitmapBytes[i * 2 + 1];
+    }
+    lastUsed[slot] = ++useClock;
+    return true;
+}
+
+int GlyphCache::lookupSlot(uint16_t id)
+{
+    int slot = findSlot(id);
+    if (slot >= 0)
+        lastUsed[slot] = ++useClock;
+    return slot;
+}
+
+const uint16_t *GlyphCache::lookup(uint16_t id)
+{
+    int slot = lookupSlot(id);
+    return slot >= 0 ? glyphData + slot * wordsPerGlyph : nullptr;
+}
+
+// 统计ID列表中不同ID的个数（列表长度受区域容量限制，逐个回查即可）
+int countDistinctGlyphIds(const uint8_t *idBytes, int count)
+{
+    int distinct = 0;
+    for (int i = 0; i < count; i++)
+    {
+        uint16_t id = ((uint16_t)idBytes[i * 2] << 8) | idBytes[i * 2 + 1];
+        bool seen = false;
+        for (int j = 0; j < i && !seen; j++)
+        {
+            seen = (((uint16_t)idBytes[j * 2] << 8) | idBytes[j * 2 + 1]) == id;
+        }
+        if (!seen)
+            distinct++;
+    }
+    return distinct;
+}
+
+// ==================== 命令处理函数 ====================
+// 处理字形定义命令 (0x09)
+// 数据格式：重复若干条 [字体大小][ID高][ID低][点阵数据32或128字节]
+void handleGlyphDefineCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 1 + BT_GLYPH_ID_LEN)
+    {
+        LOG_E("错误: 字形定义数据无效");
+        return;
+    }
+
+    int offset = 0;
+    int storedCount = 0;
+    while (offset < frame.dataLength)
+    {
+        uint8_t fontSize = frame.data[offset];
+        int glyphBytes = (fontSize == BT_FONT_32x32) ? FONT_BYTES_32 : FONT_BYTES_16;
+        int recordLength = 1 + BT_GLYPH_ID_LEN + glyphBytes;
+
+        if (fontSize != BT_FONT_16x16 && fontSize != BT_FONT_32x32)
+        {
+            LOG_E("错误: 字形定义字体大小无效 0x%02X", fontSize);
+            markBatchFailed();
+            break;
+        }
+        if (offset + recordLength > frame.dataLength)
+        {
+            LOG_E("错误: 字形定义数据截断，偏移: %d", offset);
+            markBatchFailed();
+            break;
+        }
+
+        uint16_t id = ((uint16_t)frame.data[offset + 1] << 8) | frame.data[offset + 2];
+        GlyphCache &cache = (fontSize == BT_FONT_32x32) ? glyphCache32 : glyphCache16;
+        if (cache.store(id, frame.data + offset + 1 + BT_GLYPH_ID_LEN))
+        {
+            storedCount++;
+        }
+        else
+        {
+            markBatchFailed();
+        }
+        offset += recordLength;
+    }
+
+    LOG_I("字形缓存已更新: %d个字形, 16x16缓存 %d/%d, 32x32缓存 %d/%d",
+          storedCount,
+          glyphCache16.getUsedCount(), glyphCache16.getCapacity(),
+          glyphCache32.getUsedCount(), glyphCache32.getCapacity());
+}
+
+// 处理按ID设置文本命令 (0x0A)
+// 数据格式：[屏幕区域][ID1高][ID1低][ID2高][ID2低]...
+// ID列表长度为奇数时应答：[状态=0x03]
+// 去重后的ID数超过缓存容量时（补发也无法同时缓存）应答：[状态=0x02][ID数高][ID数低][容量高][容量低]
+// 若有字形未缓存，则不更新显示，应答缺失ID列表：[状态=0x01][缺失数高][缺失数低][ID...]
+// 全部命中时应用文本并应答：[状态=0x00]
+// 超出区域容量的字符不会显示，也不参与以上检查
+void handleTextByIdCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 1 + BT_GLYPH_ID_LEN)
+    {
+        LOG_E("错误: 按ID文本数据无效");
+        return;
+    }
+
+    if ((frame.dataLength - 1) % BT_GLYPH_ID_LEN != 0)
+    {
+        LOG_E("错误: 按ID文本ID列表长度为奇数: %d", frame.dataLength - 1);
+        markBatchFailed();
+        uint8_t status = BT_GLYPH_STATUS_INVALID;
+        sendResponseFrame(BT_CMD_SET_TEXT_BY_ID, &status, 1);
+        return;
+    }
+
+    uint8_t screenArea = frame.data[0];
+    int charCount = (frame.dataLength - 1) / BT_GLYPH_ID_LEN;
+    const uint8_t *idBytes = frame.data + 1;
+    GlyphCache &cache = (currentFontSize == BT_FONT_32x32) ? glyphCache32 : glyphCache16;
+
+    if (charCount > getTextRegionCapacity(screenArea))
+        charCount = getTextRegionCapacity(screenArea);
+
+    // 不同ID多于缓存容量时，补发后面的字形会淘汰前面的，客户端将反复补发，直接拒绝
+    int distinctCount = countDistinctGlyphIds(idBytes, charCount);
+    if (distinctCount > cache.getCapacity())
+    {
+        uint8_t response[5] = {BT_GLYPH_STATUS_TOO_MANY,
+                               (uint8_t)(distinctCount >> 8), (uint8_t)(distinctCount & 0xFF),
+                               (uint8_t)(cache.getCapacity() >> 8), (uint8_t)(cache.getCapacity() & 0xFF)};
+        sendResponseFrame(BT_CMD_SET_TEXT_BY_ID, response, sizeof(response));
+        LOG_W("按ID文本: %d个不同字形超过缓存容量%d", distinctCount, cache.getCapacity());
+        markBatchFailed();
+        return;
+    }
+
+    // 第一遍：统计缺失ID
+    int missingCount = 0;
+    for (int i = 0; i < charCount; i++)
+    {
+        uint16_t id = ((uint16_t)idBytes[i * 2] << 8) | idBytes[i * 2 + 1];
+        if (!cache.contains(id))
+        {
+            missingCount++;
+        }
+    }
+
+    if (missingCount > 0)
+    {
+        // 生成去重后的缺失ID列表
+        uint8_t *response = scratchArena.allocateArray<uint8_t>(3 + missingCount * BT_GLYPH_ID_LEN);
+        if (!response)
+        {
+            LOG_E("错误: 缺失列表内存分配失败");
+            markBatchFailed();
+            return;
+        }
+
+        int listed = 0;
+        for (int i = 0; i < charCount; i++)
+        {
+            uint16_t id = ((uint16_t)idBytes[i * 2] << 8) | idBytes[i * 2 + 1];
+            if (cache.contains(id))
+                continue;
+
+            bool duplicated = false;
+            for (int j = 0; j < listed; j++)
+            {
+                if (((uint16_t)response[3 + j * 2] << 8 | response[4 + j * 2]) == id)
+                {
+                    duplicated = true;
+                    break;
+                }
+            }
+            if (!duplicated)
+            {
+                response[3 + listed * 2] = id >> 8;
+                response[4 + listed * 2] = id & 0xFF;
+                listed++;
+            }
+        }
+
+        response[0] = BT_GLYPH_STATUS_MISSING;
+        response[1] = listed >> 8;
+        response[2] = listed & 0xFF;
+        sendResponseFrame(BT_CMD_SET_TEXT_BY_ID, response, 3 + listed * BT_GLYPH_ID_LEN);
+
+        LOG_I("按ID文本: %d个字形未缓存，已请求客户端补发", listed);
+        markBatchFailed();
+        return;
+    }
+
+    // 第二遍：所有字形均已缓存，直接以缓存槽位作为字形序号，无需展开点阵
+    uint16_t *slots = scratchArena.allocateArray<uint16_t>(charCount);
+    if (!slots)
+    {
+        LOG_E("错误: 按ID文本内存分配失败");
+        markBatchFailed();
+        return;
+    }
+
+    for (int i = 0; i < charCount; i++)
+    {
+        uint16_t id = ((uint16_t)idBytes[i * 2] << 8) | idBytes[i * 2 + 1];
+        slots[i] = cache.lookupSlot(id);
+    }
+
+    LOG_I("按ID文本 - 屏幕区域: 0x%02X, 字符数: %d", screenArea, charCount);
+    applyTextGlyphs(screenArea, GlyphText(cache.getGlyphData(), slots, charCount, cache.getWordsPerGlyph()));
+
+    uint8_t status = BT_GLYPH_STATUS_OK;
+    sendResponseFrame(BT_CMD_SET_TEXT_BY_ID, &status, 1);
+}
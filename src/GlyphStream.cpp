@@ -0,0 +1,185 @@
+#include "GlyphStream.h"
+#include "MemoryPool.h"
+#include "Log.h"
+#include <string.h>
+
+// 小端读写辅助函数
+static uint32_t readLE32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void writeLE32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static int getGlyphBytes(uint8_t glyphSize)
+{
+    return (glyphSize == FONT_WIDTH_32) ? FONT_BYTES_32 : FONT_BYTES_16;
+}
+
+// ==================== 流式文本 ====================
+GlyphStream::GlyphStream()
+    : window(nullptr), windowStart(0), windowCount(0), glyphSize(FONT_WIDTH_16), charCount(0), windowLoads(0),
+      uploading(false), uploadGlyphSize(FONT_WIDTH_16), uploadBytes(0), uploadOffset(0), erasedEnd(0) {}
+
+bool GlyphStream::begin(const char *label)
+{
+    charCount = 0;
+    windowCount = 0;
+    if (!window)
+        window = (uint16_t *)streamWindowBuffer.acquire(STREAM_WINDOW_BYTES);
+    if (!window || !store.open(label))
+        return false;
+    return loadHeader();
+}
+
+uint32_t GlyphStream::getCapacity() const
+{
+    return store.size();
+}
+
+bool GlyphStream::loadHeader()
+{
+    charCount = 0;
+    windowCount = 0;
+
+    uint8_t header[STREAM_HEADER_SIZE];
+    if (!store.read(0, header, sizeof(header)))
+        return false;
+    if (readLE32(header) != STREAM_MAGIC || (header[4] | (header[5] << 8)) != STREAM_VERSION)
+        return false;
+    if (header[6] != FONT_WIDTH_16 && header[6] != FONT_WIDTH_32)
+        return false;
+
+    uint32_t count = readLE32(header + 8);
+    if (STREAM_HEADER_SIZE + (uint64_t)count * getGlyphBytes(header[6]) > getCapacity())
+        return false;
+
+    glyphSize = header[6];
+    charCount = count;
+    return true;
+}
+
+// 从start起装满窗口，点阵按协议字节序存放，读入后原地转换为显示用的uint16_t
+bool GlyphStream::loadWindow(uint32_t start)
+{
+    int glyphBytes = getGlyphBytes(glyphSize);
+    int capacity = STREAM_WINDOW_BYTES / glyphBytes;
+    int count = (charCount - start < (uint32_t)capacity) ? (int)(charCount - start) : capacity;
+
+    uint8_t *bytes = (uint8_t *)window;
+    if (!store.read(STREAM_HEADER_SIZE + start * glyphBytes, bytes, count * glyphBytes))
+    {
+        windowCount = 0;
+        LOG_E("错误: 流式文本读取失败 - 起始: %u字符", start);
+        return false;
+    }
+    for (int i = 0; i < count * glyphBytes / 2; i++)
+    {
+        window[i] = ((uint16_t)bytes[i * 2] << 8) | bytes[i * 2 + 1];
+    }
+
+    windowStart = start;
+    windowCount = count;
+    windowLoads++;
+    return true;
+}
+
+GlyphText GlyphStream::fetch(uint32_t first, int count)
+{
+    int wordsPerGlyph = getGlyphBytes(glyphSize) / 2;
+    int capacity = STREAM_WINDOW_BYTES / (wordsPerGlyph * 2);
+    if (!window || first >= charCount || count <= 0)
+        return GlyphText();
+    if (count > capacity)
+        count = capacity;
+    if (first + count > charCount)
+        count = charCount - first;
+
+    bool inWindow = windowCount > 0 && first >= windowStart && first + count <= windowStart + windowCount;
+    if (!inWindow)
+    {
+        // 向前滚动时窗口从first开始读前；向后（右滚动）时让first落在窗口末尾
+        uint32_t start = first;
+        if (windowCount > 0 && first < windowStart)
+            start = (first + count > (uint32_t)capacity) ? first + count - capacity : 0;
+        if (!loadWindow(start))
+            return GlyphText();
+    }
+
+    return GlyphText(window + (first - windowStart) * wordsPerGlyph, count, wordsPerGlyph);
+}
+
+// ==================== 上传 ====================
+uint8_t GlyphStream::beginUpload(uint8_t size, uint32_t count)
+{
+    if (!store.isOpen() || count == 0)
+        return BT_STREAM_STATUS_INVALID;
+    uint64_t total = STREAM_HEADER_SIZE + (uint64_t)count * getGlyphBytes(size);
+    if (total > getCapacity())
+        return BT_STREAM_STATUS_TOO_LARGE;
+
+    // 先擦除文件头所在扇区，旧文本立即失效
+    uploading = false;
+    charCount = 0;
+    windowCount = 0;
+    if (!store.erase(0, PARTITION_SECTOR_SIZE))
+        return BT_STREAM_STATUS_FLASH;
+
+    uploading = true;
+    uploadGlyphSize = size;
+    uploadBytes = count * getGlyphBytes(size);
+    uploadOffset = 0;
+    erasedEnd = PARTITION_SECTOR_SIZE;
+    return BT_STREAM_STATUS_OK;
+}
+
+uint8_t GlyphStream::writeUpload(uint32_t offset, const uint8_t *data, size_t length)
+{
+    if (!uploading)
+        return BT_STREAM_STATUS_INVALID;
+    if (offset != uploadOffset)
+        return BT_STREAM_STATUS_OFFSET;
+    if (uploadOffset + length > uploadBytes)
+        return BT_STREAM_STATUS_TOO_LARGE;
+
+    // 扇区在写入前才擦除，每条数据帧只擦除它覆盖到的新扇区
+    uint32_t end = STREAM_HEADER_SIZE + offset + length;
+    while (erasedEnd < end)
+    {
+        if (!store.erase(erasedEnd, PARTITION_SECTOR_SIZE))
+            return BT_STREAM_STATUS_FLASH;
+        erasedEnd += PARTITION_SECTOR_SIZE;
+    }
+    if (!store.write(STREAM_HEADER_SIZE + offset, data, length))
+        return BT_STREAM_STATUS_FLASH;
+
+    uploadOffset += length;
+    return BT_STREAM_STATUS_OK;
+}
+
+uint8_t GlyphStream::endUpload()
+{
+    if (!uploading)
+        return BT_STREAM_STATUS_INVALID;
+    if (uploadOffset != uploadBytes)
+        return BT_STREAM_STATUS_OFFSET;
+
+    uint8_t header[STREAM_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    writeLE32(header, STREAM_MAGIC);
+    header[4] = STREAM_VERSION & 0xFF;
+    header[5] = STREAM_VERSION >> 8;
+    header[6] = uploadGlyphSize;
+    writeLE32(header + 8, uploadBytes / getGlyphBytes(uploadGlyphSize));
+    uploading = false;
+    if (!store.write(0, header, sizeof(header)))
+        return BT_STREAM_STATUS_FLASH;
+
+    return loadHeader() ? BT_STREAM_STATUS_OK : BT_STREAM_STATUS_FLASH;
+}
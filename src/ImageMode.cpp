@@ -0,0 +1,259 @@
+#include "ImageMode.h"
+#include "LEDController.h"
+#include "DisplayDriver.h"
+#include "Animation.h"
+#include "LiveStream.h"
+#include "Paging.h"
+#include "Priority.h"
+#include "MemoryPool.h"
+#include "Log.h"
+
+ImageState imageState = {};
+
+static uint16_t readBE16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void drawImagePixel(int index)
+{
+    drawPanelPixel(index % SCREEN_WIDTH, index / SCREEN_WIDTH, imageState.pixels[index]);
+}
+
+static void drawWholeImage()
+{
+    for (int i = 0; i < IMAGE_PIXEL_COUNT; i++)
+    {
+        drawImagePixel(i);
+    }
+}
+
+bool isImageShowing()
+{
+    return imageState.active;
+}
+
+void exitImageMode()
+{
+    if (!imageState.active)
+        return;
+
+    LOG_I("退出图像模式 - 完整图像: %u次, 增量: %u次/%u字节, 改变像素: %u",
+          imageState.fullCount, imageState.deltaCount, imageState.deltaBytes, imageState.pixelsChanged);
+    imageState.active = false;
+    mediaBuffer.release();
+    imageState.pixels = nullptr;
+    textState.needUpdate = true; // 恢复文本显示
+}
+
+// 进入图像模式：图像、动画与实时流都占据整屏，后到的替换先到的
+static uint16_t *acquireImage()
+{
+    stopAnimation();
+    stopLiveStream();
+    if (!imageState.pixels)
+    {
+        releasePagingBitmaps();
+        imageState.pixels = (uint16_t *)mediaBuffer.acquire(IMAGE_BUFFER_BYTES);
+    }
+    return imageState.pixels;
+}
+
+// 颜色数决定每个索引的位数（1/2/4/8位），索引按行连续打包，高位在前
+static int getIndexBits(int colorCount)
+{
+    if (colorCount <= 2)
+        return 1;
+    if (colorCount <= 4)
+        return 2;
+    if (colorCount <= 16)
+        return 4;
+    return 8;
+}
+
+// 取第index个像素的调色板索引
+static uint8_t getPaletteIndex(const uint8_t *indices, int bits, int index)
+{
+    int perByte = 8 / bits;
+    int shift = 8 - bits * (index % perByte + 1);
+    return (indices[index / perByte] >> shift) & ((1 << bits) - 1);
+}
+
+// RGB565：[像素×2048，高字节在前]
+// 调色板：[颜色数-1][调色板RGB565×颜色数][像素索引]，索引不能超出调色板
+bool validateFullImage(uint8_t op, const uint8_t *data, int length)
+{
+    if (op == BT_IMAGE_FULL_RGB565)
+        return length == IMAGE_BUFFER_BYTES;
+    if (op != BT_IMAGE_FULL_PALETTE || length < 1)
+        return false;
+
+    int colorCount = data[0] + 1;
+    int bits = getIndexBits(colorCount);
+    const uint8_t *indices = data + 1 + colorCount * 2;
+    if (length != 1 + colorCount * 2 + IMAGE_PIXEL_COUNT * bits / 8)
+        return false;
+    for (int i = 0; i < IMAGE_PIXEL_COUNT; i++)
+    {
+        if (getPaletteIndex(indices, bits, i) >= colorCount)
+            return false;
+    }
+    return true;
+}
+
+void decodeFullImage(uint8_t op, const uint8_t *data, uint16_t *pixels)
+{
+    if (op == BT_IMAGE_FULL_RGB565)
+    {
+        for (int i = 0; i < IMAGE_PIXEL_COUNT; i++)
+        {
+            pixels[i] = readBE16(data + i * 2);
+        }
+        return;
+    }
+
+    // 调色板图像直接展开为RGB565
+    int colorCount = data[0] + 1;
+    int bits = getIndexBits(colorCount);
+    const uint8_t *palette = data + 1;
+    const uint8_t *indices = palette + colorCount * 2;
+    for (int i = 0; i < IMAGE_PIXEL_COUNT; i++)
+    {
+        pixels[i] = readBE16(palette + getPaletteIndex(indices, bits, i) * 2);
+    }
+}
+
+// 遍历RLE增量：pixels为空时只校验；否则原地异或，每个值发生变化的像素回调onChanged（可为空）
+int applyImageDelta(const uint8_t *data, int length, uint16_t *pixels, ImagePixelCallback onChanged)
+{
+    int pos = 0;
+    int pixel = 0;
+    int changed = 0;
+    while (pos < length)
+    {
+        uint8_t control = data[pos++];
+        int count;
+        if (control & BT_IMAGE_RLE_LITERAL)
+        {
+            count = (control & 0x7F) + 1;
+            if (pos + count * 2 > length || pixel + count > IMAGE_PIXEL_COUNT)
+                return -1;
+            for (int i = 0; pixels && i < count; i++)
+            {
+                uint16_t value = readBE16(data + pos + i * 2);
+                if (value)
+                {
+                    pixels[pixel + i] ^= value;
+                    if (onChanged)
+                        onChanged(pixel + i);
+                    changed++;
+                }
+            }
+            pos += count * 2;
+        }
+        else if (control & BT_IMAGE_RLE_REPEAT)
+        {
+            count = (control & 0x3F) + 1;
+            if (pos + 2 > length || pixel + count > IMAGE_PIXEL_COUNT)
+                return -1;
+            uint16_t value = readBE16(data + pos);
+            for (int i = 0; pixels && value && i < count; i++)
+            {
+                pixels[pixel + i] ^= value;
+                if (onChanged)
+                    onChanged(pixel + i);
+                changed++;
+            }
+            pos += 2;
+        }
+        else
+        {
+            count = (control & 0x3F) + 1; // 跳过段
+            if (pixel + count > IMAGE_PIXEL_COUNT)
+                return -1;
+        }
+        pixel += count;
+    }
+    return changed;
+}
+
+static void sendImageResponse(uint8_t op, uint8_t status, uint16_t changed)
+{
+    uint8_t response[4] = {op, status, (uint8_t)(changed >> 8), (uint8_t)(changed & 0xFF)};
+    sendResponseFrame(BT_CMD_IMAGE, response, sizeof(response));
+}
+
+// 处理图像命令 (0x15)
+// 数据格式：[操作][参数...]，见蓝牙图像帧格式.md
+// 应答：[操作][状态][改变的像素数2字节]（完整图像为2048）
+void handleImageCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 1)
+    {
+        LOG_E("错误: 图像数据无效");
+        return;
+    }
+
+    uint8_t op = frame.data[0];
+    const uint8_t *data = frame.data + 1;
+    int length = frame.dataLength - 1;
+    uint8_t status = BT_IMAGE_STATUS_INVALID;
+    int changed = 0;
+
+    // 插播期间屏幕属于插播内容，出栈时推回的是入栈时的屏幕镜像，此时改动图像会与镜像不一致
+    if (isPriorityActive())
+    {
+        LOG_W("图像命令被拒绝: 优先插播显示中 - 操作: 0x%02X", op);
+        sendImageResponse(op, BT_IMAGE_STATUS_BUSY, 0);
+        return;
+    }
+
+    switch (op)
+    {
+    case BT_IMAGE_FULL_RGB565:
+    case BT_IMAGE_FULL_PALETTE:
+        if (validateFullImage(op, data, length) && acquireImage())
+        {
+            decodeFullImage(op, data, imageState.pixels);
+            imageState.active = true;
+            imageState.fullCount++;
+            drawWholeImage();
+            changed = IMAGE_PIXEL_COUNT;
+            status = BT_IMAGE_STATUS_OK;
+            LOG_I("显示完整图像 - 格式: %s, 数据: %d字节", op == BT_IMAGE_FULL_RGB565 ? "RGB565" : "调色板", length);
+        }
+        break;
+
+    case BT_IMAGE_DELTA:
+        // 先整体校验，合法后才原地修改图像
+        if (!imageState.active)
+        {
+            status = BT_IMAGE_STATUS_NO_IMAGE;
+        }
+        else if (applyImageDelta(data, length, nullptr, nullptr) >= 0)
+        {
+            changed = applyImageDelta(data, length, imageState.pixels, drawImagePixel);
+            imageState.deltaCount++;
+            imageState.deltaBytes += length;
+            imageState.pixelsChanged += changed;
+            status = BT_IMAGE_STATUS_OK;
+            LOG_D("图像增量 - 数据: %d字节, 改变像素: %d", length, changed);
+        }
+        break;
+
+    case BT_IMAGE_EXIT:
+        exitImageMode();
+        status = BT_IMAGE_STATUS_OK;
+        break;
+
+    default:
+        LOG_E("错误: 未知的图像操作 0x%02X", op);
+        break;
+    }
+
+    if (status != BT_IMAGE_STATUS_OK)
+    {
+        LOG_W("图像命令失败 - 操作: 0x%02X, 状态: %d", op, status);
+    }
+    sendImageResponse(op, status, (uint16_t)changed);
+}
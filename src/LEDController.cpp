@@ -1,9 +1,19 @@
 #include "LEDController.h"
 #include "DisplayDriver.h"
 #include "FontData.h"
+#include "TextStream.h"
+#include "CommandBatch.h"
+#include "Animation.h"
+#include "ImageMode.h"
+#include "LiveStream.h"
+#include "Playlist.h"
+#include "Ticker.h"
+#include "Priority.h"
+#include "Paging.h"
+#include "Log.h"
 
 // ==================== 全局变量定义 ====================
-TextDisplayState textState = {"", "", 0, 0, 0, false, BT_DIRECTION_HORIZONTAL}; // 全局文本状态
+TextDisplayState textState = {"", "", 0, 0, 0, 0, false, BT_DIRECTION_HORIZONTAL, 0, 0}; // 全局文本状态
 uint8_t currentFontSize = BT_FONT_16x16;                                        // 全局字体大小标志位
 ColorState colorState = {
     // 上半屏颜色初始化
@@ -28,35 +38,42 @@ BrightnessState brightnessState = {128, false}; // 全局亮度状态，默认50
 
 MatrixPanel_I2S_DMA *dma_display = nullptr;
 
-// ==================== 动态点阵数据存储 ====================
-uint16_t *dynamic_upper_text = nullptr; // 动态上半屏点阵数据
-uint16_t *dynamic_lower_text = nullptr; // 动态下半屏点阵数据
-uint16_t *dynamic_full_text = nullptr;  // 动态全屏点阵数据
-int dynamic_upper_char_count = 0;       // 动态上半屏字符数
-int dynamic_lower_char_count = 0;       // 动态下半屏字符数
-int dynamic_full_char_count = 0;        // 动态全屏字符数
+// ==================== 区域文本 ====================
+// 区域文本存放在去重字形表中（见TextStore.h），这里负责与内置示例数据之间的选择
 
 // 内存管理辅助函数
 void freeDynamicTextData()
 {
-    if (dynamic_upper_text)
-    {
-        free(dynamic_upper_text);
-        dynamic_upper_text = nullptr;
-    }
-    if (dynamic_lower_text)
-    {
-        free(dynamic_lower_text);
-        dynamic_lower_text = nullptr;
-    }
-    if (dynamic_full_text)
-    {
-        free(dynamic_full_text);
-        dynamic_full_text = nullptr;
-    }
-    dynamic_upper_char_count = 0;
-    dynamic_lower_char_count = 0;
-    dynamic_full_char_count = 0;
+    resetRegionText(upperRegionText);
+    resetRegionText(lowerRegionText);
+    resetRegionText(fullRegionText);
+}
+
+int getTextRegionCapacity(uint8_t screenArea)
+{
+    return getTextRegionCapacity(screenArea, currentFontSize);
+}
+
+// 当前显示的文本：区域设置过文本时经字形序号解析（可能为空），从未设置时为内置示例数据
+GlyphText getUpperDisplayText()
+{
+    if (upperRegionText.hasText)
+        return getRegionGlyphs(upperRegionText);
+    return GlyphText(upper_text, getUpperTextCharCount(), 16);
+}
+
+GlyphText getLowerDisplayText()
+{
+    if (lowerRegionText.hasText)
+        return getRegionGlyphs(lowerRegionText);
+    return GlyphText(lower_text, getLowerTextCharCount(), 16);
+}
+
+GlyphText getFullDisplayText()
+{
+    if (fullRegionText.hasText)
+        return getRegionGlyphs(fullRegionText);
+    return GlyphText(full_text, getFullTextCharCount(), 64);
 }
 
 // ==================== 硬件初始化 ====================
@@ -103,39 +120,17 @@ void displayTextOnHalf(int y, bool isUpper)
         return; // 闪烁特效激活且当前应该隐藏，直接返回
     }
 
-    // 根据上下半屏选择对应的点阵数据（优先使用动态数据）
-    const uint16_t *font_data;
-    int total_char_count;
-
-    if (isUpper)
+    // 流式文本优先：只读取可见位置附近的字形
+    if (isRegionStreaming(isUpper))
     {
-        // 上半屏：优先使用动态数据，否则使用静态数据
-        if (dynamic_upper_text && dynamic_upper_char_count > 0)
-        {
-            font_data = dynamic_upper_text;
-            total_char_count = dynamic_upper_char_count;
-        }
-        else
-        {
-            font_data = upper_text;
-            total_char_count = getUpperTextCharCount();
-        }
-    }
-    else
-    {
-        // 下半屏：优先使用动态数据，否则使用静态数据
-        if (dynamic_lower_text && dynamic_lower_char_count > 0)
-        {
-            font_data = dynamic_lower_text;
-            total_char_count = dynamic_lower_char_count;
-        }
-        else
-        {
-            font_data = lower_text;
-            total_char_count = getLowerTextCharCount();
-        }
+        displayStreamingText(isUpper, y);
+        return;
     }
 
+    // 根据上下半屏选择对应的文本（优先使用动态数据）
+    GlyphText text = isUpper ? getUpperDisplayText() : getLowerDisplayText();
+    int total_char_count = text.count;
+
     // 检查是否启用滚动特效
     bool scrollActive = isUpper ? effectState.upperScrollActive : effectState.lowerScrollActive;
 
@@ -175,20 +170,26 @@ void displayTextOnHalf(int y, bool isUpper)
         // 滚动模式：显示所有字符
         uint8_t scrollType = isUpper ? effectState.upperScrollType : effectState.lowerScrollType;
         int scrollOffset = isUpper ? effectState.upperScrollOffset : effectState.lowerScrollOffset;
-        displayScrollingText(font_data, total_char_count, scrollOffset, y, scrollType);
+        if (isTickerRunning(isUpper))
+            text = getTickerText(isUpper); // 滚动队列只显示消息带，队列为空时不显示内置示例
+        displayScrollingText(text, scrollOffset, y, scrollType);
         return;
     }
 
+    // 翻页过渡中按预渲染的位图绘制
+    if (drawPagingFrame(isUpper))
+        return;
+
     // 检查显示方向
     bool isVertical = (textState.displayDirection == BT_DIRECTION_VERTICAL);
 
     // 非滚动模式：分组显示
     if (isVertical)
     {
-        // 竖向显示：每行最多显示4个字符（向左旋转后水平排列）
-        const int maxCharsPerLine = 4;
+        // 竖向显示：每组字符向左旋转后水平排列（每组字符数见Paging.h，默认4个）
+        const int maxCharsPerLine = getPageSize(isUpper);
 
-        // 如果字符数不超过4个，直接居中显示
+        // 字符数不超过一组时直接居中显示
         if (total_char_count <= maxCharsPerLine)
         {
             int display_x = (SCREEN_WIDTH - total_char_count * CHAR_SPACING_16) / 2;
@@ -197,16 +198,16 @@ void displayTextOnHalf(int y, bool isUpper)
 
             if (useGradient)
             {
-                drawString16x16VerticalGradient(display_x, y, font_data, total_char_count, isUpper, gradientMode);
+                drawString16x16VerticalGradient(display_x, y, text, isUpper, gradientMode);
             }
             else
             {
-                drawString16x16Vertical(display_x, y, font_data, total_char_count, textColor);
+                drawString16x16Vertical(display_x, y, text, textColor);
             }
             return;
         }
 
-        // 超过4个字符，按组显示
+        // 超过一组，按组显示
         int currentIndex = isUpper ? textState.upperIndex : textState.lowerIndex;
         int startCharIndex = currentIndex * maxCharsPerLine;
         int displayCharCount = min(maxCharsPerLine, total_char_count - startCharIndex);
@@ -219,22 +220,21 @@ void displayTextOnHalf(int y, bool isUpper)
         if (display_x < 0)
             display_x = 0;
 
-        const uint16_t *current_font_data = font_data + (startCharIndex * 16);
         if (useGradient)
         {
-            drawString16x16VerticalGradient(display_x, y, current_font_data, displayCharCount, isUpper, gradientMode);
+            drawString16x16VerticalGradient(display_x, y, text.slice(startCharIndex, displayCharCount), isUpper, gradientMode);
         }
         else
         {
-            drawString16x16Vertical(display_x, y, current_font_data, displayCharCount, textColor);
+            drawString16x16Vertical(display_x, y, text.slice(startCharIndex, displayCharCount), textColor);
         }
     }
     else
     {
-        // 水平显示：每行最多显示4个字符
-        const int maxCharsPerLine = 4;
+        // 水平显示：每组字符数见Paging.h（默认4个）
+        const int maxCharsPerLine = getPageSize(isUpper);
 
-        // 如果字符数不超过4个，直接居中显示
+        // 字符数不超过一组时直接居中显示
         if (total_char_count <= maxCharsPerLine)
         {
             int x = (SCREEN_WIDTH - total_char_count * CHAR_SPACING_16) / 2;
@@ -243,16 +243,16 @@ void displayTextOnHalf(int y, bool isUpper)
 
             if (useGradient)
             {
-                drawString16x16Gradient(x, y, font_data, total_char_count, isUpper, gradientMode);
+                drawString16x16Gradient(x, y, text, isUpper, gradientMode);
             }
             else
             {
-                drawString16x16(x, y, font_data, total_char_count, textColor);
+                drawString16x16(x, y, text, textColor);
             }
             return;
         }
 
-        // 超过4个字符，按组显示
+        // 超过一组，按组显示
         int currentIndex = isUpper ? textState.upperIndex : textState.lowerIndex;
         int startCharIndex = currentIndex * maxCharsPerLine;
         int displayCharCount = min(maxCharsPerLine, total_char_count - startCharIndex);
@@ -266,14 +266,13 @@ void displayTextOnHalf(int y, bool isUpper)
             x = 0;
 
         // 显示当前组的字符
-        const uint16_t *current_font_data = font_data + (startCharIndex * 16);
         if (useGradient)
         {
-            drawString16x16Gradient(x, y, current_font_data, displayCharCount, isUpper, gradientMode);
+            drawString16x16Gradient(x, y, text.slice(startCharIndex, displayCharCount), isUpper, gradientMode);
         }
         else
         {
-            drawString16x16(x, y, current_font_data, displayCharCount, textColor);
+            drawString16x16(x, y, text.slice(startCharIndex, displayCharCount), textColor);
         }
     }
 }
@@ -290,23 +289,17 @@ void displayFullScreenText32x32()
         return; // 闪烁特效激活且当前应该隐藏，直接返回
     }
 
-    // 使用全屏点阵数据（优先使用动态数据）
-    const uint16_t *font_data;
-    int total_char_count;
-
-    if (dynamic_full_text && dynamic_full_char_count > 0)
-    {
-        // 优先使用动态数据
-        font_data = dynamic_full_text;
-        total_char_count = dynamic_full_char_count;
-    }
-    else
+    // 流式文本优先（32x32全屏使用上半屏滚动状态）
+    if (isRegionStreaming(true))
     {
-        // 否则使用静态数据
-        font_data = full_text;
-        total_char_count = getFullTextCharCount();
+        displayStreamingText(true, 0);
+        return;
     }
 
+    // 使用全屏文本（优先使用动态数据）
+    GlyphText text = getFullDisplayText();
+    int total_char_count = text.count;
+
     // 检查是否启用滚动特效（仿照16x16逻辑）
     bool scrollActive = effectState.upperScrollActive; // 32x32全屏使用上半屏滚动状态
 
@@ -349,13 +342,19 @@ void displayFullScreenText32x32()
         // 滚动模式：显示所有字符
         uint8_t scrollType = effectState.upperScrollType;
         int scrollOffset = effectState.upperScrollOffset;
-        displayScrollingText32x32(font_data, total_char_count, scrollOffset, 0, scrollType);
+        if (isTickerRunning(true))
+            text = getTickerText(true);
+        displayScrollingText32x32(text, scrollOffset, 0, scrollType);
         return;
     }
 
+    // 翻页过渡中按预渲染的位图绘制
+    if (drawPagingFrame(true))
+        return;
+
     // 32x32字体居中显示和分组切换功能
-    // 32x32字体全屏最多显示2个字符（64像素宽度/32像素每字符）
-    const int maxCharsPerScreen = SCREEN_WIDTH / CHAR_SPACING_32;
+    // 32x32字体全屏最多显示2个字符（64像素宽度/32像素每字符），每组字符数见Paging.h
+    const int maxCharsPerScreen = getPageSize(true);
 
     if (isVertical)
     {
@@ -369,11 +368,11 @@ void displayFullScreenText32x32()
 
             if (useGradient)
             {
-                drawString32x32VerticalGradient(display_x, 0, font_data, total_char_count, gradientMode);
+                drawString32x32VerticalGradient(display_x, 0, text, gradientMode);
             }
             else
             {
-                drawString32x32Vertical(display_x, 0, font_data, total_char_count, textColor);
+                drawString32x32Vertical(display_x, 0, text, textColor);
             }
         }
         else
@@ -390,14 +389,13 @@ void displayFullScreenText32x32()
                 if (display_x < 0)
                     display_x = 0;
 
-                const uint16_t *current_font_data = font_data + (startCharIndex * 64);
                 if (useGradient)
                 {
-                    drawString32x32VerticalGradient(display_x, 0, current_font_data, displayCharCount, gradientMode);
+                    drawString32x32VerticalGradient(display_x, 0, text.slice(startCharIndex, displayCharCount), gradientMode);
                 }
                 else
                 {
-                    drawString32x32Vertical(display_x, 0, current_font_data, displayCharCount, textColor);
+                    drawString32x32Vertical(display_x, 0, text.slice(startCharIndex, displayCharCount), textColor);
                 }
             }
         }
@@ -414,11 +412,11 @@ void displayFullScreenText32x32()
 
             if (useGradient)
             {
-                drawString32x32Gradient(x, 0, font_data, total_char_count, gradientMode);
+                drawString32x32Gradient(x, 0, text, gradientMode);
             }
             else
             {
-                drawString32x32(x, 0, font_data, total_char_count, textColor);
+                drawString32x32(x, 0, text, textColor);
             }
         }
         else
@@ -435,14 +433,13 @@ void displayFullScreenText32x32()
                 if (x < 0)
                     x = 0;
 
-                const uint16_t *current_font_data = font_data + (startCharIndex * 64);
                 if (useGradient)
                 {
-                    drawString32x32Gradient(x, 0, current_font_data, displayCharCount, gradientMode);
+                    drawString32x32Gradient(x, 0, text.slice(startCharIndex, displayCharCount), gradientMode);
                 }
                 else
                 {
-                    drawString32x32(x, 0, current_font_data, displayCharCount, textColor);
+                    drawString32x32(x, 0, text.slice(startCharIndex, displayCharCount), textColor);
                 }
             }
         }
@@ -450,169 +447,310 @@ void displayFullScreenText32x32()
 }
 
 // 处理点阵数据命令（新的函数签名）
-void handleTextCommand(const uint16_t *upperData, int upperCharCount, const uint16_t *lowerData, int lowerCharCount)
+void handleTextCommand(const GlyphText &upper, const GlyphText &lower)
+{
+    LOG_I("设置点阵数据 - 上半屏: %d字符, 下半屏: %d字符", upper.count, lower.count);
+
+    // 写入去重字形表，区域只保存字形序号；截断时批量命令整体回滚
+    int upperStored = setRegionText(upperRegionText, upper);
+    int lowerStored = setRegionText(lowerRegionText, lower);
+    if (upperStored < upper.count || lowerStored < lower.count)
+        markBatchFailed();
+    LOG_I("点阵数据已存储 - 上半屏: %d字符, 下半屏: %d字符, 不同字形: %d",
+          upperRegionText.charCount, lowerRegionText.charCount, glyphTable16.getUsedCount());
+
+    // 更新显示状态
+    textState.upperIndex = 0;
+    textState.lowerIndex = 0;
+    textState.lastSwitchTime = millis();
+    textState.lowerSwitchTime = textState.lastSwitchTime;
+    textState.needUpdate = true;
+}
+
+// 处理32x32全屏点阵数据命令
+void handleFullScreenTextCommand(const GlyphText &text)
+{
+    LOG_I("设置32x32全屏点阵数据: %d字符", text.count);
+
+    // 写入去重字形表，区域只保存字形序号；截断时批量命令整体回滚
+    if (setRegionText(fullRegionText, text) < text.count)
+        markBatchFailed();
+    LOG_I("全屏数据已存储: %d字符, 不同字形: %d", fullRegionText.charCount, glyphTable32.getUsedCount());
+
+    // 更新显示状态
+    textState.upperIndex = 0;
+    textState.lastSwitchTime = millis();
+    textState.needUpdate = true;
+}
+
+// 处理显示方向命令
+void handleDirectionCommand(uint8_t direction)
+{
+    LOG_I("设置显示方向: %s",
+          (direction == BT_DIRECTION_HORIZONTAL) ? "正向显示" : "竖向显示");
+
+    // 更新显示方向状态
+    textState.displayDirection = direction;
+    textState.needUpdate = true; // 触发重绘
+}
+
+// ==================== 局部文本更新 ====================
+// 非滚动模式下当前页的布局：起始字符、本页字符数、首字符X坐标
+struct PageLayout
 {
-    Serial.printf("设置点阵数据 - 上半屏: %d字符, 下半屏: %d字符\n", upperCharCount, lowerCharCount);
+    int startChar;
+    int charCount;
+    int x;
+};
 
-    // 释放旧的动态数据
-    if (dynamic_upper_text)
+static PageLayout getPageLayout(int totalChars, int pageIndex, int maxPerPage, int spacing)
+{
+    PageLayout layout;
+    if (totalChars <= maxPerPage)
     {
-        free(dynamic_upper_text);
-        dynamic_upper_text = nullptr;
+        layout.startChar = 0;
+        layout.charCount = totalChars;
     }
-    if (dynamic_lower_text)
+    else
     {
-        free(dynamic_lower_text);
-        dynamic_lower_text = nullptr;
+        layout.startChar = pageIndex * maxPerPage;
+        layout.charCount = min(maxPerPage, totalChars - layout.startChar);
+        if (layout.charCount < 0)
+            layout.charCount = 0;
     }
+    layout.x = (SCREEN_WIDTH - layout.charCount * spacing) / 2;
+    if (layout.x < 0)
+        layout.x = 0;
+    return layout;
+}
+
+// 对RGB565颜色应用呼吸亮度
+static uint16_t applyBreatheToColor(uint16_t baseColor, float phase)
+{
+    float brightness = (sin(phase) + 1.0) / 2.0; // 0.0 到 1.0 的正弦波
+    brightness = 0.2 + brightness * 0.8;         // 范围从0.2到1.0，避免完全黑暗
+
+    uint8_t r = (uint8_t)(((baseColor >> 11) & 0x1F) * brightness);
+    uint8_t g = (uint8_t)(((baseColor >> 5) & 0x3F) * brightness);
+    uint8_t b = (uint8_t)((baseColor & 0x1F) * brightness);
+    return (r << 11) | (g << 5) | b;
+}
 
-    // 分配并复制上半屏数据
-    if (upperData && upperCharCount > 0)
+// 只重绘当前页中被标记的字符格（背景 + 字形），不清屏
+static void redrawDirtyCells(bool isUpper, uint8_t dirtyMask)
+{
+    bool is32 = (currentFontSize == BT_FONT_32x32);
+    bool isVertical = (textState.displayDirection == BT_DIRECTION_VERTICAL);
+    int spacing = is32 ? CHAR_SPACING_32 : CHAR_SPACING_16;
+    int maxPerPage = getPageSize(isUpper);
+    int y = (is32 || isUpper) ? 0 : 16;
+
+    GlyphText text = is32 ? getFullDisplayText() : (isUpper ? getUpperDisplayText() : getLowerDisplayText());
+    int total_char_count = text.count;
+
+    int pageIndex = isUpper ? textState.upperIndex : textState.lowerIndex;
+    PageLayout layout = getPageLayout(total_char_count, pageIndex, maxPerPage, spacing);
+
+    // 颜色与特效状态（与displayTextOnHalf/displayFullScreenText32x32一致）
+    uint16_t bgColor = (is32 || isUpper) ? colorState.upperBackgroundColor : colorState.lowerBackgroundColor;
+    uint8_t textMode = is32 ? colorState.textMode : (isUpper ? colorState.upperTextMode : colorState.lowerTextMode);
+    uint8_t gradientMode = is32 ? colorState.gradientMode : (isUpper ? colorState.upperGradientMode : colorState.lowerGradientMode);
+    bool useGradient = (textMode == BT_COLOR_MODE_GRADIENT && gradientMode != BT_GRADIENT_FIXED);
+    uint16_t textColor = is32 ? colorState.textColor : (isUpper ? colorState.upperTextColor : colorState.lowerTextColor);
+    bool breatheActive = isUpper ? effectState.upperBreatheActive : effectState.lowerBreatheActive;
+    if (breatheActive && !useGradient)
+    {
+        textColor = applyBreatheToColor(textColor, isUpper ? effectState.upperBreathePhase : effectState.lowerBreathePhase);
+    }
+    bool blinkHidden = isUpper ? (effectState.upperBlinkActive && !effectState.upperBlinkVisible)
+                               : (effectState.lowerBlinkActive && !effectState.lowerBlinkVisible);
+
+    for (int slot = 0; slot < maxPerPage; slot++)
     {
-        int upperDataSize = upperCharCount * 16 * sizeof(uint16_t); // 16x16字体每字符16个uint16_t
-        dynamic_upper_text = (uint16_t *)malloc(upperDataSize);
-        if (dynamic_upper_text)
+        if (!(dirtyMask & (1 << slot)))
+            continue;
+
+        int cellX = layout.x + slot * spacing;
+        for (int py = y; py < y + spacing && py < SCREEN_HEIGHT; py++)
         {
-            memcpy(dynamic_upper_text, upperData, upperDataSize);
-            dynamic_upper_char_count = upperCharCount;
-            Serial.printf("上半屏数据已存储: %d字符, %d字节\n", upperCharCount, upperDataSize);
+            for (int px = cellX; px < cellX + spacing && px < SCREEN_WIDTH; px++)
+            {
+                drawPanelPixel(px, py, bgColor);
+            }
         }
-        else
+
+        if (blinkHidden || slot >= layout.charCount)
+            continue;
+
+        const uint16_t *glyph = text.at(layout.startChar + slot);
+        if (is32 && useGradient)
         {
-            Serial.println("错误: 上半屏数据内存分配失败");
-            dynamic_upper_char_count = 0;
+            if (isVertical)
+                drawChar32x32VerticalGradient(cellX, y, glyph, gradientMode);
+            else
+                drawChar32x32Gradient(cellX, y, glyph, gradientMode);
         }
-    }
-    else
-    {
-        dynamic_upper_char_count = 0;
-    }
-
-    // 分配并复制下半屏数据
-    if (lowerData && lowerCharCount > 0)
-    {
-        int lowerDataSize = lowerCharCount * 16 * sizeof(uint16_t); // 16x16字体每字符16个uint16_t
-        dynamic_lower_text = (uint16_t *)malloc(lowerDataSize);
-        if (dynamic_lower_text)
+        else if (is32)
         {
-            memcpy(dynamic_lower_text, lowerData, lowerDataSize);
-            dynamic_lower_char_count = lowerCharCount;
-            Serial.printf("下半屏数据已存储: %d字符, %d字节\n", lowerCharCount, lowerDataSize);
+            if (isVertical)
+                drawChar32x32Vertical(cellX, y, glyph, textColor);
+            else
+                drawChar32x32(cellX, y, glyph, textColor);
+        }
+        else if (useGradient)
+        {
+            if (isVertical)
+                drawChar16x16VerticalGradient(cellX, y, glyph, isUpper, gradientMode);
+            else
+                drawChar16x16Gradient(cellX, y, glyph, isUpper, gradientMode);
         }
         else
         {
-            Serial.println("错误: 下半屏数据内存分配失败");
-            dynamic_lower_char_count = 0;
+            if (isVertical)
+                drawChar16x16Vertical(cellX, y, glyph, textColor);
+            else
+                drawChar16x16(cellX, y, glyph, textColor);
         }
     }
+}
+
+// 局部替换/插入/删除字符：原地修改区域字形序号，保留滚动偏移与分页位置，只标记受影响的字符格
+bool applyTextRangeUpdate(uint8_t screenArea, uint8_t op, int start, int count, const GlyphText &glyphs)
+{
+    bool is32 = (currentFontSize == BT_FONT_32x32);
+    bool isUpper;
+    RegionText *region;
+
+    if (is32)
+    {
+        isUpper = true;
+        region = &fullRegionText;
+    }
+    else if (screenArea == BT_SCREEN_UPPER || screenArea == BT_SCREEN_LOWER)
+    {
+        isUpper = (screenArea == BT_SCREEN_UPPER);
+        region = isUpper ? &upperRegionText : &lowerRegionText;
+    }
     else
     {
-        dynamic_lower_char_count = 0;
+        LOG_E("错误: 局部更新不支持的屏幕区域 0x%02X", screenArea);
+        return false;
     }
 
-    // 更新显示状态
-    textState.upperIndex = 0;
-    textState.lowerIndex = 0;
-    textState.lastSwitchTime = millis();
-    textState.needUpdate = true;
-}
-
-// 处理32x32全屏点阵数据命令
-void handleFullScreenTextCommand(const uint16_t *fontData, int charCount)
-{
-    Serial.printf("设置32x32全屏点阵数据: %d字符\n", charCount);
+    int wordsPerGlyph = is32 ? 64 : 16;
+    int spacing = is32 ? CHAR_SPACING_32 : CHAR_SPACING_16;
+    int maxPerPage = getPageSize(isUpper);
+    int oldCount = region->charCount;
+    int *pageIndex = isUpper ? &textState.upperIndex : &textState.lowerIndex;
+    PageLayout oldLayout = getPageLayout(oldCount, *pageIndex, maxPerPage, spacing);
 
-    // 释放旧的动态数据
-    if (dynamic_full_text)
+    if (start < 0 || count < 0 || start > oldCount)
     {
-        free(dynamic_full_text);
-        dynamic_full_text = nullptr;
+        LOG_E("错误: 局部更新范围无效 - 起始: %d, 数量: %d, 当前字符数: %d", start, count, oldCount);
+        return false;
     }
 
-    // 分配并复制全屏数据
-    if (fontData && charCount > 0)
+    switch (op)
     {
-        int dataSize = charCount * 64 * sizeof(uint16_t); // 32x32字体每字符64个uint16_t
-        dynamic_full_text = (uint16_t *)malloc(dataSize);
-        if (dynamic_full_text)
-        {
-            memcpy(dynamic_full_text, fontData, dataSize);
-            dynamic_full_char_count = charCount;
-            Serial.printf("全屏数据已存储: %d字符, %d字节\n", charCount, dataSize);
-        }
-        else
+    case BT_RANGE_REPLACE:
+        if (glyphs.count != count || glyphs.wordsPerGlyph != wordsPerGlyph || start + count > oldCount)
         {
-            Serial.println("错误: 全屏数据内存分配失败");
-            dynamic_full_char_count = 0;
+            LOG_E("错误: 替换范围超出当前文本");
+            return false;
         }
+        if (!replaceRegionGlyphs(*region, start, glyphs))
+            return false;
+        break;
+
+    case BT_RANGE_INSERT:
+        if (glyphs.count != count || glyphs.wordsPerGlyph != wordsPerGlyph || count == 0)
+            return false;
+        if (!insertRegionGlyphs(*region, start, glyphs))
+            return false;
+        break;
+
+    case BT_RANGE_DELETE:
+        if (start + count > oldCount)
+            count = oldCount - start;
+        deleteRegionGlyphs(*region, start, count);
+        break;
+
+    default:
+        LOG_E("错误: 未知的局部更新操作 0x%02X", op);
+        return false;
     }
-    else
+
+    // 分页位置超出新文本范围时回到最后一页，其余情况保持不变
+    int newCount = region->charCount;
+    int totalPages = (newCount + maxPerPage - 1) / maxPerPage;
+    if (*pageIndex >= totalPages)
+        *pageIndex = totalPages > 0 ? totalPages - 1 : 0;
+
+    // 滚动中或本页布局变化（字符数、居中位置）时整体重绘，否则只标记受影响的字符格
+    bool scrollActive = isUpper ? effectState.upperScrollActive : effectState.lowerScrollActive;
+    PageLayout newLayout = getPageLayout(newCount, *pageIndex, maxPerPage, spacing);
+    if (scrollActive || newLayout.startChar != oldLayout.startChar ||
+        newLayout.charCount != oldLayout.charCount || newLayout.x != oldLayout.x)
     {
-        dynamic_full_char_count = 0;
+        textState.needUpdate = true;
+        return true;
     }
 
-    // 更新显示状态
-    textState.upperIndex = 0;
-    textState.lastSwitchTime = millis();
-    textState.needUpdate = true;
-}
-
-// 处理显示方向命令
-void handleDirectionCommand(uint8_t direction)
-{
-    Serial.printf("设置显示方向: %s\n",
-                  (direction == BT_DIRECTION_HORIZONTAL) ? "正向显示" : "竖向显示");
+    uint8_t dirty = 0;
+    for (int slot = 0; slot < newLayout.charCount; slot++)
+    {
+        int position = newLayout.startChar + slot;
+        bool affected = (op == BT_RANGE_REPLACE) ? (position >= start && position < start + count)
+                                                 : (position >= start);
+        if (affected)
+            dirty |= (1 << slot);
+    }
 
-    // 更新显示方向状态
-    textState.displayDirection = direction;
-    textState.needUpdate = true; // 触发重绘
+    if (isUpper)
+        textState.upperDirtyCells |= dirty;
+    else
+        textState.lowerDirtyCells |= dirty;
+    return true;
 }
 
 // 更新文本显示
 void updateTextDisplay()
 {
+    // 动画、图像、实时流或播放列表过渡时占据整屏，文本状态照常更新，结束后再重绘；
+    // 优先插播期间由文本渲染显示插播内容，全屏模式暂停
+    if (!isPriorityActive() && (isAnimationPlaying() || isImageShowing() || isLiveStreaming() || playlist.isTransitioning()))
+        return;
+
     unsigned long currentTime = millis();
-    const unsigned long switchInterval = 2000; // 2秒切换间隔
 
     // 32x32字体使用简化逻辑
     if (currentFontSize == BT_FONT_32x32)
     {
-        // 32x32字体分组切换逻辑 (仿照16x16逻辑)
-        const int maxCharsPerScreen = SCREEN_WIDTH / CHAR_SPACING_32; // 每屏最多2个字符
-
-        if (currentTime - textState.lastSwitchTime >= switchInterval)
+        // 分组切换与翻页过渡（每组字符数、停留时间与过渡方式见Paging.h）
+        if (updatePaging(true, currentTime))
         {
-            // 获取字符总数（优先使用动态数据）
-            int totalChars = (dynamic_full_text && dynamic_full_char_count > 0)
-                                 ? dynamic_full_char_count
-                                 : getFullTextCharCount();
-            if (totalChars > maxCharsPerScreen)
-            {
-                int totalGroups = (totalChars + maxCharsPerScreen - 1) / maxCharsPerScreen;
-                textState.upperIndex++;
-                if (textState.upperIndex >= totalGroups)
-                {
-                    textState.upperIndex = 0;
-                }
-                textState.lastSwitchTime = currentTime;
-                textState.needUpdate = true; // 关键：设置needUpdate标志！
-            }
+            textState.needUpdate = true;
         }
 
         if (!textState.needUpdate && !colorState.needColorUpdate)
         {
+            if (textState.upperDirtyCells)
+            {
+                redrawDirtyCells(true, textState.upperDirtyCells);
+                textState.upperDirtyCells = 0;
+            }
             return;
         }
 
         // 清除屏幕并填充背景色
-        dma_display->clearScreen();
+        clearPanel();
         if (colorState.upperBackgroundColor != 0x0000)
         {
             for (int y = 0; y < SCREEN_HEIGHT; y++)
             {
                 for (int x = 0; x < SCREEN_WIDTH; x++)
                 {
-                    dma_display->drawPixel(x, y, colorState.upperBackgroundColor);
+                    drawPanelPixel(x, y, colorState.upperBackgroundColor);
                 }
             }
         }
@@ -620,64 +758,40 @@ void updateTextDisplay()
         // 显示32x32全屏文本
         displayFullScreenText32x32();
         textState.needUpdate = false;
+        textState.upperDirtyCells = 0;
         colorState.needColorUpdate = false; // 重置颜色更新标志
         return;
     }
 
     // 16x16字体的原有逻辑
-    // 根据显示方向确定每组最大字符数
-    bool isVertical = (textState.displayDirection == BT_DIRECTION_VERTICAL);
-    const int maxCharsPerGroup = 4; // 无论水平还是竖向都是每组4个字符
-
-    // 检查是否需要切换显示内容
-    if (currentTime - textState.lastSwitchTime >= switchInterval)
+    // 上下半屏各自按自己的设置分组切换
+    if (updatePaging(true, currentTime))
     {
-        bool needUpdate = false;
-
-        // 处理上半屏分组切换（优先使用动态数据）
-        int upperTotalChars = (dynamic_upper_text && dynamic_upper_char_count > 0)
-                                  ? dynamic_upper_char_count
-                                  : getUpperTextCharCount();
-        if (upperTotalChars > maxCharsPerGroup)
-        {
-            int upperTotalGroups = (upperTotalChars + maxCharsPerGroup - 1) / maxCharsPerGroup; // 向上取整
-            textState.upperIndex++;
-            if (textState.upperIndex >= upperTotalGroups)
-            {
-                textState.upperIndex = 0;
-            }
-            needUpdate = true;
-        }
+        textState.needUpdate = true;
+    }
+    if (updatePaging(false, currentTime))
+    {
+        textState.needUpdate = true;
+    }
 
-        // 处理下半屏分组切换（优先使用动态数据）
-        int lowerTotalChars = (dynamic_lower_text && dynamic_lower_char_count > 0)
-                                  ? dynamic_lower_char_count
-                                  : getLowerTextCharCount();
-        if (lowerTotalChars > maxCharsPerGroup)
+    if (!textState.needUpdate)
+    {
+        // 仅有局部字符变化时只重绘对应字符格
+        if (textState.upperDirtyCells)
         {
-            int lowerTotalGroups = (lowerTotalChars + maxCharsPerGroup - 1) / maxCharsPerGroup; // 向上取整
-            textState.lowerIndex++;
-            if (textState.lowerIndex >= lowerTotalGroups)
-            {
-                textState.lowerIndex = 0;
-            }
-            needUpdate = true;
+            redrawDirtyCells(true, textState.upperDirtyCells);
+            textState.upperDirtyCells = 0;
         }
-
-        if (needUpdate)
+        if (textState.lowerDirtyCells)
         {
-            textState.lastSwitchTime = currentTime;
-            textState.needUpdate = true;
+            redrawDirtyCells(false, textState.lowerDirtyCells);
+            textState.lowerDirtyCells = 0;
         }
-    }
-
-    if (!textState.needUpdate)
-    {
         return;
     }
 
     // 清除屏幕
-    dma_display->clearScreen();
+    clearPanel();
 
     // 分别填充上下半屏背景色
     // 上半屏背景（Y坐标0-15）
@@ -687,7 +801,7 @@ void updateTextDisplay()
         {
             for (int x = 0; x < SCREEN_WIDTH; x++)
             {
-                dma_display->drawPixel(x, y, colorState.upperBackgroundColor);
+                drawPanelPixel(x, y, colorState.upperBackgroundColor);
             }
         }
     }
@@ -699,7 +813,7 @@ void updateTextDisplay()
         {
             for (int x = 0; x < SCREEN_WIDTH; x++)
             {
-                dma_display->drawPixel(x, y, colorState.lowerBackgroundColor);
+                drawPanelPixel(x, y, colorState.lowerBackgroundColor);
             }
         }
     }
@@ -711,6 +825,8 @@ void updateTextDisplay()
     displayTextOnHalf(16, false);
 
     textState.needUpdate = false;
+    textState.upperDirtyCells = 0;
+    textState.lowerDirtyCells = 0;
 }
 
 // ==================== 颜色相关函数 ====================
@@ -719,7 +835,7 @@ void handleColorCommand(const BluetoothFrame &frame)
 {
     if (frame.dataLength < BT_COLOR_DATA_LEN)
     {
-        Serial.printf("错误: 颜色数据长度不足，需要%d字节，收到%d字节\n", BT_COLOR_DATA_LEN, frame.dataLength);
+        LOG_E("错误: 颜色数据长度不足，需要%d字节，收到%d字节", BT_COLOR_DATA_LEN, frame.dataLength);
         return;
     }
 
@@ -730,20 +846,20 @@ void handleColorCommand(const BluetoothFrame &frame)
     // 验证参数范围
     if (screenArea < BT_SCREEN_UPPER || screenArea > BT_SCREEN_BOTH)
     {
-        Serial.printf("错误: 无效的屏幕区域 0x%02X\n", screenArea);
+        LOG_E("错误: 无效的屏幕区域 0x%02X", screenArea);
         return;
     }
 
     if (target != BT_COLOR_TARGET_TEXT && target != BT_COLOR_TARGET_BACKGROUND)
     {
-        Serial.printf("错误: 无效的目标类型 0x%02X\n", target);
+        LOG_E("错误: 无效的目标类型 0x%02X", target);
         return;
     }
 
     // ⚠️ 重要限制：背景不可设置渐变色
     if (target == BT_COLOR_TARGET_BACKGROUND && mode == BT_COLOR_MODE_GRADIENT)
     {
-        Serial.println("错误: 背景不支持渐变色，只有文本可以设置渐变色");
+        LOG_E("错误: 背景不支持渐变色，只有文本可以设置渐变色");
         return;
     }
 
@@ -753,13 +869,13 @@ void handleColorCommand(const BluetoothFrame &frame)
     const char *targetName = (target == BT_COLOR_TARGET_TEXT) ? "文本" : "背景";
     const char *modeName = (mode == BT_COLOR_MODE_FIXED) ? "固定色" : "渐变色";
 
-    Serial.printf("设置颜色 - 区域: %s, 目标: %s, 模式: %s, RGB: (%d,%d,%d), 渐变模式: 0x%02X\n",
-                  areaName, targetName, modeName, r, g, b, gradientMode);
+    LOG_I("设置颜色 - 区域: %s, 目标: %s, 模式: %s, RGB: (%d,%d,%d), 渐变模式: 0x%02X",
+          areaName, targetName, modeName, r, g, b, gradientMode);
 
     // 检查是否为取消渐变色命令（渐变模式为0x00）
     if (gradientMode == 0x00 && target == BT_COLOR_TARGET_TEXT && mode == BT_COLOR_MODE_GRADIENT)
     {
-        Serial.println("取消渐变色，恢复最近一次固定色设置");
+        LOG_I("取消渐变色，恢复最近一次固定色设置");
 
         if (screenArea == BT_SCREEN_UPPER || screenArea == BT_SCREEN_BOTH)
         {
@@ -770,8 +886,8 @@ void handleColorCommand(const BluetoothFrame &frame)
             if (colorState.upperTextR != 0 || colorState.upperTextG != 0 || colorState.upperTextB != 0)
             {
                 colorState.upperTextColor = rgb888to565(colorState.upperTextR, colorState.upperTextG, colorState.upperTextB);
-                Serial.printf("上半屏恢复到最近颜色: RGB(%d,%d,%d)\n",
-                              colorState.upperTextR, colorState.upperTextG, colorState.upperTextB);
+                LOG_I("上半屏恢复到最近颜色: RGB(%d,%d,%d)",
+                      colorState.upperTextR, colorState.upperTextG, colorState.upperTextB);
             }
             else
             {
@@ -779,7 +895,7 @@ void handleColorCommand(const BluetoothFrame &frame)
                 colorState.upperTextR = 255;
                 colorState.upperTextG = 255;
                 colorState.upperTextB = 255;
-                Serial.println("上半屏无历史颜色记录，恢复默认白色");
+                LOG_I("上半屏无历史颜色记录，恢复默认白色");
             }
         }
 
@@ -792,8 +908,8 @@ void handleColorCommand(const BluetoothFrame &frame)
             if (colorState.lowerTextR != 0 || colorState.lowerTextG != 0 || colorState.lowerTextB != 0)
             {
                 colorState.lowerTextColor = rgb888to565(colorState.lowerTextR, colorState.lowerTextG, colorState.lowerTextB);
-                Serial.printf("下半屏恢复到最近颜色: RGB(%d,%d,%d)\n",
-                              colorState.lowerTextR, colorState.lowerTextG, colorState.lowerTextB);
+                LOG_I("下半屏恢复到最近颜色: RGB(%d,%d,%d)",
+                      colorState.lowerTextR, colorState.lowerTextG, colorState.lowerTextB);
             }
             else
             {
@@ -801,7 +917,7 @@ void handleColorCommand(const BluetoothFrame &frame)
                 colorState.lowerTextR = 255;
                 colorState.lowerTextG = 255;
                 colorState.lowerTextB = 255;
-                Serial.println("下半屏无历史颜色记录，恢复默认白色");
+                LOG_I("下半屏无历史颜色记录，恢复默认白色");
             }
         }
 
@@ -814,8 +930,8 @@ void handleColorCommand(const BluetoothFrame &frame)
             if (colorState.textR != 0 || colorState.textG != 0 || colorState.textB != 0)
             {
                 colorState.textColor = rgb888to565(colorState.textR, colorState.textG, colorState.textB);
-                Serial.printf("全屏恢复到最近颜色: RGB(%d,%d,%d)\n",
-                              colorState.textR, colorState.textG, colorState.textB);
+                LOG_I("全屏恢复到最近颜色: RGB(%d,%d,%d)",
+                      colorState.textR, colorState.textG, colorState.textB);
             }
             else
             {
@@ -823,7 +939,7 @@ void handleColorCommand(const BluetoothFrame &frame)
                 colorState.textR = 255;
                 colorState.textG = 255;
                 colorState.textB = 255;
-                Serial.println("全屏无历史颜色记录，恢复默认白色");
+                LOG_I("全屏无历史颜色记录，恢复默认白色");
             }
         }
 
@@ -964,14 +1080,15 @@ void handleBrightnessCommand(const BluetoothFrame &frame)
 {
     uint8_t brightness = frame.getBrightnessData();
 
-    Serial.printf("设置亮度: %d (%.1f%%)\n", brightness, brightness * 100.0 / 255.0);
+    LOG_I("设置亮度: %d (%d%%)", brightness, brightness * 100 / 255);
 
     // 更新亮度状态
     brightnessState.brightness = brightness;
     brightnessState.needBrightnessUpdate = true;
 
-    // 立即应用亮度设置
-    updateBrightness();
+    // 立即应用亮度设置（批量命令中推迟到场景整体渲染后）
+    if (!batchApplying)
+        updateBrightness();
 }
 
 // 更新亮度设置
@@ -982,9 +1099,9 @@ void updateBrightness()
         // 设置LED矩阵亮度
         dma_display->setBrightness8(brightnessState.brightness);
 
-        Serial.printf("亮度已更新: %d (%.1f%%)\n",
-                      brightnessState.brightness,
-                      brightnessState.brightness * 100.0 / 255.0);
+        LOG_I("亮度已更新: %d (%d%%)",
+              brightnessState.brightness,
+              brightnessState.brightness * 100 / 255);
 
         brightnessState.needBrightnessUpdate = false;
         textState.needUpdate = true; // 触发重绘以应用新亮度
@@ -996,7 +1113,7 @@ void handleEffectCommand(const BluetoothFrame &frame)
 {
     if (frame.dataLength < BT_EFFECT_DATA_LEN)
     {
-        Serial.printf("错误: 特效数据长度不足，需要%d字节，收到%d字节\n", BT_EFFECT_DATA_LEN, frame.dataLength);
+        LOG_E("错误: 特效数据长度不足，需要%d字节，收到%d字节", BT_EFFECT_DATA_LEN, frame.dataLength);
         return;
     }
 
@@ -1006,7 +1123,7 @@ void handleEffectCommand(const BluetoothFrame &frame)
     // 验证参数范围
     if (speed < 1 || speed > 10)
     {
-        Serial.printf("警告: 特效速度超出建议范围(1-10)，当前值: %d\n", speed);
+        LOG_W("警告: 特效速度超出建议范围(1-10)，当前值: %d", speed);
     }
 
     const char *areaName = (screenArea == BT_SCREEN_UPPER) ? "上半屏" : (screenArea == BT_SCREEN_LOWER) ? "下半屏"
@@ -1021,7 +1138,7 @@ void handleEffectCommand(const BluetoothFrame &frame)
                                                                         : (effectType == BT_EFFECT_SCROLL_DOWN)   ? "向下滚动"
                                                                                                                   : "未知特效";
 
-    Serial.printf("处理特效命令 - 区域: %s, 特效: %s, 速度: %d\n", areaName, effectName, speed);
+    LOG_I("处理特效命令 - 区域: %s, 特效: %s, 速度: %d", areaName, effectName, speed);
 
     bool isUpper = (screenArea == BT_SCREEN_UPPER || screenArea == BT_SCREEN_BOTH);
     bool isLower = (screenArea == BT_SCREEN_LOWER || screenArea == BT_SCREEN_BOTH);
@@ -1046,7 +1163,7 @@ void handleEffectCommand(const BluetoothFrame &frame)
             break;
         case BT_EFFECT_FIXED:
         default:
-            Serial.println("上半屏特效已清除（固定显示）");
+            LOG_I("上半屏特效已清除（固定显示）");
             break;
         }
     }
@@ -1070,7 +1187,7 @@ void handleEffectCommand(const BluetoothFrame &frame)
             break;
         case BT_EFFECT_FIXED:
         default:
-            Serial.println("下半屏特效已清除（固定显示）");
+            LOG_I("下半屏特效已清除（固定显示）");
             break;
         }
     }
@@ -1086,7 +1203,7 @@ void clearAllEffects(bool isUpper)
         effectState.upperScrollActive = false;
         effectState.upperBlinkActive = false;
         effectState.upperBreatheActive = false;
-        Serial.println("已清除上半屏所有特效");
+        LOG_I("已清除上半屏所有特效");
     }
     else
     {
@@ -1094,7 +1211,7 @@ void clearAllEffects(bool isUpper)
         effectState.lowerScrollActive = false;
         effectState.lowerBlinkActive = false;
         effectState.lowerBreatheActive = false;
-        Serial.println("已清除下半屏所有特效");
+        LOG_I("已清除下半屏所有特效");
     }
     textState.needUpdate = true;
 }
@@ -1116,7 +1233,7 @@ void setScrollEffect(bool isUpper, uint8_t scrollType, uint8_t speed)
                                                                                 : (scrollType == BT_EFFECT_SCROLL_UP)      ? "向上滚动"
                                                                                 : (scrollType == BT_EFFECT_SCROLL_DOWN)    ? "向下滚动"
                                                                                                                            : "未知滚动";
-        Serial.printf("上半屏启用滚动特效 - 类型: %s, 速度: %d\n", scrollName, speed);
+        LOG_I("上半屏启用滚动特效 - 类型: %s, 速度: %d", scrollName, speed);
     }
     else
     {
@@ -1128,7 +1245,7 @@ void setScrollEffect(bool isUpper, uint8_t scrollType, uint8_t speed)
                                                                                 : (scrollType == BT_EFFECT_SCROLL_UP)      ? "向上滚动"
                                                                                 : (scrollType == BT_EFFECT_SCROLL_DOWN)    ? "向下滚动"
                                                                                                                            : "未知滚动";
-        Serial.printf("下半屏启用滚动特效 - 类型: %s, 速度: %d\n", scrollName, speed);
+        LOG_I("下半屏启用滚动特效 - 类型: %s, 速度: %d", scrollName, speed);
     }
     textState.needUpdate = true;
 }
@@ -1145,14 +1262,14 @@ void setBlinkEffect(bool isUpper, uint8_t speed)
         effectState.upperBlinkActive = true;
         effectState.upperBlinkSpeed = speed;
         effectState.upperBlinkVisible = true;
-        Serial.printf("上半屏启用闪烁特效 - 速度: %d\n", speed);
+        LOG_I("上半屏启用闪烁特效 - 速度: %d", speed);
     }
     else
     {
         effectState.lowerBlinkActive = true;
         effectState.lowerBlinkSpeed = speed;
         effectState.lowerBlinkVisible = true;
-        Serial.printf("下半屏启用闪烁特效 - 速度: %d\n", speed);
+        LOG_I("下半屏启用闪烁特效 - 速度: %d", speed);
     }
     textState.needUpdate = true;
 }
@@ -1169,183 +1286,235 @@ void setBreatheEffect(bool isUpper, uint8_t speed)
         effectState.upperBreatheActive = true;
         effectState.upperBreatheSpeed = speed;
         effectState.upperBreathePhase = 0.0;
-        Serial.printf("上半屏启用呼吸特效 - 速度: %d\n", speed);
+        LOG_I("上半屏启用呼吸特效 - 速度: %d", speed);
     }
     else
     {
         effectState.lowerBreatheActive = true;
         effectState.lowerBreatheSpeed = speed;
         effectState.lowerBreathePhase = 0.0;
-        Serial.printf("下半屏启用呼吸特效 - 速度: %d\n", speed);
+        LOG_I("下半屏启用呼吸特效 - 速度: %d", speed);
     }
     textState.needUpdate = true;
 }
 
-// 显示滚动文本（支持水平和竖向显示，支持呼吸特效）
-void displayScrollingText(const uint16_t *font_data, int char_count, int offset, int y, uint8_t scrollType)
+// 计算滚动文本起始x坐标（文本总像素宽度为textPixelWidth）
+static int getScrollStartX(int textPixelWidth, int offset, uint8_t scrollType)
 {
-    if (char_count == 0)
-        return;
+    if (scrollType == BT_EFFECT_SCROLL_RIGHT || scrollType == BT_EFFECT_SCROLL_DOWN)
+    {
+        // 右滚动或向下滚动：从左边进入，向右移动
+        return offset - textPixelWidth;
+    }
+    // 左滚动或向上滚动：从右边进入，向左移动
+    return SCREEN_WIDTH - offset;
+}
 
+// 落在屏幕内的字符范围：返回第一个可见字符序号，visibleCount为可见字符数（可能为0）
+// 长文本与流式文本都只取这一段绘制，不遍历屏幕外的字符
+static int getVisibleSpan(int x, int charCount, int spacing, int &visibleCount)
+{
+    int first = (x < 0) ? -x / spacing : 0;
+    int last = (SCREEN_WIDTH - x + spacing - 1) / spacing; // 最后一个可见字符之后的序号
+    if (last > charCount)
+        last = charCount;
+    visibleCount = (x < SCREEN_WIDTH && last > first) ? last - first : 0;
+    return first;
+}
+
+// 以滚动样式绘制一段16x16字符（支持水平和竖向显示，支持呼吸特效）
+static void drawScrollingSpan16x16(const GlyphText &text, int x, int y)
+{
     bool isUpper = (y < 16);
     bool isVertical = (textState.displayDirection == BT_DIRECTION_VERTICAL);
-    int textPixelWidth = char_count * CHAR_SPACING_16; // 文本总像素宽度
-    int x = 0;
 
-    // 根据滚动类型和显示方向计算位置
-    if (scrollType == BT_EFFECT_SCROLL_LEFT || scrollType == BT_EFFECT_SCROLL_UP)
+    // 检查是否使用渐变色
+    uint8_t textMode = isUpper ? colorState.upperTextMode : colorState.lowerTextMode;
+    uint8_t gradientMode = isUpper ? colorState.upperGradientMode : colorState.lowerGradientMode;
+    bool useGradient = (textMode == BT_COLOR_MODE_GRADIENT && gradientMode != BT_GRADIENT_FIXED);
+
+    if (useGradient)
     {
-        // 左滚动或向上滚动：从右边进入，向左移动
-        x = SCREEN_WIDTH - offset;
+        // 使用渐变色显示（渐变色不支持呼吸特效）
+        if (isVertical)
+        {
+            drawString16x16VerticalGradient(x, y, text, isUpper, gradientMode);
+        }
+        else
+        {
+            drawString16x16Gradient(x, y, text, isUpper, gradientMode);
+        }
     }
-    else if (scrollType == BT_EFFECT_SCROLL_RIGHT || scrollType == BT_EFFECT_SCROLL_DOWN)
+    else
     {
-        // 右滚动或向下滚动：从左边进入，向右移动
-        x = offset - textPixelWidth;
+        // 获取基础颜色
+        uint16_t baseColor = isUpper ? colorState.upperTextColor : colorState.lowerTextColor;
+        uint16_t textColor = baseColor;
+
+        // 应用呼吸特效（如果激活）
+        bool breatheActive = isUpper ? effectState.upperBreatheActive : effectState.lowerBreatheActive;
+        if (breatheActive)
+        {
+            float phase = isUpper ? effectState.upperBreathePhase : effectState.lowerBreathePhase;
+            float brightness = (sin(phase) + 1.0) / 2.0; // 0.0 到 1.0 的正弦波
+            brightness = 0.2 + brightness * 0.8;         // 范围从0.2到1.0，避免完全黑暗
+
+            // 提取RGB分量（RGB565格式）
+            uint8_t r = (baseColor >> 11) & 0x1F; // 5位红色
+            uint8_t g = (baseColor >> 5) & 0x3F;  // 6位绿色
+            uint8_t b = baseColor & 0x1F;         // 5位蓝色
+
+            // 应用呼吸亮度
+            r = (uint8_t)(r * brightness);
+            g = (uint8_t)(g * brightness);
+            b = (uint8_t)(b * brightness);
+
+            // 重新组合颜色
+            textColor = (r << 11) | (g << 5) | b;
+        }
+
+        // 根据显示方向使用对应的绘制函数
+        if (isVertical)
+        {
+            drawString16x16Vertical(x, y, text, textColor);
+        }
+        else
+        {
+            drawString16x16(x, y, text, textColor);
+        }
     }
+}
 
-    // 只在屏幕范围内绘制文本
-    if (x < SCREEN_WIDTH && x + textPixelWidth > 0)
-    {
-        // 检查是否使用渐变色
-        uint8_t textMode = isUpper ? colorState.upperTextMode : colorState.lowerTextMode;
-        uint8_t gradientMode = isUpper ? colorState.upperGradientMode : colorState.lowerGradientMode;
-        bool useGradient = (textMode == BT_COLOR_MODE_GRADIENT && gradientMode != BT_GRADIENT_FIXED);
+// 以滚动样式绘制一段32x32字符
+static void drawScrollingSpan32x32(const GlyphText &text, int x, int y)
+{
+    bool isVertical = (textState.displayDirection == BT_DIRECTION_VERTICAL);
 
-        if (useGradient)
+    // 检查是否使用渐变色
+    uint8_t textMode = colorState.textMode;
+    uint8_t gradientMode = colorState.gradientMode;
+    bool useGradient = (textMode == BT_COLOR_MODE_GRADIENT && gradientMode != BT_GRADIENT_FIXED);
+
+    if (useGradient)
+    {
+        // 使用渐变色显示（渐变色不支持呼吸特效）
+        if (isVertical)
         {
-            // 使用渐变色显示（渐变色不支持呼吸特效）
-            if (isVertical)
-            {
-                drawString16x16VerticalGradient(x, y, font_data, char_count, isUpper, gradientMode);
-            }
-            else
-            {
-                drawString16x16Gradient(x, y, font_data, char_count, isUpper, gradientMode);
-            }
+            drawString32x32VerticalGradient(x, y, text, gradientMode);
         }
         else
         {
-            // 获取基础颜色
-            uint16_t baseColor = isUpper ? colorState.upperTextColor : colorState.lowerTextColor;
-            uint16_t textColor = baseColor;
+            drawString32x32Gradient(x, y, text, gradientMode);
+        }
+    }
+    else
+    {
+        // 获取基础颜色
+        uint16_t baseColor = colorState.textColor;
+        uint16_t textColor = baseColor;
 
-            // 应用呼吸特效（如果激活）
-            bool breatheActive = isUpper ? effectState.upperBreatheActive : effectState.lowerBreatheActive;
-            if (breatheActive)
-            {
-                float phase = isUpper ? effectState.upperBreathePhase : effectState.lowerBreathePhase;
-                float brightness = (sin(phase) + 1.0) / 2.0; // 0.0 到 1.0 的正弦波
-                brightness = 0.2 + brightness * 0.8;         // 范围从0.2到1.0，避免完全黑暗
-
-                // 提取RGB分量（RGB565格式）
-                uint8_t r = (baseColor >> 11) & 0x1F; // 5位红色
-                uint8_t g = (baseColor >> 5) & 0x3F;  // 6位绿色
-                uint8_t b = baseColor & 0x1F;         // 5位蓝色
-
-                // 应用呼吸亮度
-                r = (uint8_t)(r * brightness);
-                g = (uint8_t)(g * brightness);
-                b = (uint8_t)(b * brightness);
-
-                // 重新组合颜色
-                textColor = (r << 11) | (g << 5) | b;
-            }
+        // 应用呼吸特效（如果激活）- 32x32使用上半屏呼吸状态
+        bool breatheActive = effectState.upperBreatheActive;
+        if (breatheActive)
+        {
+            float phase = effectState.upperBreathePhase;
+            float brightness = (sin(phase) + 1.0) / 2.0; // 0.0 到 1.0 的正弦波
+            brightness = 0.2 + brightness * 0.8;         // 范围从0.2到1.0，避免完全黑暗
+
+            // 提取RGB分量（RGB565格式）
+            uint8_t r = (baseColor >> 11) & 0x1F; // 5位红色
+            uint8_t g = (baseColor >> 5) & 0x3F;  // 6位绿色
+            uint8_t b = baseColor & 0x1F;         // 5位蓝色
+
+            // 应用呼吸亮度
+            r = (uint8_t)(r * brightness);
+            g = (uint8_t)(g * brightness);
+            b = (uint8_t)(b * brightness);
+
+            // 重新组合颜色
+            textColor = (r << 11) | (g << 5) | b;
+        }
 
-            // 根据显示方向使用对应的绘制函数
-            if (isVertical)
-            {
-                drawString16x16Vertical(x, y, font_data, char_count, textColor);
-            }
-            else
-            {
-                drawString16x16(x, y, font_data, char_count, textColor);
-            }
+        // 根据显示方向使用对应的绘制函数
+        if (isVertical)
+        {
+            drawString32x32Vertical(x, y, text, textColor);
+        }
+        else
+        {
+            drawString32x32(x, y, text, textColor);
         }
     }
 }
 
-// 显示32x32滚动文本（仿照16x16逻辑）
-void displayScrollingText32x32(const uint16_t *font_data, int char_count, int offset, int y, uint8_t scrollType)
+// 显示滚动文本（支持水平和竖向显示，支持呼吸特效）
+void displayScrollingText(const GlyphText &text, int offset, int y, uint8_t scrollType)
 {
+    int char_count = text.count;
     if (char_count == 0)
         return;
 
-    bool isVertical = (textState.displayDirection == BT_DIRECTION_VERTICAL);
-    int textPixelWidth = char_count * CHAR_SPACING_32; // 32x32文本总像素宽度
-    int x = 0;
-
-    // 根据滚动类型和显示方向计算位置
-    if (scrollType == BT_EFFECT_SCROLL_LEFT || scrollType == BT_EFFECT_SCROLL_UP)
+    int x = getScrollStartX(char_count * CHAR_SPACING_16, offset, scrollType);
+    int visibleCount;
+    int first = getVisibleSpan(x, char_count, CHAR_SPACING_16, visibleCount);
+    if (visibleCount > 0)
     {
-        // 左滚动或向上滚动：从右边进入，向左移动
-        x = SCREEN_WIDTH - offset;
+        drawScrollingSpan16x16(text.slice(first, visibleCount), x + first * CHAR_SPACING_16, y);
     }
-    else if (scrollType == BT_EFFECT_SCROLL_RIGHT || scrollType == BT_EFFECT_SCROLL_DOWN)
+}
+
+// 显示32x32滚动文本（仿照16x16逻辑）
+void displayScrollingText32x32(const GlyphText &text, int offset, int y, uint8_t scrollType)
+{
+    int char_count = text.count;
+    if (char_count == 0)
+        return;
+
+    int x = getScrollStartX(char_count * CHAR_SPACING_32, offset, scrollType);
+    int visibleCount;
+    int first = getVisibleSpan(x, char_count, CHAR_SPACING_32, visibleCount);
+    if (visibleCount > 0)
     {
-        // 右滚动或向下滚动：从左边进入，向右移动
-        x = offset - textPixelWidth;
+        drawScrollingSpan32x32(text.slice(first, visibleCount), x + first * CHAR_SPACING_32, y);
     }
+}
+
+// 显示流式文本：只从读前窗口取可见位置的字形；未开启滚动时从第一个字符开始静止显示
+void displayStreamingText(bool isUpper, int y)
+{
+    bool is32 = (currentFontSize == BT_FONT_32x32);
+    int spacing = is32 ? CHAR_SPACING_32 : CHAR_SPACING_16;
+    int char_count = (int)textStream.getCharCount();
 
-    // 只在屏幕范围内绘制文本
-    if (x < SCREEN_WIDTH && x + textPixelWidth > 0)
+    int x = 0;
+    bool scrollActive = isUpper ? effectState.upperScrollActive : effectState.lowerScrollActive;
+    if (scrollActive)
     {
-        // 检查是否使用渐变色
-        uint8_t textMode = colorState.textMode;
-        uint8_t gradientMode = colorState.gradientMode;
-        bool useGradient = (textMode == BT_COLOR_MODE_GRADIENT && gradientMode != BT_GRADIENT_FIXED);
+        uint8_t scrollType = isUpper ? effectState.upperScrollType : effectState.lowerScrollType;
+        int scrollOffset = isUpper ? effectState.upperScrollOffset : effectState.lowerScrollOffset;
+        x = getScrollStartX(char_count * spacing, scrollOffset, scrollType);
+    }
 
-        if (useGradient)
-        {
-            // 使用渐变色显示（渐变色不支持呼吸特效）
-            if (isVertical)
-            {
-                drawString32x32VerticalGradient(x, y, font_data, char_count, gradientMode);
-            }
-            else
-            {
-                drawString32x32Gradient(x, y, font_data, char_count, gradientMode);
-            }
-        }
-        else
-        {
-            // 获取基础颜色
-            uint16_t baseColor = colorState.textColor;
-            uint16_t textColor = baseColor;
+    int visibleCount;
+    int first = getVisibleSpan(x, char_count, spacing, visibleCount);
+    GlyphText visible = textStream.fetch(first, visibleCount);
+    if (visible.count == 0)
+        return;
 
-            // 应用呼吸特效（如果激活）- 32x32使用上半屏呼吸状态
-            bool breatheActive = effectState.upperBreatheActive;
-            if (breatheActive)
-            {
-                float phase = effectState.upperBreathePhase;
-                float brightness = (sin(phase) + 1.0) / 2.0; // 0.0 到 1.0 的正弦波
-                brightness = 0.2 + brightness * 0.8;         // 范围从0.2到1.0，避免完全黑暗
-
-                // 提取RGB分量（RGB565格式）
-                uint8_t r = (baseColor >> 11) & 0x1F; // 5位红色
-                uint8_t g = (baseColor >> 5) & 0x3F;  // 6位绿色
-                uint8_t b = baseColor & 0x1F;         // 5位蓝色
-
-                // 应用呼吸亮度
-                r = (uint8_t)(r * brightness);
-                g = (uint8_t)(g * brightness);
-                b = (uint8_t)(b * brightness);
-
-                // 重新组合颜色
-                textColor = (r << 11) | (g << 5) | b;
-            }
+    if (is32)
+        drawScrollingSpan32x32(visible, x + first * spacing, y);
+    else
+        drawScrollingSpan16x16(visible, x + first * spacing, y);
+}
 
-            // 根据显示方向使用对应的绘制函数
-            if (isVertical)
-            {
-                drawString32x32Vertical(x, y, font_data, char_count, textColor);
-            }
-            else
-            {
-                drawString32x32(x, y, font_data, char_count, textColor);
-            }
-        }
-    }
+// 滚动区域的字符数（32x32时isUpper为true表示全屏）
+static int getScrollCharCount(bool isUpper)
+{
+    if (isRegionStreaming(isUpper))
+        return (int)textStream.getCharCount();
+    if (currentFontSize == BT_FONT_32x32)
+        return getFullDisplayText().count;
+    return isUpper ? getUpperDisplayText().count : getLowerDisplayText().count;
 }
 
 // 更新滚动特效（支持速度控制）
@@ -1370,30 +1539,18 @@ void updateScrollEffect()
 
         if (currentTime - lastUpperScrollTime >= upperScrollInterval)
         {
-            int upperCharCount, textPixelWidth;
-
-            // 根据字体大小计算字符数和像素宽度（优先使用动态数据）
-            if (currentFontSize == BT_FONT_32x32)
-            {
-                // 32x32字体：优先使用动态数据
-                upperCharCount = (dynamic_full_text && dynamic_full_char_count > 0)
-                                     ? dynamic_full_char_count
-                                     : getFullTextCharCount();
-                textPixelWidth = upperCharCount * CHAR_SPACING_32;
-            }
-            else
-            {
-                // 16x16字体：优先使用动态数据
-                upperCharCount = (dynamic_upper_text && dynamic_upper_char_count > 0)
-                                     ? dynamic_upper_char_count
-                                     : getUpperTextCharCount();
-                textPixelWidth = upperCharCount * CHAR_SPACING_16;
-            }
+            // 根据字体大小计算字符数和像素宽度（流式文本优先，其次动态数据）
+            int spacing = (currentFontSize == BT_FONT_32x32) ? CHAR_SPACING_32 : CHAR_SPACING_16;
+            int textPixelWidth = getScrollCharCount(true) * spacing;
 
             int maxOffset = SCREEN_WIDTH + textPixelWidth; // 完全滚出屏幕的偏移量
 
             effectState.upperScrollOffset += upperMoveDistance;
-            if (effectState.upperScrollOffset >= maxOffset)
+            if (isTickerRunning(true))
+            {
+                effectState.upperScrollOffset = advanceTicker(true, effectState.upperScrollOffset); // 滚动队列首尾相接，不回到起点
+            }
+            else if (effectState.upperScrollOffset >= maxOffset)
             {
                 effectState.upperScrollOffset = 0; // 重新开始滚动
             }
@@ -1411,15 +1568,16 @@ void updateScrollEffect()
 
         if (currentTime - lastLowerScrollTime >= lowerScrollInterval)
         {
-            // 下半屏：优先使用动态数据
-            int lowerCharCount = (dynamic_lower_text && dynamic_lower_char_count > 0)
-                                     ? dynamic_lower_char_count
-                                     : getLowerTextCharCount();
-            int textPixelWidth = lowerCharCount * CHAR_SPACING_16;
+            // 下半屏：流式文本优先，其次动态数据
+            int textPixelWidth = getScrollCharCount(false) * CHAR_SPACING_16;
             int maxOffset = SCREEN_WIDTH + textPixelWidth; // 完全滚出屏幕的偏移量
 
             effectState.lowerScrollOffset += lowerMoveDistance;
-            if (effectState.lowerScrollOffset >= maxOffset)
+            if (isTickerRunning(false))
+            {
+                effectState.lowerScrollOffset = advanceTicker(false, effectState.lowerScrollOffset); // 滚动队列首尾相接，不回到起点
+            }
+            else if (effectState.lowerScrollOffset >= maxOffset)
             {
                 effectState.lowerScrollOffset = 0; // 重新开始滚动
             }
@@ -1544,25 +1702,25 @@ void updateAllEffects()
 // 演示如何使用蓝牙点阵数据
 void demoBluetoothDataUsage()
 {
-    Serial.println("=== 蓝牙点阵数据使用示例 ===");
+    LOG_I("=== 蓝牙点阵数据使用示例 ===");
 
     // 示例1：16x16模式 - 传入自定义点阵数据
     if (currentFontSize == BT_FONT_16x16)
     {
         // 假设这是从蓝牙接收到的点阵数据
-        uint16_t customUpperData[] = {
+        static const uint16_t customUpperData[] = {
             // 自定义上半屏点阵数据 (1个字符，16个uint16_t)
             0x0000, 0x0180, 0x03C0, 0x07E0, 0x0FF0, 0x1FF8, 0x3FFC, 0x7FFE,
             0x7FFE, 0x3FFC, 0x1FF8, 0x0FF0, 0x07E0, 0x03C0, 0x0180, 0x0000};
 
-        uint16_t customLowerData[] = {
+        static const uint16_t customLowerData[] = {
             // 自定义下半屏点阵数据 (1个字符，16个uint16_t)
             0xFFFF, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001,
             0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0xFFFF};
 
         // 调用新的API传入点阵数据
-        handleTextCommand(customUpperData, 1, customLowerData, 1);
-        Serial.println("16x16自定义点阵数据已设置");
+        handleTextCommand(GlyphText(customUpperData, 1, 16), GlyphText(customLowerData, 1, 16));
+        LOG_I("16x16自定义点阵数据已设置");
     }
 
     // 示例2：32x32模式 - 传入自定义点阵数据
@@ -1577,13 +1735,13 @@ void demoBluetoothDataUsage()
         }
 
         // 调用新的API传入点阵数据
-        handleFullScreenTextCommand(custom32x32Data, 1);
-        Serial.println("32x32自定义点阵数据已设置");
+        handleFullScreenTextCommand(GlyphText(custom32x32Data, 1, 64));
+        LOG_I("32x32自定义点阵数据已设置");
     }
 
-    Serial.println("=== 使用说明 ===");
-    Serial.println("1. 接收蓝牙数据：uint16_t* bluetoothData, int charCount");
-    Serial.println("2. 16x16模式调用：handleTextCommand(upperData, upperCount, lowerData, lowerCount)");
-    Serial.println("3. 32x32模式调用：handleFullScreenTextCommand(fontData, charCount)");
-    Serial.println("4. 数据会自动显示，无需其他操作");
+    LOG_I("=== 使用说明 ===");
+    LOG_I("1. 接收蓝牙数据：uint16_t* bluetoothData, int charCount");
+    LOG_I("2. 16x16模式调用：handleTextCommand(upperData, upperCount, lowerData, lowerCount)");
+    LOG_I("3. 32x32模式调用：handleFullScreenTextCommand(fontData, charCount)");
+    LOG_I("4. 数据会自动显示，无需其他操作");
 }
\ No newline at end of file
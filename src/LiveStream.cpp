@@ -0,0 +1,292 @@
+#include "LiveStream.h"
+#include "ImageMode.h"
+#include "Animation.h"
+#include "LEDController.h"
+#include "DisplayDriver.h"
+#include "Paging.h"
+#include "MemoryPool.h"
+#include "Log.h"
+
+LiveStreamState liveStream = {};
+
+// 行标记按位存放，屏幕行数不能超过32
+static_assert(SCREEN_HEIGHT <= 32, "dirtyRows只能标记32行");
+
+static const uint32_t ALL_ROWS = (SCREEN_HEIGHT == 32) ? 0xFFFFFFFFUL : ((1UL << SCREEN_HEIGHT) - 1);
+
+static void markRowDirty(int index)
+{
+    liveStream.dirtyRows |= 1UL << (index / SCREEN_WIDTH);
+}
+
+// 帧号按16位循环计数比较，返回seq相对ref的先后（正数为更新）
+static int16_t seqDiff(uint16_t seq, uint16_t ref)
+{
+    return (int16_t)(seq - ref);
+}
+
+bool isLiveStreaming()
+{
+    return liveStream.active;
+}
+
+static void writeBE16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)(value & 0xFF);
+}
+
+static void writeBE32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)(value >> 24);
+    p[1] = (uint8_t)(value >> 16);
+    p[2] = (uint8_t)(value >> 8);
+    p[3] = (uint8_t)(value & 0xFF);
+}
+
+// 统计应答：[操作][状态][是否进行中][最近呈现帧号2][收到4][呈现4][被取代4][丢弃4][接收帧率2][呈现帧率2]
+static void sendLiveStats(uint8_t op)
+{
+    uint8_t response[25];
+    response[0] = op;
+    response[1] = BT_LIVE_STATUS_OK;
+    response[2] = liveStream.active ? 1 : 0;
+    writeBE16(response + 3, liveStream.presentedSeq);
+    writeBE32(response + 5, liveStream.received);
+    writeBE32(response + 9, liveStream.presented);
+    writeBE32(response + 13, liveStream.superseded);
+    writeBE32(response + 17, liveStream.dropped);
+    writeBE16(response + 21, liveStream.receiveFps);
+    writeBE16(response + 23, liveStream.presentFps);
+    sendResponseFrame(BT_CMD_LIVE, response, sizeof(response));
+}
+
+// 帧处理只在出错时应答：[操作][状态][帧号2]
+static void sendLiveStatus(uint8_t op, uint8_t status, uint16_t seq)
+{
+    uint8_t response[4] = {op, status, (uint8_t)(seq >> 8), (uint8_t)(seq & 0xFF)};
+    sendResponseFrame(BT_CMD_LIVE, response, sizeof(response));
+}
+
+// 进入实时流：与动画、图像模式都占据整屏，后到的替换先到的
+static bool startLiveStream()
+{
+    if (liveStream.active)
+        return true;
+
+    // 缓冲区与动画、图像共用，须先让它们退出
+    stopAnimation();
+    exitImageMode();
+    releasePagingBitmaps();
+    uint16_t *buffer = (uint16_t *)mediaBuffer.acquire(LIVE_BUFFER_BYTES);
+    if (!buffer)
+        return false;
+
+    liveStream = {};
+    liveStream.back = buffer;
+    liveStream.front = buffer + IMAGE_PIXEL_COUNT;
+    liveStream.fullRedraw = true;
+    liveStream.windowStart = millis();
+    liveStream.active = true;
+    LOG_I("进入实时流模式");
+    return true;
+}
+
+void stopLiveStream()
+{
+    if (!liveStream.active)
+        return;
+
+    LOG_I("结束实时流 - 收到: %u帧, 呈现: %u帧, 被取代: %u帧, 丢弃: %u帧",
+          liveStream.received, liveStream.presented, liveStream.superseded, liveStream.dropped);
+    liveStream.active = false;
+    mediaBuffer.release();
+    liveStream.back = nullptr;
+    liveStream.front = nullptr;
+    textState.needUpdate = true; // 恢复文本显示
+}
+
+// 新帧已解码到后台缓冲；上一帧尚未呈现则被取代
+static void commitDecodedFrame(uint16_t seq)
+{
+    if (liveStream.pending)
+        liveStream.superseded++;
+    liveStream.pending = true;
+    liveStream.decodedSeq = seq;
+}
+
+// 增量链断开：丢弃该帧，首次断开时请求关键帧
+static void dropBrokenChain(uint8_t op, uint16_t seq)
+{
+    liveStream.chainValid = false;
+    liveStream.dropped++;
+    if (!liveStream.keyframeRequested)
+    {
+        liveStream.keyframeRequested = true;
+        LOG_W("实时流增量链断开 - 帧号: %u, 最近解码: %u", seq, liveStream.decodedSeq);
+        sendLiveStatus(op, BT_LIVE_STATUS_NEED_KEYFRAME, seq);
+    }
+}
+
+static void handleKeyframe(uint8_t op, uint16_t seq, const uint8_t *data, int length)
+{
+    if (!validateFullImage(op, data, length))
+    {
+        liveStream.dropped++;
+        sendLiveStatus(op, BT_LIVE_STATUS_INVALID, seq);
+        return;
+    }
+    // 不新于已解码帧的关键帧是迟到的，直接丢弃
+    if (liveStream.chainValid && seqDiff(seq, liveStream.decodedSeq) <= 0)
+    {
+        liveStream.dropped++;
+        return;
+    }
+
+    decodeFullImage(op, data, liveStream.back);
+    liveStream.dirtyRows = ALL_ROWS;
+    liveStream.chainValid = true;
+    liveStream.keyframeRequested = false;
+    commitDecodedFrame(seq);
+}
+
+static void handleDelta(uint8_t op, uint16_t seq, const uint8_t *data, int length)
+{
+    if (!liveStream.chainValid)
+    {
+        dropBrokenChain(op, seq);
+        return;
+    }
+
+    int16_t diff = seqDiff(seq, liveStream.decodedSeq);
+    if (diff <= 0)
+    {
+        liveStream.dropped++; // 迟到或重复的帧，不影响增量链
+        return;
+    }
+    if (diff > 1)
+    {
+        dropBrokenChain(op, seq); // 中间有帧丢失，后台缓冲已无法接续
+        return;
+    }
+
+    // 先整体校验，格式错误时后台缓冲不变，但该帧已丢失，增量链同样断开
+    if (applyImageDelta(data, length, nullptr, nullptr) < 0)
+    {
+        sendLiveStatus(op, BT_LIVE_STATUS_INVALID, seq);
+        dropBrokenChain(op, seq);
+        return;
+    }
+    applyImageDelta(data, length, liveStream.back, markRowDirty);
+    commitDecodedFrame(seq);
+}
+
+// 把后台缓冲呈现到屏上：只处理被修改过的行，只重绘与屏上不同的像素
+static void presentFrame()
+{
+    for (int y = 0; y < SCREEN_HEIGHT; y++)
+    {
+        if (!(liveStream.dirtyRows & (1UL << y)))
+            continue;
+
+        const uint16_t *back = liveStream.back + y * SCREEN_WIDTH;
+        uint16_t *front = liveStream.front + y * SCREEN_WIDTH;
+        for (int x = 0; x < SCREEN_WIDTH; x++)
+        {
+            if (back[x] != front[x] || liveStream.fullRedraw)
+            {
+                drawPanelPixel(x, y, back[x]);
+                front[x] = back[x];
+            }
+        }
+    }
+    liveStream.dirtyRows = 0;
+    liveStream.fullRedraw = false;
+    liveStream.pending = false;
+    liveStream.presentedSeq = liveStream.decodedSeq;
+    liveStream.presented++;
+    liveStream.windowPresented++;
+}
+
+void updateLiveStream()
+{
+    if (!liveStream.active)
+        return;
+
+    unsigned long now = millis();
+    if (liveStream.pending && now - liveStream.lastPresent >= LIVE_PRESENT_INTERVAL_MS)
+    {
+        presentFrame();
+        liveStream.lastPresent = now;
+    }
+
+    unsigned long elapsed = now - liveStream.windowStart;
+    if (elapsed >= LIVE_STATS_WINDOW_MS)
+    {
+        liveStream.receiveFps = (uint16_t)(liveStream.windowReceived * 1000UL / elapsed);
+        liveStream.presentFps = (uint16_t)(liveStream.windowPresented * 1000UL / elapsed);
+        liveStream.windowReceived = 0;
+        liveStream.windowPresented = 0;
+        liveStream.windowStart = now;
+        LOG_D("实时流 - 接收: %dfps, 呈现: %dfps, 丢弃: %u帧",
+              liveStream.receiveFps, liveStream.presentFps, liveStream.dropped);
+    }
+}
+
+// 处理实时流命令 (0x16)
+// 帧数据：[操作][帧号2][编码数据]，编码与图像命令的同名操作相同；结束与统计只有操作字节
+// 帧正常处理时不应答，以免应答占用链路；出错、结束与统计时应答，格式见蓝牙实时流帧格式.md
+void handleLiveStreamCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 1)
+    {
+        LOG_E("错误: 实时流数据无效");
+        return;
+    }
+
+    uint8_t op = frame.data[0];
+    switch (op)
+    {
+    case BT_LIVE_KEY_RGB565:
+    case BT_LIVE_KEY_PALETTE:
+    case BT_LIVE_DELTA:
+    {
+        if (frame.dataLength < BT_LIVE_HEADER_LEN)
+        {
+            sendLiveStatus(op, BT_LIVE_STATUS_INVALID, 0);
+            return;
+        }
+        uint16_t seq = (uint16_t)((frame.data[1] << 8) | frame.data[2]);
+        const uint8_t *data = frame.data + BT_LIVE_HEADER_LEN;
+        int length = frame.dataLength - BT_LIVE_HEADER_LEN;
+
+        if (!startLiveStream())
+        {
+            LOG_E("错误: 实时流缓冲区不可用");
+            sendLiveStatus(op, BT_LIVE_STATUS_INVALID, seq);
+            return;
+        }
+        liveStream.received++;
+        liveStream.windowReceived++;
+        if (op == BT_LIVE_DELTA)
+            handleDelta(op, seq, data, length);
+        else
+            handleKeyframe(op, seq, data, length);
+        break;
+    }
+
+    case BT_LIVE_STOP:
+        sendLiveStats(op);
+        stopLiveStream();
+        break;
+
+    case BT_LIVE_STATS:
+        sendLiveStats(op);
+        break;
+
+    default:
+        LOG_E("错误: 未知的实时流操作 0x%02X", op);
+        sendLiveStatus(op, BT_LIVE_STATUS_INVALID, 0);
+        break;
+    }
+}
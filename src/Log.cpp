@@ -0,0 +1,168 @@
+#include "Log.h"
+
+#ifdef ARDUINO
+#include "freertos/FreeRTOS.h"
+static portMUX_TYPE logMux = portMUX_INITIALIZER_UNLOCKED; // 其他任务也可能写日志
+#define LOG_LOCK() portENTER_CRITICAL(&logMux)
+#define LOG_UNLOCK() portEXIT_CRITICAL(&logMux)
+#define logSerial Serial
+#else
+#include <stdio.h>
+#define LOG_LOCK()
+#define LOG_UNLOCK()
+
+// 主机构建（单元测试）输出到标准输出，接口与串口相同
+struct StdoutLogSerial
+{
+    void setTxBufferSize(size_t) {}
+    int availableForWrite() { return LOG_DRAIN_HEADROOM; }
+    size_t write(const uint8_t *data, size_t length) { return fwrite(data, 1, length, stdout); }
+    template <typename... Args>
+    int printf(const char *format, Args... args) { return ::printf(format, args...); }
+    void println() { ::printf("\n"); }
+};
+static StdoutLogSerial logSerial;
+#endif
+
+static LogRecord logBuffer[LOG_BUFFER_RECORDS];
+static uint16_t logHead = 0;           // 下一条写入位置
+static uint16_t logTail = 0;           // 下一条输出位置
+static uint16_t logCount = 0;          // 缓冲区中的记录数
+static uint32_t logDropped = 0;        // 累计丢弃条数
+static uint32_t logDroppedPending = 0; // 尚未提示的丢弃条数
+
+void logBegin()
+{
+    logSerial.setTxBufferSize(LOG_SERIAL_TX_BUFFER);
+}
+
+void logPush(uint8_t level, const char *format, const uintptr_t *args, uint8_t argCount)
+{
+    uint32_t now = millis();
+
+    LOG_LOCK();
+    if (logCount >= LOG_BUFFER_RECORDS)
+    {
+        logDropped++;
+        logDroppedPending++;
+        LOG_UNLOCK();
+        return;
+    }
+
+    LogRecord &record = logBuffer[logHead];
+    record.timestamp = now;
+    record.format = format;
+    record.level = level;
+    record.argCount = argCount;
+    for (uint8_t i = 0; i < LOG_MAX_ARGS; i++)
+    {
+        record.args[i] = (i < argCount) ? args[i] : 0;
+    }
+    logHead = (logHead + 1) % LOG_BUFFER_RECORDS;
+    logCount++;
+    LOG_UNLOCK();
+}
+
+uint32_t logGetDroppedCount()
+{
+    return logDropped;
+}
+
+static char levelChar(uint8_t level)
+{
+    switch (level)
+    {
+    case LOG_LEVEL_ERROR:
+        return 'E';
+    case LOG_LEVEL_WARN:
+        return 'W';
+    case LOG_LEVEL_INFO:
+        return 'I';
+    default:
+        return 'D';
+    }
+}
+
+// 输出一条记录；二进制格式：[0xA5][级别][参数个数][时间戳4字节][格式串地址4字节][参数各4字节]，小端
+static void writeRecord(const LogRecord &record)
+{
+#if LOG_BINARY_OUTPUT
+    uint8_t packet[11 + LOG_MAX_ARGS * 4];
+    int length = 0;
+    packet[length++] = 0xA5;
+    packet[length++] = record.level;
+    packet[length++] = record.argCount;
+    uint32_t words[2 + LOG_MAX_ARGS];
+    words[0] = record.timestamp;
+    words[1] = (uint32_t)(uintptr_t)record.format;
+    for (uint8_t i = 0; i < record.argCount; i++)
+    {
+        words[2 + i] = (uint32_t)record.args[i];
+    }
+    for (int i = 0; i < 2 + record.argCount; i++)
+    {
+        packet[length++] = (uint8_t)(words[i] & 0xFF);
+        packet[length++] = (uint8_t)(words[i] >> 8);
+        packet[length++] = (uint8_t)(words[i] >> 16);
+        packet[length++] = (uint8_t)(words[i] >> 24);
+    }
+    logSerial.write(packet, length);
+#else
+    const uintptr_t *a = record.args;
+    logSerial.printf("[%lu] %c ", (unsigned long)record.timestamp, levelChar(record.level));
+    logSerial.printf(record.format, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+    logSerial.println();
+#endif
+}
+
+// 取出最早的一条记录；缓冲区为空返回false
+static bool popRecord(LogRecord &record, uint32_t &dropped)
+{
+    LOG_LOCK();
+    dropped = logDroppedPending;
+    logDroppedPending = 0;
+    if (logCount == 0)
+    {
+        LOG_UNLOCK();
+        return false;
+    }
+    record = logBuffer[logTail];
+    logTail = (logTail + 1) % LOG_BUFFER_RECORDS;
+    logCount--;
+    LOG_UNLOCK();
+    return true;
+}
+
+static bool drainOne()
+{
+    LogRecord record;
+    uint32_t dropped;
+    bool hasRecord = popRecord(record, dropped);
+
+    if (dropped > 0)
+    {
+        LogRecord notice = {(uint32_t)millis(), "日志缓冲区已满，丢弃%lu条", LOG_LEVEL_WARN, 1, {dropped}};
+        writeRecord(notice);
+    }
+    if (hasRecord)
+    {
+        writeRecord(record);
+    }
+    return hasRecord;
+}
+
+void logDrain()
+{
+    while (logCount > 0 && logSerial.availableForWrite() >= LOG_DRAIN_HEADROOM)
+    {
+        if (!drainOne())
+            break;
+    }
+}
+
+void logFlush()
+{
+    while (drainOne())
+    {
+    }
+}
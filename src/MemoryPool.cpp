@@ -0,0 +1,206 @@
+#include "MemoryPool.h"
+#include "TextStore.h"
+#include "Log.h"
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#else
+#include <stdlib.h>
+#endif
+
+// ==================== 静态存储 ====================
+alignas(4) static uint8_t bootStorage[BOOT_ARENA_BYTES];
+alignas(4) static uint8_t upperTextStorage[TEXT_REGION_CHARS_16 * sizeof(uint16_t)]; // 区域文本只存字形序号
+alignas(4) static uint8_t lowerTextStorage[TEXT_REGION_CHARS_16 * sizeof(uint16_t)];
+alignas(4) static uint8_t fullTextStorage[TEXT_REGION_CHARS_32 * sizeof(uint16_t)];
+alignas(4) static uint8_t streamStorage[STREAM_WINDOW_BYTES];
+
+static_assert(sizeof(bootStorage) + sizeof(upperTextStorage) + sizeof(lowerTextStorage) + sizeof(fullTextStorage) +
+                      sizeof(streamStorage) <=
+                  MEMORY_STATIC_BUDGET,
+              "常驻.bss的内存池超出MEMORY_STATIC_BUDGET，较大的池应改为启动时取得存储");
+static_assert(ANIMATION_BUFFER_BYTES <= MEDIA_BUFFER_BYTES && IMAGE_BUFFER_BYTES <= MEDIA_BUFFER_BYTES &&
+                  LIVE_BUFFER_BYTES <= MEDIA_BUFFER_BYTES && PAGING_BITMAP_BYTES <= MEDIA_BUFFER_BYTES,
+              "全屏内容缓冲区须容纳动画、图像、实时流与翻页位图中最大的一个");
+
+// 构造函数为constexpr，静态存储的池在静态初始化阶段即可用（其他全局对象的构造函数可从中分配）；
+// 存储为nullptr的池在memoryPoolsBegin()之前不可用
+StaticArena bootArena("boot", bootStorage, sizeof(bootStorage));
+StaticArena scratchArena("scratch", nullptr, SCRATCH_ARENA_BYTES);
+StaticArena priorityArena("priority", nullptr, PRIORITY_STACK_BYTES);
+FixedBuffer upperTextBuffer("upper", upperTextStorage, sizeof(upperTextStorage));
+FixedBuffer lowerTextBuffer("lower", lowerTextStorage, sizeof(lowerTextStorage));
+FixedBuffer fullTextBuffer("full", fullTextStorage, sizeof(fullTextStorage));
+FixedBuffer transferBuffer("transfer", nullptr, BT_TRANSFER_MAX_SIZE);
+FixedBuffer streamWindowBuffer("stream", streamStorage, sizeof(streamStorage));
+FixedBuffer mediaBuffer("media", nullptr, MEDIA_BUFFER_BYTES);
+FixedBuffer playlistBuffer("playlist", nullptr, PLAYLIST_STAGING_BYTES);
+
+// ==================== 启动时取得的存储 ====================
+static uint8_t *allocateHeapBlock(size_t size)
+{
+#ifdef ARDUINO
+    return (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+#else
+    return (uint8_t *)malloc(size);
+#endif
+}
+
+// 已有存储的池不重复分配
+template <typename Pool>
+static bool attachHeapStorage(Pool &pool, size_t &total)
+{
+    if (pool.hasStorage())
+        return true;
+
+    uint8_t *block = allocateHeapBlock(pool.getCapacity());
+    if (!block)
+    {
+        LOG_E("错误: 内存池%s存储分配失败 - 需要: %u字节", pool.getName(), (unsigned)pool.getCapacity());
+        return false;
+    }
+    pool.attach(block);
+    total += pool.getCapacity();
+    return true;
+}
+
+// 各池独立分配：某一池失败时其余池照常可用，失败的池所有分配均返回nullptr
+bool memoryPoolsBegin()
+{
+    size_t total = 0;
+    bool ok = attachHeapStorage(scratchArena, total);
+    ok = attachHeapStorage(priorityArena, total) && ok;
+    ok = attachHeapStorage(transferBuffer, total) && ok;
+    ok = attachHeapStorage(mediaBuffer, total) && ok;
+    ok = attachHeapStorage(playlistBuffer, total) && ok;
+    LOG_I("内存池已从堆取得存储 - 共: %u字节", (unsigned)total);
+    return ok;
+}
+
+void *StaticArena::allocate(size_t size, size_t align)
+{
+    size_t start = (used + align - 1) & ~(align - 1);
+    if (!storage || start + size > capacity)
+    {
+        failureCount++;
+        LOG_E("错误: 内存池%s容量不足 - 需要: %u字节, 剩余: %u字节",
+              name, (unsigned)size, (unsigned)(capacity - used));
+        return nullptr;
+    }
+
+    used = start + size;
+    if (used > highWater)
+        highWater = used;
+    return storage + start;
+}
+
+void StaticArena::rewind(size_t position)
+{
+    if (position < used)
+        used = position;
+}
+
+void *FixedBuffer::acquire(size_t size)
+{
+    if (!storage || size > capacity)
+    {
+        failureCount++;
+        LOG_E("错误: 内存池%s容量不足 - 需要: %u字节, 容量: %u字节",
+              name, (unsigned)size, (unsigned)capacity);
+        return nullptr;
+    }
+
+    used = size;
+    if (used > highWater)
+        highWater = used;
+    return storage;
+}
+
+// ==================== 用量报告 ====================
+template <typename Pool>
+static void logPoolUsage(const Pool &pool)
+{
+    LOG_I("内存池%s - 容量: %u, 当前: %u, 高水位: %u (%d%%), 失败: %u",
+          pool.getName(), (unsigned)pool.getCapacity(), (unsigned)pool.getUsed(), (unsigned)pool.getHighWater(),
+          (int)(pool.getHighWater() * 100 / pool.getCapacity()), pool.getFailureCount());
+}
+
+void reportMemoryUsage()
+{
+    logPoolUsage(bootArena);
+    logPoolUsage(scratchArena);
+    logPoolUsage(upperTextBuffer);
+    logPoolUsage(lowerTextBuffer);
+    logPoolUsage(fullTextBuffer);
+    logPoolUsage(transferBuffer);
+    logPoolUsage(streamWindowBuffer);
+    logPoolUsage(mediaBuffer);
+    logPoolUsage(playlistBuffer);
+    logPoolUsage(priorityArena);
+    reportTextStoreUsage();
+}
+
+// 每条记录：[池编号][容量4字节][高水位4字节][当前4字节][失败次数2字节]，均为高字节在前
+static const int POOL_RECORD_LEN = 15;
+
+static void writeBE32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)(value >> 24);
+    p[1] = (uint8_t)(value >> 16);
+    p[2] = (uint8_t)(value >> 8);
+    p[3] = (uint8_t)(value & 0xFF);
+}
+
+static int appendPoolRecord(uint8_t *response, int length, uint8_t poolId,
+                            uint32_t capacity, uint32_t highWater, uint32_t used, uint32_t failures)
+{
+    uint8_t *p = response + length;
+    if (failures > 0xFFFF)
+        failures = 0xFFFF;
+    p[0] = poolId;
+    writeBE32(p + 1, capacity);
+    writeBE32(p + 5, highWater);
+    writeBE32(p + 9, used);
+    p[13] = (uint8_t)(failures >> 8);
+    p[14] = (uint8_t)(failures & 0xFF);
+    return length + POOL_RECORD_LEN;
+}
+
+template <typename Pool>
+static int appendPoolRecord(uint8_t *response, int length, uint8_t poolId, const Pool &pool)
+{
+    return appendPoolRecord(response, length, poolId, pool.getCapacity(), pool.getHighWater(),
+                            pool.getUsed(), pool.getFailureCount());
+}
+
+// 字形表按槽位计数，统计时换算为字节，与其他内存池一致
+static int appendPoolRecord(uint8_t *response, int length, uint8_t poolId, const GlyphTable &table)
+{
+    uint32_t glyphBytes = table.getWordsPerGlyph() * sizeof(uint16_t);
+    return appendPoolRecord(response, length, poolId, table.getCapacity() * glyphBytes,
+                            table.getHighWater() * glyphBytes, table.getUsedCount() * glyphBytes,
+                            table.getFailureCount());
+}
+
+// 处理内存统计查询命令 (0x12)
+// 应答：[池数量][记录...]，临时分配区的当前用量为处理本命令时的值（通常为0）
+void handleMemoryStatsCommand(const BluetoothFrame &)
+{
+    uint8_t response[1 + MEMORY_POOL_COUNT * POOL_RECORD_LEN];
+    int length = 0;
+    response[length++] = MEMORY_POOL_COUNT;
+    length = appendPoolRecord(response, length, MEMORY_POOL_BOOT, bootArena);
+    length = appendPoolRecord(response, length, MEMORY_POOL_SCRATCH, scratchArena);
+    length = appendPoolRecord(response, length, MEMORY_POOL_UPPER_TEXT, upperTextBuffer);
+    length = appendPoolRecord(response, length, MEMORY_POOL_LOWER_TEXT, lowerTextBuffer);
+    length = appendPoolRecord(response, length, MEMORY_POOL_FULL_TEXT, fullTextBuffer);
+    length = appendPoolRecord(response, length, MEMORY_POOL_TRANSFER, transferBuffer);
+    length = appendPoolRecord(response, length, MEMORY_POOL_GLYPHS_16, glyphTable16);
+    length = appendPoolRecord(response, length, MEMORY_POOL_GLYPHS_32, glyphTable32);
+    length = appendPoolRecord(response, length, MEMORY_POOL_STREAM, streamWindowBuffer);
+    length = appendPoolRecord(response, length, MEMORY_POOL_MEDIA, mediaBuffer);
+    length = appendPoolRecord(response, length, MEMORY_POOL_PLAYLIST, playlistBuffer);
+    length = appendPoolRecord(response, length, MEMORY_POOL_PRIORITY, priorityArena);
+    sendResponseFrame(BT_CMD_MEMORY_STATS, response, length);
+
+    reportMemoryUsage();
+}
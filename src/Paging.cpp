@@ -0,0 +1,440 @@
+#include "Paging.h"
+#include "LEDController.h"
+#include "DisplayDriver.h"
+#include "TextStore.h"
+#include "TextStream.h"
+#include "MemoryPool.h"
+#include "CommandBatch.h"
+#include "Log.h"
+
+// 预渲染位图的标记：与当前状态算出的标记不同即为过期
+struct PageStamp
+{
+    bool valid;
+    uint32_t revision; // 区域文本修改计数
+    int page;          // 页号
+    int pageSize;      // 每组字符数
+    uint8_t fontSize;
+    uint8_t direction;
+    uint16_t textColor;
+    uint16_t bgColor;
+    uint8_t textMode;
+    uint8_t gradientMode;
+};
+
+// 区域的翻页状态
+struct PagingRegion
+{
+    PagingConfig config;
+    PageStamp stamps[2];           // 两个位图槽位的标记
+    uint8_t current;               // 当前页所在的槽位，另一个槽位存放下一页（过渡结束后互换）
+    bool transitioning;            // 正在过渡
+    unsigned long transitionStart; // 过渡开始时间
+    int fromPage;                  // 过渡的旧页
+    int toPage;                    // 过渡的新页
+    int distance;                  // 过渡总进度（像素）
+    int outgoingEnd;               // 推移/滚动：旧页在位图带上的结束列
+    int shift;                     // 推移/滚动：新页位图在位图带上的起始列
+    int drawnProgress;             // 已绘制的进度（像素）
+};
+
+// [0]上半屏（32x32时为全屏），[1]下半屏
+static PagingRegion pagingRegions[2] = {
+    {{0, PAGING_DEFAULT_DWELL, BT_PAGING_TRANSITION_CUT, 0},
+     {{false, 0, 0, 0, 0, 0, 0, 0, 0, 0}, {false, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+     0, false, 0, 0, 0, 0, 0, 0, 0},
+    {{0, PAGING_DEFAULT_DWELL, BT_PAGING_TRANSITION_CUT, 0},
+     {{false, 0, 0, 0, 0, 0, 0, 0, 0, 0}, {false, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+     0, false, 0, 0, 0, 0, 0, 0, 0}};
+static uint8_t bitmapFont = BT_FONT_16x16; // 位图区当前按哪种字体划分
+static bool bitmapsHeld = false;           // 全屏内容缓冲区当前存放的是翻页位图
+
+static PagingRegion &getPagingRegion(bool isUpper)
+{
+    return pagingRegions[isUpper ? 0 : 1];
+}
+
+static bool isFont32()
+{
+    return currentFontSize == BT_FONT_32x32;
+}
+
+static int getRegionTop(bool isUpper)
+{
+    return (isFont32() || isUpper) ? 0 : 16;
+}
+
+static int getRegionHeight()
+{
+    return isFont32() ? SCREEN_HEIGHT : 16;
+}
+
+static int getSpacing()
+{
+    return isFont32() ? CHAR_SPACING_32 : CHAR_SPACING_16;
+}
+
+int getPageSize(bool isUpper)
+{
+    int maxPerLine = SCREEN_WIDTH / getSpacing();
+    uint8_t groupSize = getPagingRegion(isUpper).config.groupSize;
+    return (groupSize == 0 || groupSize > maxPerLine) ? maxPerLine : groupSize;
+}
+
+// 位图存放在全屏内容缓冲区中，动画、图像或实时流占用时（如在其上插播）没有位图可用
+static bool isBitmapAvailable()
+{
+    return mediaBuffer.hasStorage() && (bitmapsHeld || mediaBuffer.getUsed() == 0);
+}
+
+// 位图区按字体划分：16x16时上下半屏各两个槽位，32x32时全屏两个槽位
+static uint16_t *getBitmap(bool isUpper, int slot)
+{
+    uint16_t *base = (uint16_t *)mediaBuffer.acquire(PAGING_BITMAP_BYTES);
+    bitmapsHeld = true;
+    int regionPixels = SCREEN_WIDTH * getRegionHeight();
+    return base + ((isUpper ? 0 : 2) + slot) * regionPixels;
+}
+
+static PageStamp makeStamp(bool isUpper, int page)
+{
+    bool is32 = isFont32();
+    const RegionText &region = is32 ? fullRegionText : (isUpper ? upperRegionText : lowerRegionText);
+
+    PageStamp stamp;
+    stamp.valid = true;
+    stamp.revision = region.revision;
+    stamp.page = page;
+    stamp.pageSize = getPageSize(isUpper);
+    stamp.fontSize = currentFontSize;
+    stamp.direction = textState.displayDirection;
+    if (is32)
+    {
+        stamp.textColor = colorState.textColor;
+        stamp.bgColor = colorState.upperBackgroundColor;
+        stamp.textMode = colorState.textMode;
+        stamp.gradientMode = colorState.gradientMode;
+    }
+    else
+    {
+        stamp.textColor = isUpper ? colorState.upperTextColor : colorState.lowerTextColor;
+        stamp.bgColor = isUpper ? colorState.upperBackgroundColor : colorState.lowerBackgroundColor;
+        stamp.textMode = isUpper ? colorState.upperTextMode : colorState.lowerTextMode;
+        stamp.gradientMode = isUpper ? colorState.upperGradientMode : colorState.lowerGradientMode;
+    }
+    return stamp;
+}
+
+static bool isStampCurrent(const PageStamp &stamp, bool isUpper, int page)
+{
+    if (!stamp.valid)
+        return false;
+
+    PageStamp now = makeStamp(isUpper, page);
+    return stamp.revision == now.revision && stamp.page == now.page && stamp.pageSize == now.pageSize &&
+           stamp.fontSize == now.fontSize && stamp.direction == now.direction &&
+           stamp.textColor == now.textColor && stamp.bgColor == now.bgColor &&
+           stamp.textMode == now.textMode && stamp.gradientMode == now.gradientMode;
+}
+
+// 过渡只用于画面静止的区域：闪烁、呼吸、滚动与流式文本逐帧变化，预渲染的位图代表不了
+static bool canTransition(bool isUpper)
+{
+    const PagingConfig &config = getPagingRegion(isUpper).config;
+    if (config.transition == BT_PAGING_TRANSITION_CUT || config.transitionTime == 0)
+        return false;
+    if (!isBitmapAvailable())
+        return false;
+    if (isRegionStreaming(isUpper))
+        return false;
+    if (isUpper)
+        return !effectState.upperScrollActive && !effectState.upperBlinkActive && !effectState.upperBreatheActive;
+    return !effectState.lowerScrollActive && !effectState.lowerBlinkActive && !effectState.lowerBreatheActive;
+}
+
+// 用现有的文本绘制函数把第page页渲染进槽位：绘制目标临时指向位图，分页位置临时指向该页
+static void renderPage(bool isUpper, int page, int slot)
+{
+    // 字体改变后位图区的划分随之改变，两个区域已有的位图全部作废
+    if (bitmapFont != currentFontSize)
+    {
+        for (int r = 0; r < 2; r++)
+        {
+            pagingRegions[r].stamps[0].valid = false;
+            pagingRegions[r].stamps[1].valid = false;
+        }
+        bitmapFont = currentFontSize;
+    }
+
+    PagingRegion &region = getPagingRegion(isUpper);
+    PageStamp stamp = makeStamp(isUpper, page);
+    uint16_t *bitmap = getBitmap(isUpper, slot);
+    int top = getRegionTop(isUpper);
+    int height = getRegionHeight();
+    for (int i = 0; i < SCREEN_WIDTH * height; i++)
+    {
+        bitmap[i] = stamp.bgColor;
+    }
+
+    int &pageIndex = isUpper ? textState.upperIndex : textState.lowerIndex;
+    int shownPage = pageIndex;
+    pageIndex = page;
+    panelTarget = {bitmap, top, height};
+    if (isFont32())
+        displayFullScreenText32x32();
+    else
+        displayTextOnHalf(top, isUpper);
+    panelTarget.pixels = nullptr;
+    pageIndex = shownPage;
+
+    region.stamps[slot] = stamp;
+}
+
+// 停留期间预渲染当前页和下一页，每次调用最多渲染一页，渲染耗时分散到不同的loop中
+static void prebuildPages(bool isUpper, int page, int totalPages)
+{
+    if (!canTransition(isUpper))
+        return;
+
+    PagingRegion &region = getPagingRegion(isUpper);
+    int next = (page + 1 >= totalPages) ? 0 : page + 1;
+    if (!isStampCurrent(region.stamps[region.current], isUpper, page))
+        renderPage(isUpper, page, region.current);
+    else if (!isStampCurrent(region.stamps[1 - region.current], isUpper, next))
+        renderPage(isUpper, next, 1 - region.current);
+}
+
+// 第page页首字符的X坐标与本页字符数（与displayTextOnHalf的居中方式一致）
+static void getPageSpan(int totalChars, int page, int pageSize, int &x, int &count)
+{
+    count = min(pageSize, totalChars - page * pageSize);
+    x = (SCREEN_WIDTH - count * getSpacing()) / 2;
+    if (x < 0)
+        x = 0;
+}
+
+static void beginTransition(bool isUpper, int from, int to, int totalChars, unsigned long now)
+{
+    PagingRegion &region = getPagingRegion(isUpper);
+    region.transitioning = true;
+    region.transitionStart = now;
+    region.fromPage = from;
+    region.toPage = to;
+    region.drawnProgress = 0; // 进度0即旧页，屏幕上已是该画面
+
+    region.outgoingEnd = SCREEN_WIDTH;
+    region.shift = SCREEN_WIDTH;
+    if (region.config.transition == BT_PAGING_TRANSITION_SCROLL)
+    {
+        // 新页首字符紧接旧页末字符：窗口左移到新页的居中位置为止
+        int pageSize = getPageSize(isUpper);
+        int fromX, fromCount, toX, toCount;
+        getPageSpan(totalChars, from, pageSize, fromX, fromCount);
+        getPageSpan(totalChars, to, pageSize, toX, toCount);
+        region.outgoingEnd = fromX + fromCount * getSpacing();
+        region.shift = region.outgoingEnd - toX;
+    }
+    region.distance = (region.config.transition == BT_PAGING_TRANSITION_WIPE) ? SCREEN_WIDTH : region.shift;
+}
+
+// 按进度把两张位图按列拷贝到屏幕
+static void drawTransition(bool isUpper, int progress)
+{
+    const PagingRegion &region = getPagingRegion(isUpper);
+    const uint16_t *outgoing = getBitmap(isUpper, region.current);
+    const uint16_t *incoming = getBitmap(isUpper, 1 - region.current);
+    int top = getRegionTop(isUpper);
+    int height = getRegionHeight();
+
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+    {
+        const uint16_t *column;
+        if (region.config.transition == BT_PAGING_TRANSITION_WIPE)
+        {
+            column = (x < progress) ? incoming + x : outgoing + x;
+        }
+        else
+        {
+            // 推移与滚动：旧页与新页首尾相接成一条位图带，屏幕窗口在带上左移progress列
+            int stripX = x + progress;
+            column = (stripX < region.outgoingEnd) ? outgoing + stripX : incoming + (stripX - region.shift);
+        }
+
+        for (int y = 0; y < height; y++)
+        {
+            drawPanelPixel(x, top + y, column[y * SCREEN_WIDTH]);
+        }
+    }
+}
+
+void releasePagingBitmaps()
+{
+    if (!bitmapsHeld)
+        return;
+
+    for (int r = 0; r < 2; r++)
+    {
+        pagingRegions[r].stamps[0].valid = false;
+        pagingRegions[r].stamps[1].valid = false;
+        pagingRegions[r].transitioning = false; // 全屏模式结束后文本整体重绘
+    }
+    bitmapsHeld = false;
+    mediaBuffer.release();
+}
+
+bool drawPagingFrame(bool isUpper)
+{
+    const PagingRegion &region = getPagingRegion(isUpper);
+    if (!region.transitioning)
+        return false;
+
+    drawTransition(isUpper, region.drawnProgress);
+    return true;
+}
+
+bool updatePaging(bool isUpper, unsigned long now)
+{
+    PagingRegion &region = getPagingRegion(isUpper);
+    int &pageIndex = isUpper ? textState.upperIndex : textState.lowerIndex;
+    unsigned long &lastSwitchTime = isUpper ? textState.lastSwitchTime : textState.lowerSwitchTime;
+    int totalChars = isFont32() ? getFullDisplayText().count
+                                : (isUpper ? getUpperDisplayText().count : getLowerDisplayText().count);
+    int pageSize = getPageSize(isUpper);
+    int totalPages = (totalChars + pageSize - 1) / pageSize;
+
+    if (region.transitioning)
+    {
+        // 过渡中内容、外观或特效改变：结束过渡，按新状态整体重绘
+        if (totalPages <= 1 || pageIndex != region.toPage || !canTransition(isUpper) ||
+            !isStampCurrent(region.stamps[region.current], isUpper, region.fromPage) ||
+            !isStampCurrent(region.stamps[1 - region.current], isUpper, region.toPage))
+        {
+            region.transitioning = false;
+            lastSwitchTime = now;
+            return true;
+        }
+
+        unsigned long duration = region.config.transitionTime * 10UL;
+        unsigned long elapsed = now - region.transitionStart;
+        int progress = (elapsed >= duration) ? region.distance : (int)(region.distance * elapsed / duration);
+        if (progress != region.drawnProgress)
+        {
+            drawTransition(isUpper, progress);
+            region.drawnProgress = progress;
+        }
+        if (progress >= region.distance)
+        {
+            // 新页成为当前页；旧页的位图留在另一个槽位，只有两页时正好就是下一页
+            region.transitioning = false;
+            region.current = 1 - region.current;
+            lastSwitchTime = now;
+        }
+        return false;
+    }
+
+    if (totalPages <= 1)
+        return false;
+
+    if (now - lastSwitchTime < region.config.dwell * 100UL)
+    {
+        prebuildPages(isUpper, pageIndex, totalPages);
+        return false;
+    }
+
+    int from = pageIndex;
+    int to = (pageIndex + 1 >= totalPages) ? 0 : pageIndex + 1;
+    pageIndex = to;
+    lastSwitchTime = now;
+    if (!canTransition(isUpper))
+        return true;
+
+    if (isStampCurrent(region.stamps[region.current], isUpper, from) &&
+        isStampCurrent(region.stamps[1 - region.current], isUpper, to))
+    {
+        beginTransition(isUpper, from, to, totalChars, now);
+        return false;
+    }
+
+    LOG_D("翻页位图未就绪，直接切换 - 区域: %s, 页: %d -> %d", isUpper ? "上" : "下", from, to);
+    return true;
+}
+
+const PagingConfig &getPagingConfig(bool isUpper)
+{
+    return getPagingRegion(isUpper).config;
+}
+
+void setPagingConfig(bool isUpper, const PagingConfig &config)
+{
+    PagingRegion &region = getPagingRegion(isUpper);
+    bool regroup = (region.config.groupSize != config.groupSize);
+    region.config = config;
+    region.transitioning = false;
+
+    // 每组字符数改变后页的划分随之改变，从第一页重新开始
+    if (regroup)
+    {
+        if (isUpper)
+            textState.upperIndex = 0;
+        else
+            textState.lowerIndex = 0;
+    }
+    if (isUpper)
+        textState.lastSwitchTime = millis();
+    else
+        textState.lowerSwitchTime = millis();
+    textState.needUpdate = true;
+}
+
+// 处理分页设置命令 (0x1B)
+// 数据格式：[屏幕区域][每组字符数][停留时间2字节][过渡方式][过渡时长]，只有[屏幕区域]时为查询
+// 应答：[状态][屏幕区域][每组字符数（按当前字体的实际值）][停留时间2字节][过渡方式][过渡时长]，全屏时为上半屏的设置
+void handlePagingCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 1)
+    {
+        LOG_E("错误: 分页设置数据无效");
+        return;
+    }
+
+    uint8_t screenArea = frame.data[0];
+    bool areaValid = (screenArea >= BT_SCREEN_UPPER && screenArea <= BT_SCREEN_BOTH);
+    uint8_t status = BT_PAGING_STATUS_INVALID;
+    if (areaValid && frame.dataLength == 1)
+    {
+        status = BT_PAGING_STATUS_OK;
+    }
+    else if (areaValid && frame.dataLength >= BT_PAGING_DATA_LEN)
+    {
+        PagingConfig config;
+        config.groupSize = frame.data[1];
+        config.dwell = ((uint16_t)frame.data[2] << 8) | frame.data[3];
+        config.transition = frame.data[4];
+        config.transitionTime = frame.data[5];
+        if (config.groupSize <= SCREEN_WIDTH / CHAR_SPACING_16 && config.dwell > 0 &&
+            config.transition <= BT_PAGING_TRANSITION_SCROLL &&
+            (config.transition == BT_PAGING_TRANSITION_CUT || config.transitionTime > 0))
+        {
+            if (screenArea != BT_SCREEN_LOWER)
+                setPagingConfig(true, config);
+            if (screenArea != BT_SCREEN_UPPER)
+                setPagingConfig(false, config);
+            status = BT_PAGING_STATUS_OK;
+            LOG_I("分页设置 - 区域: 0x%02X, 每组: %d字符, 停留: %dms, 过渡: %d, 过渡时长: %dms",
+                  screenArea, config.groupSize, config.dwell * 100, config.transition, config.transitionTime * 10);
+        }
+        else
+        {
+            LOG_E("错误: 分页设置参数无效");
+        }
+    }
+
+    if (status != BT_PAGING_STATUS_OK)
+        markBatchFailed();
+
+    bool isUpper = (screenArea != BT_SCREEN_LOWER);
+    const PagingConfig &config = getPagingRegion(isUpper).config;
+    uint8_t response[7] = {status, screenArea, (uint8_t)getPageSize(isUpper), (uint8_t)(config.dwell >> 8),
+                           (uint8_t)(config.dwell & 0xFF), config.transition, config.transitionTime};
+    sendResponseFrame(BT_CMD_PAGING, response, sizeof(response));
+}
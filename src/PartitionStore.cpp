@@ -0,0 +1,144 @@
+#include "PartitionStore.h"
+#include <string.h>
+
+#ifdef ARDUINO
+// ==================== 设备实现：esp_partition ====================
+PartitionStore::PartitionStore() : partition(nullptr) {}
+
+PartitionStore::~PartitionStore() {}
+
+bool PartitionStore::open(const char *label)
+{
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    return partition != nullptr;
+}
+
+void PartitionStore::close()
+{
+    partition = nullptr;
+}
+
+bool PartitionStore::isOpen() const
+{
+    return partition != nullptr;
+}
+
+uint32_t PartitionStore::size() const
+{
+    return partition ? partition->size : 0;
+}
+
+bool PartitionStore::read(uint32_t offset, void *dest, size_t length) const
+{
+    if (!partition || offset + length > partition->size)
+        return false;
+    return esp_partition_read(partition, offset, dest, length) == ESP_OK;
+}
+
+bool PartitionStore::write(uint32_t offset, const void *src, size_t length)
+{
+    if (!partition || offset + length > partition->size)
+        return false;
+    return esp_partition_write(partition, offset, src, length) == ESP_OK;
+}
+
+bool PartitionStore::erase(uint32_t offset, size_t length)
+{
+    if (!partition || offset % PARTITION_SECTOR_SIZE != 0 || offset + length > partition->size)
+        return false;
+    size_t alignedLength = (length + PARTITION_SECTOR_SIZE - 1) / PARTITION_SECTOR_SIZE * PARTITION_SECTOR_SIZE;
+    if (offset + alignedLength > partition->size)
+        alignedLength = partition->size - offset;
+    return esp_partition_erase_range(partition, offset, alignedLength) == ESP_OK;
+}
+
+#else
+// ==================== 主机实现：文件替身 ====================
+// 文件不存在时创建空文件；写入超出文件末尾时自动增长。
+PartitionStore::PartitionStore() : file(nullptr), fileSize(0) {}
+
+PartitionStore::~PartitionStore()
+{
+    close();
+}
+
+bool PartitionStore::open(const char *label)
+{
+    close();
+
+    char path[128];
+    snprintf(path, sizeof(path), "%s.bin", label);
+    file = fopen(path, "r+b");
+    if (!file)
+    {
+        file = fopen(path, "w+b");
+    }
+    if (!file)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    fileSize = (uint32_t)ftell(file);
+    return true;
+}
+
+void PartitionStore::close()
+{
+    if (file)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+    fileSize = 0;
+}
+
+bool PartitionStore::isOpen() const
+{
+    return file != nullptr;
+}
+
+uint32_t PartitionStore::size() const
+{
+    return fileSize;
+}
+
+bool PartitionStore::read(uint32_t offset, void *dest, size_t length) const
+{
+    if (!file || offset + length > fileSize)
+        return false;
+    fseek(file, offset, SEEK_SET);
+    return fread(dest, 1, length, file) == length;
+}
+
+bool PartitionStore::write(uint32_t offset, const void *src, size_t length)
+{
+    if (!file)
+        return false;
+    fseek(file, offset, SEEK_SET);
+    if (fwrite(src, 1, length, file) != length)
+        return false;
+    fflush(file);
+    if (offset + length > fileSize)
+        fileSize = offset + length;
+    return true;
+}
+
+bool PartitionStore::erase(uint32_t offset, size_t length)
+{
+    if (!file || offset % PARTITION_SECTOR_SIZE != 0)
+        return false;
+
+    uint8_t blank[256];
+    memset(blank, 0xFF, sizeof(blank));
+    size_t alignedLength = (length + PARTITION_SECTOR_SIZE - 1) / PARTITION_SECTOR_SIZE * PARTITION_SECTOR_SIZE;
+    fseek(file, offset, SEEK_SET);
+    for (size_t done = 0; done < alignedLength; done += sizeof(blank))
+    {
+        if (fwrite(blank, 1, sizeof(blank), file) != sizeof(blank))
+            return false;
+    }
+    fflush(file);
+    if (offset + alignedLength > fileSize)
+        fileSize = offset + alignedLength;
+    return true;
+}
+#endif
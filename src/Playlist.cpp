@@ -0,0 +1,505 @@
+#include "Playlist.h"
+#include "SceneStore.h"
+#include "SceneSync.h"
+#include "LEDController.h"
+#include "DisplayDriver.h"
+#include "Animation.h"
+#include "ImageMode.h"
+#include "LiveStream.h"
+#include "MemoryPool.h"
+#include "Log.h"
+#include <string.h>
+
+Playlist playlist;
+
+// 列表表头：[魔数 4][版本 2][条目数 1][运行中 1]，条目之后是哈希
+static const int TABLE_HEADER_SIZE = 8;
+static const int TABLE_ENTRY_SIZE = 4;
+static const int TABLE_BYTES = TABLE_HEADER_SIZE + PLAYLIST_MAX_ENTRIES * TABLE_ENTRY_SIZE + 4;
+
+static uint16_t readLE16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t readLE32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void writeLE32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static bool isTransitionValid(uint8_t transition)
+{
+    return transition <= BT_PLAYLIST_TRANSITION_WIPE_DOWN;
+}
+
+// 整屏被动画、图像或实时流占据时暂停轮播
+static bool isScreenTaken()
+{
+    return isAnimationPlaying() || isImageShowing() || isLiveStreaming();
+}
+
+Playlist::Playlist()
+    : entryCount(0), running(false), sceneSequence(0), currentEntry(-1), entryStart(0), staging(nullptr),
+      stagedEntry(-1), stagedLength(0), prepareNeeded(false), transitioning(false), transitionStart(0),
+      transitionDrawn(0), incomingFrame(nullptr), switchCount(0)
+{
+    memset(entries, 0, sizeof(entries));
+    memset(sceneLengths, 0, sizeof(sceneLengths));
+    memset(sceneHashes, 0, sizeof(sceneHashes));
+}
+
+uint32_t Playlist::getSceneBase(int scene) const
+{
+    return PLAYLIST_TABLE_SIZE + scene * PLAYLIST_SCENE_SLOT_SIZE;
+}
+
+uint8_t Playlist::getSceneMask() const
+{
+    uint8_t mask = 0;
+    for (int i = 0; i < PLAYLIST_SCENE_COUNT && i < 8; i++)
+    {
+        if (sceneLengths[i] > 0)
+            mask |= 1 << i;
+    }
+    return mask;
+}
+
+bool Playlist::begin(const char *label)
+{
+    if (!store.open(label))
+        return false;
+    if (store.size() < PLAYLIST_TABLE_SIZE + PLAYLIST_SCENE_COUNT * PLAYLIST_SCENE_SLOT_SIZE)
+    {
+        LOG_E("错误: 播放列表分区过小 - %u字节", store.size());
+        store.close();
+        return false;
+    }
+
+    // 只读各场景的槽位头，负载在预备时再读取校验
+    for (int i = 0; i < PLAYLIST_SCENE_COUNT; i++)
+    {
+        uint32_t sequence, length, hash;
+        if (readSceneSlotHeader(store, getSceneBase(i), PLAYLIST_SCENE_SLOT_SIZE, sequence, length, hash) &&
+            length <= PLAYLIST_STAGING_BYTES)
+        {
+            sceneLengths[i] = length;
+            sceneHashes[i] = hash;
+            if (sequence > sceneSequence)
+                sceneSequence = sequence;
+        }
+    }
+
+    uint8_t table[TABLE_BYTES];
+    if (!store.read(0, table, sizeof(table)) || readLE32(table) != PLAYLIST_MAGIC ||
+        readLE16(table + 4) != PLAYLIST_VERSION || table[6] > PLAYLIST_MAX_ENTRIES ||
+        readLE32(table + TABLE_BYTES - 4) != fnv1aHash(table, TABLE_BYTES - 4))
+    {
+        return true; // 尚未设置过列表
+    }
+
+    entryCount = 0;
+    for (int i = 0; i < table[6]; i++)
+    {
+        const uint8_t *p = table + TABLE_HEADER_SIZE + i * TABLE_ENTRY_SIZE;
+        if (p[0] >= PLAYLIST_SCENE_COUNT || !isTransitionValid(p[1]) || readLE16(p + 2) == 0)
+            continue;
+        entries[entryCount].scene = p[0];
+        entries[entryCount].transition = p[1];
+        entries[entryCount].duration = readLE16(p + 2);
+        entryCount++;
+    }
+    running = table[7] != 0;
+    return true;
+}
+
+bool Playlist::writeTable()
+{
+    uint8_t table[TABLE_BYTES];
+    memset(table, 0xFF, sizeof(table));
+    writeLE32(table, PLAYLIST_MAGIC);
+    table[4] = PLAYLIST_VERSION & 0xFF;
+    table[5] = PLAYLIST_VERSION >> 8;
+    table[6] = entryCount;
+    table[7] = running ? 1 : 0;
+    for (int i = 0; i < entryCount; i++)
+    {
+        uint8_t *p = table + TABLE_HEADER_SIZE + i * TABLE_ENTRY_SIZE;
+        p[0] = entries[i].scene;
+        p[1] = entries[i].transition;
+        p[2] = (uint8_t)(entries[i].duration & 0xFF);
+        p[3] = (uint8_t)(entries[i].duration >> 8);
+    }
+    writeLE32(table + TABLE_BYTES - 4, fnv1aHash(table, TABLE_BYTES - 4));
+
+    if (!store.erase(0, PARTITION_SECTOR_SIZE) || !store.write(0, table, sizeof(table)))
+    {
+        LOG_E("错误: 播放列表写入失败");
+        return false;
+    }
+    return true;
+}
+
+// 保存前让场景从第一页、滚动起点重新开始并立即渲染，保存的首帧即为应用该场景后的第一帧画面
+static void restartSceneForCapture()
+{
+    textState.upperIndex = 0;
+    textState.lowerIndex = 0;
+    textState.lastSwitchTime = millis();
+    textState.lowerSwitchTime = textState.lastSwitchTime;
+    effectState.upperScrollOffset = 0;
+    effectState.lowerScrollOffset = 0;
+    textState.needUpdate = true;
+    updateTextDisplay();
+}
+
+uint8_t Playlist::storeScene(uint8_t scene, uint32_t &length)
+{
+    length = 0;
+    if (scene >= PLAYLIST_SCENE_COUNT)
+        return BT_PLAYLIST_STATUS_INVALID;
+    if (!store.isOpen())
+        return BT_PLAYLIST_STATUS_NO_STORAGE;
+
+    if (transitioning)
+        finishSwitch(); // 先完成过渡，保存的是切换后的场景
+    if (stagedEntry >= 0 && entries[stagedEntry].scene == scene)
+        discardStaged(); // 预备缓冲区中是旧内容
+    restartSceneForCapture();
+
+    uint32_t sequence, hash;
+    sceneLengths[scene] = 0;
+    if (!writeSceneSlot(store, getSceneBase(scene), PLAYLIST_SCENE_SLOT_SIZE, sceneSequence + 1, length) ||
+        !readSceneSlotHeader(store, getSceneBase(scene), PLAYLIST_SCENE_SLOT_SIZE, sequence, length, hash))
+    {
+        LOG_E("错误: 场景%d保存失败", scene);
+        length = 0;
+        return BT_PLAYLIST_STATUS_NO_STORAGE;
+    }
+
+    sceneSequence = sequence;
+    sceneLengths[scene] = length;
+    sceneHashes[scene] = hash;
+    LOG_I("场景%d已保存 - 负载: %u字节", scene, length);
+    return BT_PLAYLIST_STATUS_OK;
+}
+
+uint8_t Playlist::deleteScene(uint8_t scene)
+{
+    if (scene >= PLAYLIST_SCENE_COUNT)
+        return BT_PLAYLIST_STATUS_INVALID;
+    if (!store.isOpen() || !store.erase(getSceneBase(scene), PARTITION_SECTOR_SIZE))
+        return BT_PLAYLIST_STATUS_NO_STORAGE;
+
+    // 槽位头已擦除，引用该场景的条目在轮播时跳过
+    if (stagedEntry >= 0 && entries[stagedEntry].scene == scene)
+        discardStaged();
+    sceneLengths[scene] = 0;
+    LOG_I("场景%d已删除", scene);
+    return BT_PLAYLIST_STATUS_OK;
+}
+
+uint8_t Playlist::setEntries(const PlaylistEntry *list, uint8_t count)
+{
+    if (!store.isOpen())
+        return BT_PLAYLIST_STATUS_NO_STORAGE;
+    if (count > PLAYLIST_MAX_ENTRIES)
+        return BT_PLAYLIST_STATUS_INVALID;
+    for (int i = 0; i < count; i++)
+    {
+        if (list[i].scene >= PLAYLIST_SCENE_COUNT || !isTransitionValid(list[i].transition) || list[i].duration == 0)
+            return BT_PLAYLIST_STATUS_INVALID;
+        if (sceneLengths[list[i].scene] == 0)
+            return BT_PLAYLIST_STATUS_NO_SCENE;
+    }
+
+    discardStaged();
+    memcpy(entries, list, count * sizeof(PlaylistEntry));
+    entryCount = count;
+    currentEntry = -1;
+    LOG_I("播放列表已设置 - 条目: %d", count);
+    if (running)
+        return start(); // 按新列表从第一项重新开始（同时写入列表）
+    return writeTable() ? BT_PLAYLIST_STATUS_OK : BT_PLAYLIST_STATUS_NO_STORAGE;
+}
+
+// 预备的内容失效：过渡中的切换先完成，之后在下一轮poll重新预备
+void Playlist::discardStaged()
+{
+    if (transitioning)
+        finishSwitch();
+    stagedEntry = -1;
+    prepareNeeded = running;
+}
+
+int Playlist::findNextEntry() const
+{
+    for (int k = 1; k <= entryCount; k++)
+    {
+        int entry = (currentEntry + k + entryCount) % entryCount;
+        if (sceneLengths[entries[entry].scene] > 0)
+            return entry;
+    }
+    return -1;
+}
+
+// 负载从Flash读入预备缓冲区后按槽位头中的哈希校验，损坏的场景标记为未保存，之后跳过
+bool Playlist::prepare(int entry)
+{
+    uint8_t scene = entries[entry].scene;
+    uint32_t length = sceneLengths[scene];
+    if (!staging || length == 0)
+        return false;
+
+    [[maybe_unused]] unsigned long startTime = millis(); // 只用于调试日志
+    stagedEntry = -1;
+    if (!store.read(getSceneBase(scene) + SCENE_HEADER_SIZE, staging, length) ||
+        fnv1aHash(staging, length) != sceneHashes[scene])
+    {
+        LOG_W("场景%d校验失败，轮播时跳过", scene);
+        sceneLengths[scene] = 0;
+        return false;
+    }
+    stagedEntry = entry;
+    stagedLength = length;
+    LOG_D("已预备条目%d（场景%d） - 负载: %u字节, 耗时: %u毫秒",
+          entry, scene, length, (unsigned)(millis() - startTime));
+    return true;
+}
+
+void Playlist::beginSwitch(int entry)
+{
+    uint8_t transition = entries[entry].transition;
+    incomingFrame = findSceneFrame(staging, stagedLength);
+    if (transition == BT_PLAYLIST_TRANSITION_CUT || !incomingFrame || currentEntry < 0)
+    {
+        finishSwitch();
+        return;
+    }
+    transitioning = true;
+    transitionStart = millis();
+    transitionDrawn = 0;
+}
+
+// 从RAM应用预备好的场景；过渡已把首帧推送到屏上，应用后的第一次渲染与之相同
+void Playlist::finishSwitch()
+{
+    ScenePayload payload = {nullptr, 0, staging, stagedLength};
+    applyScenePayload(payload, false);
+    transitioning = false;
+    currentEntry = stagedEntry;
+    stagedEntry = -1;
+    entryStart = millis();
+    prepareNeeded = true; // 下一轮poll再读取下一项，切换本身不含Flash读取
+    switchCount++;
+    LOG_I("播放列表切换到条目%d（场景%d）", currentEntry, entries[currentEntry].scene);
+}
+
+// 按已过时间推进擦除：只推送新覆盖的列或行
+void Playlist::drawTransition(unsigned long now)
+{
+    bool byColumn = (entries[stagedEntry].transition == BT_PLAYLIST_TRANSITION_WIPE_LEFT);
+    int total = byColumn ? SCREEN_WIDTH : SCREEN_HEIGHT;
+    unsigned long elapsed = now - transitionStart;
+    int target = (elapsed >= PLAYLIST_TRANSITION_MS) ? total : (int)(elapsed * total / PLAYLIST_TRANSITION_MS);
+
+    for (; transitionDrawn < target; transitionDrawn++)
+    {
+        int count = byColumn ? SCREEN_HEIGHT : SCREEN_WIDTH;
+        for (int i = 0; i < count; i++)
+        {
+            int x = byColumn ? transitionDrawn : i;
+            int y = byColumn ? i : transitionDrawn;
+            drawPanelPixel(x, y, readLE16(incomingFrame + (y * SCREEN_WIDTH + x) * 2));
+        }
+    }
+    if (transitionDrawn >= total)
+        finishSwitch();
+}
+
+uint8_t Playlist::start(bool persist)
+{
+    if (!store.isOpen())
+        return BT_PLAYLIST_STATUS_NO_STORAGE;
+    if (!staging)
+        staging = (uint8_t *)playlistBuffer.acquire(PLAYLIST_STAGING_BYTES);
+    if (!staging)
+        return BT_PLAYLIST_STATUS_NO_STORAGE;
+
+    currentEntry = -1;
+    transitioning = false;
+    int first = findNextEntry();
+    if (first < 0 || !prepare(first))
+    {
+        running = false;
+        playlistBuffer.release();
+        staging = nullptr;
+        return BT_PLAYLIST_STATUS_NO_SCENE;
+    }
+
+    // 运行状态写入列表，重启后自动继续
+    running = true;
+    if (persist)
+        writeTable();
+    finishSwitch();
+    LOG_I("开始轮播 - 条目: %d", entryCount);
+    return BT_PLAYLIST_STATUS_OK;
+}
+
+void Playlist::stop()
+{
+    if (!running)
+        return;
+    if (transitioning)
+        finishSwitch(); // 过渡中停止时直接完成切换
+    running = false;
+    stagedEntry = -1;
+    playlistBuffer.release();
+    staging = nullptr;
+    writeTable();
+    LOG_I("停止轮播 - 停留在条目%d, 共切换%u次", currentEntry, switchCount);
+}
+
+bool Playlist::resume()
+{
+    if (!running)
+        return false;
+    running = false; // 由start()重新置位，场景都不可用时保持停止
+    return start(false) == BT_PLAYLIST_STATUS_OK;
+}
+
+void Playlist::poll()
+{
+    if (!running || isScreenTaken())
+        return;
+
+    unsigned long now = millis();
+    if (transitioning)
+    {
+        drawTransition(now);
+        return;
+    }
+
+    // 切换后的下一轮预备下一项，远早于它的显示时刻
+    if (prepareNeeded)
+    {
+        prepareNeeded = false;
+        int next = findNextEntry();
+        if (next >= 0 && next != currentEntry)
+            prepare(next);
+        return;
+    }
+
+    if (now - entryStart < entries[currentEntry].duration * 100UL)
+        return;
+
+    int next = findNextEntry();
+    if (next < 0 || next == currentEntry)
+    {
+        entryStart = now; // 只有一个可用场景，继续显示
+        return;
+    }
+    if (stagedEntry != next && !prepare(next))
+    {
+        entryStart = now; // 该场景已被标记为不可用，下次跳过
+        return;
+    }
+    beginSwitch(next);
+}
+
+// ==================== 蓝牙命令 ====================
+// 处理播放列表命令 (0x17)
+// 数据格式：[操作][参数...]，见蓝牙播放列表帧格式.md
+// 应答：[操作][状态]，保存场景时附 [场景号][负载长度2]，查询状态时附运行状态
+void handlePlaylistCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 1)
+    {
+        LOG_E("错误: 播放列表数据无效");
+        return;
+    }
+
+    uint8_t op = frame.data[0];
+    uint8_t response[10] = {op, BT_PLAYLIST_STATUS_INVALID};
+    int length = 2;
+
+    switch (op)
+    {
+    case BT_PLAYLIST_STORE:
+    {
+        uint32_t payloadLength = 0;
+        uint8_t scene = frame.dataLength >= 2 ? frame.data[1] : 0xFF;
+        response[1] = playlist.storeScene(scene, payloadLength);
+        response[2] = scene;
+        response[3] = (uint8_t)(payloadLength >> 8);
+        response[4] = (uint8_t)(payloadLength & 0xFF);
+        length = 5;
+        break;
+    }
+
+    case BT_PLAYLIST_DELETE:
+        if (frame.dataLength >= 2)
+            response[1] = playlist.deleteScene(frame.data[1]);
+        break;
+
+    case BT_PLAYLIST_SET:
+    {
+        if (frame.dataLength < 2 || frame.data[1] > PLAYLIST_MAX_ENTRIES ||
+            frame.dataLength != 2 + frame.data[1] * BT_PLAYLIST_ENTRY_LEN)
+            break;
+        uint8_t count = frame.data[1];
+        PlaylistEntry list[PLAYLIST_MAX_ENTRIES];
+        for (int i = 0; i < count; i++)
+        {
+            const uint8_t *p = frame.data + 2 + i * BT_PLAYLIST_ENTRY_LEN;
+            list[i].scene = p[0];
+            list[i].duration = (uint16_t)((p[1] << 8) | p[2]);
+            list[i].transition = p[3];
+        }
+        response[1] = playlist.setEntries(list, count);
+        break;
+    }
+
+    case BT_PLAYLIST_START:
+        response[1] = playlist.start();
+        break;
+
+    case BT_PLAYLIST_STOP:
+        playlist.stop();
+        response[1] = BT_PLAYLIST_STATUS_OK;
+        break;
+
+    case BT_PLAYLIST_STATUS:
+    {
+        uint32_t switches = playlist.getSwitchCount();
+        response[1] = playlist.isAvailable() ? BT_PLAYLIST_STATUS_OK : BT_PLAYLIST_STATUS_NO_STORAGE;
+        response[2] = playlist.isRunning() ? 1 : 0;
+        response[3] = playlist.getCurrentEntry() < 0 ? 0xFF : (uint8_t)playlist.getCurrentEntry();
+        response[4] = playlist.getEntryCount();
+        response[5] = playlist.getSceneMask();
+        response[6] = (uint8_t)(switches >> 24);
+        response[7] = (uint8_t)(switches >> 16);
+        response[8] = (uint8_t)(switches >> 8);
+        response[9] = (uint8_t)(switches & 0xFF);
+        length = 10;
+        break;
+    }
+
+    default:
+        LOG_E("错误: 未知的播放列表操作 0x%02X", op);
+        break;
+    }
+
+    if (response[1] != BT_PLAYLIST_STATUS_OK)
+    {
+        LOG_W("播放列表命令失败 - 操作: 0x%02X, 状态: %d", op, response[1]);
+    }
+    sendResponseFrame(BT_CMD_PLAYLIST, response, length);
+}
@@ -0,0 +1,230 @@
+#include "Priority.h"
+#include "DisplayDriver.h"
+#include "TextStore.h"
+#include "MemoryPool.h"
+#include "Animation.h"
+#include "ImageMode.h"
+#include "LiveStream.h"
+#include "Playlist.h"
+#include "CommandBatch.h"
+#include "Log.h"
+
+static SceneStackEntry sceneStack[PRIORITY_STACK_DEPTH];
+static uint8_t stackDepth = 0;
+
+static RegionText *const stackRegions[3] = {&upperRegionText, &lowerRegionText, &fullRegionText};
+
+bool isPriorityActive()
+{
+    return stackDepth > 0;
+}
+
+uint8_t getPriorityDepth()
+{
+    return stackDepth;
+}
+
+// 入栈：先分配全部存储，成功后才增加字形引用并保存状态，失败时场景与栈都不变
+static uint8_t pushScene(uint8_t priority, uint16_t duration)
+{
+    if (stackDepth >= PRIORITY_STACK_DEPTH)
+        return BT_PRIORITY_STATUS_FULL;
+    if (stackDepth > 0 && priority < sceneStack[stackDepth - 1].priority)
+        return BT_PRIORITY_STATUS_LOWER;
+
+    bool fullScreen = isAnimationPlaying() || isImageShowing() || isLiveStreaming() || playlist.isTransitioning();
+#if !SCENE_FIRST_FRAME
+    if (fullScreen)
+        return BT_PRIORITY_STATUS_BUSY; // 全屏模式的画面只能从屏幕镜像恢复
+#endif
+
+    SceneStackEntry &entry = sceneStack[stackDepth];
+    entry.arenaMark = priorityArena.mark();
+    entry.frame = nullptr;
+#if SCENE_FIRST_FRAME
+    entry.frame = priorityArena.allocateArray<uint16_t>(SCREEN_WIDTH * SCREEN_HEIGHT);
+    if (!entry.frame)
+    {
+        priorityArena.rewind(entry.arenaMark);
+        return BT_PRIORITY_STATUS_FULL;
+    }
+    memcpy(entry.frame, panelMirror, sizeof(panelMirror));
+#endif
+
+    // 栈中的序号与区域文本各持有一份字形引用，插播改写文本时原场景的字形不会被回收
+    for (int i = 0; i < 3; i++)
+    {
+        if (!saveRegionText(*stackRegions[i], priorityArena, entry.regions[i]))
+        {
+            while (i-- > 0)
+            {
+                releaseRegionSnapshot(*stackRegions[i], entry.regions[i]);
+            }
+            priorityArena.rewind(entry.arenaMark);
+            entry.frame = nullptr;
+            return BT_PRIORITY_STATUS_FULL;
+        }
+    }
+
+    entry.text = textState;
+    entry.color = colorState;
+    entry.effect = effectState;
+    entry.brightness = brightnessState;
+    entry.fontSize = currentFontSize;
+    entry.stream = streamPlayback;
+    entry.priority = priority;
+    entry.pushedAt = millis();
+    entry.duration = (unsigned long)duration * 100;
+    stackDepth++;
+
+    // 全屏模式让出屏幕后由文本渲染接管，插播内容到来前先按当前场景绘制一次
+    textState.needUpdate = true;
+    LOG_I("开始插播 - 层数: %d, 优先级: %d, 时长: %dms, 全屏模式: %d, 栈存储: %u字节",
+          stackDepth, priority, (int)entry.duration, fullScreen ? 1 : 0, (unsigned)priorityArena.getUsed());
+    return BT_PRIORITY_STATUS_OK;
+}
+
+// 出栈：区域文本换回保存的序号（引用随之转回），状态恢复，屏幕镜像直接推回屏幕
+static void popScene()
+{
+    SceneStackEntry &entry = sceneStack[--stackDepth];
+    unsigned long paused = millis() - entry.pushedAt;
+
+    for (int i = 0; i < 3; i++)
+    {
+        restoreRegionText(*stackRegions[i], entry.regions[i]);
+    }
+
+    // 分页与特效计时顺延插播占用的时间，恢复后从中断处继续
+    textState = entry.text;
+    textState.lastSwitchTime += paused;
+    textState.lowerSwitchTime += paused;
+    colorState = entry.color;
+    effectState = entry.effect;
+    effectState.lastEffectTime += paused;
+    if (brightnessState.brightness != entry.brightness.brightness)
+    {
+        brightnessState.brightness = entry.brightness.brightness;
+        brightnessState.needBrightnessUpdate = true;
+    }
+    currentFontSize = entry.fontSize;
+    streamPlayback = entry.stream;
+
+#if SCENE_FIRST_FRAME
+    for (int y = 0; y < SCREEN_HEIGHT; y++)
+    {
+        for (int x = 0; x < SCREEN_WIDTH; x++)
+        {
+            drawPanelPixel(x, y, entry.frame[y * SCREEN_WIDTH + x]);
+        }
+    }
+#else
+    textState.needUpdate = true;
+#endif
+
+    priorityArena.rewind(entry.arenaMark);
+    entry.frame = nullptr;
+    LOG_I("插播结束 - 剩余层数: %d, 持续: %ums", stackDepth, (unsigned)paused);
+}
+
+void discardPriorityScenes(uint8_t depth)
+{
+    while (stackDepth > depth)
+    {
+        SceneStackEntry &entry = sceneStack[--stackDepth];
+        for (int i = 0; i < 3; i++)
+        {
+            releaseRegionSnapshot(*stackRegions[i], entry.regions[i]);
+        }
+        priorityArena.rewind(entry.arenaMark);
+        entry.frame = nullptr;
+        LOG_I("丢弃插播场景 - 剩余层数: %d", stackDepth);
+    }
+}
+
+void updatePriority()
+{
+    if (stackDepth == 0)
+        return;
+
+    const SceneStackEntry &top = sceneStack[stackDepth - 1];
+    if (top.duration > 0 && millis() - top.pushedAt >= top.duration)
+        popScene();
+}
+
+// 应答：[操作][状态][层数][最上层优先级][剩余时长2字节，0.1秒为单位，0xFFFF表示直到撤销]
+static void sendPriorityResponse(uint8_t op, uint8_t status)
+{
+    uint8_t topPriority = 0;
+    uint16_t remaining = 0;
+    if (stackDepth > 0)
+    {
+        const SceneStackEntry &top = sceneStack[stackDepth - 1];
+        topPriority = top.priority;
+        remaining = 0xFFFF;
+        if (top.duration > 0)
+        {
+            unsigned long elapsed = millis() - top.pushedAt;
+            remaining = (elapsed < top.duration) ? (uint16_t)((top.duration - elapsed + 99) / 100) : 0;
+        }
+    }
+    uint8_t response[6] = {op, status, stackDepth, topPriority, (uint8_t)(remaining >> 8), (uint8_t)(remaining & 0xFF)};
+    sendResponseFrame(BT_CMD_PRIORITY, response, sizeof(response));
+}
+
+// 处理优先插播命令 (0x1A)
+// 数据格式：[操作][参数...]，见蓝牙优先插播帧格式.md
+void handlePriorityCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 1)
+    {
+        LOG_E("错误: 优先插播数据无效");
+        return;
+    }
+
+    uint8_t op = frame.data[0];
+    uint8_t status = BT_PRIORITY_STATUS_INVALID;
+    switch (op)
+    {
+    case BT_PRIORITY_PUSH:
+        if (frame.dataLength >= 4)
+        {
+            uint16_t duration = ((uint16_t)frame.data[2] << 8) | frame.data[3];
+            status = pushScene(frame.data[1], duration);
+        }
+        break;
+
+    case BT_PRIORITY_POP:
+        status = BT_PRIORITY_STATUS_EMPTY;
+        if (stackDepth > 0)
+        {
+            popScene();
+            status = BT_PRIORITY_STATUS_OK;
+        }
+        break;
+
+    case BT_PRIORITY_CLEAR:
+        status = BT_PRIORITY_STATUS_EMPTY;
+        if (stackDepth > 0)
+        {
+            while (stackDepth > 0)
+            {
+                popScene();
+            }
+            status = BT_PRIORITY_STATUS_OK;
+        }
+        break;
+
+    case BT_PRIORITY_STATUS:
+        status = BT_PRIORITY_STATUS_OK;
+        break;
+
+    default:
+        LOG_E("错误: 未知的优先插播操作 0x%02X", op);
+        break;
+    }
+
+    if (status != BT_PRIORITY_STATUS_OK)
+        markBatchFailed();
+    sendPriorityResponse(op, status);
+}
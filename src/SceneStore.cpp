@@ -0,0 +1,675 @@
+#include "SceneStore.h"
+#include "LEDController.h"
+#include "DisplayDriver.h"
+#include "TextStore.h"
+#include "TextStream.h"
+#include "SceneSync.h"
+#include "Animation.h"
+#include "ImageMode.h"
+#include "LiveStream.h"
+#include "MemoryPool.h"
+#include "Log.h"
+#include <string.h>
+
+SceneStore sceneStore;
+
+// 负载段类型（格式见SceneStore.h）
+static const uint8_t SECTION_DISPLAY = 0x01;
+static const uint8_t SECTION_COLOR = 0x02;
+static const uint8_t SECTION_EFFECT = 0x03;
+static const uint8_t SECTION_FRAME = 0x04;
+static const uint8_t SECTION_GLYPHS_16 = 0x10;
+static const uint8_t SECTION_GLYPHS_32 = 0x11;
+static const uint8_t SECTION_UPPER_TEXT = 0x20;
+static const uint8_t SECTION_LOWER_TEXT = 0x21;
+static const uint8_t SECTION_FULL_TEXT = 0x22;
+
+static const int SECTION_HEADER_SIZE = 4;
+static const int DISPLAY_SECTION_SIZE = 8;
+static const int COLOR_BYTES_PER_AREA = 13;
+static const int EFFECT_BYTES_PER_HALF = 7;
+static const int FRAME_ROW_BYTES = SCREEN_WIDTH * 2;
+
+// 小端读写辅助函数
+static uint16_t readLE16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t readLE32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void writeLE32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+// ==================== 槽位写入 ====================
+// 顺序写入槽位负载：经暂存区成块写Flash，写到新扇区前才擦除，同时累计负载哈希
+class SlotWriter
+{
+private:
+    PartitionStore &store;
+    uint32_t base;      // 槽位起始偏移
+    uint32_t slotSize;  // 槽位大小
+    uint32_t written;   // 已写入Flash的负载字节数
+    uint32_t erasedEnd; // 槽位内已擦除到的偏移
+    uint32_t hash;      // 负载哈希
+    uint8_t staging[256];
+    size_t staged;
+    bool failed;
+
+    bool flush()
+    {
+        if (failed || staged == 0)
+            return !failed;
+
+        uint32_t end = SCENE_HEADER_SIZE + written + staged;
+        if (end > slotSize)
+        {
+            LOG_E("错误: 场景快照超出槽位大小 - 需要: %u字节, 槽位: %u字节", end, slotSize);
+            failed = true;
+            return false;
+        }
+        while (erasedEnd < end)
+        {
+            if (!store.erase(base + erasedEnd, PARTITION_SECTOR_SIZE))
+            {
+                failed = true;
+                return false;
+            }
+            erasedEnd += PARTITION_SECTOR_SIZE;
+        }
+        if (!store.write(base + SCENE_HEADER_SIZE + written, staging, staged))
+        {
+            failed = true;
+            return false;
+        }
+        written += staged;
+        staged = 0;
+        return true;
+    }
+
+public:
+    SlotWriter(PartitionStore &store, uint32_t base, uint32_t slotSize)
+        : store(store), base(base), slotSize(slotSize), written(0), erasedEnd(0), hash(fnv1aHash(nullptr, 0)), staged(0), failed(false) {}
+
+    void put(const void *data, size_t length)
+    {
+        const uint8_t *bytes = (const uint8_t *)data;
+        hash = fnv1aHash(bytes, length, hash);
+        while (length > 0 && !failed)
+        {
+            size_t chunk = sizeof(staging) - staged;
+            if (chunk > length)
+                chunk = length;
+            memcpy(staging + staged, bytes, chunk);
+            staged += chunk;
+            bytes += chunk;
+            length -= chunk;
+            if (staged == sizeof(staging))
+                flush();
+        }
+    }
+
+    void put16(uint16_t value)
+    {
+        uint8_t bytes[2] = {(uint8_t)(value & 0xFF), (uint8_t)(value >> 8)};
+        put(bytes, 2);
+    }
+
+    void beginSection(uint8_t type, uint16_t length)
+    {
+        uint8_t header[SECTION_HEADER_SIZE] = {type, 0, (uint8_t)(length & 0xFF), (uint8_t)(length >> 8)};
+        put(header, sizeof(header));
+    }
+
+    bool finish() { return flush(); }
+    uint32_t getLength() const { return written + staged; }
+    uint32_t getHash() const { return hash; }
+};
+
+// 为区域文本用到的字形按首次出现顺序分配快照内序号，remap为字形表槽位到快照序号的映射，order为反向映射
+static int collectGlyphs(const RegionText *const *regions, int regionCount, uint16_t *remap, uint16_t *order)
+{
+    int count = 0;
+    for (int r = 0; r < regionCount; r++)
+    {
+        const RegionText &region = *regions[r];
+        for (int i = 0; i < region.charCount; i++)
+        {
+            uint16_t slot = region.indices[i];
+            if (remap[slot] == 0xFFFF)
+            {
+                remap[slot] = count;
+                order[count++] = slot;
+            }
+        }
+    }
+    return count;
+}
+
+static void putGlyphSection(SlotWriter &writer, uint8_t type, const GlyphTable &table, const uint16_t *order, int count)
+{
+    int wordsPerGlyph = table.getWordsPerGlyph();
+    writer.beginSection(type, 2 + count * wordsPerGlyph * 2);
+    writer.put16(count);
+    for (int i = 0; i < count; i++)
+    {
+        const uint16_t *glyph = table.getGlyphData() + order[i] * wordsPerGlyph;
+        for (int j = 0; j < wordsPerGlyph; j++)
+        {
+            writer.put16(glyph[j]);
+        }
+    }
+}
+
+// 从未设置过文本的区域不写文本段，恢复时据此显示内置示例数据
+static void putTextSection(SlotWriter &writer, uint8_t type, const RegionText &region, const uint16_t *remap)
+{
+    if (!region.hasText)
+        return;
+    writer.beginSection(type, 2 + region.charCount * 2);
+    writer.put16(region.charCount);
+    for (int i = 0; i < region.charCount; i++)
+    {
+        writer.put16(remap[region.indices[i]]);
+    }
+}
+
+static void putColorArea(SlotWriter &writer, uint16_t textColor, uint16_t bgColor, uint8_t textMode, uint8_t bgMode,
+                         uint8_t textR, uint8_t textG, uint8_t textB, uint8_t bgR, uint8_t bgG, uint8_t bgB,
+                         uint8_t gradientMode)
+{
+    writer.put16(textColor);
+    writer.put16(bgColor);
+    uint8_t bytes[9] = {textMode, bgMode, textR, textG, textB, bgR, bgG, bgB, gradientMode};
+    writer.put(bytes, sizeof(bytes));
+}
+
+// ==================== 快照槽位 ====================
+bool ScenePayload::read(uint32_t offset, void *buffer, size_t size) const
+{
+    if (offset + size > length)
+        return false;
+    if (data)
+    {
+        memcpy(buffer, data + offset, size);
+        return true;
+    }
+    return store->read(base + offset, buffer, size);
+}
+
+bool readSceneSlotHeader(const PartitionStore &store, uint32_t base, uint32_t slotSize,
+                         uint32_t &sequence, uint32_t &length, uint32_t &hash)
+{
+    uint8_t header[SCENE_HEADER_SIZE];
+    if (!store.read(base, header, sizeof(header)))
+        return false;
+    if (readLE32(header) != SCENE_MAGIC || readLE16(header + 4) != SCENE_VERSION)
+        return false;
+
+    sequence = readLE32(header + 8);
+    length = readLE32(header + 12);
+    hash = readLE32(header + 16);
+    return length > 0 && length <= slotSize - SCENE_HEADER_SIZE;
+}
+
+bool verifySceneSlot(const PartitionStore &store, uint32_t base, uint32_t length, uint32_t hash)
+{
+    uint8_t buffer[256];
+    uint32_t actual = fnv1aHash(nullptr, 0);
+    uint32_t offset = base + SCENE_HEADER_SIZE;
+    for (uint32_t done = 0; done < length;)
+    {
+        uint32_t chunk = (length - done < sizeof(buffer)) ? length - done : sizeof(buffer);
+        if (!store.read(offset + done, buffer, chunk))
+            return false;
+        actual = fnv1aHash(buffer, chunk, actual);
+        done += chunk;
+    }
+    return actual == hash;
+}
+
+// 只保存区域文本实际引用的字形；负载写完后才写槽位头，槽位头所在扇区已在写第一块负载时擦除
+bool writeSceneSlot(PartitionStore &store, uint32_t base, uint32_t slotSize, uint32_t sequence, uint32_t &length)
+{
+    ArenaScope scope(scratchArena);
+
+    // 字形序号在快照内重新编号
+    uint16_t *remap16 = scratchArena.allocateArray<uint16_t>(glyphTable16.getCapacity());
+    uint16_t *order16 = scratchArena.allocateArray<uint16_t>(glyphTable16.getCapacity());
+    uint16_t *remap32 = scratchArena.allocateArray<uint16_t>(glyphTable32.getCapacity());
+    uint16_t *order32 = scratchArena.allocateArray<uint16_t>(glyphTable32.getCapacity());
+    if (!remap16 || !order16 || !remap32 || !order32)
+        return false;
+    memset(remap16, 0xFF, glyphTable16.getCapacity() * sizeof(uint16_t));
+    memset(remap32, 0xFF, glyphTable32.getCapacity() * sizeof(uint16_t));
+    const RegionText *halves[2] = {&upperRegionText, &lowerRegionText};
+    const RegionText *full[1] = {&fullRegionText};
+    int glyphCount16 = collectGlyphs(halves, 2, remap16, order16);
+    int glyphCount32 = collectGlyphs(full, 1, remap32, order32);
+
+    SlotWriter writer(store, base, slotSize);
+
+    writer.beginSection(SECTION_DISPLAY, DISPLAY_SECTION_SIZE);
+    uint8_t display[DISPLAY_SECTION_SIZE] = {currentFontSize, textState.displayDirection, brightnessState.brightness,
+                                             streamPlayback.active, streamPlayback.screenArea, 0, 0, 0};
+    writer.put(display, sizeof(display));
+
+#if SCENE_FIRST_FRAME
+    // 动画、图像与实时流不属于快照内容，显示期间屏上不是场景画面，不保存首帧
+    if (!isAnimationPlaying() && !isImageShowing() && !isLiveStreaming())
+    {
+        writer.beginSection(SECTION_FRAME, SCREEN_HEIGHT * FRAME_ROW_BYTES);
+        for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++)
+        {
+            writer.put16(panelMirror[i]);
+        }
+    }
+#endif
+
+    writer.beginSection(SECTION_COLOR, COLOR_BYTES_PER_AREA * 3);
+    putColorArea(writer, colorState.upperTextColor, colorState.upperBackgroundColor,
+                 colorState.upperTextMode, colorState.upperBgMode,
+                 colorState.upperTextR, colorState.upperTextG, colorState.upperTextB,
+                 colorState.upperBgR, colorState.upperBgG, colorState.upperBgB, colorState.upperGradientMode);
+    putColorArea(writer, colorState.lowerTextColor, colorState.lowerBackgroundColor,
+                 colorState.lowerTextMode, colorState.lowerBgMode,
+                 colorState.lowerTextR, colorState.lowerTextG, colorState.lowerTextB,
+                 colorState.lowerBgR, colorState.lowerBgG, colorState.lowerBgB, colorState.lowerGradientMode);
+    putColorArea(writer, colorState.textColor, colorState.backgroundColor, colorState.textMode, colorState.bgMode,
+                 colorState.textR, colorState.textG, colorState.textB,
+                 colorState.bgR, colorState.bgG, colorState.bgB, colorState.gradientMode);
+
+    // 与场景同步项相同的特效字段：[滚动开关][滚动类型][滚动速度][闪烁开关][闪烁速度][呼吸开关][呼吸速度]
+    writer.beginSection(SECTION_EFFECT, EFFECT_BYTES_PER_HALF * 2);
+    uint8_t effects[EFFECT_BYTES_PER_HALF * 2] = {
+        effectState.upperScrollActive, effectState.upperScrollType, effectState.upperScrollSpeed,
+        effectState.upperBlinkActive, effectState.upperBlinkSpeed,
+        effectState.upperBreatheActive, effectState.upperBreatheSpeed,
+        effectState.lowerScrollActive, effectState.lowerScrollType, effectState.lowerScrollSpeed,
+        effectState.lowerBlinkActive, effectState.lowerBlinkSpeed,
+        effectState.lowerBreatheActive, effectState.lowerBreatheSpeed};
+    writer.put(effects, sizeof(effects));
+
+    putGlyphSection(writer, SECTION_GLYPHS_16, glyphTable16, order16, glyphCount16);
+    putGlyphSection(writer, SECTION_GLYPHS_32, glyphTable32, order32, glyphCount32);
+    putTextSection(writer, SECTION_UPPER_TEXT, upperRegionText, remap16);
+    putTextSection(writer, SECTION_LOWER_TEXT, lowerRegionText, remap16);
+    putTextSection(writer, SECTION_FULL_TEXT, fullRegionText, remap32);
+
+    uint8_t header[SCENE_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    writeLE32(header, SCENE_MAGIC);
+    header[4] = SCENE_VERSION & 0xFF;
+    header[5] = SCENE_VERSION >> 8;
+    writeLE32(header + 8, sequence);
+    writeLE32(header + 12, writer.getLength());
+    writeLE32(header + 16, writer.getHash());
+    if (!writer.finish() || !store.write(base, header, sizeof(header)))
+        return false;
+
+    length = writer.getLength();
+    return true;
+}
+
+// 按段依次应用：显示设置与首帧在前，文本在后；字形段先于引用它的文本段
+bool applyScenePayload(const ScenePayload &payload, bool drawFrame)
+{
+    ArenaScope scope(scratchArena);
+    const uint16_t *glyphs16 = nullptr;
+    const uint16_t *glyphs32 = nullptr;
+    int glyphCount16 = 0;
+    int glyphCount32 = 0;
+    bool textRestored[3] = {false, false, false};
+
+    uint32_t offset = 0;
+    uint32_t end = payload.length;
+    while (offset + SECTION_HEADER_SIZE <= end)
+    {
+        uint8_t sectionHeader[SECTION_HEADER_SIZE];
+        if (!payload.read(offset, sectionHeader, sizeof(sectionHeader)))
+            break;
+        uint8_t type = sectionHeader[0];
+        uint16_t length = readLE16(sectionHeader + 2);
+        uint32_t dataOffset = offset + SECTION_HEADER_SIZE;
+        offset = dataOffset + length;
+        if (offset > end)
+            break;
+
+        switch (type)
+        {
+        case SECTION_DISPLAY:
+        {
+            uint8_t data[DISPLAY_SECTION_SIZE];
+            if (length < DISPLAY_SECTION_SIZE || !payload.read(dataOffset, data, sizeof(data)))
+                break;
+            currentFontSize = (data[0] == BT_FONT_32x32) ? BT_FONT_32x32 : BT_FONT_16x16;
+            textState.displayDirection = data[1];
+            brightnessState.brightness = data[2];
+            dma_display->setBrightness8(data[2]); // 首帧以保存时的亮度显示
+            streamPlayback.active = data[3] != 0;
+            streamPlayback.screenArea = data[4];
+            break;
+        }
+
+        case SECTION_FRAME:
+        {
+            if (!drawFrame || length != SCREEN_HEIGHT * FRAME_ROW_BYTES)
+                break;
+            uint8_t row[FRAME_ROW_BYTES];
+            for (int y = 0; y < SCREEN_HEIGHT; y++)
+            {
+                if (!payload.read(dataOffset + y * FRAME_ROW_BYTES, row, sizeof(row)))
+                    break;
+                for (int x = 0; x < SCREEN_WIDTH; x++)
+                {
+                    drawPanelPixel(x, y, readLE16(row + x * 2));
+                }
+            }
+            break;
+        }
+
+        case SECTION_COLOR:
+        {
+            uint8_t data[COLOR_BYTES_PER_AREA * 3];
+            if (length < sizeof(data) || !payload.read(dataOffset, data, sizeof(data)))
+                break;
+            const uint8_t *p = data;
+            colorState.upperTextColor = readLE16(p);
+            colorState.upperBackgroundColor = readLE16(p + 2);
+            colorState.upperTextMode = p[4];
+            colorState.upperBgMode = p[5];
+            colorState.upperTextR = p[6];
+            colorState.upperTextG = p[7];
+            colorState.upperTextB = p[8];
+            colorState.upperBgR = p[9];
+            colorState.upperBgG = p[10];
+            colorState.upperBgB = p[11];
+            colorState.upperGradientMode = p[12];
+            p += COLOR_BYTES_PER_AREA;
+            colorState.lowerTextColor = readLE16(p);
+            colorState.lowerBackgroundColor = readLE16(p + 2);
+            colorState.lowerTextMode = p[4];
+            colorState.lowerBgMode = p[5];
+            colorState.lowerTextR = p[6];
+            colorState.lowerTextG = p[7];
+            colorState.lowerTextB = p[8];
+            colorState.lowerBgR = p[9];
+            colorState.lowerBgG = p[10];
+            colorState.lowerBgB = p[11];
+            colorState.lowerGradientMode = p[12];
+            p += COLOR_BYTES_PER_AREA;
+            colorState.textColor = readLE16(p);
+            colorState.backgroundColor = readLE16(p + 2);
+            colorState.textMode = p[4];
+            colorState.bgMode = p[5];
+            colorState.textR = p[6];
+            colorState.textG = p[7];
+            colorState.textB = p[8];
+            colorState.bgR = p[9];
+            colorState.bgG = p[10];
+            colorState.bgB = p[11];
+            colorState.gradientMode = p[12];
+            colorState.needColorUpdate = true;
+            break;
+        }
+
+        case SECTION_EFFECT:
+        {
+            uint8_t data[EFFECT_BYTES_PER_HALF * 2];
+            if (length < sizeof(data) || !payload.read(dataOffset, data, sizeof(data)))
+                break;
+            for (int half = 0; half < 2; half++)
+            {
+                const uint8_t *p = data + half * EFFECT_BYTES_PER_HALF;
+                bool isUpper = (half == 0);
+                clearAllEffects(isUpper);
+                if (p[0])
+                    setScrollEffect(isUpper, p[1], p[2]);
+                else if (p[3])
+                    setBlinkEffect(isUpper, p[4]);
+                else if (p[5])
+                    setBreatheEffect(isUpper, p[6]);
+            }
+            break;
+        }
+
+        case SECTION_GLYPHS_16:
+        case SECTION_GLYPHS_32:
+        {
+            bool is32 = (type == SECTION_GLYPHS_32);
+            int glyphBytes = is32 ? FONT_BYTES_32 : FONT_BYTES_16;
+            uint8_t countBytes[2];
+            if (length < 2 || !payload.read(dataOffset, countBytes, 2))
+                break;
+            int count = readLE16(countBytes);
+            if (length != 2 + count * glyphBytes)
+                break;
+            uint16_t *glyphs = scratchArena.allocateArray<uint16_t>(count * glyphBytes / 2);
+            if (count > 0 && (!glyphs || !payload.read(dataOffset + 2, glyphs, count * glyphBytes)))
+                break;
+            for (int i = 0; i < count * glyphBytes / 2; i++)
+            {
+                glyphs[i] = readLE16((const uint8_t *)&glyphs[i]);
+            }
+            (is32 ? glyphs32 : glyphs16) = glyphs;
+            (is32 ? glyphCount32 : glyphCount16) = count;
+            break;
+        }
+
+        case SECTION_UPPER_TEXT:
+        case SECTION_LOWER_TEXT:
+        case SECTION_FULL_TEXT:
+        {
+            int which = type - SECTION_UPPER_TEXT;
+            bool is32 = (type == SECTION_FULL_TEXT);
+            RegionText &region = is32 ? fullRegionText : (type == SECTION_UPPER_TEXT ? upperRegionText : lowerRegionText);
+            const uint16_t *glyphs = is32 ? glyphs32 : glyphs16;
+            int glyphCount = is32 ? glyphCount32 : glyphCount16;
+
+            uint8_t countBytes[2];
+            if (length < 2 || !payload.read(dataOffset, countBytes, 2))
+                break;
+            int count = readLE16(countBytes);
+            if (length != 2 + count * 2)
+                break;
+            if (count == 0)
+            {
+                clearRegionText(region);
+                textRestored[which] = true;
+                break;
+            }
+
+            uint16_t *indices = scratchArena.allocateArray<uint16_t>(count);
+            if (!indices || !glyphs || !payload.read(dataOffset + 2, indices, count * 2))
+                break;
+            bool valid = true;
+            for (int i = 0; i < count && valid; i++)
+            {
+                indices[i] = readLE16((const uint8_t *)&indices[i]);
+                valid = indices[i] < glyphCount;
+            }
+            if (!valid)
+                break;
+            setRegionText(region, GlyphText(glyphs, indices, count, is32 ? 64 : 16));
+            textRestored[which] = true;
+            break;
+        }
+
+        default:
+            break; // 新版本增加的段，跳过
+        }
+    }
+
+    // 没有文本段的区域保存时从未设置过文本（或该段损坏），回到内置示例数据
+    RegionText *const regions[3] = {&upperRegionText, &lowerRegionText, &fullRegionText};
+    for (int i = 0; i < 3; i++)
+    {
+        if (!textRestored[i])
+            resetRegionText(*regions[i]);
+    }
+
+    textState.upperIndex = 0;
+    textState.lowerIndex = 0;
+    textState.lastSwitchTime = millis();
+    textState.lowerSwitchTime = textState.lastSwitchTime;
+    textState.needUpdate = true;
+    return true;
+}
+
+const uint8_t *findSceneFrame(const uint8_t *payload, uint32_t length)
+{
+    uint32_t offset = 0;
+    while (offset + SECTION_HEADER_SIZE <= length)
+    {
+        uint16_t size = readLE16(payload + offset + 2);
+        uint32_t dataOffset = offset + SECTION_HEADER_SIZE;
+        if (dataOffset + size > length)
+            break;
+        if (payload[offset] == SECTION_FRAME && size == SCREEN_HEIGHT * FRAME_ROW_BYTES)
+            return payload + dataOffset;
+        offset = dataOffset + size;
+    }
+    return nullptr;
+}
+
+// ==================== 场景快照 ====================
+SceneStore::SceneStore()
+    : latestSlot(-1), latestSequence(0), latestLength(0), savedHash(0), observedHash(0),
+      lastCheckTime(0), changeTime(0), lastSaveTime(0), saveCount(0), failureCount(0) {}
+
+uint32_t SceneStore::getSlotCount() const
+{
+    return store.size() / SCENE_SLOT_SIZE;
+}
+
+// 先只读各槽位头，从序号最大的开始校验负载，校验失败（如写入时掉电）再退回上一个
+bool SceneStore::begin(const char *label)
+{
+    latestSlot = -1;
+    latestSequence = 0;
+    latestLength = 0;
+    if (!store.open(label))
+        return false;
+
+    uint32_t slotCount = getSlotCount();
+    uint32_t rejected = 0; // 已校验失败的槽位位掩码
+    for (uint32_t attempt = 0; attempt < slotCount; attempt++)
+    {
+        int best = -1;
+        uint32_t bestSequence = 0;
+        uint32_t bestLength = 0;
+        uint32_t bestHash = 0;
+        for (uint32_t slot = 0; slot < slotCount && slot < 32; slot++)
+        {
+            uint32_t sequence, length, hash;
+            if ((rejected & (1UL << slot)) ||
+                !readSceneSlotHeader(store, slot * SCENE_SLOT_SIZE, SCENE_SLOT_SIZE, sequence, length, hash))
+                continue;
+            if (best < 0 || sequence > bestSequence)
+            {
+                best = slot;
+                bestSequence = sequence;
+                bestLength = length;
+                bestHash = hash;
+            }
+        }
+        if (best < 0)
+            break;
+
+        if (verifySceneSlot(store, best * SCENE_SLOT_SIZE, bestLength, bestHash))
+        {
+            latestSlot = best;
+            latestSequence = bestSequence;
+            latestLength = bestLength;
+            return true;
+        }
+        LOG_W("场景快照槽位%d校验失败，使用上一份快照", best);
+        rejected |= 1UL << best;
+    }
+    return true;
+}
+
+bool SceneStore::restore()
+{
+    if (latestSlot < 0)
+        return false;
+
+    [[maybe_unused]] unsigned long startTime = millis(); // 只用于日志
+    ScenePayload payload = {&store, (uint32_t)latestSlot * SCENE_SLOT_SIZE + SCENE_HEADER_SIZE, nullptr, latestLength};
+    applyScenePayload(payload, true);
+    LOG_I("已恢复场景快照 - 序号: %u, 负载: %u字节, 耗时: %u毫秒",
+          latestSequence, latestLength, (unsigned)(millis() - startTime));
+    return true;
+}
+
+uint32_t SceneStore::computeSnapshotHash() const
+{
+    uint8_t stream[2] = {streamPlayback.active, streamPlayback.screenArea};
+    return fnv1aHash(stream, sizeof(stream), computeSceneHash());
+}
+
+void SceneStore::resetBaseline()
+{
+    savedHash = computeSnapshotHash();
+    observedHash = savedHash;
+    changeTime = millis();
+}
+
+bool SceneStore::save()
+{
+    uint32_t slotCount = getSlotCount();
+    if (!store.isOpen() || slotCount == 0)
+        return false;
+
+    unsigned long startTime = millis();
+    lastSaveTime = startTime;
+    uint32_t hash = computeSnapshotHash();
+    int slot = (latestSlot + 1) % slotCount;
+    uint32_t length = 0;
+    if (!writeSceneSlot(store, slot * SCENE_SLOT_SIZE, SCENE_SLOT_SIZE, latestSequence + 1, length))
+    {
+        failureCount++;
+        LOG_E("错误: 场景快照写入失败 - 槽位: %d", slot);
+        return false;
+    }
+
+    latestSlot = slot;
+    latestSequence++;
+    latestLength = length;
+    savedHash = hash;
+    saveCount++;
+    LOG_I("场景快照已保存 - 槽位: %d, 序号: %u, 负载: %u字节, 耗时: %u毫秒",
+          slot, latestSequence, latestLength, (unsigned)(millis() - startTime));
+    return true;
+}
+
+// 场景变化后先等它稳定，再受最小保存间隔约束，避免连续调整或频繁刷新的内容反复擦写Flash
+void SceneStore::poll()
+{
+    unsigned long now = millis();
+    if (!store.isOpen() || now - lastCheckTime < SCENE_CHECK_INTERVAL_MS)
+        return;
+    lastCheckTime = now;
+
+    uint32_t hash = computeSnapshotHash();
+    if (hash != observedHash)
+    {
+        observedHash = hash;
+        changeTime = now;
+        return;
+    }
+    if (hash == savedHash || now - changeTime < SCENE_SAVE_QUIET_MS)
+        return;
+    if (saveCount + failureCount > 0 && now - lastSaveTime < SCENE_SAVE_MIN_INTERVAL_MS)
+        return;
+
+    save();
+}
@@ -0,0 +1,148 @@
+#include "SceneSync.h"
+#include "LEDController.h"
+#include "Log.h"
+
+static const uint8_t sceneItems[SCENE_ITEM_COUNT] = {
+    SCENE_ITEM_UPPER_TEXT, SCENE_ITEM_LOWER_TEXT, SCENE_ITEM_FULL_TEXT,
+    SCENE_ITEM_UPPER_COLOR, SCENE_ITEM_LOWER_COLOR,
+    SCENE_ITEM_UPPER_EFFECT, SCENE_ITEM_LOWER_EFFECT,
+    SCENE_ITEM_DISPLAY};
+
+// 点阵按协议字节序（每个uint16高字节在前）逐字符串联计算，与客户端发送的连续点阵字节一致
+static uint32_t hashGlyphText(const GlyphText &text)
+{
+    uint32_t hash = fnv1aHash(nullptr, 0);
+    for (int i = 0; i < text.count; i++)
+    {
+        const uint16_t *words = text.at(i);
+        for (int j = 0; j < text.wordsPerGlyph; j++)
+        {
+            uint8_t bytes[2] = {(uint8_t)(words[j] >> 8), (uint8_t)(words[j] & 0xFF)};
+            hash = fnv1aHash(bytes, 2, hash);
+        }
+    }
+    return hash;
+}
+
+// 当前显示的点阵：与渲染一致，优先动态数据，否则为内置示例数据
+static uint32_t hashRegionText(uint8_t item)
+{
+    switch (item)
+    {
+    case SCENE_ITEM_UPPER_TEXT:
+        return hashGlyphText(getUpperDisplayText());
+
+    case SCENE_ITEM_LOWER_TEXT:
+        return hashGlyphText(getLowerDisplayText());
+
+    default:
+        return hashGlyphText(getFullDisplayText());
+    }
+}
+
+uint32_t computeSceneItemHash(uint8_t item, bool &valid)
+{
+    valid = true;
+
+    switch (item)
+    {
+    case SCENE_ITEM_UPPER_TEXT:
+    case SCENE_ITEM_LOWER_TEXT:
+    case SCENE_ITEM_FULL_TEXT:
+        return hashRegionText(item);
+
+    case SCENE_ITEM_UPPER_COLOR:
+    {
+        // [文本模式][文本R][文本G][文本B][渐变模式][背景模式][背景R][背景G][背景B]
+        uint8_t bytes[9] = {colorState.upperTextMode, colorState.upperTextR, colorState.upperTextG, colorState.upperTextB,
+                            colorState.upperGradientMode, colorState.upperBgMode,
+                            colorState.upperBgR, colorState.upperBgG, colorState.upperBgB};
+        return fnv1aHash(bytes, sizeof(bytes));
+    }
+
+    case SCENE_ITEM_LOWER_COLOR:
+    {
+        uint8_t bytes[9] = {colorState.lowerTextMode, colorState.lowerTextR, colorState.lowerTextG, colorState.lowerTextB,
+                            colorState.lowerGradientMode, colorState.lowerBgMode,
+                            colorState.lowerBgR, colorState.lowerBgG, colorState.lowerBgB};
+        return fnv1aHash(bytes, sizeof(bytes));
+    }
+
+    case SCENE_ITEM_UPPER_EFFECT:
+    {
+        // [滚动开关][滚动类型][滚动速度][闪烁开关][闪烁速度][呼吸开关][呼吸速度]
+        uint8_t bytes[7] = {effectState.upperScrollActive, effectState.upperScrollType, effectState.upperScrollSpeed,
+                            effectState.upperBlinkActive, effectState.upperBlinkSpeed,
+                            effectState.upperBreatheActive, effectState.upperBreatheSpeed};
+        return fnv1aHash(bytes, sizeof(bytes));
+    }
+
+    case SCENE_ITEM_LOWER_EFFECT:
+    {
+        uint8_t bytes[7] = {effectState.lowerScrollActive, effectState.lowerScrollType, effectState.lowerScrollSpeed,
+                            effectState.lowerBlinkActive, effectState.lowerBlinkSpeed,
+                            effectState.lowerBreatheActive, effectState.lowerBreatheSpeed};
+        return fnv1aHash(bytes, sizeof(bytes));
+    }
+
+    case SCENE_ITEM_DISPLAY:
+    {
+        // [字体大小][显示方向][亮度]
+        uint8_t bytes[3] = {currentFontSize, textState.displayDirection, brightnessState.brightness};
+        return fnv1aHash(bytes, sizeof(bytes));
+    }
+
+    default:
+        valid = false;
+        return 0;
+    }
+}
+
+uint32_t computeSceneHash()
+{
+    uint32_t hash = fnv1aHash(nullptr, 0);
+    for (int i = 0; i < SCENE_ITEM_COUNT; i++)
+    {
+        bool valid;
+        uint32_t itemHash = computeSceneItemHash(sceneItems[i], valid);
+        hash = fnv1aHash((const uint8_t *)&itemHash, sizeof(itemHash), hash);
+    }
+    return hash;
+}
+
+// 处理场景同步查询命令 (0x11)
+// 请求数据为要查询的同步项列表，为空时返回全部同步项
+// 应答：[项数] + 每项 [同步项][哈希4字节]，未知同步项不返回
+void handleSceneSyncCommand(const BluetoothFrame &frame)
+{
+    const uint8_t *items = sceneItems;
+    int itemCount = SCENE_ITEM_COUNT;
+    if (frame.data != nullptr && frame.dataLength > 0)
+    {
+        items = frame.data;
+        itemCount = frame.dataLength;
+    }
+
+    uint8_t response[1 + SCENE_ITEM_COUNT * 5];
+    int length = 1;
+    uint8_t resultCount = 0;
+
+    for (int i = 0; i < itemCount && resultCount < SCENE_ITEM_COUNT; i++)
+    {
+        bool valid;
+        uint32_t hash = computeSceneItemHash(items[i], valid);
+        if (!valid)
+            continue;
+
+        response[length++] = items[i];
+        response[length++] = (uint8_t)(hash >> 24);
+        response[length++] = (uint8_t)(hash >> 16);
+        response[length++] = (uint8_t)(hash >> 8);
+        response[length++] = (uint8_t)(hash & 0xFF);
+        resultCount++;
+    }
+    response[0] = resultCount;
+
+    LOG_I("场景同步查询 - 返回%d项", resultCount);
+    sendResponseFrame(BT_CMD_SCENE_SYNC, response, length);
+}
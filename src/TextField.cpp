@@ -0,0 +1,324 @@
+#include "TextField.h"
+#include "LEDController.h"
+#include "TextStore.h"
+#include "FontPack.h"
+#include "MemoryPool.h"
+#include "CommandBatch.h"
+#include "Log.h"
+
+FieldGlyphSet fieldSets[FIELD_MAX_SETS] = {};
+TextField textFields[FIELD_MAX_FIELDS] = {};
+
+static GlyphTable &getSetTable(const FieldGlyphSet &set)
+{
+    return set.is32 ? glyphTable32 : glyphTable16;
+}
+
+static void releaseSet(FieldGlyphSet &set)
+{
+    if (!set.defined)
+        return;
+
+    GlyphTable &table = getSetTable(set);
+    for (int i = 0; i < set.count; i++)
+    {
+        table.release(set.glyphs[i]);
+    }
+    set.defined = false;
+    set.count = 0;
+}
+
+static int findSetChar(const FieldGlyphSet &set, uint32_t codepoint)
+{
+    for (int i = 0; i < set.count; i++)
+    {
+        if (set.codepoints[i] == codepoint)
+            return i;
+    }
+    return -1;
+}
+
+// 字段所在的区域文本（32x32为全屏，16x16按屏幕区域），区域无效返回nullptr
+static RegionText *getFieldRegion(const TextField &field)
+{
+    if (field.is32)
+        return &fullRegionText;
+    if (field.screenArea == BT_SCREEN_UPPER)
+        return &upperRegionText;
+    if (field.screenArea == BT_SCREEN_LOWER)
+        return &lowerRegionText;
+    return nullptr;
+}
+
+// 定义字符集：[字符集号][字符数N][N个码位，各2字节][N个点阵，省略时从设备端字库读取]
+static uint8_t defineSet(const uint8_t *data, int length)
+{
+    if (length < 2)
+        return BT_FIELD_STATUS_INVALID;
+
+    uint8_t setId = data[0];
+    int count = data[1];
+    bool is32 = (currentFontSize == BT_FONT_32x32);
+    int glyphBytes = is32 ? FONT_BYTES_32 : FONT_BYTES_16;
+    int wordsPerGlyph = glyphBytes / 2;
+    int bitmapLength = length - 2 - count * 2;
+    if (setId >= FIELD_MAX_SETS || count == 0 || count > FIELD_SET_MAX_CHARS || bitmapLength < 0)
+        return BT_FIELD_STATUS_INVALID;
+
+    bool fromFontPack = (bitmapLength == 0);
+    if (!fromFontPack && bitmapLength != count * glyphBytes)
+        return BT_FIELD_STATUS_INVALID;
+    if (fromFontPack && !fontPack.isLoaded())
+    {
+        LOG_E("错误: 字符集未带点阵且设备端字库未加载");
+        return BT_FIELD_STATUS_INVALID;
+    }
+
+    uint16_t *glyph = scratchArena.allocateArray<uint16_t>(wordsPerGlyph);
+    if (!glyph)
+        return BT_FIELD_STATUS_FULL;
+
+    FieldGlyphSet &set = fieldSets[setId];
+    releaseSet(set);
+    set.is32 = is32;
+    GlyphTable &table = getSetTable(set);
+
+    uint8_t status = BT_FIELD_STATUS_OK;
+    const uint8_t *codes = data + 2;
+    const uint8_t *bitmaps = codes + count * 2;
+    for (int i = 0; i < count; i++)
+    {
+        set.codepoints[i] = ((uint16_t)codes[i * 2] << 8) | codes[i * 2 + 1];
+        if (fromFontPack)
+        {
+            if (!fontPack.readGlyph(currentFontSize, set.codepoints[i], glyph))
+            {
+                memset(glyph, 0, wordsPerGlyph * sizeof(uint16_t)); // 字库中没有的字符以空白显示
+                status = BT_FIELD_STATUS_MISSING;
+            }
+        }
+        else
+        {
+            const uint8_t *bytes = bitmaps + i * glyphBytes;
+            for (int w = 0; w < wordsPerGlyph; w++)
+            {
+                glyph[w] = ((uint16_t)bytes[w * 2] << 8) | bytes[w * 2 + 1];
+            }
+        }
+
+        int index = table.intern(glyph);
+        if (index < 0)
+        {
+            LOG_E("错误: 字形表%s空间不足，字符集%d未定义", table.getName(), setId);
+            set.count = i;
+            set.defined = true;
+            releaseSet(set);
+            return BT_FIELD_STATUS_FULL;
+        }
+        set.glyphs[i] = index;
+    }
+    set.count = count;
+    set.defined = true;
+    LOG_I("定义字符集%d - 字符数: %d, 来源: %s", setId, count, fromFontPack ? "设备端字库" : "点阵数据");
+    return status;
+}
+
+// 定义字段：[字段号][屏幕区域][起始2字节][宽度][对齐][字符集号][填充码位2字节]
+static uint8_t defineField(const uint8_t *data, int length)
+{
+    if (length < 9)
+        return BT_FIELD_STATUS_INVALID;
+
+    uint8_t fieldId = data[0];
+    TextField field = {};
+    field.is32 = (currentFontSize == BT_FONT_32x32);
+    field.screenArea = field.is32 ? BT_SCREEN_BOTH : data[1];
+    field.start = ((uint16_t)data[2] << 8) | data[3];
+    field.width = data[4];
+    field.align = data[5];
+    field.set = data[6];
+    field.padChar = ((uint16_t)data[7] << 8) | data[8];
+    if (fieldId >= FIELD_MAX_FIELDS || !getFieldRegion(field) || field.width == 0 || field.width > FIELD_MAX_WIDTH ||
+        field.align > BT_FIELD_ALIGN_RIGHT || field.set >= FIELD_MAX_SETS)
+        return BT_FIELD_STATUS_INVALID;
+
+    field.defined = true;
+    textFields[fieldId] = field;
+    LOG_I("定义字段%d - 区域: 0x%02X, 起始: %d, 宽度: %d, 字符集: %d",
+          fieldId, field.screenArea, field.start, field.width, field.set);
+    return BT_FIELD_STATUS_OK;
+}
+
+// 设置字段值：按对齐方式排好整个字段的字形序号，只替换与区域文本中不同的连续字符段
+static uint8_t setFieldValue(const uint8_t *data, int length, int &changed)
+{
+    changed = 0;
+    if (length < 1 || data[0] >= FIELD_MAX_FIELDS)
+        return BT_FIELD_STATUS_INVALID;
+
+    uint8_t fieldId = data[0];
+    TextField &field = textFields[fieldId];
+    if (!field.defined || !fieldSets[field.set].defined)
+        return BT_FIELD_STATUS_UNDEFINED;
+
+    const FieldGlyphSet &set = fieldSets[field.set];
+    bool is32 = (currentFontSize == BT_FONT_32x32);
+    RegionText *region = getFieldRegion(field);
+    if (field.is32 != is32 || set.is32 != is32 || field.start + field.width > region->charCount)
+    {
+        LOG_W("字段%d与当前模板不符 - 起始: %d, 宽度: %d, 区域字符数: %d",
+              fieldId, field.start, field.width, region->charCount);
+        return BT_FIELD_STATUS_INVALID;
+    }
+    int padSlot = findSetChar(set, field.padChar);
+    if (padSlot < 0)
+        return BT_FIELD_STATUS_INVALID;
+
+    uint32_t codepoints[FIELD_MAX_WIDTH + 1];
+    int count = decodeUtf8(data + 1, length - 1, codepoints, FIELD_MAX_WIDTH + 1);
+    if (count > field.width)
+        return BT_FIELD_STATUS_TOO_LONG;
+
+    uint8_t status = BT_FIELD_STATUS_OK;
+    uint16_t indices[FIELD_MAX_WIDTH];
+    int lead = (field.align == BT_FIELD_ALIGN_RIGHT) ? field.width - count : 0;
+    for (int i = 0; i < field.width; i++)
+    {
+        int slot = padSlot;
+        if (i >= lead && i < lead + count)
+        {
+            slot = findSetChar(set, codepoints[i - lead]);
+            if (slot < 0)
+            {
+                slot = padSlot;
+                status = BT_FIELD_STATUS_MISSING;
+            }
+        }
+        indices[i] = set.glyphs[slot];
+    }
+
+    // 字形表去重，序号相同即点阵相同
+    const GlyphTable &table = getSetTable(set);
+    const uint16_t *current = region->indices + field.start;
+    int i = 0;
+    while (i < field.width)
+    {
+        if (indices[i] == current[i])
+        {
+            i++;
+            continue;
+        }
+        int runStart = i;
+        while (i < field.width && indices[i] != current[i])
+        {
+            i++;
+        }
+        GlyphText run(table.getGlyphData(), indices + runStart, i - runStart, table.getWordsPerGlyph());
+        if (!applyTextRangeUpdate(field.screenArea, BT_RANGE_REPLACE, field.start + runStart, run.count, run))
+            return BT_FIELD_STATUS_FULL;
+        changed += run.count;
+    }
+
+    field.updates++;
+    field.cellWrites += changed;
+    LOG_D("字段%d更新 - 字符数: %d, 替换: %d格", fieldId, count, changed);
+    return status;
+}
+
+static void clearFields()
+{
+    for (int i = 0; i < FIELD_MAX_SETS; i++)
+    {
+        releaseSet(fieldSets[i]);
+    }
+    for (int i = 0; i < FIELD_MAX_FIELDS; i++)
+    {
+        textFields[i].defined = false;
+    }
+    LOG_I("模板字段与字符集已清除");
+}
+
+void saveTextFields(TextFieldState &state)
+{
+    memcpy(state.sets, fieldSets, sizeof(fieldSets));
+    memcpy(state.fields, textFields, sizeof(textFields));
+    for (int i = 0; i < FIELD_MAX_SETS; i++)
+    {
+        const FieldGlyphSet &set = state.sets[i];
+        if (!set.defined)
+            continue;
+        for (int j = 0; j < set.count; j++)
+        {
+            getSetTable(set).retain(set.glyphs[j]);
+        }
+    }
+}
+
+void restoreTextFields(TextFieldState &state)
+{
+    for (int i = 0; i < FIELD_MAX_SETS; i++)
+    {
+        releaseSet(fieldSets[i]);
+    }
+    memcpy(fieldSets, state.sets, sizeof(fieldSets));
+    memcpy(textFields, state.fields, sizeof(textFields));
+    for (int i = 0; i < FIELD_MAX_SETS; i++)
+    {
+        state.sets[i].defined = false; // 引用已转回全局字符集
+    }
+}
+
+void releaseTextFields(TextFieldState &state)
+{
+    for (int i = 0; i < FIELD_MAX_SETS; i++)
+    {
+        releaseSet(state.sets[i]);
+    }
+}
+
+// 处理模板字段命令 (0x19)
+// 数据格式：[操作][参数...]，见蓝牙模板字段帧格式.md
+// 应答：[操作][状态][编号][替换的字符格数]，编号为字符集号或字段号
+void handleTextFieldCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 1)
+    {
+        LOG_E("错误: 模板字段数据无效");
+        return;
+    }
+
+    uint8_t op = frame.data[0];
+    const uint8_t *data = frame.data + 1;
+    int length = frame.dataLength - 1;
+    uint8_t status = BT_FIELD_STATUS_INVALID;
+    int changed = 0;
+    switch (op)
+    {
+    case BT_FIELD_DEFINE_SET:
+        status = defineSet(data, length);
+        break;
+
+    case BT_FIELD_DEFINE:
+        status = defineField(data, length);
+        break;
+
+    case BT_FIELD_SET_VALUE:
+        status = setFieldValue(data, length, changed);
+        break;
+
+    case BT_FIELD_CLEAR:
+        clearFields();
+        status = BT_FIELD_STATUS_OK;
+        break;
+
+    default:
+        LOG_E("错误: 未知的模板字段操作 0x%02X", op);
+        break;
+    }
+
+    if (status != BT_FIELD_STATUS_OK && status != BT_FIELD_STATUS_MISSING)
+        markBatchFailed();
+
+    uint8_t response[4] = {op, status, (uint8_t)(length > 0 ? data[0] : 0), (uint8_t)changed};
+    sendResponseFrame(BT_CMD_TEXT_FIELD, response, sizeof(response));
+}
@@ -0,0 +1,344 @@
+#include "TextStore.h"
+#include "SceneSync.h"
+#include "Log.h"
+
+static_assert((GLYPH_TABLE_BUCKETS & (GLYPH_TABLE_BUCKETS - 1)) == 0, "哈希桶数量须为2的幂");
+static_assert(GLYPH_TABLE_CAPACITY_16 <= 0x7FFF && GLYPH_TABLE_CAPACITY_32 <= 0x7FFF, "字形表槽位序号须能放入int16_t");
+static_assert(GLYPH_CACHE_CAPACITY_16 * (FONT_BYTES_16 + 6) + GLYPH_CACHE_CAPACITY_32 * (FONT_BYTES_32 + 6) +
+                      GLYPH_TABLE_CAPACITY_16 * (FONT_BYTES_16 + 10) + GLYPH_TABLE_CAPACITY_32 * (FONT_BYTES_32 + 10) <=
+                  BOOT_ARENA_BYTES,
+              "启动期分配区容纳不下字形缓存与字形表");
+
+// ==================== 全局实例 ====================
+GlyphTable glyphTable16("glyphs16", GLYPH_TABLE_CAPACITY_16, FONT_BYTES_16 / 2);
+GlyphTable glyphTable32("glyphs32", GLYPH_TABLE_CAPACITY_32, FONT_BYTES_32 / 2);
+
+RegionText upperRegionText = {&glyphTable16, &upperTextBuffer, nullptr, 0, 0, false};
+RegionText lowerRegionText = {&glyphTable16, &lowerTextBuffer, nullptr, 0, 0, false};
+RegionText fullRegionText = {&glyphTable32, &fullTextBuffer, nullptr, 0, 0, false};
+
+// ==================== 字形表 ====================
+GlyphTable::GlyphTable(const char *name, uint16_t capacity, uint16_t wordsPerGlyph)
+    : name(name), capacity(capacity), wordsPerGlyph(wordsPerGlyph)
+{
+    // 字形表随程序常驻，从启动期分配区取得存储，不经过堆
+    hashes = bootArena.allocateArray<uint32_t>(capacity);
+    glyphData = bootArena.allocateArray<uint16_t>(capacity * wordsPerGlyph);
+    refCounts = bootArena.allocateArray<uint16_t>(capacity);
+    nextSlot = bootArena.allocateArray<int16_t>(capacity);
+    if (!hashes || !glyphData || !refCounts || !nextSlot)
+    {
+        this->capacity = 0; // 分配区不足时字形表不可用，所有写入均失败
+    }
+    failureCount = 0;
+    internCount = 0;
+    sharedCount = 0;
+    highWater = 0;
+    clear();
+}
+
+void GlyphTable::clear()
+{
+    for (int i = 0; i < GLYPH_TABLE_BUCKETS; i++)
+    {
+        buckets[i] = -1;
+    }
+    for (int i = 0; i < capacity; i++)
+    {
+        refCounts[i] = 0;
+        nextSlot[i] = (i + 1 < capacity) ? i + 1 : -1;
+    }
+    freeHead = capacity > 0 ? 0 : -1;
+    usedCount = 0;
+}
+
+uint32_t GlyphTable::hashGlyph(const uint16_t *glyph) const
+{
+    return fnv1aHash((const uint8_t *)glyph, wordsPerGlyph * sizeof(uint16_t));
+}
+
+int GlyphTable::intern(const uint16_t *glyph)
+{
+    uint32_t hash = hashGlyph(glyph);
+    int16_t *bucket = &buckets[hash & (GLYPH_TABLE_BUCKETS - 1)];
+    internCount++;
+
+    for (int16_t slot = *bucket; slot >= 0; slot = nextSlot[slot])
+    {
+        if (hashes[slot] == hash &&
+            memcmp(glyphData + slot * wordsPerGlyph, glyph, wordsPerGlyph * sizeof(uint16_t)) == 0)
+        {
+            refCounts[slot]++;
+            sharedCount++;
+            return slot;
+        }
+    }
+
+    if (freeHead < 0)
+    {
+        failureCount++;
+        return -1;
+    }
+
+    int16_t slot = freeHead;
+    freeHead = nextSlot[slot];
+    memcpy(glyphData + slot * wordsPerGlyph, glyph, wordsPerGlyph * sizeof(uint16_t));
+    hashes[slot] = hash;
+    refCounts[slot] = 1;
+    nextSlot[slot] = *bucket;
+    *bucket = slot;
+
+    usedCount++;
+    if (usedCount > highWater)
+        highWater = usedCount;
+    return slot;
+}
+
+void GlyphTable::retain(uint16_t index)
+{
+    if (index < capacity && refCounts[index] > 0)
+        refCounts[index]++;
+}
+
+void GlyphTable::release(uint16_t index)
+{
+    if (index >= capacity || refCounts[index] == 0)
+        return;
+    if (--refCounts[index] > 0)
+        return;
+
+    // 从哈希桶链表摘下，放回空闲链表
+    int16_t *link = &buckets[hashes[index] & (GLYPH_TABLE_BUCKETS - 1)];
+    while (*link >= 0 && *link != (int16_t)index)
+    {
+        link = &nextSlot[*link];
+    }
+    if (*link == (int16_t)index)
+        *link = nextSlot[index];
+
+    nextSlot[index] = freeHead;
+    freeHead = index;
+    usedCount--;
+}
+
+// ==================== 区域文本操作 ====================
+// 把text中的字形逐个写入字形表；任一失败时撤销已写入的引用
+static bool internGlyphs(GlyphTable &table, const GlyphText &text, uint16_t *indices)
+{
+    for (int i = 0; i < text.count; i++)
+    {
+        int index = table.intern(text.at(i));
+        if (index < 0)
+        {
+            for (int j = 0; j < i; j++)
+            {
+                table.release(indices[j]);
+            }
+            return false;
+        }
+        indices[i] = index;
+    }
+    return true;
+}
+
+static int getRegionCapacity(const RegionText &region)
+{
+    return region.indexBuffer->getCapacity() / sizeof(uint16_t);
+}
+
+void clearRegionText(RegionText &region)
+{
+    for (int i = 0; i < region.charCount; i++)
+    {
+        region.table->release(region.indices[i]);
+    }
+    region.indexBuffer->release();
+    region.indices = nullptr;
+    region.charCount = 0;
+    region.revision++;
+    region.hasText = true;
+}
+
+void resetRegionText(RegionText &region)
+{
+    clearRegionText(region);
+    region.hasText = false;
+}
+
+int setRegionText(RegionText &region, const GlyphText &text)
+{
+    clearRegionText(region);
+    if (text.count <= 0)
+        return 0;
+
+    int count = text.count;
+    if (count > getRegionCapacity(region))
+    {
+        LOG_W("区域%s文本超出容量，已截断: %d -> %d字符", region.indexBuffer->getName(), count, getRegionCapacity(region));
+        count = getRegionCapacity(region);
+    }
+
+    region.indices = (uint16_t *)region.indexBuffer->acquire(count * sizeof(uint16_t));
+    int stored = 0;
+    while (stored < count)
+    {
+        int index = region.table->intern(text.at(stored));
+        if (index < 0)
+        {
+            LOG_W("字形表%s已满（%d个不同字形），文本已截断: %d -> %d字符",
+                  region.table->getName(), region.table->getCapacity(), count, stored);
+            break;
+        }
+        region.indices[stored++] = index;
+    }
+
+    region.indexBuffer->acquire(stored * sizeof(uint16_t)); // 同步实际用量
+    region.charCount = stored;
+    return stored;
+}
+
+GlyphText getRegionGlyphs(const RegionText &region)
+{
+    return GlyphText(region.table->getGlyphData(), region.indices, region.charCount, region.table->getWordsPerGlyph());
+}
+
+bool replaceRegionGlyphs(RegionText &region, int start, const GlyphText &text)
+{
+    if (start < 0 || start + text.count > region.charCount)
+        return false;
+
+    // 先写入全部新字形再释放旧字形，失败时区域保持不变
+    ArenaScope scratch(scratchArena);
+    uint16_t *newIndices = scratchArena.allocateArray<uint16_t>(text.count);
+    if (!newIndices || !internGlyphs(*region.table, text, newIndices))
+    {
+        LOG_E("错误: 字形表%s空间不足，替换未执行", region.table->getName());
+        return false;
+    }
+
+    for (int i = 0; i < text.count; i++)
+    {
+        region.table->release(region.indices[start + i]);
+        region.indices[start + i] = newIndices[i];
+    }
+    region.revision++;
+    return true;
+}
+
+bool insertRegionGlyphs(RegionText &region, int start, const GlyphText &text)
+{
+    if (start < 0 || start > region.charCount)
+        return false;
+    if (region.charCount + text.count > getRegionCapacity(region))
+    {
+        LOG_E("错误: 插入后超出区域容量 - 当前: %d字符, 插入: %d字符", region.charCount, text.count);
+        return false;
+    }
+
+    ArenaScope scratch(scratchArena);
+    uint16_t *newIndices = scratchArena.allocateArray<uint16_t>(text.count);
+    if (!newIndices || !internGlyphs(*region.table, text, newIndices))
+    {
+        LOG_E("错误: 字形表%s空间不足，插入未执行", region.table->getName());
+        return false;
+    }
+
+    // 序号缓冲区地址固定，在容量内增长时原有内容保持不变
+    region.indices = (uint16_t *)region.indexBuffer->acquire((region.charCount + text.count) * sizeof(uint16_t));
+    memmove(region.indices + start + text.count, region.indices + start,
+            (region.charCount - start) * sizeof(uint16_t));
+    memcpy(region.indices + start, newIndices, text.count * sizeof(uint16_t));
+    region.charCount += text.count;
+    region.revision++;
+    region.hasText = true;
+    return true;
+}
+
+void deleteRegionGlyphs(RegionText &region, int start, int count)
+{
+    if (start < 0 || start >= region.charCount || count <= 0)
+        return;
+    if (start + count > region.charCount)
+        count = region.charCount - start;
+
+    for (int i = 0; i < count; i++)
+    {
+        region.table->release(region.indices[start + i]);
+    }
+    memmove(region.indices + start, region.indices + start + count,
+            (region.charCount - start - count) * sizeof(uint16_t));
+    region.charCount -= count;
+    region.revision++;
+    region.indexBuffer->acquire(region.charCount * sizeof(uint16_t)); // 同步当前用量，缓冲区地址不变
+}
+
+int getTextRegionCapacity(uint8_t screenArea, uint8_t fontSize)
+{
+    if (fontSize == BT_FONT_32x32)
+        return TEXT_REGION_CHARS_32;
+    return (screenArea == BT_SCREEN_BOTH) ? TEXT_REGION_CHARS_16 * 2 : TEXT_REGION_CHARS_16;
+}
+
+// ==================== 区域文本快照 ====================
+bool saveRegionText(const RegionText &region, StaticArena &arena, RegionSnapshot &snapshot)
+{
+    snapshot.indices = nullptr;
+    snapshot.count = 0;
+    snapshot.hasText = region.hasText;
+    if (region.charCount == 0)
+        return true;
+
+    snapshot.indices = arena.allocateArray<uint16_t>(region.charCount);
+    if (!snapshot.indices)
+        return false;
+
+    // 快照与区域文本各持有一份字形引用，之后改写区域文本时快照中的字形不会被回收
+    memcpy(snapshot.indices, region.indices, region.charCount * sizeof(uint16_t));
+    snapshot.count = region.charCount;
+    for (int i = 0; i < snapshot.count; i++)
+    {
+        region.table->retain(snapshot.indices[i]);
+    }
+    return true;
+}
+
+void restoreRegionText(RegionText &region, RegionSnapshot &snapshot)
+{
+    clearRegionText(region);
+    if (snapshot.count > 0)
+    {
+        region.indices = (uint16_t *)region.indexBuffer->acquire(snapshot.count * sizeof(uint16_t));
+        memcpy(region.indices, snapshot.indices, snapshot.count * sizeof(uint16_t));
+        region.charCount = snapshot.count;
+    }
+    region.hasText = snapshot.hasText;
+    snapshot.indices = nullptr;
+    snapshot.count = 0;
+}
+
+void releaseRegionSnapshot(const RegionText &region, RegionSnapshot &snapshot)
+{
+    for (int i = 0; i < snapshot.count; i++)
+    {
+        region.table->release(snapshot.indices[i]);
+    }
+    snapshot.indices = nullptr;
+    snapshot.count = 0;
+}
+
+// ==================== 用量报告 ====================
+static void logGlyphTableUsage(const GlyphTable &table)
+{
+    uint32_t interned = table.getInternCount();
+    LOG_I("字形表%s - 不同字形: %d/%d, 高水位: %d, 累计写入: %u字符, 复用率: %d%%, 失败: %u",
+          table.getName(), table.getUsedCount(), table.getCapacity(), table.getHighWater(), interned,
+          interned > 0 ? (int)((uint64_t)table.getSharedCount() * 100 / interned) : 0, table.getFailureCount());
+}
+
+void reportTextStoreUsage()
+{
+    logGlyphTableUsage(glyphTable16);
+    logGlyphTableUsage(glyphTable32);
+    LOG_I("区域文本 - 上半屏: %d字符, 下半屏: %d字符, 全屏: %d字符",
+          upperRegionText.charCount, lowerRegionText.charCount, fullRegionText.charCount);
+}
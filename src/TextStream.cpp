@@ -0,0 +1,135 @@
+#include "TextStream.h"
+#include "LEDController.h"
+#include "Log.h"
+
+GlyphStream textStream;
+StreamPlayback streamPlayback = {false, BT_SCREEN_UPPER};
+
+// 大端读取辅助函数
+static uint32_t readBE32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// ==================== 播放 ====================
+bool isRegionStreaming(bool isUpper)
+{
+    if (!streamPlayback.active || !textStream.isReady())
+        return false;
+    if (currentFontSize == BT_FONT_32x32)
+        return isUpper && textStream.getGlyphSize() == FONT_WIDTH_32;
+    if (textStream.getGlyphSize() != FONT_WIDTH_16)
+        return false;
+    return streamPlayback.screenArea == (isUpper ? BT_SCREEN_UPPER : BT_SCREEN_LOWER);
+}
+
+static uint8_t startPlayback(uint8_t screenArea)
+{
+    if (!textStream.isReady())
+        return BT_STREAM_STATUS_EMPTY;
+
+    bool is32 = (currentFontSize == BT_FONT_32x32);
+    if (textStream.getGlyphSize() != (is32 ? FONT_WIDTH_32 : FONT_WIDTH_16))
+    {
+        LOG_E("错误: 流式文本字形尺寸%d与当前字体不符", textStream.getGlyphSize());
+        return BT_STREAM_STATUS_INVALID;
+    }
+    if (!is32 && screenArea != BT_SCREEN_UPPER && screenArea != BT_SCREEN_LOWER)
+        return BT_STREAM_STATUS_INVALID;
+
+    // 流式文本只以滚动方式显示；区域未开启滚动时按左滚动、中速开启，已开启时从头滚动
+    bool isUpper = is32 || screenArea == BT_SCREEN_UPPER;
+    bool scrollActive = isUpper ? effectState.upperScrollActive : effectState.lowerScrollActive;
+    if (!scrollActive)
+        setScrollEffect(isUpper, BT_EFFECT_SCROLL_LEFT, 5);
+    if (isUpper)
+        effectState.upperScrollOffset = 0;
+    else
+        effectState.lowerScrollOffset = 0;
+
+    streamPlayback.active = true;
+    streamPlayback.screenArea = is32 ? BT_SCREEN_BOTH : screenArea;
+    textState.needUpdate = true;
+    LOG_I("开始播放流式文本 - 区域: 0x%02X, 字符数: %u", streamPlayback.screenArea, textStream.getCharCount());
+    return BT_STREAM_STATUS_OK;
+}
+
+static void stopPlayback()
+{
+    if (streamPlayback.active)
+    {
+        LOG_I("停止播放流式文本 - 窗口加载: %u次", textStream.getWindowLoads());
+    }
+    streamPlayback.active = false;
+    textState.needUpdate = true;
+}
+
+// 应答：[操作][状态][参数4字节]，参数为上传的下一期望偏移（BEGIN/DATA/END）或字符数（PLAY/STOP）
+static void sendStreamResponse(uint8_t op, uint8_t status)
+{
+    bool upload = (op == BT_STREAM_BEGIN || op == BT_STREAM_DATA || op == BT_STREAM_END);
+    uint32_t value = upload ? textStream.getUploadOffset() : textStream.getCharCount();
+    uint8_t response[6] = {op, status,
+                           (uint8_t)(value >> 24), (uint8_t)(value >> 16),
+                           (uint8_t)(value >> 8), (uint8_t)(value & 0xFF)};
+    sendResponseFrame(BT_CMD_STREAM_TEXT, response, sizeof(response));
+}
+
+// 处理流式文本命令 (0x13)
+// 数据格式：[操作][参数...]，见蓝牙流式文本帧格式.md
+void handleStreamTextCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 1)
+    {
+        LOG_E("错误: 流式文本数据无效");
+        return;
+    }
+
+    uint8_t op = frame.data[0];
+    uint8_t status = BT_STREAM_STATUS_INVALID;
+    switch (op)
+    {
+    case BT_STREAM_BEGIN:
+        if (frame.dataLength >= 6)
+        {
+            uint8_t fontSize = frame.data[1];
+            uint32_t count = readBE32(frame.data + 2);
+            stopPlayback(); // 上传会覆盖正在播放的内容
+            status = textStream.beginUpload(fontSize == BT_FONT_32x32 ? FONT_WIDTH_32 : FONT_WIDTH_16, count);
+            LOG_I("流式文本开始上传 - 字体: 0x%02X, 字符数: %u, 状态: %d", fontSize, count, status);
+        }
+        break;
+
+    case BT_STREAM_DATA:
+        if (frame.dataLength >= 5) // 不带点阵的数据帧可用于查询期望偏移
+        {
+            status = textStream.writeUpload(readBE32(frame.data + 1), frame.data + 5, frame.dataLength - 5);
+            if (status != BT_STREAM_STATUS_OK)
+            {
+                LOG_W("流式文本写入失败 - 状态: %d, 期望偏移: %u", status, textStream.getUploadOffset());
+            }
+        }
+        break;
+
+    case BT_STREAM_END:
+        status = textStream.endUpload();
+        LOG_I("流式文本上传结束 - 字符数: %u, 状态: %d", textStream.getCharCount(), status);
+        break;
+
+    case BT_STREAM_PLAY:
+        if (frame.dataLength >= 2)
+            status = startPlayback(frame.data[1]);
+        break;
+
+    case BT_STREAM_STOP:
+        stopPlayback();
+        status = BT_STREAM_STATUS_OK;
+        break;
+
+    default:
+        LOG_E("错误: 未知的流式文本操作 0x%02X", op);
+        break;
+    }
+
+    sendStreamResponse(op, status);
+}
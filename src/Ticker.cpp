@@ -0,0 +1,346 @@
+#include "Ticker.h"
+#include "LEDController.h"
+#include "TextStream.h"
+#include "MemoryPool.h"
+#include "Log.h"
+
+TickerQueue upperTicker = {};
+TickerQueue lowerTicker = {};
+
+static TickerQueue &getQueue(bool isUpper)
+{
+    return isUpper ? upperTicker : lowerTicker;
+}
+
+static RegionText &getRegion(const TickerQueue &queue, bool isUpper)
+{
+    if (queue.is32)
+        return fullRegionText;
+    return isUpper ? upperRegionText : lowerRegionText;
+}
+
+static const char *getAreaName(const TickerQueue &queue, bool isUpper)
+{
+    return queue.is32 ? "全屏" : (isUpper ? "上半屏" : "下半屏");
+}
+
+static GlyphText getSeparatorText(const TickerQueue &queue, const RegionText &region)
+{
+    return GlyphText(region.table->getGlyphData(), queue.separator, queue.separatorCount,
+                     region.table->getWordsPerGlyph());
+}
+
+// 区域文本与队列记录一致（没有被其他文本命令改写）
+static bool isQueueIntact(const TickerQueue &queue, const RegionText &region)
+{
+    int expected = 0;
+    for (int i = 0; i < queue.count; i++)
+    {
+        expected += queue.lengths[i] + queue.separatorCount;
+    }
+    return expected == region.charCount;
+}
+
+bool isTickerRunning(bool isUpper)
+{
+    const TickerQueue &queue = getQueue(isUpper);
+    if (!queue.active || queue.is32 != (currentFontSize == BT_FONT_32x32) || isRegionStreaming(isUpper))
+        return false;
+
+    bool scrollActive = isUpper ? effectState.upperScrollActive : effectState.lowerScrollActive;
+    uint8_t scrollType = isUpper ? effectState.upperScrollType : effectState.lowerScrollType;
+    if (!scrollActive || scrollType != BT_EFFECT_SCROLL_LEFT)
+        return false;
+    return isQueueIntact(queue, getRegion(queue, isUpper));
+}
+
+GlyphText getTickerText(bool isUpper)
+{
+    const TickerQueue &queue = getQueue(isUpper);
+    return getRegionGlyphs(getRegion(queue, isUpper));
+}
+
+// 释放分隔符持有的字形引用并结束队列
+static void releaseTicker(TickerQueue &queue, bool isUpper)
+{
+    if (!queue.active)
+        return;
+
+    RegionText &region = getRegion(queue, isUpper);
+    for (int i = 0; i < queue.separatorCount; i++)
+    {
+        region.table->release(queue.separator[i]);
+    }
+    LOG_I("滚动队列结束 - 区域: %s, 追加: %u, 移出: %u, 补位: %u",
+          getAreaName(queue, isUpper), queue.appended, queue.evicted, queue.repeated);
+    queue.active = false;
+    queue.count = 0;
+    queue.separatorCount = 0;
+}
+
+// 在带尾追加一条消息及其分隔符；失败时区域文本保持不变
+static bool appendMessage(TickerQueue &queue, RegionText &region, const GlyphText &message)
+{
+    if (queue.count >= TICKER_MAX_MESSAGES)
+        return false;
+
+    int start = region.charCount;
+    if (!insertRegionGlyphs(region, start, message))
+        return false;
+    if (queue.separatorCount > 0 && !insertRegionGlyphs(region, region.charCount, getSeparatorText(queue, region)))
+    {
+        deleteRegionGlyphs(region, start, message.count);
+        return false;
+    }
+    queue.lengths[queue.count++] = message.count;
+    return true;
+}
+
+int advanceTicker(bool isUpper, int offset)
+{
+    TickerQueue &queue = getQueue(isUpper);
+    RegionText &region = getRegion(queue, isUpper);
+    if (queue.count == 0)
+        return 0; // 空队列停在右侧，下一条消息从屏幕右边缘进入
+
+    int spacing = queue.is32 ? CHAR_SPACING_32 : CHAR_SPACING_16;
+
+    // 补位：带尾（起点SCREEN_WIDTH - offset加上带宽）已进入屏幕，从队首起依次复制消息接在带尾。
+    // 插入位置在所有源字符之后，源序号在插入过程中不会移动
+    int source = 0;
+    int sourceStart = 0;
+    while (region.charCount * spacing <= offset)
+    {
+        GlyphText message = getRegionGlyphs(region).slice(sourceStart, queue.lengths[source]);
+        if (!appendMessage(queue, region, message))
+        {
+            if (!queue.fillFailed)
+            {
+                LOG_W("滚动队列补位失败（队列或区域已满） - 区域: %s, 消息数: %d",
+                      getAreaName(queue, isUpper), queue.count);
+                queue.fillFailed = true;
+            }
+            break;
+        }
+        queue.repeated++;
+        sourceStart += queue.lengths[source] + queue.separatorCount;
+        source++;
+    }
+
+    // 移出：队首完全滚出左边且后面还有消息时删除，偏移减去其宽度，屏上内容位置不变
+    while (queue.count > 1)
+    {
+        int headChars = queue.lengths[0] + queue.separatorCount;
+        int headWidth = headChars * spacing;
+        if (offset < SCREEN_WIDTH + headWidth)
+            break;
+
+        deleteRegionGlyphs(region, 0, headChars);
+        memmove(queue.lengths, queue.lengths + 1, (queue.count - 1) * sizeof(queue.lengths[0]));
+        queue.count--;
+        queue.evicted++;
+        offset -= headWidth;
+    }
+
+    // 补位失败且仅剩的一条也已滚出时，按普通滚动从右侧重新进入
+    if (queue.count == 1 && offset >= SCREEN_WIDTH + region.charCount * spacing)
+        offset = 0;
+    return offset;
+}
+
+// 开始：清空区域文本与队列，写入分隔符并以左滚动开启
+static uint8_t startTicker(bool isUpper, uint8_t speed, const uint16_t *separator, int separatorCount)
+{
+    TickerQueue &queue = getQueue(isUpper);
+    releaseTicker(queue, isUpper);
+
+    bool is32 = (currentFontSize == BT_FONT_32x32);
+    int wordsPerGlyph = is32 ? 64 : 16;
+    queue = {};
+    queue.is32 = is32;
+    RegionText &region = getRegion(queue, isUpper);
+    clearRegionText(region);
+
+    GlyphText glyphs(separator, separatorCount, wordsPerGlyph);
+    for (int i = 0; i < separatorCount; i++)
+    {
+        int index = region.table->intern(glyphs.at(i));
+        if (index < 0)
+        {
+            for (int j = 0; j < i; j++)
+            {
+                region.table->release(queue.separator[j]);
+            }
+            LOG_E("错误: 字形表%s空间不足，滚动队列分隔符未写入", region.table->getName());
+            return BT_TICKER_STATUS_FULL;
+        }
+        queue.separator[i] = index;
+    }
+    queue.separatorCount = separatorCount;
+    queue.active = true;
+
+    // 流式文本优先于区域文本显示，开始队列时停止该区域的流式播放
+    if (isRegionStreaming(isUpper))
+        streamPlayback.active = false;
+
+    clearAllEffects(isUpper);
+    setScrollEffect(isUpper, BT_EFFECT_SCROLL_LEFT, speed);
+    textState.needUpdate = true;
+    LOG_I("滚动队列开始 - 区域: %s, 速度: %d, 分隔符: %d字符", getAreaName(queue, isUpper), speed, separatorCount);
+    return BT_TICKER_STATUS_OK;
+}
+
+// 应答：[操作][状态][消息数][带长字符数2][累计追加4][累计移出4][累计补位4]
+static void sendTickerResponse(uint8_t op, uint8_t status, const TickerQueue &queue, int charCount)
+{
+    uint8_t response[17];
+    response[0] = op;
+    response[1] = status;
+    response[2] = queue.count;
+    response[3] = (uint8_t)(charCount >> 8);
+    response[4] = (uint8_t)(charCount & 0xFF);
+    const uint32_t counters[3] = {queue.appended, queue.evicted, queue.repeated};
+    for (int i = 0; i < 3; i++)
+    {
+        uint8_t *p = response + 5 + i * 4;
+        p[0] = (uint8_t)(counters[i] >> 24);
+        p[1] = (uint8_t)(counters[i] >> 16);
+        p[2] = (uint8_t)(counters[i] >> 8);
+        p[3] = (uint8_t)(counters[i] & 0xFF);
+    }
+    sendResponseFrame(BT_CMD_TICKER, response, sizeof(response));
+}
+
+// 点阵数据（大端）转为字形数组，长度须为整字符；返回字符数，无效时返回-1
+static int readGlyphPayload(const uint8_t *bytes, int length, uint16_t *&glyphs)
+{
+    int glyphBytes = (currentFontSize == BT_FONT_32x32) ? FONT_BYTES_32 : FONT_BYTES_16;
+    if (length % glyphBytes != 0)
+        return -1;
+
+    glyphs = nullptr;
+    if (length == 0)
+        return 0;
+    glyphs = scratchArena.allocateArray<uint16_t>(length / 2);
+    if (!glyphs)
+        return -1;
+    for (int i = 0; i < length / 2; i++)
+    {
+        glyphs[i] = ((uint16_t)bytes[i * 2] << 8) | bytes[i * 2 + 1];
+    }
+    return length / glyphBytes;
+}
+
+// 处理滚动队列命令 (0x18)
+// 数据格式：[操作][屏幕区域][参数...]，32x32字体时区域固定为全屏，见蓝牙滚动队列帧格式.md
+void handleTickerCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 2)
+    {
+        LOG_E("错误: 滚动队列数据无效");
+        return;
+    }
+
+    uint8_t op = frame.data[0];
+    uint8_t screenArea = frame.data[1];
+    bool is32 = (currentFontSize == BT_FONT_32x32);
+    bool isUpper = is32 || screenArea == BT_SCREEN_UPPER;
+    TickerQueue &queue = getQueue(isUpper);
+    RegionText *region = &getRegion(queue, isUpper);
+    if (!is32 && screenArea != BT_SCREEN_UPPER && screenArea != BT_SCREEN_LOWER)
+    {
+        LOG_E("错误: 滚动队列不支持的屏幕区域 0x%02X", screenArea);
+        sendTickerResponse(op, BT_TICKER_STATUS_INVALID, queue, 0);
+        return;
+    }
+
+    // 区域文本被其他命令改写或字体已切换，队列记录不再可信
+    if (queue.active && (queue.is32 != is32 || !isQueueIntact(queue, *region)))
+    {
+        LOG_W("滚动队列已失效（区域文本被改写或字体切换） - 区域: %s", getAreaName(queue, isUpper));
+        releaseTicker(queue, isUpper);
+    }
+
+    uint8_t status = BT_TICKER_STATUS_INVALID;
+    switch (op)
+    {
+    case BT_TICKER_START:
+    {
+        if (frame.dataLength < 4)
+            break;
+        uint8_t speed = frame.data[2];
+        uint16_t *separator = nullptr;
+        int separatorCount = readGlyphPayload(frame.data + 4, frame.dataLength - 4, separator);
+        if (speed > 10 || separatorCount < 0 || separatorCount != frame.data[3] || separatorCount > TICKER_MAX_SEPARATOR)
+        {
+            LOG_E("错误: 滚动队列参数无效 - 速度: %d, 分隔符: %d字符", speed, frame.data[3]);
+            break;
+        }
+        status = startTicker(isUpper, speed, separator, separatorCount);
+        region = &getRegion(queue, isUpper);
+        break;
+    }
+
+    case BT_TICKER_APPEND:
+    {
+        uint16_t *glyphs = nullptr;
+        int count = readGlyphPayload(frame.data + 2, frame.dataLength - 2, glyphs);
+        if (count <= 0)
+        {
+            LOG_E("错误: 滚动队列消息点阵长度无效 - %d字节", frame.dataLength - 2);
+            break;
+        }
+        if (!queue.active)
+        {
+            status = BT_TICKER_STATUS_INACTIVE;
+            break;
+        }
+        if (!appendMessage(queue, *region, GlyphText(glyphs, count, is32 ? 64 : 16)))
+        {
+            LOG_W("滚动队列已满 - 区域: %s, 消息数: %d, 区域字符数: %d",
+                  getAreaName(queue, isUpper), queue.count, region->charCount);
+            status = BT_TICKER_STATUS_FULL;
+            break;
+        }
+        queue.appended++;
+        queue.fillFailed = false;
+        textState.needUpdate = true;
+        LOG_D("滚动队列追加消息 - 区域: %s, 字符数: %d, 消息数: %d", getAreaName(queue, isUpper), count, queue.count);
+        status = BT_TICKER_STATUS_OK;
+        break;
+    }
+
+    case BT_TICKER_CLEAR:
+        if (!queue.active)
+        {
+            status = BT_TICKER_STATUS_INACTIVE;
+            break;
+        }
+        clearRegionText(*region);
+        queue.count = 0;
+        queue.fillFailed = false;
+        if (isUpper)
+            effectState.upperScrollOffset = 0;
+        else
+            effectState.lowerScrollOffset = 0;
+        textState.needUpdate = true;
+        status = BT_TICKER_STATUS_OK;
+        break;
+
+    case BT_TICKER_STOP:
+        releaseTicker(queue, isUpper);
+        textState.needUpdate = true;
+        status = BT_TICKER_STATUS_OK;
+        break;
+
+    case BT_TICKER_STATUS:
+        status = queue.active ? BT_TICKER_STATUS_OK : BT_TICKER_STATUS_INACTIVE;
+        break;
+
+    default:
+        LOG_E("错误: 未知的滚动队列操作 0x%02X", op);
+        break;
+    }
+
+    sendTickerResponse(op, status, queue, queue.active ? region->charCount : 0);
+}
@@ -0,0 +1,130 @@
+#include "Transport.h"
+#include "config.h"
+
+#ifdef ARDUINO
+// ==================== 设备实现 ====================
+bool SppTransport::begin()
+{
+    return serial.begin(deviceName);
+}
+
+bool UartTransport::begin()
+{
+    // 接收缓冲区须在begin之前设置；其大小即该通道的流量控制窗口
+    serial.setRxBufferSize(UART_RX_BUFFER_SIZE);
+    serial.begin(baudRate, SERIAL_8N1, rxPin, txPin);
+    return true;
+}
+#else
+// ==================== 主机实现：TCP回环 ====================
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+TcpLoopbackTransport::TcpLoopbackTransport(uint16_t port)
+    : port(port), listenFd(-1), clientFd(-1), readPos(0), readLength(0) {}
+
+TcpLoopbackTransport::~TcpLoopbackTransport()
+{
+    closeClient();
+    if (listenFd >= 0)
+        close(listenFd);
+}
+
+void TcpLoopbackTransport::closeClient()
+{
+    if (clientFd >= 0)
+    {
+        close(clientFd);
+        clientFd = -1;
+    }
+    readPos = readLength = 0;
+}
+
+bool TcpLoopbackTransport::begin()
+{
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0)
+        return false;
+
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listenFd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenFd, 1) < 0)
+    {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    fcntl(listenFd, F_SETFL, O_NONBLOCK);
+    return true;
+}
+
+// 非阻塞：没有客户端时尝试接受连接，缓冲区读空时再收一批
+int TcpLoopbackTransport::available()
+{
+    if (listenFd < 0)
+        return 0;
+
+    if (clientFd < 0)
+    {
+        clientFd = accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0)
+            return 0;
+        fcntl(clientFd, F_SETFL, O_NONBLOCK);
+        int noDelay = 1;
+        setsockopt(clientFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+
+    if (readPos >= readLength)
+    {
+        ssize_t n = recv(clientFd, readBuffer, sizeof(readBuffer), 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+        {
+            closeClient(); // 客户端断开，等待下一个连接
+            return 0;
+        }
+        readPos = 0;
+        readLength = n > 0 ? (size_t)n : 0;
+    }
+    return (int)(readLength - readPos);
+}
+
+int TcpLoopbackTransport::read()
+{
+    if (readPos >= readLength && available() <= 0)
+        return -1;
+    return readBuffer[readPos++];
+}
+
+size_t TcpLoopbackTransport::write(const uint8_t *data, size_t length)
+{
+    size_t sent = 0;
+    while (clientFd >= 0 && sent < length)
+    {
+        ssize_t n = send(clientFd, data + sent, length - sent, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            sent += n;
+        }
+        else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            usleep(100);
+        }
+        else
+        {
+            closeClient();
+        }
+    }
+    return sent;
+}
+#endif
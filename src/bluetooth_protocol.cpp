@@ -1,24 +1,25 @@
 #include "bluetooth_protocol.h"
+#include "CommandRegistry.h"
+#include "MemoryPool.h"
+#include "Log.h"
 
-BluetoothProtocolParser::BluetoothProtocolParser()
+BluetoothProtocolParser::BluetoothProtocolParser(uint8_t *frameBuffer)
+    : frameBuffer(frameBuffer)
 {
-    dataBuffer = new uint8_t[MAX_DATA_LENGTH];
-    errorCount = 0;
-    timeoutCheckCounter = 0;
+    memset(stateErrorCount, 0, sizeof(stateErrorCount));
+    replayPos = 0;
+    replayEnd = 0;
     reset();
 }
 
-BluetoothProtocolParser::~BluetoothProtocolParser()
-{
-    delete[] dataBuffer;
-}
-
+// 重置为等待帧头；不影响待重放数据
 void BluetoothProtocolParser::reset()
 {
     currentState = ParseState::WAITING_HEADER1;
     command = 0;
     dataLength = 0;
     dataReceived = 0;
+    rawLength = 0;
     timeoutCheckCounter = 0;
     frameStartTime = millis();
 }
@@ -28,25 +29,122 @@ bool BluetoothProtocolParser::isFrameComplete() const
     return currentState == ParseState::FRAME_COMPLETE;
 }
 
+bool BluetoothProtocolParser::isIdle() const
+{
+    return (currentState == ParseState::WAITING_HEADER1 || currentState == ParseState::FRAME_COMPLETE) &&
+           !hasPendingData();
+}
+
+uint32_t BluetoothProtocolParser::getErrorCount() const
+{
+    uint32_t total = 0;
+    for (int i = 0; i < STATE_COUNT; i++)
+    {
+        total += stateErrorCount[i];
+    }
+    return total;
+}
+
+void BluetoothProtocolParser::recordError()
+{
+    stateErrorCount[(int)currentState]++;
+}
+
+// 出错重同步：当前帧的帧头已被否定，从帧头后一字节起查找下一个0xAA，
+// 把从该处起的已收字节（含尚未重放完的字节）安排为待重放数据。
+// 已保存字节位于 [0, rawLength)，未重放字节位于 [replayPos, replayEnd)，且 rawLength <= replayPos，
+// 把前者的有效部分移到后者之前即可拼成连续的待重放区，无需额外缓冲区。
+void BluetoothProtocolParser::resync()
+{
+    uint16_t start = 1;
+    while (start < rawLength && frameBuffer[start] != BT_FRAME_HEADER_1)
+    {
+        start++;
+    }
+
+    uint16_t keep = rawLength - start;
+    if (!hasPendingData())
+    {
+        replayPos = rawLength;
+        replayEnd = rawLength;
+    }
+    if (keep > 0)
+    {
+        memmove(frameBuffer + replayPos - keep, frameBuffer + start, keep);
+        replayPos -= keep;
+    }
+
+    reset();
+}
+
 ParseResult BluetoothProtocolParser::parseByte(uint8_t byte, BluetoothFrame &frame)
 {
     // 优化：每100字节检查一次超时，减少millis()调用开销
     if (++timeoutCheckCounter >= 100)
     {
         timeoutCheckCounter = 0;
-        if (isFrameTimeout())
+        if (abandonIfTimedOut())
         {
-            errorCount++;
-            reset();
+            // 把当前字节排在待重放数据末尾
+            if (!hasPendingData())
+            {
+                replayPos = 0;
+                replayEnd = 0;
+            }
+            frameBuffer[replayEnd++] = byte;
             return ParseResult::FRAME_ERROR;
         }
     }
 
+    return consumeByte(byte, frame);
+}
+
+// 卡住的帧里可能夹着完整的新帧，放弃时按出错重同步。发送端中途停发时不会再有字节触发
+// parseByte中的检查，调用方可在没有新字节时直接调用
+bool BluetoothProtocolParser::abandonIfTimedOut()
+{
+    if (!isFrameTimeout())
+        return false;
+
+    recordError();
+    resync();
+    return true;
+}
+
+ParseResult BluetoothProtocolParser::parsePending(BluetoothFrame &frame)
+{
+    if (!hasPendingData())
+        return ParseResult::NEED_MORE_DATA;
+
+    uint8_t byte = frameBuffer[replayPos++];
+    if (!hasPendingData())
+    {
+        replayPos = 0;
+        replayEnd = 0;
+    }
+    return consumeByte(byte, frame);
+}
+
+ParseResult BluetoothProtocolParser::consumeByte(uint8_t byte, BluetoothFrame &frame)
+{
+    if (currentState == ParseState::FRAME_COMPLETE)
+    {
+        reset();
+    }
+
+    // 帧头之后的每个字节都保存下来，出错时用于重同步
+    if (currentState != ParseState::WAITING_HEADER1)
+    {
+        frameBuffer[rawLength++] = byte;
+    }
+
     switch (currentState)
     {
     case ParseState::WAITING_HEADER1:
         if (byte == BT_FRAME_HEADER_1)
         {
+            frameBuffer[0] = byte;
+            rawLength = 1;
             currentState = ParseState::WAITING_HEADER2;
             frameStartTime = millis();
         }
@@ -59,22 +157,22 @@ ParseResult BluetoothProtocolParser::parseByte(uint8_t byte, BluetoothFrame &fra
         }
         else
         {
-            errorCount++;
-            reset();
+            recordError();
+            resync();
             return ParseResult::FRAME_ERROR;
         }
         break;
 
     case ParseState::WAITING_COMMAND:
-        if (byte >= BT_CMD_SET_DIRECTION && byte <= BT_CMD_SET_EFFECT)
+        if (findCommandSpec(byte) != nullptr)
         {
             command = byte;
             currentState = ParseState::WAITING_LENGTH_HIGH;
         }
         else
         {
-            errorCount++;
-            reset();
+            recordError();
+            resync();
             return ParseResult::INVALID_COMMAND;
         }
         break;
@@ -90,11 +188,19 @@ ParseResult BluetoothProtocolParser::parseByte(uint8_t byte, BluetoothFrame &fra
 
         if (dataLength > MAX_DATA_LENGTH)
         {
-            errorCount++;
-            reset();
+            recordError();
+            resync();
             return ParseResult::DATA_TOO_LONG;
         }
 
+        // 不在该命令允许的长度范围内时立即判定出错，损坏的长度字节不会吞掉后续帧
+        if (!isCommandLengthValid(findCommandSpec(command), dataLength))
+        {
+            recordError();
+            resync();
+            return ParseResult::INVALID_LENGTH;
+        }
+
         if (dataLength == 0)
         {
             currentState = ParseState::WAITING_TAIL1;
@@ -106,7 +212,7 @@ ParseResult BluetoothProtocolParser::parseByte(uint8_t byte, BluetoothFrame &fra
         break;
 
     case ParseState::WAITING_DATA:
-        dataBuffer[dataReceived++] = byte;
+        dataReceived++;
 
         if (dataReceived >= dataLength)
         {
@@ -121,8 +227,8 @@ ParseResult BluetoothProtocolParser::parseByte(uint8_t byte, BluetoothFrame &fra
         }
         else
         {
-            errorCount++;
-            reset();
+            recordError();
+            resync();
             return ParseResult::FRAME_ERROR;
         }
         break;
@@ -130,9 +236,13 @@ ParseResult BluetoothProtocolParser::parseByte(uint8_t byte, BluetoothFrame &fra
     case ParseState::WAITING_TAIL2:
         if (byte == BT_FRAME_TAIL_2)
         {
+            // 帧对象可能被复用，丢弃上一帧的字体转换结果（其内存已随上一条命令回收）
+            frame.convertedData = nullptr;
+            frame.isConverted = false;
+
             frame.command = command;
             frame.dataLength = dataLength;
-            frame.data = dataBuffer;
+            frame.data = frameBuffer + 5;
             frame.isValid = true;
             frame.timestamp = millis();
 
@@ -141,15 +251,14 @@ ParseResult BluetoothProtocolParser::parseByte(uint8_t byte, BluetoothFrame &fra
         }
         else
         {
-            errorCount++;
-            reset();
+            recordError();
+            resync();
             return ParseResult::FRAME_ERROR;
         }
         break;
 
     case ParseState::FRAME_COMPLETE:
-        reset();
-        return parseByte(byte, frame);
+        break;
     }
 
     return ParseResult::NEED_MORE_DATA;
@@ -159,10 +268,11 @@ ParseResult BluetoothProtocolParser::parseByte(uint8_t byte, BluetoothFrame &fra
 bool BluetoothProtocolParser::isFrameTimeout() const
 {
     return (currentState != ParseState::WAITING_HEADER1) &&
+           (currentState != ParseState::FRAME_COMPLETE) &&
            (millis() - frameStartTime > FRAME_TIMEOUT_MS);
 }
 
-// 批量解析缓冲区数据
+// 批量解析缓冲区数据（每个字节之后先处理重同步产生的待重放字节）
 ParseResult BluetoothProtocolParser::parseBuffer(uint8_t *buffer, size_t length,
                                                  BluetoothFrame frames[], size_t maxFrames, size_t &frameCount)
 {
@@ -172,20 +282,33 @@ ParseResult BluetoothProtocolParser::parseBuffer(uint8_t *buffer, size_t length,
     for (size_t i = 0; i < length && frameCount < maxFrames; i++)
     {
         lastResult = parseByte(buffer[i], frames[frameCount]);
-        if (lastResult == ParseResult::FRAME_COMPLETE)
+        while (true)
         {
-            frameCount++;
-            reset(); // 准备解析下一帧
+            if (lastResult == ParseResult::FRAME_COMPLETE)
+            {
+                frameCount++;
+                reset(); // 准备解析下一帧
+            }
+            if (!hasPendingData() || frameCount >= maxFrames)
+                break;
+            lastResult = parsePending(frames[frameCount]);
         }
     }
 
     return lastResult;
 }
 
+#ifdef ARDUINO
 // 获取状态字符串
 String BluetoothProtocolParser::getStateString() const
 {
-    switch (currentState)
+    return getStateName(currentState);
+}
+#endif
+
+const char *BluetoothProtocolParser::getStateName(ParseState state)
+{
+    switch (state)
     {
     case ParseState::WAITING_HEADER1:
         return "WAITING_HEADER1";
@@ -213,21 +336,57 @@ String BluetoothProtocolParser::getStateString() const
 // 打印调试信息
 void BluetoothProtocolParser::printDebugInfo() const
 {
-    Serial.printf("Parser State: %s\n", getStateString().c_str());
-    Serial.printf("Command: 0x%02X\n", command);
-    Serial.printf("Data Length: %d\n", dataLength);
-    Serial.printf("Data Received: %d\n", dataReceived);
-    Serial.printf("Error Count: %d\n", errorCount);
-    Serial.printf("Frame Start Time: %d\n", frameStartTime);
+    LOG_D("Parser State: %s", getStateName(currentState));
+    LOG_D("Command: 0x%02X", command);
+    LOG_D("Data Length: %d", dataLength);
+    LOG_D("Data Received: %d", dataReceived);
+    LOG_D("Pending Replay: %d", replayEnd - replayPos);
+    LOG_D("Error Count: %d", getErrorCount());
+    for (int i = 0; i < STATE_COUNT; i++)
+    {
+        if (stateErrorCount[i] > 0)
+        {
+            LOG_D("  %s: %d", getStateName((ParseState)i), stateErrorCount[i]);
+        }
+    }
+    LOG_D("Frame Start Time: %d", frameStartTime);
+}
+
+// ==================== 应答帧发送 ====================
+static ResponseWriter responseWriter = nullptr; // 应答输出通道（由main.cpp设置）
+
+void setResponseWriter(ResponseWriter writer)
+{
+    responseWriter = writer;
+}
+
+// 发送应答帧：帧头、命令、长度、数据、帧尾分段写出，避免额外拷贝
+void sendResponseFrame(uint8_t command, const uint8_t *data, uint16_t length)
+{
+    if (!responseWriter)
+        return;
+
+    uint8_t header[5] = {BT_FRAME_HEADER_1, BT_FRAME_HEADER_2, (uint8_t)(command | BT_RESPONSE_FLAG),
+                         (uint8_t)(length >> 8), (uint8_t)(length & 0xFF)};
+    static const uint8_t tail[2] = {BT_FRAME_TAIL_1, BT_FRAME_TAIL_2};
+
+    responseWriter(header, sizeof(header));
+    if (data && length > 0)
+    {
+        responseWriter(data, length);
+    }
+    responseWriter(tail, sizeof(tail));
 }
 
 // BluetoothFrame 方法实现
+#ifdef ARDUINO
 String BluetoothFrame::getTextData() const
 {
     if (!isValid || data == nullptr || dataLength == 0)
         return "";
     return String((char *)data, dataLength);
 }
+#endif
 
 void BluetoothFrame::getColorData(uint8_t &screenArea, uint8_t &target, uint8_t &mode, uint8_t &r, uint8_t &g, uint8_t &b, uint8_t &gradientMode) const
 {
@@ -266,7 +425,7 @@ void BluetoothFrame::getEffectData(uint8_t &screenArea, uint8_t &type, uint8_t &
 
 bool BluetoothFrame::isValidCommand() const
 {
-    return isValid && (command >= BT_CMD_SET_DIRECTION && command <= BT_CMD_SET_EFFECT);
+    return isValid && findCommandSpec(command) != nullptr;
 }
 
 // 转换8位数据为16位字体数据 (高性能版本)
@@ -285,7 +444,9 @@ const uint16_t *BluetoothFrame::getFontData16x16(uint8_t &screenArea, int &charC
     // 如果还没转换，进行转换
     if (!isConverted && fontDataLength > 0)
     {
-        convertedData = new uint16_t[fontDataLength / 2]; // 16位数据数量是8位的一半
+        convertedData = scratchArena.allocateArray<uint16_t>(fontDataLength / 2); // 16位数据数量是8位的一半
+        if (!convertedData)
+            return nullptr;
 
         // 高性能转换：按字节顺序组合 0x12,0x34 -> 0x1234
         for (int i = 0; i < fontDataLength && i + 1 < fontDataLength; i += 2)
@@ -314,7 +475,9 @@ const uint16_t *BluetoothFrame::getFontData32x32(uint8_t &screenArea, int &charC
     // 如果还没转换，进行转换
     if (!isConverted && fontDataLength > 0)
     {
-        convertedData = new uint16_t[fontDataLength / 2]; // 16位数据数量是8位的一半
+        convertedData = scratchArena.allocateArray<uint16_t>(fontDataLength / 2); // 16位数据数量是8位的一半
+        if (!convertedData)
+            return nullptr;
 
         // 高性能转换：按字节顺序组合 0x12,0x34 -> 0x1234
         for (int i = 0; i < fontDataLength && i + 1 < fontDataLength; i += 2)
@@ -0,0 +1,77 @@
+// ==================== 主机回环入口（env:host） ====================
+// 在PC上以全速驱动真实的解析器与命令分发：TcpLoopbackTransport监听127.0.0.1:HOST_LOOPBACK_PORT，
+// 收到的字节经CommandChannel解析后交给processBluetoothCommand，应答写回TCP连接，日志输出到标准输出。
+// 命令表与固件相同（CommandTable.h），长度范围、批量标记与能力查询的结果一致；
+// 依赖显示与Flash任务的处理函数不在主机上编译，这些命令解析、校验后只记录日志。
+// 运行：pio run -e host && .pio/build/host/program
+#ifndef ARDUINO
+#include <stdio.h>
+#include <unistd.h>
+#include "Transport.h"
+#include "CommandChannel.h"
+#include "CommandRegistry.h"
+#include "CommandTable.h"
+#include "MemoryPool.h"
+#include "Log.h"
+
+static void handleHostUnavailableCommand(const BluetoothFrame &frame)
+{
+    LOG_I("主机构建不执行该命令 - 命令: 0x%02X, 数据长度: %d", frame.command, frame.dataLength);
+}
+
+// 流量控制状态属于命令的来源通道
+static void handleChannelFlowControlCommand(const BluetoothFrame &frame)
+{
+    if (getActiveChannel())
+    {
+        handleFlowControlCommand(frame, getActiveChannel()->getFlowControl());
+    }
+}
+
+// 主机上可用的处理函数：查询类命令与流量控制
+static CommandHandler getHostHandler(uint8_t command)
+{
+    switch (command)
+    {
+    case BT_CMD_CAPABILITIES:
+        return handleCapabilityCommand;
+    case BT_CMD_MEMORY_STATS:
+        return handleMemoryStatsCommand;
+    case BT_CMD_FLOW_CONTROL:
+        return handleChannelFlowControlCommand;
+    default:
+        return handleHostUnavailableCommand;
+    }
+}
+
+#define HOST_ROW(command, name, handler, minLength, maxLength, feature, batchable) \
+    {command, name, getHostHandler(command), minLength, maxLength, feature, batchable},
+static const CommandSpec hostCommandTable[] = {COMMAND_TABLE(HOST_ROW)};
+#undef HOST_ROW
+
+int main()
+{
+    setvbuf(stdout, nullptr, _IOLBF, 0); // 日志重定向到文件时也逐行输出
+    memoryPoolsBegin();
+    logBegin();
+    registerCommandTable(hostCommandTable, sizeof(hostCommandTable) / sizeof(hostCommandTable[0]));
+
+    // TCP自带流量控制，窗口与有线串口相同即可
+    TcpLoopbackTransport loopbackTransport(HOST_LOOPBACK_PORT);
+    CommandChannel loopbackChannel(loopbackTransport, UART_RX_BUFFER_SIZE);
+    if (!loopbackChannel.begin())
+    {
+        LOG_E("错误: TCP回环端口%d监听失败", HOST_LOOPBACK_PORT);
+        logDrain();
+        return 1;
+    }
+    LOG_I("TCP回环通道已启动 - 127.0.0.1:%d", HOST_LOOPBACK_PORT);
+
+    for (;;)
+    {
+        loopbackChannel.poll();
+        logDrain();
+        usleep(1000); // 没有数据时让出CPU
+    }
+}
+#endif
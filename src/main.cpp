@@ -5,10 +5,33 @@
 #include "LEDController.h"
 #include "config.h"
 #include "FontData.h"
+#include "GlyphCache.h"
+#include "TextStream.h"
+#include "FontPack.h"
+#include "ChunkedTransfer.h"
+#include "CommandBatch.h"
+#include "FlowControl.h"
+#include "Transport.h"
+#include "CommandChannel.h"
+#include "CommandRegistry.h"
+#include "CommandTable.h"
+#include "SceneSync.h"
+#include "SceneStore.h"
+#include "Playlist.h"
+#include "Ticker.h"
+#include "TextField.h"
+#include "Priority.h"
+#include "Paging.h"
+#include "BootTimeline.h"
+#include "Animation.h"
+#include "ImageMode.h"
+#include "LiveStream.h"
+#include "MemoryPool.h"
+#include "Log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 String device_name = "ESP32-BT-Slave";
-BluetoothProtocolParser btParser; // 蓝牙协议解析器
-BluetoothFrame currentFrame;      // 当前解析的帧
 
 // Check if Bluetooth is available
 #if !defined(CONFIG_BT_ENABLED) || !defined(CONFIG_BLUEDROID_ENABLED)
@@ -22,151 +45,245 @@ BluetoothFrame currentFrame;      // 当前解析的帧
 
 BluetoothSerial SerialBT;
 
+// 命令输入通道：蓝牙SPP与有线串口，各自独立解析，共用同一命令分发
+SppTransport sppTransport(SerialBT, device_name);
+UartTransport uartTransport(Serial2, UART_BAUD_RATE, UART_RX_PIN, UART_TX_PIN);
+CommandChannel sppChannel(sppTransport, FLOW_WINDOW_BYTES);
+CommandChannel uartChannel(uartTransport, UART_RX_BUFFER_SIZE);
+
 // 函数声明
-void handleParseResult(ParseResult result);
-void processBluetoothCommand(const BluetoothFrame &frame);
 void handleTextCommand(const BluetoothFrame &frame);
-void handleUpperTextCommand(const uint16_t *fontData, int charCount); // 独立处理上半屏
-void handleLowerTextCommand(const uint16_t *fontData, int charCount); // 独立处理下半屏
+void handleUtf8TextCommand(const BluetoothFrame &frame);
+void handleTextRangeCommand(const BluetoothFrame &frame);
 void handleColorCommand(const BluetoothFrame &frame);
 
 const char *getEffectName(uint8_t type);
 
-void setup()
+// ==================== 命令注册表 ====================
+static void handleSetDirectionCommand(const BluetoothFrame &)
 {
-    Serial.begin(115200);
+    handleDirectionCommand(BT_DIRECTION_HORIZONTAL);
+    LOG_I("设置文本显示方向: 正向显示");
+}
 
-    // 初始化显示硬件
-    if (!initializeDisplay())
+static void handleSetVerticalCommand(const BluetoothFrame &)
+{
+    handleDirectionCommand(BT_DIRECTION_VERTICAL);
+    LOG_I("设置文本显示方向: 竖向显示");
+}
+
+static void handleSetFont16Command(const BluetoothFrame &)
+{
+    currentFontSize = BT_FONT_16x16;
+    LOG_I("设置字体: 16x16");
+}
+
+static void handleSetFont32Command(const BluetoothFrame &)
+{
+    currentFontSize = BT_FONT_32x32;
+    LOG_I("设置字体: 32x32");
+}
+
+// 流量控制状态属于命令的来源通道
+static void handleChannelFlowControlCommand(const BluetoothFrame &frame)
+{
+    if (getActiveChannel())
     {
-        Serial.println("显示硬件初始化失败！");
-        return;
+        handleFlowControlCommand(frame, getActiveChannel()->getFlowControl());
     }
+}
 
-    Serial.println("=== ESP32 LED屏控制器 ===");
-    Serial.println("硬件初始化完成");
+// 命令表见CommandTable.h，与主机测试共用
+#define COMMAND_ROW(command, name, handler, minLength, maxLength, feature, batchable) \
+    {command, name, handler, minLength, maxLength, feature, batchable},
+static const CommandSpec commandTable[] = {COMMAND_TABLE(COMMAND_ROW)};
+#undef COMMAND_ROW
 
-    // 启动蓝牙串口
-    SerialBT.begin(device_name);
-    Serial.printf("蓝牙设备已启动，设备名: %s\n", device_name.c_str());
-    Serial.println("可以配对连接了");
+// 依赖运行时资源的特性仅在资源可用时通告
+static uint32_t filterAvailableFeatures(uint32_t features)
+{
+    if (!fontPack.isLoaded())
+    {
+        features &= ~(uint32_t)BT_FEATURE_FONT_PACK;
+    }
+    if (!textStream.isAvailable())
+    {
+        features &= ~(uint32_t)BT_FEATURE_STREAM_TEXT;
+    }
+    if (!playlist.isAvailable())
+    {
+        features &= ~(uint32_t)BT_FEATURE_PLAYLIST;
+    }
+    return features;
+}
 
-    // 根据字体大小设置初始点阵数据（使用FontData中的示例数据）
-    if (currentFontSize == BT_FONT_32x32)
+#if BT_DEFERRED_INIT
+// 蓝牙协议栈启动耗时较长，放到后台任务中进行，主循环在此期间照常渲染与接收有线串口
+static volatile bool bluetoothReady = false;
+
+static void bluetoothInitTask(void *parameter)
+{
+    (void)parameter;
+    if (sppChannel.begin())
     {
-        handleFullScreenTextCommand(full_text, getFullTextCharCount());
+        bluetoothReady = true;
+        bootMark(BOOT_PHASE_BLUETOOTH);
+        LOG_I("蓝牙设备已启动，设备名: %s", device_name.c_str());
+        LOG_I("可以配对连接了");
     }
     else
     {
-        handleTextCommand(upper_text, getUpperTextCharCount(), lower_text, getLowerTextCharCount());
+        LOG_E("错误: 蓝牙启动失败");
     }
+    vTaskDelete(nullptr);
 }
+#endif
 
-void loop()
+void setup()
 {
-    // 处理蓝牙数据接收
-    while (SerialBT.available())
+    bootMark(BOOT_PHASE_SETUP);
+    logBegin(); // 发送缓冲区须在Serial.begin之前设置
+    Serial.begin(115200);
+
+    // 初始化显示硬件
+    if (!initializeDisplay())
     {
-        uint8_t receivedByte = SerialBT.read();
-        ParseResult result = btParser.parseByte(receivedByte, currentFrame);
+        LOG_E("显示硬件初始化失败！");
+        logFlush();
+        return;
+    }
+    bootMark(BOOT_PHASE_DISPLAY);
 
-        if (result != ParseResult::NEED_MORE_DATA)
-        {
-            handleParseResult(result);
-        }
+    // 大块内存池在显示驱动的DMA缓冲区之后、其余子系统之前从堆取得存储
+    if (!memoryPoolsBegin())
+    {
+        LOG_W("部分内存池不可用，相关功能将拒绝请求");
     }
 
-    updateAllEffects();  // 更新所有特效
-    updateBrightness();  // 更新亮度设置
-    updateColors();      // 更新颜色状态
-    updateTextDisplay(); // 更新文本显示
-}
+    // 打开流式文本分区（只读文件头，恢复的场景可能正在播放流式文本）
+    bool streamReady = textStream.begin();
+    bootMark(BOOT_PHASE_STREAM);
 
-// 处理解析结果
-void handleParseResult(ParseResult result)
-{
-    switch (result)
-    {
-    case ParseResult::FRAME_COMPLETE:
-        Serial.printf("收到完整帧 - 命令: 0x%02X, 数据长度: %d\n",
-                      currentFrame.command, currentFrame.dataLength);
-        processBluetoothCommand(currentFrame);
-        btParser.reset(); // 重置解析器准备下一帧
-        break;
+    // 恢复上次保存的场景并立即推送预渲染首帧，早于蓝牙等其余初始化；
+    // 播放列表上次处于轮播状态时直接从第一项开始，不再恢复快照
+    bool sceneReady = sceneStore.begin();
+    bool playlistResumed = playlist.begin() && playlist.resume();
+    bool sceneRestored = playlistResumed || (sceneReady && sceneStore.restore());
+    bootMark(BOOT_PHASE_SCENE);
 
-    case ParseResult::FRAME_ERROR:
-        Serial.println("错误: 帧格式错误");
-        break;
+    if (!sceneRestored)
+    {
+        // 没有场景快照时显示FontData中的示例数据：区域文本为空时渲染直接读取Flash中的内置点阵，
+        // 不再复制进字形表，字形表与区域缓冲区全部留给上传的文本
+        freeDynamicTextData();
+        textState.upperIndex = 0;
+        textState.lowerIndex = 0;
+        textState.lastSwitchTime = millis();
+        textState.lowerSwitchTime = textState.lastSwitchTime;
+        textState.needUpdate = true;
+    }
 
-    case ParseResult::INVALID_COMMAND:
-        Serial.println("错误: 无效命令");
-        break;
+    // 先把内容画出来，其余子系统随后再初始化
+    updateTextDisplay();
+    bootMark(BOOT_PHASE_FIRST_FRAME);
 
-    case ParseResult::DATA_TOO_LONG:
-        Serial.println("错误: 数据过长");
-        break;
+    LOG_I("=== ESP32 LED屏控制器 ===");
+    LOG_I("硬件初始化完成");
 
-    case ParseResult::NEED_MORE_DATA:
-        // 继续等待更多数据，无需处理
-        break;
+    // 注册命令表（须在启动输入通道之前）
+    registerCommandTable(commandTable, sizeof(commandTable) / sizeof(commandTable[0]));
+    setFeatureFilter(filterAvailableFeatures);
 
-    default:
-        Serial.printf("未知解析结果: %d\n", (int)result);
-        break;
+    // 启动蓝牙串口
+#if BT_DEFERRED_INIT
+    if (xTaskCreatePinnedToCore(bluetoothInitTask, "bt_init", BT_INIT_TASK_STACK, nullptr, 1, nullptr,
+                                BT_INIT_TASK_CORE) != pdPASS)
+    {
+        LOG_E("错误: 蓝牙启动任务创建失败");
     }
-}
+#else
+    sppChannel.begin();
+    bootMark(BOOT_PHASE_BLUETOOTH);
+    LOG_I("蓝牙设备已启动，设备名: %s", device_name.c_str());
+    LOG_I("可以配对连接了");
+#endif
 
-// 处理蓝牙命令
-void processBluetoothCommand(const BluetoothFrame &frame)
-{
-    if (!frame.isValidCommand())
+    // 启动有线串口（安装人员批量下载内容）
+    uartChannel.begin();
+    bootMark(BOOT_PHASE_UART);
+    LOG_I("有线串口已启动，波特率: %d (RX=%d, TX=%d)", UART_BAUD_RATE, UART_RX_PIN, UART_TX_PIN);
+
+    // 加载设备端字库（fontpack分区，分区为空时使用内置字库）
+    if (fontPack.begin())
     {
-        Serial.println("错误: 无效的命令帧");
-        return;
+        LOG_I("设备端字库已加载(%s) - 16x16: %u字, 32x32: %u字", fontPack.isBuiltin() ? "内置" : "分区",
+              fontPack.getGlyphCount(BT_FONT_16x16), fontPack.getGlyphCount(BT_FONT_32x32));
     }
-
-    switch (frame.command)
+    else
     {
-    case BT_CMD_SET_DIRECTION: // 0x00
-        handleDirectionCommand(BT_DIRECTION_HORIZONTAL);
-        Serial.println("设置文本显示方向: 正向显示");
-        break;
-
-    case BT_CMD_SET_VERTICAL: // 0x01
-        handleDirectionCommand(BT_DIRECTION_VERTICAL);
-        Serial.println("设置文本显示方向: 竖向显示");
-        break;
-
-    case BT_CMD_SET_FONT_16x16: // 0x02
-        currentFontSize = BT_FONT_16x16;
-        Serial.println("设置字体: 16x16");
-        break;
-
-    case BT_CMD_SET_FONT_32x32: // 0x03
-        currentFontSize = BT_FONT_32x32;
-        Serial.println("设置字体: 32x32");
-        break;
+        LOG_W("未找到设备端字库，UTF-8文本命令不可用");
+    }
+    bootMark(BOOT_PHASE_FONT_PACK);
 
-    case BT_CMD_SET_TEXT: // 0x04
-        handleTextCommand(frame);
-        break;
+    // 流式文本分区（超长跑马灯，播放时按窗口从Flash读取）
+    if (streamReady)
+    {
+        LOG_I("流式文本分区已就绪 - 已存文本: %u字符", textStream.getCharCount());
+    }
+    else if (!textStream.isAvailable())
+    {
+        LOG_W("未找到流式文本分区，流式文本命令不可用");
+    }
 
-    case BT_CMD_SET_COLOR: // 0x06
-        handleColorCommand(frame);
-        break;
+    if (sceneRestored)
+    {
+        LOG_I("已恢复上次的场景 - 上半屏: %d字符, 下半屏: %d字符, 全屏: %d字符",
+              upperRegionText.charCount, lowerRegionText.charCount, fullRegionText.charCount);
+    }
+    else
+    {
+        if (!sceneStore.isAvailable())
+        {
+            LOG_W("未找到场景分区，场景不会在重启后保留");
+        }
+        LOG_I("内置示例数据 - 上半屏: %d字符, 下半屏: %d字符, 全屏: %d字符",
+              getUpperTextCharCount(), getLowerTextCharCount(), getFullTextCharCount());
+    }
+    sceneStore.resetBaseline(); // 启动时的场景不必再写回Flash
 
-    case BT_CMD_SET_BRIGHTNESS: // 0x07
-        handleBrightnessCommand(frame);
-        break;
+    bootMark(BOOT_PHASE_SETUP_DONE);
+    reportBootTimeline(); // 后台启动的蓝牙在完成时另行记录，可用启动时间线命令查询
+    reportMemoryUsage();
+    logFlush(); // 启动阶段日志直接输出完毕
+}
 
-    case BT_CMD_SET_EFFECT: // 0x08
-        handleEffectCommand(frame);
-        break;
+void loop()
+{
+    // 处理各通道数据接收
+#if BT_DEFERRED_INIT
+    if (bluetoothReady)
+        sppChannel.poll();
+#else
+    sppChannel.poll();
+#endif
+    uartChannel.poll();
 
-    default:
-        Serial.printf("未支持的命令: 0x%02X\n", frame.command);
-        break;
+    updateAllEffects();  // 更新所有特效
+    updateBrightness();  // 更新亮度设置
+    updateColors();      // 更新颜色状态
+    updatePriority();    // 插播到时后恢复原场景
+    updateTransfer();    // 放弃闲置超时的分块传输
+    if (!isPriorityActive())
+    {
+        updateAnimation();  // 更新动画帧（播放时占据整屏）
+        updateLiveStream(); // 呈现实时流的最新帧
+        playlist.poll();    // 播放列表到时切换场景
     }
+    updateTextDisplay(); // 更新文本显示
+    if (!playlist.isRunning() && !isPriorityActive())
+        sceneStore.poll(); // 场景稳定后保存快照（轮播时场景由播放列表决定，插播内容也不保存）
+
+    logDrain(); // 空闲时输出日志，串口发送缓冲区不足时留到下一轮
 }
 
 // 处理文本命令 (0x04)
@@ -181,12 +298,13 @@ void handleTextCommand(const BluetoothFrame &frame)
 
         if (fontData && charCount > 0)
         {
-            Serial.printf("处理32x32文本命令 - 屏幕区域: 0x%02X, 字符数: %d\n", screenArea, charCount);
-            handleFullScreenTextCommand(fontData, charCount);
+            LOG_I("处理32x32文本命令 - 屏幕区域: 0x%02X, 字符数: %d", screenArea, charCount);
+            handleFullScreenTextCommand(GlyphText(fontData, charCount, FONT_BYTES_32 / 2));
         }
         else
         {
-            Serial.println("错误: 32x32字体数据无效");
+            LOG_E("错误: 32x32字体数据无效");
+            markBatchFailed();
         }
     }
     else
@@ -198,66 +316,202 @@ void handleTextCommand(const BluetoothFrame &frame)
 
         if (fontData && charCount > 0)
         {
-            Serial.printf("处理16x16文本命令 - 屏幕区域: 0x%02X, 字符数: %d\n", screenArea, charCount);
-
-            switch (screenArea)
-            {
-            case BT_SCREEN_UPPER: // 上半屏
-                handleUpperTextCommand(fontData, charCount);
-                break;
-            case BT_SCREEN_LOWER: // 下半屏
-                handleLowerTextCommand(fontData, charCount);
-                break;
-            case BT_SCREEN_BOTH: // 全屏 (分为上下两部分)
-            {
-                int halfCount = charCount / 2;
-                const uint16_t *upperData = fontData;
-                const uint16_t *lowerData = fontData + (halfCount * 16); // 每个字符16个uint16_t
-                handleTextCommand(upperData, halfCount, lowerData, charCount - halfCount);
-            }
-            break;
-            default:
-                Serial.printf("错误: 无效的屏幕区域 0x%02X\n", screenArea);
-                break;
-            }
+            LOG_I("处理16x16文本命令 - 屏幕区域: 0x%02X, 字符数: %d", screenArea, charCount);
+            applyTextGlyphs(screenArea, GlyphText(fontData, charCount, FONT_BYTES_16 / 2));
         }
         else
         {
-            Serial.println("错误: 16x16字体数据无效");
+            LOG_E("错误: 16x16字体数据无效");
+            markBatchFailed();
         }
     }
 }
 
-// 独立处理上半屏文本（保持下半屏不变）
-void handleUpperTextCommand(const uint16_t *fontData, int charCount)
+// 按屏幕区域应用点阵数据（文本命令、UTF-8文本命令与按ID文本命令共用）
+void applyTextGlyphs(uint8_t screenArea, const GlyphText &text)
 {
-    if (!fontData || charCount <= 0)
+    if (currentFontSize == BT_FONT_32x32)
+    {
+        handleFullScreenTextCommand(text);
         return;
+    }
 
-    Serial.printf("设置上半屏文本 - 字符数: %d\n", charCount);
+    switch (screenArea)
+    {
+    case BT_SCREEN_UPPER: // 上半屏
+        handleUpperTextCommand(text);
+        break;
+    case BT_SCREEN_LOWER: // 下半屏
+        handleLowerTextCommand(text);
+        break;
+    case BT_SCREEN_BOTH: // 全屏 (分为上下两部分)
+    {
+        int halfCount = text.count / 2;
+        handleTextCommand(text.slice(0, halfCount), text.slice(halfCount, text.count - halfCount));
+    }
+    break;
+    default:
+        LOG_E("错误: 无效的屏幕区域 0x%02X", screenArea);
+        markBatchFailed();
+        break;
+    }
+}
 
-    // 只释放上半屏数据
-    if (dynamic_upper_text)
+// 处理UTF-8文本命令 (0x0B)
+// 数据格式：[屏幕区域][UTF-8文本...]，设备按码位在字库中查找字形并排版
+// 应答：[状态][缺失字数高][缺失字数低]，字库中不存在的字符以空白显示
+void handleUtf8TextCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < 2)
+    {
+        LOG_E("错误: UTF-8文本数据无效");
+        markBatchFailed();
+        return;
+    }
+    if (!fontPack.isLoaded())
     {
-        free(dynamic_upper_text);
-        dynamic_upper_text = nullptr;
+        LOG_E("错误: 设备端字库未加载");
+        markBatchFailed();
+        return;
     }
 
-    // 分配并复制上半屏数据
-    int upperDataSize = charCount * 16 * sizeof(uint16_t); // 16x16字体每字符16个uint16_t
-    dynamic_upper_text = (uint16_t *)malloc(upperDataSize);
-    if (dynamic_upper_text)
+    uint8_t screenArea = frame.data[0];
+    int maxChars = frame.dataLength - 1; // 每个码位至少占1字节
+    if (maxChars > getTextRegionCapacity(screenArea))
+        maxChars = getTextRegionCapacity(screenArea); // 超出区域容量的字符不会显示，无需解码
+    bool is32x32 = (currentFontSize == BT_FONT_32x32);
+    int wordsPerGlyph = is32x32 ? FONT_BYTES_32 / 2 : FONT_BYTES_16 / 2;
+
+    // 同一码位只读取一次字形，不同字形数不会超过字形表容量
+    int maxUnique = is32x32 ? glyphTable32.getCapacity() : glyphTable16.getCapacity();
+    if (maxUnique > maxChars)
+        maxUnique = maxChars;
+
+    // 临时缓冲来自临时分配区，命令处理结束后由分发函数统一回收
+    uint32_t *codepoints = scratchArena.allocateArray<uint32_t>(maxChars);
+    uint16_t *indices = scratchArena.allocateArray<uint16_t>(maxChars);
+    uint32_t *uniqueCodepoints = scratchArena.allocateArray<uint32_t>(maxUnique);
+    uint16_t *uniqueGlyphs = scratchArena.allocateArray<uint16_t>(maxUnique * wordsPerGlyph);
+    bool *uniqueMissing = scratchArena.allocateArray<bool>(maxUnique);
+    if (!codepoints || !indices || !uniqueCodepoints || !uniqueGlyphs || !uniqueMissing)
     {
-        memcpy(dynamic_upper_text, fontData, upperDataSize);
-        dynamic_upper_char_count = charCount;
-        Serial.printf("上半屏数据已更新: %d字符, %d字节\n", charCount, upperDataSize);
+        LOG_E("错误: UTF-8文本内存分配失败");
+        markBatchFailed();
+        return;
     }
-    else
+
+    int codepointCount = decodeUtf8(frame.data + 1, frame.dataLength - 1, codepoints, maxChars);
+    int charCount = 0;
+    int uniqueCount = 0;
+    int missingCount = 0;
+    for (int i = 0; i < codepointCount; i++)
+    {
+        if (codepoints[i] < 0x20)
+            continue; // 跳过控制字符
+
+        int slot = 0;
+        while (slot < uniqueCount && uniqueCodepoints[slot] != codepoints[i])
+        {
+            slot++;
+        }
+        if (slot == uniqueCount)
+        {
+            if (uniqueCount >= maxUnique)
+            {
+                LOG_W("UTF-8文本不同字符超过字形表容量%d，已截断", maxUnique);
+                markBatchFailed();
+                break;
+            }
+            uint16_t *glyph = uniqueGlyphs + slot * wordsPerGlyph;
+            uniqueMissing[slot] = !fontPack.readGlyph(currentFontSize, codepoints[i], glyph);
+            if (uniqueMissing[slot])
+                memset(glyph, 0, wordsPerGlyph * sizeof(uint16_t));
+            uniqueCodepoints[slot] = codepoints[i];
+            uniqueCount++;
+        }
+        if (uniqueMissing[slot])
+            missingCount++;
+        indices[charCount++] = slot;
+    }
+
+    LOG_I("UTF-8文本 - 屏幕区域: 0x%02X, 字符数: %d, 不同字符: %d, 缺字: %d",
+          screenArea, charCount, uniqueCount, missingCount);
+    if (charCount > 0)
+    {
+        applyTextGlyphs(screenArea, GlyphText(uniqueGlyphs, indices, charCount, wordsPerGlyph));
+    }
+
+    uint8_t response[3] = {(uint8_t)(missingCount > 0 ? BT_UTF8_STATUS_MISSING : BT_UTF8_STATUS_OK),
+                           (uint8_t)(missingCount >> 8), (uint8_t)(missingCount & 0xFF)};
+    sendResponseFrame(BT_CMD_SET_TEXT_UTF8, response, sizeof(response));
+}
+
+// 处理局部文本更新命令 (0x0D)
+// 数据格式：[屏幕区域][操作][起始位置2字节][数量2字节][点阵数据...]
+// 替换/插入时数量须等于点阵数据中的字符数，删除时不带点阵数据
+void handleTextRangeCommand(const BluetoothFrame &frame)
+{
+    if (!frame.isValid || frame.data == nullptr || frame.dataLength < BT_RANGE_HEADER_LEN)
     {
-        Serial.println("错误: 上半屏数据内存分配失败");
-        dynamic_upper_char_count = 0;
+        LOG_E("错误: 局部文本更新数据无效");
+        markBatchFailed();
+        return;
+    }
+
+    uint8_t screenArea = frame.data[0];
+    uint8_t op = frame.data[1];
+    int start = ((int)frame.data[2] << 8) | frame.data[3];
+    int count = ((int)frame.data[4] << 8) | frame.data[5];
+    int glyphBytes = (currentFontSize == BT_FONT_32x32) ? FONT_BYTES_32 : FONT_BYTES_16;
+    int payloadLength = frame.dataLength - BT_RANGE_HEADER_LEN;
+
+    GlyphText text;
+    if (op != BT_RANGE_DELETE)
+    {
+        if (payloadLength != count * glyphBytes)
+        {
+            LOG_E("错误: 局部更新点阵长度不符 - 数量: %d, 数据: %d字节", count, payloadLength);
+            markBatchFailed();
+            return;
+        }
+
+        uint16_t *glyphs = scratchArena.allocateArray<uint16_t>(payloadLength / 2);
+        if (!glyphs)
+        {
+            LOG_E("错误: 局部更新内存分配失败");
+            markBatchFailed();
+            return;
+        }
+        const uint8_t *bytes = frame.data + BT_RANGE_HEADER_LEN;
+        for (int i = 0; i < payloadLength / 2; i++)
+        {
+            glyphs[i] = ((uint16_t)bytes[i * 2] << 8) | bytes[i * 2 + 1];
+        }
+        text = GlyphText(glyphs, count, glyphBytes / 2);
     }
 
+    const char *opName = (op == BT_RANGE_REPLACE) ? "替换" : (op == BT_RANGE_INSERT) ? "插入"
+                                                         : (op == BT_RANGE_DELETE)   ? "删除"
+                                                                                     : "未知";
+    LOG_I("局部文本更新 - 区域: 0x%02X, 操作: %s, 起始: %d, 数量: %d", screenArea, opName, start, count);
+    if (!applyTextRangeUpdate(screenArea, op, start, count, text))
+        markBatchFailed();
+}
+
+// 独立处理上半屏文本（保持下半屏不变）
+void handleUpperTextCommand(const GlyphText &text)
+{
+    if (text.count <= 0)
+        return;
+
+    LOG_I("设置上半屏文本 - 字符数: %d", text.count);
+
+    // 只覆盖上半屏文本（字形写入共用的16x16字形表）
+    int stored = setRegionText(upperRegionText, text);
+    LOG_I("上半屏数据已更新: %d字符", stored);
+    if (stored < text.count)
+        markBatchFailed(); // 截断时批量命令整体回滚
+
     // 更新显示状态（只重置上半屏索引）
     textState.upperIndex = 0;
     textState.lastSwitchTime = millis();
@@ -265,37 +519,21 @@ void handleUpperTextCommand(const uint16_t *fontData, int charCount)
 }
 
 // 独立处理下半屏文本（保持上半屏不变）
-void handleLowerTextCommand(const uint16_t *fontData, int charCount)
+void handleLowerTextCommand(const GlyphText &text)
 {
-    if (!fontData || charCount <= 0)
+    if (text.count <= 0)
         return;
 
-    Serial.printf("设置下半屏文本 - 字符数: %d\n", charCount);
+    LOG_I("设置下半屏文本 - 字符数: %d", text.count);
 
-    // 只释放下半屏数据
-    if (dynamic_lower_text)
-    {
-        free(dynamic_lower_text);
-        dynamic_lower_text = nullptr;
-    }
-
-    // 分配并复制下半屏数据
-    int lowerDataSize = charCount * 16 * sizeof(uint16_t); // 16x16字体每字符16个uint16_t
-    dynamic_lower_text = (uint16_t *)malloc(lowerDataSize);
-    if (dynamic_lower_text)
-    {
-        memcpy(dynamic_lower_text, fontData, lowerDataSize);
-        dynamic_lower_char_count = charCount;
-        Serial.printf("下半屏数据已更新: %d字符, %d字节\n", charCount, lowerDataSize);
-    }
-    else
-    {
-        Serial.println("错误: 下半屏数据内存分配失败");
-        dynamic_lower_char_count = 0;
-    }
+    // 只覆盖下半屏文本（字形写入共用的16x16字形表）
+    int stored = setRegionText(lowerRegionText, text);
+    LOG_I("下半屏数据已更新: %d字符", stored);
+    if (stored < text.count)
+        markBatchFailed(); // 截断时批量命令整体回滚
 
     // 更新显示状态（只重置下半屏索引）
     textState.lowerIndex = 0;
-    textState.lastSwitchTime = millis();
+    textState.lowerSwitchTime = millis();
     textState.needUpdate = true;
 }
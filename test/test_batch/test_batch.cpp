@@ -0,0 +1,351 @@
+// 批量命令校验测试：子命令拆分、按推演字体检查点阵长度、区域容量、
+// 按ID文本的字形来源与缓存容量、字形定义记录完整性，以及应用期间固定在缓存中的ID
+// 在项目根目录运行：pio test -e native
+#include <unity.h>
+#include <string.h>
+#include "BatchValidation.h"
+#include "CommandRegistry.h"
+#include "CommandTable.h"
+#include "MemoryPool.h"
+
+// 与固件共用命令表（CommandTable.h），处理函数不会被调用
+#define TEST_ROW(command, name, handler, minLength, maxLength, feature, batchable) \
+    {command, name, nullptr, minLength, maxLength, feature, batchable},
+static const CommandSpec testTable[] = {COMMAND_TABLE(TEST_ROW)};
+#undef TEST_ROW
+
+static uint8_t batch[40960];
+static int batchLength;
+static BatchRecord records[BT_BATCH_MAX_COMMANDS];
+static BatchContext context;
+
+// 缓存中已有的字形：16x16的ID 100-109
+static bool isTestGlyphCached(uint8_t fontSize, uint16_t id)
+{
+    return fontSize == BT_FONT_16x16 && id >= 100 && id < 110;
+}
+
+// 追加一条子命令，返回清零的数据区供填写
+static uint8_t *addRecord(uint8_t command, int length)
+{
+    uint8_t *record = batch + batchLength;
+    record[0] = command;
+    record[1] = length >> 8;
+    record[2] = length & 0xFF;
+    memset(record + BT_BATCH_RECORD_HEADER_LEN, 0, length);
+    batchLength += BT_BATCH_RECORD_HEADER_LEN + length;
+    return record + BT_BATCH_RECORD_HEADER_LEN;
+}
+
+static void addTextById(uint8_t screenArea, const uint16_t *ids, int count)
+{
+    uint8_t *data = addRecord(BT_CMD_SET_TEXT_BY_ID, 1 + count * 2);
+    data[0] = screenArea;
+    for (int i = 0; i < count; i++)
+    {
+        data[1 + i * 2] = ids[i] >> 8;
+        data[2 + i * 2] = ids[i] & 0xFF;
+    }
+}
+
+static void addGlyphDefine(uint8_t fontSize, const uint16_t *ids, int count)
+{
+    int recordLength = 1 + BT_GLYPH_ID_LEN + ((fontSize == BT_FONT_32x32) ? FONT_BYTES_32 : FONT_BYTES_16);
+    uint8_t *data = addRecord(BT_CMD_DEFINE_GLYPH, count * recordLength);
+    for (int i = 0; i < count; i++)
+    {
+        data[i * recordLength] = fontSize;
+        data[i * recordLength + 1] = ids[i] >> 8;
+        data[i * recordLength + 2] = ids[i] & 0xFF;
+    }
+}
+
+static int parse(int &failedIndex)
+{
+    failedIndex = -1;
+    return parseBatch(batch, batchLength, context, records, failedIndex);
+}
+
+void setUp(void)
+{
+    registerCommandTable(testTable, sizeof(testTable) / sizeof(testTable[0]));
+    batchLength = 0;
+    context.fontSize = BT_FONT_16x16;
+    context.fontPackLoaded = true;
+    context.cacheCapacity[0] = 16;
+    context.cacheCapacity[1] = 4;
+    context.tableCapacity[0] = 8;
+    context.tableCapacity[1] = 4;
+    context.isGlyphCached = isTestGlyphCached;
+}
+
+void tearDown(void) {}
+
+void test_valid_scene()
+{
+    uint8_t *text = addRecord(BT_CMD_SET_TEXT, 1 + 2 * FONT_BYTES_16);
+    text[0] = BT_SCREEN_UPPER;
+    uint8_t *color = addRecord(BT_CMD_SET_COLOR, BT_COLOR_DATA_LEN);
+    color[0] = BT_SCREEN_UPPER;
+    color[1] = BT_COLOR_TARGET_TEXT;
+    addRecord(BT_CMD_SET_BRIGHTNESS, 1)[0] = 0x80;
+
+    int failed;
+    TEST_ASSERT_EQUAL_INT(3, parse(failed));
+    TEST_ASSERT_EQUAL_HEX8(BT_CMD_SET_COLOR, records[1].command);
+    TEST_ASSERT_EQUAL_INT(BT_COLOR_DATA_LEN, records[1].length);
+}
+
+void test_truncated_record()
+{
+    addRecord(BT_CMD_SET_BRIGHTNESS, 1);
+    addRecord(BT_CMD_SET_BRIGHTNESS, 1);
+    batchLength -= 1; // 第二条的数据不完整
+
+    int failed;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(1, failed);
+
+    batchLength -= 2; // 只剩半个子命令头
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(1, failed);
+}
+
+void test_rejects_unbatchable_and_bad_length()
+{
+    addRecord(BT_CMD_SET_BRIGHTNESS, 1);
+    addRecord(BT_CMD_BATCH, 4); // 批量不可嵌套
+
+    int failed;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(1, failed);
+
+    batchLength = 0;
+    addRecord(BT_CMD_SET_BRIGHTNESS, 2); // 长度不在注册范围内
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(0, failed);
+}
+
+void test_font_switch_changes_glyph_size()
+{
+    // 切换到32x32后，一个16x16字形的数据量不足一个字
+    addRecord(BT_CMD_SET_FONT_32x32, 0);
+    addRecord(BT_CMD_SET_TEXT, 1 + FONT_BYTES_16)[0] = BT_SCREEN_BOTH;
+
+    int failed;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(1, failed);
+
+    batchLength = 0;
+    addRecord(BT_CMD_SET_FONT_32x32, 0);
+    addRecord(BT_CMD_SET_TEXT, 1 + FONT_BYTES_32)[0] = BT_SCREEN_BOTH;
+    addRecord(BT_CMD_SET_FONT_16x16, 0);
+    addRecord(BT_CMD_SET_TEXT, 1 + FONT_BYTES_16)[0] = BT_SCREEN_LOWER;
+    TEST_ASSERT_EQUAL_INT(4, parse(failed));
+    TEST_ASSERT_EQUAL_UINT8(BT_FONT_32x32, records[1].fontSize);
+    TEST_ASSERT_EQUAL_UINT8(BT_FONT_16x16, records[3].fontSize);
+}
+
+void test_text_over_region_capacity()
+{
+    // 32x32全屏最多TEXT_REGION_CHARS_32个字，超出时不截断而是拒绝
+    context.fontSize = BT_FONT_32x32;
+    addRecord(BT_CMD_SET_TEXT, 1 + TEXT_REGION_CHARS_32 * FONT_BYTES_32)[0] = BT_SCREEN_BOTH;
+    int failed;
+    TEST_ASSERT_EQUAL_INT(1, parse(failed));
+
+    batchLength = 0;
+    addRecord(BT_CMD_SET_TEXT, 1 + (TEXT_REGION_CHARS_32 + 1) * FONT_BYTES_32)[0] = BT_SCREEN_BOTH;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(0, failed);
+}
+
+void test_invalid_screen_area()
+{
+    addRecord(BT_CMD_SET_TEXT, 1 + FONT_BYTES_16)[0] = 0x07;
+    int failed;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(0, failed);
+}
+
+void test_text_by_id_sources()
+{
+    const uint16_t cached[] = {100, 101, 100};
+    const uint16_t defined[] = {500};
+    const uint16_t mixed[] = {100, 500};
+
+    // 已缓存、由更早的字形定义提供：通过
+    addTextById(BT_SCREEN_UPPER, cached, 3);
+    addGlyphDefine(BT_FONT_16x16, defined, 1);
+    addTextById(BT_SCREEN_LOWER, mixed, 2);
+    int failed;
+    TEST_ASSERT_EQUAL_INT(3, parse(failed));
+
+    // 在引用之后才定义：拒绝
+    batchLength = 0;
+    addTextById(BT_SCREEN_LOWER, mixed, 2);
+    addGlyphDefine(BT_FONT_16x16, defined, 1);
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(0, failed);
+
+    // 定义的是另一种字体的字形：拒绝
+    batchLength = 0;
+    addGlyphDefine(BT_FONT_32x32, defined, 1);
+    addTextById(BT_SCREEN_LOWER, mixed, 2);
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(1, failed);
+}
+
+void test_text_by_id_odd_length()
+{
+    uint8_t *data = addRecord(BT_CMD_SET_TEXT_BY_ID, 4); // 区域加一个ID后多出一个字节
+    data[0] = BT_SCREEN_UPPER;
+    data[2] = 100;
+
+    int failed;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(0, failed);
+}
+
+void test_cache_capacity_across_batch()
+{
+    // 缓存只有4个槽位：引用的2个已缓存字形加上新定义的3个字形无法同时放入
+    context.cacheCapacity[0] = 4;
+    const uint16_t referenced[] = {100, 101};
+    const uint16_t definedFits[] = {200, 201};
+    const uint16_t definedOver[] = {202};
+
+    addTextById(BT_SCREEN_UPPER, referenced, 2);
+    addGlyphDefine(BT_FONT_16x16, definedFits, 2);
+    int failed;
+    TEST_ASSERT_EQUAL_INT(2, parse(failed));
+
+    addGlyphDefine(BT_FONT_16x16, definedOver, 1);
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(2, failed);
+
+    // 重复定义同一ID不占用额外槽位
+    batchLength = 0;
+    addTextById(BT_SCREEN_UPPER, referenced, 2);
+    addGlyphDefine(BT_FONT_16x16, definedFits, 2);
+    addGlyphDefine(BT_FONT_16x16, definedFits, 2);
+    TEST_ASSERT_EQUAL_INT(3, parse(failed));
+}
+
+void test_glyph_define_incomplete()
+{
+    const uint16_t ids[] = {1, 2};
+    addGlyphDefine(BT_FONT_16x16, ids, 2);
+    batch[2] -= 1; // 第二个字形少一个字节
+    batchLength -= 1;
+
+    int failed;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(0, failed);
+
+    batchLength = 0;
+    addGlyphDefine(0x05, ids, 1); // 字体大小无效
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+}
+
+void test_utf8_text()
+{
+    const char text[] = "abcab";
+    uint8_t *data = addRecord(BT_CMD_SET_TEXT_UTF8, 1 + 5);
+    data[0] = BT_SCREEN_UPPER;
+    memcpy(data + 1, text, 5);
+
+    int failed;
+    context.tableCapacity[0] = 3;
+    TEST_ASSERT_EQUAL_INT(1, parse(failed));
+
+    context.tableCapacity[0] = 2; // 3个不同字符放不进字形表
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+
+    context.tableCapacity[0] = 8;
+    context.fontPackLoaded = false;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+}
+
+void test_text_range_payload()
+{
+    uint8_t *data = addRecord(BT_CMD_TEXT_RANGE, BT_RANGE_HEADER_LEN + FONT_BYTES_16);
+    data[0] = BT_SCREEN_UPPER;
+    data[1] = BT_RANGE_REPLACE;
+    data[5] = 2; // 声明2个字符，只带1个字形
+    int failed;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+
+    data[5] = 1;
+    TEST_ASSERT_EQUAL_INT(1, parse(failed));
+
+    data[0] = BT_SCREEN_BOTH; // 16x16局部更新只支持单个半屏
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+}
+
+void test_priority_pop_only_last()
+{
+    addRecord(BT_CMD_PRIORITY, 1)[0] = BT_PRIORITY_POP;
+    addRecord(BT_CMD_SET_BRIGHTNESS, 1);
+    int failed;
+    TEST_ASSERT_EQUAL_INT(-1, parse(failed));
+    TEST_ASSERT_EQUAL_INT(0, failed);
+
+    batchLength = 0;
+    uint8_t *push = addRecord(BT_CMD_PRIORITY, 4);
+    push[0] = BT_PRIORITY_PUSH;
+    push[1] = 5;
+    addRecord(BT_CMD_SET_BRIGHTNESS, 1);
+    addRecord(BT_CMD_PRIORITY, 1)[0] = BT_PRIORITY_CLEAR;
+    TEST_ASSERT_EQUAL_INT(3, parse(failed));
+}
+
+void test_collect_pinned_ids()
+{
+    const uint16_t upper[] = {105, 100, 105};
+    const uint16_t lower[] = {300, 100};
+    addTextById(BT_SCREEN_UPPER, upper, 3);
+    addRecord(BT_CMD_SET_FONT_32x32, 0);
+    addTextById(BT_SCREEN_BOTH, lower, 2); // 32x32字形，不计入16x16
+
+    int failed;
+    context.isGlyphCached = nullptr;
+    int count = parse(failed);
+    TEST_ASSERT_EQUAL_INT(-1, count); // 均未缓存也未定义
+
+    context.isGlyphCached = [](uint8_t, uint16_t) { return true; };
+    count = parse(failed);
+    TEST_ASSERT_EQUAL_INT(3, count);
+
+    uint16_t ids[4];
+    TEST_ASSERT_EQUAL_INT(2, collectPinnedGlyphIds(records, count, BT_FONT_16x16, ids, 4));
+    TEST_ASSERT_EQUAL_UINT16(100, ids[0]);
+    TEST_ASSERT_EQUAL_UINT16(105, ids[1]);
+    TEST_ASSERT_EQUAL_INT(2, collectPinnedGlyphIds(records, count, BT_FONT_32x32, ids, 4));
+    TEST_ASSERT_EQUAL_UINT16(100, ids[0]);
+    TEST_ASSERT_EQUAL_UINT16(300, ids[1]);
+    TEST_ASSERT_EQUAL_INT(-1, collectPinnedGlyphIds(records, count, BT_FONT_16x16, ids, 1));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    memoryPoolsBegin(); // 临时分配区的存储与设备上一样在启动时取得
+    UNITY_BEGIN();
+    RUN_TEST(test_valid_scene);
+    RUN_TEST(test_truncated_record);
+    RUN_TEST(test_rejects_unbatchable_and_bad_length);
+    RUN_TEST(test_font_switch_changes_glyph_size);
+    RUN_TEST(test_text_over_region_capacity);
+    RUN_TEST(test_invalid_screen_area);
+    RUN_TEST(test_text_by_id_sources);
+    RUN_TEST(test_text_by_id_odd_length);
+    RUN_TEST(test_cache_capacity_across_batch);
+    RUN_TEST(test_glyph_define_incomplete);
+    RUN_TEST(test_utf8_text);
+    RUN_TEST(test_text_range_payload);
+    RUN_TEST(test_priority_pop_only_last);
+    RUN_TEST(test_collect_pinned_ids);
+    return UNITY_END();
+}
@@ -0,0 +1,201 @@
+// 字库往返测试：用 tools/mkfontpack.py 从测试BDF生成字库，经PartitionStore文件替身与FontPack查字读回
+// 另覆盖decodeUtf8对截断、超长编码等非法序列的处理
+// 在项目根目录运行：pio test -e native
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "FontPack.h"
+
+static const char *TEST_LABEL = "test_fontpack";   // PartitionStore主机替身读取 test_fontpack.bin
+static const char *TEST_BDF = "test_fontpack.bdf";
+
+static bool packReady = false;
+
+// 三个16x16字形：A（左上角一个点）、中（最右一列竖线）、😀（对角线）
+static bool writeTestBdf()
+{
+    FILE *file = fopen(TEST_BDF, "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "STARTFONT 2.1\nFONT test\nSIZE 16 75 75\nFONTBOUNDINGBOX 16 16 0 -2\nCHARS 3\n");
+    fprintf(file, "STARTCHAR A\nENCODING 65\nBBX 16 16 0 -2\nBITMAP\n8000\n");
+    for (int row = 1; row < 16; row++)
+        fprintf(file, "0000\n");
+    fprintf(file, "ENDCHAR\n");
+    fprintf(file, "STARTCHAR zhong\nENCODING 20013\nBBX 16 16 0 -2\nBITMAP\n");
+    for (int row = 0; row < 16; row++)
+        fprintf(file, "0001\n");
+    fprintf(file, "ENDCHAR\n");
+    fprintf(file, "STARTCHAR smile\nENCODING 128512\nBBX 16 16 0 -2\nBITMAP\n");
+    for (int row = 0; row < 16; row++)
+        fprintf(file, "%04X\n", 0x8000 >> row);
+    fprintf(file, "ENDCHAR\nENDFONT\n");
+    fclose(file);
+    return true;
+}
+
+static bool buildPack()
+{
+    if (!writeTestBdf())
+        return false;
+
+    char command[256];
+    snprintf(command, sizeof(command), "python3 tools/mkfontpack.py --font16 %s -o %s.bin", TEST_BDF, TEST_LABEL);
+    if (system(command) == 0)
+        return true;
+    snprintf(command, sizeof(command), "python tools/mkfontpack.py --font16 %s -o %s.bin", TEST_BDF, TEST_LABEL);
+    return system(command) == 0;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_pack_header()
+{
+    if (!packReady)
+        TEST_IGNORE_MESSAGE("mkfontpack.py未能运行（需要python）");
+
+    FontPack pack;
+    TEST_ASSERT_TRUE(pack.begin(TEST_LABEL));
+    TEST_ASSERT_FALSE(pack.isBuiltin());
+    TEST_ASSERT_EQUAL_UINT32(3, pack.getGlyphCount(BT_FONT_16x16));
+    TEST_ASSERT_EQUAL_UINT32(0, pack.getGlyphCount(BT_FONT_32x32));
+}
+
+void test_pack_glyph_lookup()
+{
+    if (!packReady)
+        TEST_IGNORE_MESSAGE("mkfontpack.py未能运行（需要python）");
+
+    FontPack pack;
+    TEST_ASSERT_TRUE(pack.begin(TEST_LABEL));
+
+    uint16_t glyph[FONT_BYTES_16 / 2];
+    uint16_t expected[FONT_BYTES_16 / 2] = {0};
+
+    // 列取模：第0列最高位为左上角像素
+    expected[0] = 0x8000;
+    TEST_ASSERT_TRUE(pack.readGlyph(BT_FONT_16x16, 'A', glyph));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, glyph, FONT_BYTES_16 / 2);
+
+    expected[0] = 0;
+    expected[15] = 0xFFFF;
+    TEST_ASSERT_TRUE(pack.readGlyph(BT_FONT_16x16, 0x4E2D, glyph));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, glyph, FONT_BYTES_16 / 2);
+
+    for (int col = 0; col < 16; col++)
+        expected[col] = 0x8000 >> col;
+    TEST_ASSERT_TRUE(pack.readGlyph(BT_FONT_16x16, 0x1F600, glyph));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, glyph, FONT_BYTES_16 / 2);
+}
+
+void test_pack_missing_glyph()
+{
+    if (!packReady)
+        TEST_IGNORE_MESSAGE("mkfontpack.py未能运行（需要python）");
+
+    FontPack pack;
+    TEST_ASSERT_TRUE(pack.begin(TEST_LABEL));
+
+    uint16_t glyph[FONT_BYTES_32 / 2];
+    TEST_ASSERT_FALSE(pack.readGlyph(BT_FONT_16x16, 'B', glyph));      // 索引两端之间不存在
+    TEST_ASSERT_FALSE(pack.readGlyph(BT_FONT_16x16, 0x10FFFF, glyph)); // 大于最大码位
+    TEST_ASSERT_FALSE(pack.readGlyph(BT_FONT_32x32, 'A', glyph));      // 没有32x32段
+}
+
+void test_pack_bad_magic()
+{
+    static const uint8_t image[8] = {'X', 'F', 'N', 'T', 1, 0, 1, 0};
+    FontPack pack;
+    TEST_ASSERT_FALSE(pack.beginImage(image, sizeof(image)));
+    TEST_ASSERT_FALSE(pack.isLoaded());
+}
+
+void test_utf8_valid()
+{
+    const uint8_t text[] = {'A', 0xE4, 0xB8, 0xAD, 0xF0, 0x9F, 0x98, 0x80, 0xC2, 0xA9};
+    uint32_t codepoints[8];
+    TEST_ASSERT_EQUAL_INT(4, decodeUtf8(text, sizeof(text), codepoints, 8));
+    TEST_ASSERT_EQUAL_HEX32('A', codepoints[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x4E2D, codepoints[1]);
+    TEST_ASSERT_EQUAL_HEX32(0x1F600, codepoints[2]);
+    TEST_ASSERT_EQUAL_HEX32(0xA9, codepoints[3]);
+}
+
+void test_utf8_truncated()
+{
+    uint32_t codepoints[8];
+
+    // 末尾截断：已读到的前缀替换为一个U+FFFD
+    const uint8_t tail[] = {'A', 0xE4, 0xB8};
+    TEST_ASSERT_EQUAL_INT(2, decodeUtf8(tail, sizeof(tail), codepoints, 8));
+    TEST_ASSERT_EQUAL_HEX32('A', codepoints[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFD, codepoints[1]);
+
+    // 中途截断：后面的正常字符保留
+    const uint8_t middle[] = {0xE4, 'B', 0xF0, 0x9F, 0x98, 'C'};
+    TEST_ASSERT_EQUAL_INT(4, decodeUtf8(middle, sizeof(middle), codepoints, 8));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFD, codepoints[0]);
+    TEST_ASSERT_EQUAL_HEX32('B', codepoints[1]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFD, codepoints[2]);
+    TEST_ASSERT_EQUAL_HEX32('C', codepoints[3]);
+
+    // 孤立续字节
+    const uint8_t stray[] = {0x80, 'D'};
+    TEST_ASSERT_EQUAL_INT(2, decodeUtf8(stray, sizeof(stray), codepoints, 8));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFD, codepoints[0]);
+    TEST_ASSERT_EQUAL_HEX32('D', codepoints[1]);
+}
+
+void test_utf8_overlong()
+{
+    uint32_t codepoints[8];
+
+    // "/" 的两字节、三字节、四字节超长编码
+    const uint8_t overlong[] = {0xC0, 0xAF, 0xE0, 0x80, 0xAF, 0xF0, 0x80, 0x80, 0xAF, 'E'};
+    TEST_ASSERT_EQUAL_INT(4, decodeUtf8(overlong, sizeof(overlong), codepoints, 8));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFD, codepoints[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFD, codepoints[1]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFD, codepoints[2]);
+    TEST_ASSERT_EQUAL_HEX32('E', codepoints[3]);
+
+    // 代理区码位与超出U+10FFFF
+    const uint8_t invalid[] = {0xED, 0xA0, 0x80, 0xF4, 0x90, 0x80, 0x80};
+    TEST_ASSERT_EQUAL_INT(2, decodeUtf8(invalid, sizeof(invalid), codepoints, 8));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFD, codepoints[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFD, codepoints[1]);
+}
+
+void test_utf8_max_codepoints()
+{
+    const uint8_t text[] = {'a', 'b', 'c', 'd'};
+    uint32_t codepoints[2];
+    TEST_ASSERT_EQUAL_INT(2, decodeUtf8(text, sizeof(text), codepoints, 2));
+    TEST_ASSERT_EQUAL_HEX32('b', codepoints[1]);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    packReady = buildPack();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_pack_header);
+    RUN_TEST(test_pack_glyph_lookup);
+    RUN_TEST(test_pack_missing_glyph);
+    RUN_TEST(test_pack_bad_magic);
+    RUN_TEST(test_utf8_valid);
+    RUN_TEST(test_utf8_truncated);
+    RUN_TEST(test_utf8_overlong);
+    RUN_TEST(test_utf8_max_codepoints);
+    int failures = UNITY_END();
+
+    remove(TEST_BDF);
+    char path[64];
+    snprintf(path, sizeof(path), "%s.bin", TEST_LABEL);
+    remove(path);
+    return failures;
+}
@@ -0,0 +1,167 @@
+// 流式文本测试：经PartitionStore文件替身上传点阵后重新打开读回，以及读前窗口的命中、前移与回退
+// 在项目根目录运行：pio test -e native
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "GlyphStream.h"
+#include "MemoryPool.h"
+
+static const char *TEST_LABEL = "test_glyphstream"; // PartitionStore主机替身读写 test_glyphstream.bin
+static const int TEST_SECTORS = 4;                  // 替身文件大小即分区容量
+static const int WINDOW_CHARS = STREAM_WINDOW_BYTES / FONT_BYTES_16;
+
+static GlyphStream stream;
+
+// 第n个字符的点阵（协议字节序）：首字为n，末字为~n，其余为0
+static void makeGlyph(uint32_t n, uint8_t *bytes)
+{
+    memset(bytes, 0, FONT_BYTES_16);
+    bytes[0] = (uint8_t)(n >> 8);
+    bytes[1] = (uint8_t)(n & 0xFF);
+    bytes[FONT_BYTES_16 - 2] = (uint8_t)(~n >> 8);
+    bytes[FONT_BYTES_16 - 1] = (uint8_t)(~n & 0xFF);
+}
+
+// 与刚擦除的Flash分区一样全部为0xFF
+static bool createBlankPartition()
+{
+    char path[64];
+    snprintf(path, sizeof(path), "%s.bin", TEST_LABEL);
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return false;
+    uint8_t blank[PARTITION_SECTOR_SIZE];
+    memset(blank, 0xFF, sizeof(blank));
+    for (int i = 0; i < TEST_SECTORS; i++)
+    {
+        fwrite(blank, 1, sizeof(blank), file);
+    }
+    fclose(file);
+    return true;
+}
+
+// 按客户端的方式分多条数据帧上传count个16x16字符
+static void uploadChars(uint32_t count)
+{
+    TEST_ASSERT_EQUAL_UINT8(BT_STREAM_STATUS_OK, stream.beginUpload(FONT_WIDTH_16, count));
+    uint8_t chunk[FONT_BYTES_16 * 5];
+    uint32_t sent = 0;
+    while (sent < count)
+    {
+        uint32_t n = (count - sent < 5) ? count - sent : 5;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            makeGlyph(sent + i, chunk + i * FONT_BYTES_16);
+        }
+        TEST_ASSERT_EQUAL_UINT8(BT_STREAM_STATUS_OK, stream.writeUpload(sent * FONT_BYTES_16, chunk, n * FONT_BYTES_16));
+        sent += n;
+    }
+    TEST_ASSERT_EQUAL_UINT8(BT_STREAM_STATUS_OK, stream.endUpload());
+}
+
+// 视图中第i个字符是否为第n个上传的字符
+static bool glyphMatches(const GlyphText &text, int i, uint32_t n)
+{
+    const uint16_t *glyph = text.at(i);
+    return glyph[0] == (uint16_t)n && glyph[FONT_BYTES_16 / 2 - 1] == (uint16_t)~n;
+}
+
+void setUp(void)
+{
+    TEST_ASSERT_TRUE(createBlankPartition());
+    TEST_ASSERT_FALSE(stream.begin(TEST_LABEL)); // 空分区没有完整文本
+    TEST_ASSERT_TRUE(stream.isAvailable());
+}
+
+void tearDown(void) {}
+
+void test_upload_round_trip()
+{
+    uploadChars(12);
+    TEST_ASSERT_EQUAL_UINT32(12, stream.getCharCount());
+
+    // 重新打开分区：文件头与点阵从替身文件读回，字节序转换为显示用的uint16_t
+    TEST_ASSERT_TRUE(stream.begin(TEST_LABEL));
+    TEST_ASSERT_EQUAL_UINT32(12, stream.getCharCount());
+    TEST_ASSERT_EQUAL_UINT8(FONT_WIDTH_16, stream.getGlyphSize());
+    GlyphText text = stream.fetch(0, 12);
+    TEST_ASSERT_EQUAL_INT(12, text.count);
+    for (int i = 0; i < 12; i++)
+    {
+        TEST_ASSERT_TRUE(glyphMatches(text, i, i));
+    }
+}
+
+void test_upload_rejects_bad_offset_and_capacity()
+{
+    uint32_t tooMany = (TEST_SECTORS * PARTITION_SECTOR_SIZE - STREAM_HEADER_SIZE) / FONT_BYTES_16 + 1;
+    TEST_ASSERT_EQUAL_UINT8(BT_STREAM_STATUS_TOO_LARGE, stream.beginUpload(FONT_WIDTH_16, tooMany));
+
+    uint8_t glyph[FONT_BYTES_16];
+    makeGlyph(0, glyph);
+    TEST_ASSERT_EQUAL_UINT8(BT_STREAM_STATUS_OK, stream.beginUpload(FONT_WIDTH_16, 2));
+    TEST_ASSERT_EQUAL_UINT8(BT_STREAM_STATUS_OFFSET, stream.writeUpload(FONT_BYTES_16, glyph, sizeof(glyph)));
+    TEST_ASSERT_EQUAL_UINT8(BT_STREAM_STATUS_OK, stream.writeUpload(0, glyph, sizeof(glyph)));
+    TEST_ASSERT_EQUAL_UINT8(BT_STREAM_STATUS_OFFSET, stream.endUpload()); // 点阵未传完时不写文件头
+
+    // 中断的上传不会留下有效文本
+    TEST_ASSERT_FALSE(stream.begin(TEST_LABEL));
+    TEST_ASSERT_FALSE(stream.isReady());
+}
+
+void test_window_fetch()
+{
+    uint32_t count = WINDOW_CHARS * 3;
+    uploadChars(count);
+    uint32_t loads = stream.getWindowLoads();
+
+    // 首次读取装满窗口，窗口内的后续读取不再访问分区
+    GlyphText text = stream.fetch(0, 4);
+    TEST_ASSERT_EQUAL_INT(4, text.count);
+    TEST_ASSERT_TRUE(glyphMatches(text, 0, 0));
+    TEST_ASSERT_EQUAL_UINT32(loads + 1, stream.getWindowLoads());
+    text = stream.fetch(WINDOW_CHARS - 4, 4);
+    TEST_ASSERT_TRUE(glyphMatches(text, 3, WINDOW_CHARS - 1));
+    TEST_ASSERT_EQUAL_UINT32(loads + 1, stream.getWindowLoads());
+
+    // 越过窗口末尾：从first起重新读前
+    text = stream.fetch(WINDOW_CHARS - 2, 4);
+    TEST_ASSERT_EQUAL_INT(4, text.count);
+    for (int i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_TRUE(glyphMatches(text, i, WINDOW_CHARS - 2 + i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(loads + 2, stream.getWindowLoads());
+
+    // 向回滚动到窗口之前：新窗口向前读到first之前（不足一个窗口时从0开始），继续后退仍在窗口内
+    text = stream.fetch(WINDOW_CHARS - 6, 4);
+    TEST_ASSERT_TRUE(glyphMatches(text, 0, WINDOW_CHARS - 6));
+    TEST_ASSERT_EQUAL_UINT32(loads + 3, stream.getWindowLoads());
+    text = stream.fetch(WINDOW_CHARS - 10, 4);
+    TEST_ASSERT_TRUE(glyphMatches(text, 0, WINDOW_CHARS - 10));
+    TEST_ASSERT_EQUAL_UINT32(loads + 3, stream.getWindowLoads());
+
+    // 末尾截断，超出窗口容量的请求按窗口容量截断，越界返回空视图
+    text = stream.fetch(count - 2, 4);
+    TEST_ASSERT_EQUAL_INT(2, text.count);
+    TEST_ASSERT_TRUE(glyphMatches(text, 1, count - 1));
+    TEST_ASSERT_EQUAL_INT(WINDOW_CHARS, stream.fetch(0, WINDOW_CHARS * 2).count);
+    TEST_ASSERT_EQUAL_INT(0, stream.fetch(count, 1).count);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    memoryPoolsBegin(); // 读前窗口与设备上一样来自流式文本缓冲区
+    UNITY_BEGIN();
+    RUN_TEST(test_upload_round_trip);
+    RUN_TEST(test_upload_rejects_bad_offset_and_capacity);
+    RUN_TEST(test_window_fetch);
+    int failures = UNITY_END();
+
+    char path[64];
+    snprintf(path, sizeof(path), "%s.bin", TEST_LABEL);
+    remove(path);
+    return failures;
+}
@@ -0,0 +1,207 @@
+// 帧解析器重同步测试：帧头、命令、长度、帧尾损坏时只丢弃出错的帧，
+// 其后（包括夹在损坏帧数据中）的完整帧仍能解析出来
+#include <unity.h>
+#include <string.h>
+#include "bluetooth_protocol.h"
+#include "CommandRegistry.h"
+#include "CommandTable.h"
+
+// 与固件共用命令表（CommandTable.h），处理函数不会被调用
+#define TEST_ROW(command, name, handler, minLength, maxLength, feature, batchable) \
+    {command, name, nullptr, minLength, maxLength, feature, batchable},
+static const CommandSpec testTable[] = {COMMAND_TABLE(TEST_ROW)};
+#undef TEST_ROW
+
+struct ParsedFrame
+{
+    uint8_t command;
+    uint16_t length;
+    uint8_t data[64];
+};
+
+static uint8_t frameBuffer[BluetoothProtocolParser::FRAME_BUFFER_SIZE];
+static BluetoothProtocolParser *parser;
+static ParsedFrame parsed[8];
+static int parsedCount;
+static int errorCount;
+
+static void handleResult(ParseResult result, const BluetoothFrame &frame)
+{
+    if (result == ParseResult::FRAME_COMPLETE)
+    {
+        if (parsedCount < 8)
+        {
+            ParsedFrame &out = parsed[parsedCount++];
+            out.command = frame.command;
+            out.length = frame.dataLength;
+            memcpy(out.data, frame.data, frame.dataLength < sizeof(out.data) ? frame.dataLength : sizeof(out.data));
+        }
+        parser->reset();
+    }
+    else if (result != ParseResult::NEED_MORE_DATA)
+    {
+        errorCount++;
+    }
+}
+
+// 与CommandChannel::poll相同的驱动方式：待重放字节先于新字节处理
+static void feed(const uint8_t *bytes, size_t length)
+{
+    BluetoothFrame frame;
+    size_t i = 0;
+    while (parser->hasPendingData() || i < length)
+    {
+        ParseResult result = parser->hasPendingData() ? parser->parsePending(frame) : parser->parseByte(bytes[i++], frame);
+        handleResult(result, frame);
+    }
+}
+
+void setUp(void)
+{
+    registerCommandTable(testTable, sizeof(testTable) / sizeof(testTable[0]));
+    parser = new BluetoothProtocolParser(frameBuffer);
+    parsedCount = 0;
+    errorCount = 0;
+}
+
+void tearDown(void)
+{
+    delete parser;
+}
+
+void test_single_frame()
+{
+    const uint8_t bytes[] = {0xAA, 0x55, 0x07, 0x00, 0x01, 0x80, 0x0D, 0x0A};
+    feed(bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(1, parsedCount);
+    TEST_ASSERT_EQUAL_INT(0, errorCount);
+    TEST_ASSERT_EQUAL_HEX8(BT_CMD_SET_BRIGHTNESS, parsed[0].command);
+    TEST_ASSERT_EQUAL_INT(1, parsed[0].length);
+    TEST_ASSERT_EQUAL_HEX8(0x80, parsed[0].data[0]);
+}
+
+void test_leading_garbage()
+{
+    const uint8_t bytes[] = {0x00, 0x0D, 0x0A, 0x55, 0xAA, 0x55, 0x10, 0x00, 0x00, 0x0D, 0x0A};
+    feed(bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(1, parsedCount);
+    TEST_ASSERT_EQUAL_HEX8(BT_CMD_CAPABILITIES, parsed[0].command);
+}
+
+void test_repeated_header_byte()
+{
+    // 第一个0xAA之后不是0x55，从第二个0xAA重新开始
+    const uint8_t bytes[] = {0xAA, 0xAA, 0x55, 0x07, 0x00, 0x01, 0x10, 0x0D, 0x0A};
+    feed(bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(1, parsedCount);
+    TEST_ASSERT_EQUAL_HEX8(0x10, parsed[0].data[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, parser->getErrorCount(ParseState::WAITING_HEADER2));
+}
+
+void test_invalid_command_then_frame()
+{
+    const uint8_t bytes[] = {0xAA, 0x55, 0xEE, 0x00, 0x01,
+                             0xAA, 0x55, 0x07, 0x00, 0x01, 0x20, 0x0D, 0x0A};
+    feed(bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(1, parsedCount);
+    TEST_ASSERT_EQUAL_HEX8(0x20, parsed[0].data[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, parser->getErrorCount(ParseState::WAITING_COMMAND));
+}
+
+void test_corrupt_length_does_not_swallow_next_frame()
+{
+    // 亮度命令长度字节损坏为0x40：不在允许范围内立即出错，下一帧照常解析
+    const uint8_t bytes[] = {0xAA, 0x55, 0x07, 0x00, 0x40, 0x30, 0x0D, 0x0A,
+                             0xAA, 0x55, 0x07, 0x00, 0x01, 0x31, 0x0D, 0x0A};
+    feed(bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(1, parsedCount);
+    TEST_ASSERT_EQUAL_HEX8(0x31, parsed[0].data[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, parser->getErrorCount(ParseState::WAITING_LENGTH_LOW));
+}
+
+void test_frame_inside_truncated_frame()
+{
+    // 文本帧声明4字节数据，发送端只发出2字节就开始了下一帧；
+    // 损坏帧在帧尾处出错，重放其已收字节后找到夹在其中的完整亮度帧，随后的帧也不丢失
+    const uint8_t bytes[] = {0xAA, 0x55, 0x04, 0x00, 0x04, 0x01, 0x02,
+                             0xAA, 0x55, 0x07, 0x00, 0x01, 0x40, 0x0D, 0x0A,
+                             0xAA, 0x55, 0x07, 0x00, 0x01, 0x41, 0x0D, 0x0A};
+    feed(bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(2, parsedCount);
+    TEST_ASSERT_EQUAL_HEX8(0x40, parsed[0].data[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x41, parsed[1].data[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, parser->getErrorCount(ParseState::WAITING_TAIL1));
+}
+
+void test_bad_tail_then_frame()
+{
+    const uint8_t bytes[] = {0xAA, 0x55, 0x07, 0x00, 0x01, 0x50, 0x0D, 0x0B,
+                             0xAA, 0x55, 0x04, 0x00, 0x03, 0x01, 0xAA, 0x55, 0x0D, 0x0A};
+    feed(bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(1, parsedCount);
+    TEST_ASSERT_EQUAL_HEX8(BT_CMD_SET_TEXT, parsed[0].command);
+    TEST_ASSERT_EQUAL_INT(3, parsed[0].length);
+    TEST_ASSERT_EQUAL_HEX8(0xAA, parsed[0].data[1]); // 数据中的0xAA 0x55不会被当作帧头
+    TEST_ASSERT_EQUAL_UINT32(1, parser->getErrorCount(ParseState::WAITING_TAIL2));
+}
+
+void test_back_to_back_frames_split_across_calls()
+{
+    const uint8_t bytes[] = {0xAA, 0x55, 0x07, 0x00, 0x01, 0x60, 0x0D, 0x0A,
+                             0xAA, 0x55, 0x07, 0x00, 0x01, 0x61, 0x0D, 0x0A};
+    for (size_t i = 0; i < sizeof(bytes); i++)
+    {
+        feed(bytes + i, 1);
+    }
+    TEST_ASSERT_EQUAL_INT(2, parsedCount);
+    TEST_ASSERT_EQUAL_INT(0, errorCount);
+    TEST_ASSERT_EQUAL_HEX8(0x61, parsed[1].data[0]);
+}
+
+void test_oversized_length()
+{
+    const uint8_t bytes[] = {0xAA, 0x55, 0x04, 0xFF, 0xFF,
+                             0xAA, 0x55, 0x10, 0x00, 0x00, 0x0D, 0x0A};
+    feed(bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT(1, parsedCount);
+    TEST_ASSERT_EQUAL_HEX8(BT_CMD_CAPABILITIES, parsed[0].command);
+    TEST_ASSERT_EQUAL_INT(1, errorCount);
+}
+
+void test_idle_only_between_frames()
+{
+    // 通道据此决定何时让出共用的帧缓冲区：帧未收完或有待重放字节时都不空闲
+    TEST_ASSERT_TRUE(parser->isIdle());
+    const uint8_t head[] = {0xAA, 0x55, 0x07, 0x00};
+    feed(head, sizeof(head));
+    TEST_ASSERT_FALSE(parser->isIdle());
+
+    const uint8_t tail[] = {0x01, 0x70, 0x0D, 0x0A};
+    feed(tail, sizeof(tail));
+    TEST_ASSERT_EQUAL_INT(1, parsedCount);
+    TEST_ASSERT_TRUE(parser->isIdle());
+
+    // 帧尾出错后重放到夹在其中的帧头，该帧未收完时仍不空闲
+    const uint8_t broken[] = {0xAA, 0x55, 0x04, 0x00, 0x02, 0x01, 0xAA, 0x55, 0x07};
+    feed(broken, sizeof(broken));
+    TEST_ASSERT_FALSE(parser->isIdle());
+    TEST_ASSERT_FALSE(parser->abandonIfTimedOut()); // 未超时不放弃
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_single_frame);
+    RUN_TEST(test_leading_garbage);
+    RUN_TEST(test_repeated_header_byte);
+    RUN_TEST(test_invalid_command_then_frame);
+    RUN_TEST(test_corrupt_length_does_not_swallow_next_frame);
+    RUN_TEST(test_frame_inside_truncated_frame);
+    RUN_TEST(test_bad_tail_then_frame);
+    RUN_TEST(test_back_to_back_frames_split_across_calls);
+    RUN_TEST(test_oversized_length);
+    RUN_TEST(test_idle_only_between_frames);
+    return UNITY_END();
+}
@@ -0,0 +1,304 @@
+// 去重文本存储测试：字形表引用计数、槽位回收，区域文本写入、替换、插入、删除失败时引用不泄漏，
+// 以及"从未设置"与"已设置但为空"两种状态的区分
+// 在项目根目录运行：pio test -e native
+#include <unity.h>
+#include <string.h>
+#include "TextStore.h"
+#include "MemoryPool.h"
+
+static const int TEST_WORDS = FONT_BYTES_16 / 2;
+
+// 小容量字形表与区域缓冲，便于构造表满与区域满的情况
+static GlyphTable testTable("test", 4, TEST_WORDS);
+static uint8_t testStorage[8 * sizeof(uint16_t)];
+static FixedBuffer testBuffer("test", testStorage, sizeof(testStorage));
+static RegionText region = {&testTable, &testBuffer, nullptr, 0, 0, false};
+
+// 第n个测试字形：首个字写入n，其余为0
+static uint16_t glyphs[8][TEST_WORDS];
+
+static GlyphText makeText(const int *ids, int count)
+{
+    static uint16_t data[16 * TEST_WORDS];
+    for (int i = 0; i < count; i++)
+    {
+        memcpy(data + i * TEST_WORDS, glyphs[ids[i]], sizeof(glyphs[0]));
+    }
+    return GlyphText(data, count, TEST_WORDS);
+}
+
+static uint16_t glyphIdAt(int i)
+{
+    return getRegionGlyphs(region).at(i)[0];
+}
+
+void setUp(void)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        memset(glyphs[i], 0, sizeof(glyphs[i]));
+        glyphs[i][0] = i;
+    }
+    resetRegionText(region);
+    testTable.clear();
+}
+
+void tearDown(void) {}
+
+void test_intern_shares_and_release_frees()
+{
+    int a = testTable.intern(glyphs[1]);
+    int b = testTable.intern(glyphs[1]);
+    TEST_ASSERT_TRUE(a >= 0);
+    TEST_ASSERT_EQUAL_INT(a, b);
+    TEST_ASSERT_EQUAL_UINT16(1, testTable.getUsedCount());
+
+    testTable.release(a);
+    TEST_ASSERT_EQUAL_UINT16(1, testTable.getUsedCount()); // 还有一个引用
+    testTable.release(a);
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+
+    testTable.release(a); // 多余的释放不产生影响
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+}
+
+void test_retain_keeps_slot()
+{
+    int a = testTable.intern(glyphs[2]);
+    testTable.retain(a);
+    testTable.release(a);
+    TEST_ASSERT_EQUAL_UINT16(1, testTable.getUsedCount());
+    testTable.release(a);
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+
+    testTable.retain(a); // 空槽不能被retain复活
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+}
+
+void test_full_table_and_slot_reuse()
+{
+    int slots[4];
+    for (int i = 0; i < 4; i++)
+    {
+        slots[i] = testTable.intern(glyphs[i]);
+        TEST_ASSERT_TRUE(slots[i] >= 0);
+    }
+    uint32_t failures = testTable.getFailureCount();
+    TEST_ASSERT_EQUAL_INT(-1, testTable.intern(glyphs[4]));
+    TEST_ASSERT_EQUAL_UINT32(failures + 1, testTable.getFailureCount());
+    TEST_ASSERT_EQUAL_INT(slots[0], testTable.intern(glyphs[0])); // 已有字形不受表满影响
+    testTable.release(slots[0]);
+
+    // 回收的槽位从哈希链上摘下，写入新字形后旧字形不再命中
+    testTable.release(slots[1]);
+    int reused = testTable.intern(glyphs[5]);
+    TEST_ASSERT_EQUAL_INT(slots[1], reused);
+    TEST_ASSERT_EQUAL_UINT16(5, testTable.getGlyphData()[reused * TEST_WORDS]);
+    TEST_ASSERT_EQUAL_INT(-1, testTable.intern(glyphs[1]));
+}
+
+void test_set_region_dedups_and_clear_releases()
+{
+    const int ids[] = {1, 2, 1, 1, 2};
+    TEST_ASSERT_EQUAL_INT(5, setRegionText(region, makeText(ids, 5)));
+    TEST_ASSERT_EQUAL_UINT16(2, testTable.getUsedCount());
+    for (int i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT16(ids[i], glyphIdAt(i));
+    }
+
+    uint32_t revision = region.revision;
+    clearRegionText(region);
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+    TEST_ASSERT_EQUAL_INT(0, region.charCount);
+    TEST_ASSERT_TRUE(region.revision != revision);
+}
+
+void test_set_region_truncates_on_full_table()
+{
+    const int ids[] = {1, 2, 3, 4, 5, 1};
+    TEST_ASSERT_EQUAL_INT(4, setRegionText(region, makeText(ids, 6))); // 第5个不同字形放不下
+    TEST_ASSERT_EQUAL_UINT16(4, testTable.getUsedCount());
+    TEST_ASSERT_EQUAL_UINT(4 * sizeof(uint16_t), testBuffer.getUsed());
+
+    clearRegionText(region);
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+}
+
+void test_set_region_truncates_on_capacity()
+{
+    const int ids[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+    TEST_ASSERT_EQUAL_INT(8, setRegionText(region, makeText(ids, 10)));
+    clearRegionText(region);
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+}
+
+void test_replace_releases_old_glyphs()
+{
+    const int ids[] = {1, 2, 3};
+    setRegionText(region, makeText(ids, 3));
+    const int replacement[] = {4};
+    TEST_ASSERT_TRUE(replaceRegionGlyphs(region, 1, makeText(replacement, 1)));
+    TEST_ASSERT_EQUAL_UINT16(4, glyphIdAt(1));
+    TEST_ASSERT_EQUAL_UINT16(3, testTable.getUsedCount()); // 字形2已回收
+}
+
+void test_failed_replace_leaves_region_unchanged()
+{
+    const int ids[] = {1, 2, 3, 4};
+    setRegionText(region, makeText(ids, 4));
+    uint32_t revision = region.revision;
+
+    // 第二个新字形写不进满表：第一个新字形（与已有字形相同）的引用须撤销
+    const int replacement[] = {1, 5};
+    TEST_ASSERT_FALSE(replaceRegionGlyphs(region, 0, makeText(replacement, 2)));
+    TEST_ASSERT_EQUAL_UINT32(revision, region.revision);
+    TEST_ASSERT_EQUAL_UINT16(1, glyphIdAt(0));
+    TEST_ASSERT_EQUAL_UINT16(2, glyphIdAt(1));
+
+    clearRegionText(region);
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+}
+
+void test_insert_and_delete()
+{
+    const int ids[] = {1, 3};
+    setRegionText(region, makeText(ids, 2));
+    const int inserted[] = {2, 2};
+    TEST_ASSERT_TRUE(insertRegionGlyphs(region, 1, makeText(inserted, 2)));
+    TEST_ASSERT_EQUAL_INT(4, region.charCount);
+    TEST_ASSERT_EQUAL_UINT16(1, glyphIdAt(0));
+    TEST_ASSERT_EQUAL_UINT16(2, glyphIdAt(1));
+    TEST_ASSERT_EQUAL_UINT16(2, glyphIdAt(2));
+    TEST_ASSERT_EQUAL_UINT16(3, glyphIdAt(3));
+
+    deleteRegionGlyphs(region, 1, 1);
+    TEST_ASSERT_EQUAL_UINT16(3, testTable.getUsedCount()); // 字形2仍被一个字符引用
+    deleteRegionGlyphs(region, 1, 100);                    // 超出末尾按剩余字符数删除
+    TEST_ASSERT_EQUAL_INT(1, region.charCount);
+    TEST_ASSERT_EQUAL_UINT16(1, testTable.getUsedCount());
+    TEST_ASSERT_EQUAL_UINT(sizeof(uint16_t), testBuffer.getUsed());
+}
+
+// 删除全部字符后区域仍是已设置的空文本，只有重置才回到内置示例数据
+void test_delete_all_keeps_region_set()
+{
+    TEST_ASSERT_FALSE(region.hasText);
+    const int ids[] = {1, 2};
+    setRegionText(region, makeText(ids, 2));
+    TEST_ASSERT_TRUE(region.hasText);
+
+    deleteRegionGlyphs(region, 0, 2);
+    TEST_ASSERT_EQUAL_INT(0, region.charCount);
+    TEST_ASSERT_TRUE(region.hasText);
+
+    clearRegionText(region);
+    TEST_ASSERT_TRUE(region.hasText);
+    resetRegionText(region);
+    TEST_ASSERT_FALSE(region.hasText);
+
+    // 在未设置的区域插入即成为已设置的文本
+    TEST_ASSERT_TRUE(insertRegionGlyphs(region, 0, makeText(ids, 1)));
+    TEST_ASSERT_TRUE(region.hasText);
+}
+
+void test_failed_insert_keeps_references()
+{
+    const int ids[] = {1, 2, 3, 4, 1, 2, 3};
+    setRegionText(region, makeText(ids, 7));
+
+    const int overCapacity[] = {1, 1};
+    TEST_ASSERT_FALSE(insertRegionGlyphs(region, 0, makeText(overCapacity, 2))); // 区域只剩1个位置
+    const int overTable[] = {5};
+    TEST_ASSERT_FALSE(insertRegionGlyphs(region, 0, makeText(overTable, 1))); // 字形表已满
+    TEST_ASSERT_EQUAL_INT(7, region.charCount);
+
+    clearRegionText(region);
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+}
+
+void test_snapshot_restore_and_release()
+{
+    static uint8_t arenaStorage[64];
+    StaticArena arena("test", arenaStorage, sizeof(arenaStorage));
+
+    const int ids[] = {1, 2, 1};
+    setRegionText(region, makeText(ids, 3));
+    RegionSnapshot snapshot;
+    TEST_ASSERT_TRUE(saveRegionText(region, arena, snapshot));
+
+    // 快照持有引用：改写区域后原字形仍在表中
+    const int replacement[] = {3, 4};
+    setRegionText(region, makeText(replacement, 2));
+    TEST_ASSERT_EQUAL_UINT16(4, testTable.getUsedCount());
+
+    restoreRegionText(region, snapshot);
+    TEST_ASSERT_EQUAL_INT(3, region.charCount);
+    TEST_ASSERT_EQUAL_UINT16(2, glyphIdAt(1));
+    TEST_ASSERT_EQUAL_UINT16(2, testTable.getUsedCount()); // 字形3、4已回收
+    TEST_ASSERT_EQUAL_INT(0, snapshot.count);
+
+    // 放弃快照时释放其引用
+    TEST_ASSERT_TRUE(saveRegionText(region, arena, snapshot));
+    clearRegionText(region);
+    TEST_ASSERT_EQUAL_UINT16(2, testTable.getUsedCount());
+    releaseRegionSnapshot(region, snapshot);
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+}
+
+// 快照保留区域是否设置过文本：未设置的区域恢复后仍显示内置示例数据
+void test_snapshot_keeps_unset_state()
+{
+    static uint8_t arenaStorage[64];
+    StaticArena arena("test", arenaStorage, sizeof(arenaStorage));
+
+    RegionSnapshot snapshot;
+    TEST_ASSERT_TRUE(saveRegionText(region, arena, snapshot));
+    const int ids[] = {1};
+    setRegionText(region, makeText(ids, 1));
+    restoreRegionText(region, snapshot);
+    TEST_ASSERT_FALSE(region.hasText);
+
+    setRegionText(region, makeText(ids, 0));
+    TEST_ASSERT_TRUE(saveRegionText(region, arena, snapshot));
+    resetRegionText(region);
+    restoreRegionText(region, snapshot);
+    TEST_ASSERT_TRUE(region.hasText);
+    TEST_ASSERT_EQUAL_INT(0, region.charCount);
+}
+
+void test_snapshot_out_of_arena()
+{
+    static uint8_t arenaStorage[4];
+    StaticArena arena("test", arenaStorage, sizeof(arenaStorage));
+
+    const int ids[] = {1, 2, 3};
+    setRegionText(region, makeText(ids, 3));
+    RegionSnapshot snapshot;
+    TEST_ASSERT_FALSE(saveRegionText(region, arena, snapshot)); // 分配区不足时不增加引用
+    clearRegionText(region);
+    TEST_ASSERT_EQUAL_UINT16(0, testTable.getUsedCount());
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    memoryPoolsBegin(); // 临时分配区的存储与设备上一样在启动时取得
+    UNITY_BEGIN();
+    RUN_TEST(test_intern_shares_and_release_frees);
+    RUN_TEST(test_retain_keeps_slot);
+    RUN_TEST(test_full_table_and_slot_reuse);
+    RUN_TEST(test_set_region_dedups_and_clear_releases);
+    RUN_TEST(test_set_region_truncates_on_full_table);
+    RUN_TEST(test_set_region_truncates_on_capacity);
+    RUN_TEST(test_replace_releases_old_glyphs);
+    RUN_TEST(test_failed_replace_leaves_region_unchanged);
+    RUN_TEST(test_insert_and_delete);
+    RUN_TEST(test_delete_all_keeps_region_set);
+    RUN_TEST(test_failed_insert_keeps_references);
+    RUN_TEST(test_snapshot_restore_and_release);
+    RUN_TEST(test_snapshot_keeps_unset_state);
+    RUN_TEST(test_snapshot_out_of_arena);
+    return UNITY_END();
+}
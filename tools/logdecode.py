@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""解码设备二进制日志（LOG_BINARY_OUTPUT=1 时串口输出的记录）。
+
+用法:
+    python tools/logdecode.py .pio/build/esp32dev/firmware.elf capture.bin
+    cat /dev/ttyUSB0 | python tools/logdecode.py .pio/build/esp32dev/firmware.elf -
+
+记录格式见 src/Log.cpp：[0xA5][级别][参数个数][时间戳][格式串地址][参数...]，整数均为4字节小端。
+格式串与 %s 参数都是固件中的常量字符串，按地址从ELF中读取。需要 pyelftools。
+"""
+
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+LEVELS = {1: "E", 2: "W", 3: "I", 4: "D"}
+SPEC = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(l{0,2}|h{0,2})([diuxXcsp%])")
+
+
+class FirmwareStrings:
+    def __init__(self, path):
+        self.segments = []
+        with open(path, "rb") as f:
+            elf = ELFFile(f)
+            for seg in elf.iter_segments():
+                if seg["p_type"] == "PT_LOAD" and seg["p_filesz"] > 0:
+                    self.segments.append((seg["p_vaddr"], seg.data()))
+
+    def read(self, address):
+        for base, data in self.segments:
+            if base <= address < base + len(data):
+                end = data.index(b"\0", address - base)
+                return data[address - base:end].decode("utf-8", "replace")
+        return "<0x%08X>" % address
+
+
+def format_record(strings, fmt, args):
+    args = list(args)
+
+    def convert(m):
+        flags, _, conv = m.groups()
+        if conv == "%":
+            return "%"
+        value = args.pop(0) if args else 0
+        if conv in "di":
+            value = value - (1 << 32) if value & 0x80000000 else value
+            return ("%" + flags + "d") % value
+        if conv == "s":
+            return ("%" + flags + "s") % strings.read(value)
+        if conv == "c":
+            return chr(value & 0xFF)
+        if conv == "p":
+            return "0x%08x" % value
+        return ("%" + flags + conv) % value
+
+    return SPEC.sub(convert, fmt)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        sys.exit(1)
+
+    strings = FirmwareStrings(sys.argv[1])
+    stream = sys.stdin.buffer if sys.argv[2] == "-" else open(sys.argv[2], "rb")
+
+    buffer = b""
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            break
+        buffer += chunk
+        while True:
+            start = buffer.find(b"\xA5")
+            if start < 0:
+                buffer = b""
+                break
+            if len(buffer) < start + 3:
+                buffer = buffer[start:]
+                break
+            level, argc = buffer[start + 1], buffer[start + 2]
+            size = 3 + 4 * (2 + argc)
+            if level not in LEVELS or argc > 8:
+                buffer = buffer[start + 1:]  # 不是记录开头，继续查找
+                continue
+            if len(buffer) < start + size:
+                buffer = buffer[start:]
+                break
+            words = struct.unpack_from("<%dI" % (2 + argc), buffer, start + 3)
+            timestamp, fmt_addr, args = words[0], words[1], words[2:]
+            text = format_record(strings, strings.read(fmt_addr), args)
+            print("[%d] %s %s" % (timestamp, LEVELS[level], text))
+            buffer = buffer[start + size:]
+
+
+if __name__ == "__main__":
+    main()
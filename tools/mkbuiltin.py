@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""生成链接进固件Flash的内置内容（const数组，原地读取，不占用DRAM）。
+
+用法:
+    # 从BDF字体渲染内置示例文本，重新生成 include/FontData.h 与 src/FontData.cpp
+    python tools/mkbuiltin.py text --font16 unifont.bdf --font32 wqy32.bdf \
+        --upper "欢迎光临" --lower "营业时间 9:00-21:00" --full "→→→"
+
+    # 把 mkfontpack.py 生成的字库转换为内置字库映像 src/BuiltinFontPack.cpp
+    python tools/mkbuiltin.py fontpack fontpack.bin
+
+内置字库需在 include/config.h 中把 FONT_PACK_BUILTIN 设为1才会链接；
+fontpack分区中有字库时优先使用分区，分区为空时使用内置字库。
+内置数据计入app分区（见partitions.csv），内置字库过大时会给出警告。
+"""
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from mkfontpack import encode_glyph, parse_bdf, render_glyph  # noqa: E402
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+APP_PARTITION_SIZE = 0x1E0000  # 与partitions.csv中app0一致
+
+DEFAULT_UPPER = "人人人人人人"
+DEFAULT_LOWER = "人人人人人"
+DEFAULT_FULL = "→→→"
+
+
+def render_text(path, size, text):
+    """按字符渲染点阵，返回 [(字符, 点阵字节)]；字体中不存在的字符以空白代替。"""
+    bbox, glyphs = parse_bdf(path)
+    out = []
+    for ch in text:
+        glyph = glyphs.get(ord(ch))
+        if glyph is None:
+            print("警告: %s 中没有字符 %r (U+%04X)，以空白代替" % (path, ch, ord(ch)), file=sys.stderr)
+            out.append((ch, bytes(size * size // 8)))
+        else:
+            out.append((ch, encode_glyph(render_glyph(bbox, glyph, size), size)))
+    return out
+
+
+def format_words(data, per_line):
+    words = ["0x%02X%02X" % (data[i], data[i + 1]) for i in range(0, len(data), 2)]
+    lines = []
+    for i in range(0, len(words), per_line):
+        lines.append("    " + ", ".join(words[i:i + per_line]))
+    return lines
+
+
+def format_array(name, glyphs, per_line):
+    lines = ["const uint16_t %s[] = {" % name]
+    for ch, data in glyphs:
+        lines.append('    // "%s" U+%04X' % (ch, ord(ch)))
+        lines += [line + "," for line in format_words(data, per_line)]
+    lines[-1] = lines[-1][:-1] + "};"
+    return lines
+
+
+def write_text(args):
+    if not args.font16 or not args.font32:
+        sys.exit("错误: 重新生成示例数据需要同时指定 --font16 与 --font32")
+
+    upper = args.upper or DEFAULT_UPPER
+    lower = args.lower or DEFAULT_LOWER
+    full = args.full or DEFAULT_FULL
+    font16 = args.font16
+    font32 = args.font32
+
+    regions = [
+        ("upper_text", "UPPER", "上半屏", upper, render_text(font16, 16, upper), "FONT_BYTES_16"),
+        ("lower_text", "LOWER", "下半屏", lower, render_text(font16, 16, lower), "FONT_BYTES_16"),
+        ("full_text", "FULL", "全屏（32x32）", full, render_text(font32, 32, full), "FONT_BYTES_32"),
+    ]
+
+    header = [
+        "#ifndef FONTDATA_H",
+        "#define FONTDATA_H",
+        "",
+        "#include <Arduino.h>",
+        '#include "config.h"',
+        "",
+        "// ==================== 内置示例数据 ====================",
+        "// 由 tools/mkbuiltin.py 生成，请勿手工修改。",
+        "// 内置点阵均为const数组，链接到Flash只读段，渲染时原地读取，不在启动时复制到DRAM。",
+        "// 字符数为编译期常量，与数组实际长度不符时编译报错（见src/FontData.cpp）。",
+    ]
+    for name, macro, label, text, glyphs, _ in regions:
+        header.append("#define %s_TEXT_CHAR_COUNT %d // %s示例字符数" % (macro, len(glyphs), label))
+    header += ["", "// ==================== 字库数据声明 ===================="]
+    for name, macro, label, text, glyphs, _ in regions:
+        header += ['// "%s"' % text, "extern const uint16_t %s[];" % name, ""]
+    header += [
+        "// ==================== 辅助函数声明 ====================",
+        "// 获取字符数量的辅助函数（编译期常量）",
+        "constexpr int getUpperTextCharCount() { return UPPER_TEXT_CHAR_COUNT; } // 获取上半屏文本字符数",
+        "constexpr int getLowerTextCharCount() { return LOWER_TEXT_CHAR_COUNT; } // 获取下半屏文本字符数",
+        "constexpr int getFullTextCharCount() { return FULL_TEXT_CHAR_COUNT; }   // 获取全屏文本字符数",
+        "",
+        "#endif",
+        "",
+    ]
+
+    source = ['#include "FontData.h"', "", "// ==================== 字库数据定义 ===================="]
+    for name, macro, label, text, glyphs, _ in regions:
+        source.append('// "%s"' % text)
+        source += format_array(name, glyphs, 4 if name != "full_text" else 8)
+        source.append("")
+    source.append("// ==================== 编译期校验 ====================")
+    for name, macro, label, text, glyphs, bytes_macro in regions:
+        source.append('static_assert(sizeof(%s) == %s_TEXT_CHAR_COUNT * %s, "%s示例字符数与点阵长度不符");'
+                      % (name, macro, bytes_macro, label))
+    source.append("")
+
+    with open(os.path.join(ROOT, "include", "FontData.h"), "w", encoding="utf-8") as f:
+        f.write("\n".join(header))
+    with open(os.path.join(ROOT, "src", "FontData.cpp"), "w", encoding="utf-8") as f:
+        f.write("\n".join(source))
+
+    total = sum(len(data) for _, _, _, _, glyphs, _ in regions for _, data in glyphs)
+    for name, macro, label, text, glyphs, _ in regions:
+        print("%s: %d 个字符" % (label, len(glyphs)))
+    print("已生成 include/FontData.h 与 src/FontData.cpp，点阵共 %d 字节（Flash）" % total)
+
+
+def write_fontpack(args):
+    with open(args.input, "rb") as f:
+        data = f.read()
+    if data[:4] != b"LFNT":
+        sys.exit("错误: %s 不是字库文件（魔数不符）" % args.input)
+
+    lines = [
+        "// 由 tools/mkbuiltin.py 从 %s 生成，请勿手工修改。" % os.path.basename(args.input),
+        "// 内置字库映像：const数组位于Flash只读段，FontPack原地读取，不占用DRAM。",
+        '#include "FontPack.h"',
+        "",
+        "#if FONT_PACK_BUILTIN",
+        "const uint32_t builtinFontPackSize = %d;" % len(data),
+        "alignas(4) const uint8_t builtinFontPack[] = {",
+    ]
+    for i in range(0, len(data), 16):
+        chunk = ", ".join("0x%02X" % b for b in data[i:i + 16])
+        lines.append("    " + chunk + ("," if i + 16 < len(data) else "};"))
+    lines += ["#endif", ""]
+
+    output = args.output or os.path.join(ROOT, "src", "BuiltinFontPack.cpp")
+    with open(output, "w", encoding="utf-8") as f:
+        f.write("\n".join(lines))
+
+    print("已生成 %s，字库映像 %d 字节" % (output, len(data)))
+    print("请在 include/config.h 中设置 FONT_PACK_BUILTIN 为1")
+    if len(data) > APP_PARTITION_SIZE // 2:
+        print("警告: 内置字库超过app分区的一半，固件可能放不下，建议改用fontpack分区", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="生成LED屏内置内容（Flash常量数据）")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    text = sub.add_parser("text", help="重新生成内置示例文本 (FontData.h/.cpp)")
+    text.add_argument("--font16", help="16x16使用的BDF字体")
+    text.add_argument("--font32", help="32x32使用的BDF字体")
+    text.add_argument("--upper", help="上半屏示例文本")
+    text.add_argument("--lower", help="下半屏示例文本")
+    text.add_argument("--full", help="全屏（32x32）示例文本")
+    text.set_defaults(func=write_text)
+
+    pack = sub.add_parser("fontpack", help="把字库文件转换为内置字库映像")
+    pack.add_argument("input", help="mkfontpack.py 生成的字库文件")
+    pack.add_argument("-o", "--output", help="输出的C++源文件（默认 src/BuiltinFontPack.cpp）")
+    pack.set_defaults(func=write_fontpack)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
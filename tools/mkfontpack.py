@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""从BDF点阵字体生成设备端字库(fontpack.bin)。
+
+用法:
+    python tools/mkfontpack.py --font16 unifont.bdf --font32 wqy32.bdf -o fontpack.bin
+    python tools/mkfontpack.py --font16 unifont.bdf --charset chars.txt -o fontpack.bin
+
+可选 --charset 指定一个UTF-8文本文件，只打包其中出现的字符（用于裁剪字库体积）。
+
+烧录到fontpack分区（偏移见partitions.csv）:
+    esptool.py write_flash 0x1F0000 fontpack.bin
+
+主机构建时，PartitionStore以当前目录下的 fontpack.bin 代替Flash分区。
+
+文件格式见 include/FontPack.h：小端整数，按码位排序的索引 + 定长点阵。
+点阵与蓝牙文本命令(0x04)一致：列取模，每列高位对应上方像素，
+16x16每列1个uint16，32x32每列2个uint16（先上16行，后下16行），高字节在前。
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x544E464C  # "LFNT"
+VERSION = 1
+
+
+def parse_bdf(path):
+    """解析BDF字体，返回 (字体包围盒, {码位: (w, h, xoff, yoff, rows)})。"""
+    glyphs = {}
+    bbox = None
+    with open(path, "r", encoding="latin-1") as f:
+        lines = iter(f.read().splitlines())
+    encoding = None
+    bbx = None
+    for line in lines:
+        parts = line.split()
+        if not parts:
+            continue
+        key = parts[0]
+        if key == "FONTBOUNDINGBOX":
+            bbox = tuple(int(v) for v in parts[1:5])
+        elif key == "ENCODING":
+            encoding = int(parts[1])
+        elif key == "BBX":
+            bbx = tuple(int(v) for v in parts[1:5])
+        elif key == "BITMAP":
+            rows = []
+            for row in lines:
+                if row.startswith("ENDCHAR"):
+                    break
+                rows.append(int(row.strip(), 16) if row.strip() else 0)
+            if encoding is not None and encoding >= 0 and bbx is not None:
+                glyphs[encoding] = (bbx, rows)
+            encoding = None
+            bbx = None
+    if bbox is None:
+        raise ValueError("%s: 缺少FONTBOUNDINGBOX" % path)
+    return bbox, glyphs
+
+
+def render_glyph(bbox, glyph, size):
+    """把BDF字形放入 size×size 的格子，返回二维像素数组 pixels[row][col]。"""
+    fbb_w, fbb_h, fbb_x, fbb_y = bbox
+    (w, h, xoff, yoff), rows = glyph
+    pixels = [[0] * size for _ in range(size)]
+
+    # 以字体包围盒为格子，垂直方向按基线对齐，整体在目标格子中居中
+    pad_x = (size - fbb_w) // 2
+    pad_y = (size - fbb_h) // 2
+    top = (fbb_h + fbb_y) - (h + yoff)
+    left = xoff - fbb_x
+    row_bits = ((w + 7) // 8) * 8
+
+    for r, bits in enumerate(rows[:h]):
+        for c in range(w):
+            if bits & (1 << (row_bits - 1 - c)):
+                x = pad_x + left + c
+                y = pad_y + top + r
+                if 0 <= x < size and 0 <= y < size:
+                    pixels[y][x] = 1
+    return pixels
+
+
+def encode_glyph(pixels, size):
+    """按设备列取模格式编码为字节串（高字节在前）。"""
+    out = bytearray()
+    for col in range(size):
+        for half in range(size // 16):
+            word = 0
+            for row in range(16):
+                if pixels[half * 16 + row][col]:
+                    word |= 0x8000 >> row
+            out += struct.pack(">H", word)
+    return bytes(out)
+
+
+def build_section(path, size, charset):
+    bbox, glyphs = parse_bdf(path)
+    codepoints = sorted(cp for cp in glyphs if charset is None or cp in charset)
+    index = b"".join(struct.pack("<I", cp) for cp in codepoints)
+    bitmaps = b"".join(encode_glyph(render_glyph(bbox, glyphs[cp], size), size) for cp in codepoints)
+    return size, len(codepoints), index, bitmaps
+
+
+def main():
+    parser = argparse.ArgumentParser(description="生成LED屏设备端字库")
+    parser.add_argument("--font16", help="16x16使用的BDF字体")
+    parser.add_argument("--font32", help="32x32使用的BDF字体")
+    parser.add_argument("--charset", help="UTF-8文本文件，仅打包其中出现的字符")
+    parser.add_argument("-o", "--output", default="fontpack.bin", help="输出文件")
+    args = parser.parse_args()
+
+    if not args.font16 and not args.font32:
+        parser.error("至少需要指定 --font16 或 --font32")
+
+    charset = None
+    if args.charset:
+        with open(args.charset, "r", encoding="utf-8") as f:
+            charset = {ord(ch) for ch in f.read()}
+
+    sections = []
+    if args.font16:
+        sections.append(build_section(args.font16, 16, charset))
+    if args.font32:
+        sections.append(build_section(args.font32, 32, charset))
+
+    header_size = 8 + 16 * len(sections)
+    offset = header_size
+    table = b""
+    body = b""
+    for size, count, index, bitmaps in sections:
+        index_offset = offset
+        bitmap_offset = index_offset + len(index)
+        table += struct.pack("<B3xIII", size, count, index_offset, bitmap_offset)
+        body += index + bitmaps
+        offset = bitmap_offset + len(bitmaps)
+
+    data = struct.pack("<IHH", MAGIC, VERSION, len(sections)) + table + body
+    with open(args.output, "wb") as f:
+        f.write(data)
+
+    for size, count, _, _ in sections:
+        print("%dx%d: %d 个字形" % (size, size, count))
+    print("已生成 %s，共 %d 字节" % (args.output, len(data)))
+    if len(data) > 0x100000:
+        print("警告: 超出fontpack分区大小(1MB)", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
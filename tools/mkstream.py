@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""从UTF-8文本与BDF点阵字体生成流式文本文件(stream.bin)。
+
+用法:
+    python tools/mkstream.py --font16 unifont.bdf --text news.txt -o stream.bin
+    python tools/mkstream.py --font32 wqy32.bdf --text prices.txt -o stream.bin
+
+烧录到stream分区（偏移见partitions.csv）:
+    esptool.py write_flash 0x2F0000 stream.bin
+
+也可用流式文本命令 (0x13) 经蓝牙/串口上传，格式见 蓝牙流式文本帧格式.md。
+主机构建时，GlyphStream经PartitionStore以当前目录下的 stream.bin 代替Flash分区。
+
+文件格式见 include/GlyphStream.h：16字节小端文件头 + 按字符顺序排列的定长点阵，
+点阵与蓝牙文本命令(0x04)一致。文本中的换行与控制字符被忽略。
+"""
+
+import argparse
+import struct
+import sys
+import os
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from mkfontpack import encode_glyph, parse_bdf, render_glyph  # noqa: E402
+
+MAGIC = 0x5254534C  # "LSTR"
+VERSION = 1
+HEADER_SIZE = 16
+PARTITION_SIZE = 0xC0000  # 与partitions.csv中stream分区一致
+
+
+def main():
+    parser = argparse.ArgumentParser(description="生成LED屏流式文本文件")
+    font = parser.add_mutually_exclusive_group(required=True)
+    font.add_argument("--font16", help="16x16使用的BDF字体")
+    font.add_argument("--font32", help="32x32使用的BDF字体")
+    parser.add_argument("--text", required=True, help="UTF-8文本文件")
+    parser.add_argument("-o", "--output", default="stream.bin", help="输出文件")
+    args = parser.parse_args()
+
+    size = 16 if args.font16 else 32
+    bbox, glyphs = parse_bdf(args.font16 or args.font32)
+    with open(args.text, "r", encoding="utf-8") as f:
+        text = [ch for ch in f.read() if ord(ch) >= 0x20]
+    if not text:
+        sys.exit("错误: 文本为空")
+
+    blank = bytes(size * size // 8)
+    missing = set()
+    bitmaps = bytearray()
+    for ch in text:
+        glyph = glyphs.get(ord(ch))
+        if glyph is None:
+            missing.add(ch)
+            bitmaps += blank
+        else:
+            bitmaps += encode_glyph(render_glyph(bbox, glyph, size), size)
+
+    header = struct.pack("<IHBxI4x", MAGIC, VERSION, size, len(text))
+    data = header + bytes(bitmaps)
+    with open(args.output, "wb") as f:
+        f.write(data)
+
+    print("%dx%d: %d 个字符" % (size, size, len(text)))
+    if missing:
+        print("警告: 字体中缺少 %d 个字符，以空白显示: %s" % (len(missing), "".join(sorted(missing))), file=sys.stderr)
+    print("已生成 %s，共 %d 字节" % (args.output, len(data)))
+    if len(data) > PARTITION_SIZE:
+        print("警告: 超出stream分区大小(768KB)", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()